@@ -1,4 +1,5 @@
 #include "argument_parser.h"
+#include "../models/configuration.h"
 #include <QCoreApplication>
 #include <QDebug>
 
@@ -9,17 +10,25 @@ ArgumentParser::ArgumentParser(QObject *parent)
     , m_historyLimit(-1)
     , m_verbose(false)
     , m_noTray(false)
+    , m_traceLatency(false)
     , m_testMode(false)
+    , m_clientMode(false)
     , m_configPathOption({"c", "config-path"}, 
         "Set custom configuration directory path", "path")
     , m_historyLimitOption({"l", "history-limit"}, 
-        "Set maximum number of history items (10-100)", "count")
+        "Set maximum number of history items (10-100000)", "count")
     , m_hotkeyOption({"k", "hotkey"}, 
         "Set custom global hotkey (e.g., 'Ctrl+Alt+V')", "key")
     , m_verboseOption("verbose", 
         "Enable verbose output")
     , m_noTrayOption("no-tray", 
         "Disable system tray icon")
+    , m_traceLatencyOption("trace-latency", 
+        "Record hotkey-to-paint latencies and print them on exit")
+    , m_recordTraceOption("record-trace", 
+        "Record an anonymized trace of clipboard captures to a file", "file")
+    , m_profileFootprintOption("profile-footprint", 
+        "Profile startup, memory and timer wakeups and write a report to a file on exit", "file")
     , m_verifyClipboardOption("verify-clipboard", 
         "Test clipboard access and exit")
     , m_testHotkeyOption("test-hotkey", 
@@ -28,6 +37,24 @@ ArgumentParser::ArgumentParser(QObject *parent)
         "Test system tray availability and exit")
     , m_listHotkeysOption("list-hotkeys", 
         "List available hotkey combinations and exit")
+    , m_listOption("list", 
+        "Print the newest history items of the running instance")
+    , m_searchOption("search", 
+        "Print history items of the running instance matching text", "text")
+    , m_getOption("get", 
+        "Print the full text of a history item", "id")
+    , m_pinOption("pin", 
+        "Pin a history item", "id")
+    , m_unpinOption("unpin", 
+        "Unpin a history item", "id")
+    , m_pasteOption("paste", 
+        "Put a history item on the clipboard", "id")
+    , m_showOption("show", 
+        "Show the history window of the running instance")
+    , m_metricsOption("metrics", 
+        "Print runtime metrics of the running instance")
+    , m_limitOption("limit", 
+        "Maximum number of items printed by --list and --search", "count")
 {
     setupParser();
 }
@@ -48,10 +75,24 @@ void ArgumentParser::setupParser()
     m_parser.addOption(m_hotkeyOption);
     m_parser.addOption(m_verboseOption);
     m_parser.addOption(m_noTrayOption);
+    m_parser.addOption(m_traceLatencyOption);
+    m_parser.addOption(m_recordTraceOption);
+    m_parser.addOption(m_profileFootprintOption);
     m_parser.addOption(m_verifyClipboardOption);
     m_parser.addOption(m_testHotkeyOption);
     m_parser.addOption(m_testTrayOption);
     m_parser.addOption(m_listHotkeysOption);
+    
+    // Client commands for a running instance
+    m_parser.addOption(m_listOption);
+    m_parser.addOption(m_searchOption);
+    m_parser.addOption(m_getOption);
+    m_parser.addOption(m_pinOption);
+    m_parser.addOption(m_unpinOption);
+    m_parser.addOption(m_pasteOption);
+    m_parser.addOption(m_showOption);
+    m_parser.addOption(m_metricsOption);
+    m_parser.addOption(m_limitOption);
 }
 
 bool ArgumentParser::parse(QApplication& app)
@@ -73,8 +114,13 @@ bool ArgumentParser::parse(const QStringList& args)
     m_hotkey.clear();
     m_verbose = false;
     m_noTray = false;
+    m_traceLatency = false;
+    m_recordTracePath.clear();
+    m_profileFootprintPath.clear();
     m_testMode = false;
     m_testHotkey.clear();
+    m_clientMode = false;
+    m_clientRequest = IpcProtocol::Request();
     m_errorString.clear();
 
     // QCommandLineParser expects the first argument to be the executable name
@@ -105,8 +151,10 @@ bool ArgumentParser::validateArguments()
             m_errorString = "Invalid history limit: must be a number";
             return false;
         }
-        if (m_historyLimit < 10 || m_historyLimit > 100) {
-            m_errorString = "Invalid history limit: must be between 10 and 100";
+        if (!Configuration::isValidMaxHistoryItems(m_historyLimit)) {
+            m_errorString = QString("Invalid history limit: must be between %1 and %2")
+                                .arg(Configuration::minHistoryLimit())
+                                .arg(Configuration::maxHistoryLimit());
             return false;
         }
     }
@@ -118,6 +166,9 @@ bool ArgumentParser::validateArguments()
     // Extract boolean flags
     m_verbose = m_parser.isSet(m_verboseOption);
     m_noTray = m_parser.isSet(m_noTrayOption);
+    m_traceLatency = m_parser.isSet(m_traceLatencyOption);
+    m_recordTracePath = m_parser.value(m_recordTraceOption);
+    m_profileFootprintPath = m_parser.value(m_profileFootprintOption);
 
     // Check for test modes
     m_testMode = m_parser.isSet(m_verifyClipboardOption) || 
@@ -129,6 +180,43 @@ bool ArgumentParser::validateArguments()
         m_testHotkey = m_parser.value(m_testHotkeyOption);
     }
 
+    return validateClientArguments();
+}
+
+bool ArgumentParser::validateClientArguments()
+{
+    using Command = IpcProtocol::Command;
+    const QList<QPair<const QCommandLineOption*, Command>> commands = {
+        {&m_listOption, Command::List},   {&m_searchOption, Command::Search},
+        {&m_getOption, Command::Get},     {&m_pinOption, Command::Pin},
+        {&m_unpinOption, Command::Unpin}, {&m_pasteOption, Command::Paste},
+        {&m_showOption, Command::Show},   {&m_metricsOption, Command::Metrics},
+    };
+
+    for (const auto& [option, command] : commands) {
+        if (!m_parser.isSet(*option)) {
+            continue;
+        }
+        if (m_clientMode) {
+            m_errorString = "Only one client command can be given at a time";
+            return false;
+        }
+        m_clientMode = true;
+        m_clientRequest.command = command;
+        if (!option->valueName().isEmpty()) {
+            m_clientRequest.argument = m_parser.value(*option);
+        }
+    }
+
+    if (m_parser.isSet(m_limitOption)) {
+        bool ok;
+        m_clientRequest.limit = m_parser.value(m_limitOption).toInt(&ok);
+        if (!ok || m_clientRequest.limit <= 0 || m_clientRequest.limit > IpcProtocol::MAX_LIMIT) {
+            m_errorString = QString("Invalid limit: must be between 1 and %1").arg(IpcProtocol::MAX_LIMIT);
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -157,6 +245,21 @@ bool ArgumentParser::isNoTray() const
     return m_noTray;
 }
 
+bool ArgumentParser::isTraceLatency() const
+{
+    return m_traceLatency;
+}
+
+QString ArgumentParser::getRecordTracePath() const
+{
+    return m_recordTracePath;
+}
+
+QString ArgumentParser::getProfileFootprintPath() const
+{
+    return m_profileFootprintPath;
+}
+
 bool ArgumentParser::isTestMode() const
 {
     return m_testMode;
@@ -167,6 +270,36 @@ QString ArgumentParser::getTestHotkey() const
     return m_testHotkey;
 }
 
+bool ArgumentParser::isClientMode() const
+{
+    return m_clientMode;
+}
+
+IpcProtocol::Request ArgumentParser::getClientRequest() const
+{
+    return m_clientRequest;
+}
+
+bool ArgumentParser::isClientInvocation(int argc, char* argv[])
+{
+    static const char* const commands[] = {"list", "search", "get", "pin", "unpin", "paste",
+                                            "show", "metrics"};
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if (!arg.startsWith("--")) {
+            continue;
+        }
+        const qsizetype equals = arg.indexOf('=');
+        const QByteArray name = equals < 0 ? arg.mid(2) : arg.mid(2, equals - 2);
+        for (const char* command : commands) {
+            if (name == command) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 QString ArgumentParser::getErrorString() const
 {
     return m_errorString;
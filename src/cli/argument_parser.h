@@ -6,6 +6,8 @@
 #include <QStringList>
 #include <QApplication>
 
+#include "../services/ipc_protocol.h"
+
 /**
  * @brief Command-line argument parser for clipboard history manager
  * 
@@ -43,16 +45,35 @@ public:
     bool isVerbose() const;
     bool isNoTray() const;
 
+    // Diagnostics getters
+    bool isTraceLatency() const;
+    QString getRecordTracePath() const;
+    QString getProfileFootprintPath() const;
+
     // Test mode getters
     bool isTestMode() const;
     QString getTestHotkey() const;
 
+    // Client mode getters
+    bool isClientMode() const;
+    IpcProtocol::Request getClientRequest() const;
+
+    /**
+     * @brief Check for a client command without parsing the arguments
+     * @param argc Argument count from main()
+     * @param argv Arguments from main()
+     * @return true if the invocation talks to a running instance, so no
+     *         GUI application has to be created
+     */
+    static bool isClientInvocation(int argc, char* argv[]);
+
     // Error handling
     QString getErrorString() const;
 
 private:
     void setupParser();
     bool validateArguments();
+    bool validateClientArguments();
 
 private:
     QCommandLineParser m_parser;
@@ -63,8 +84,13 @@ private:
     QString m_hotkey;
     bool m_verbose;
     bool m_noTray;
+    bool m_traceLatency;
+    QString m_recordTracePath;
+    QString m_profileFootprintPath;
     bool m_testMode;
     QString m_testHotkey;
+    bool m_clientMode;
+    IpcProtocol::Request m_clientRequest;
     QString m_errorString;
 
     // Command line options
@@ -73,10 +99,22 @@ private:
     QCommandLineOption m_hotkeyOption;
     QCommandLineOption m_verboseOption;
     QCommandLineOption m_noTrayOption;
+    QCommandLineOption m_traceLatencyOption;
+    QCommandLineOption m_recordTraceOption;
+    QCommandLineOption m_profileFootprintOption;
     QCommandLineOption m_verifyClipboardOption;
     QCommandLineOption m_testHotkeyOption;
     QCommandLineOption m_testTrayOption;
     QCommandLineOption m_listHotkeysOption;
+    QCommandLineOption m_listOption;
+    QCommandLineOption m_searchOption;
+    QCommandLineOption m_getOption;
+    QCommandLineOption m_pinOption;
+    QCommandLineOption m_unpinOption;
+    QCommandLineOption m_pasteOption;
+    QCommandLineOption m_showOption;
+    QCommandLineOption m_metricsOption;
+    QCommandLineOption m_limitOption;
 };
 
 #endif // ARGUMENT_PARSER_H
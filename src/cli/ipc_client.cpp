@@ -0,0 +1,46 @@
+#include "ipc_client.h"
+#include <QDeadlineTimer>
+
+bool IpcClient::connectToServer(const QString& name, int timeoutMs)
+{
+    m_buffer.clear();
+    m_socket.connectToServer(name);
+    if (!m_socket.waitForConnected(timeoutMs)) {
+        m_errorString = QString("No running instance at %1: %2").arg(name, m_socket.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool IpcClient::send(const IpcProtocol::Request& request, IpcProtocol::Response& response,
+                     int timeoutMs)
+{
+    QDeadlineTimer deadline(timeoutMs);
+    m_socket.write(IpcProtocol::frame(IpcProtocol::encodeRequest(request)));
+    if (!m_socket.waitForBytesWritten(int(deadline.remainingTime()))) {
+        m_errorString = QString("Failed to send request: %1").arg(m_socket.errorString());
+        return false;
+    }
+
+    QByteArray payload;
+    IpcProtocol::FrameResult result;
+    while ((result = IpcProtocol::takeFrame(m_buffer, payload)) == IpcProtocol::FrameResult::Incomplete) {
+        if (deadline.hasExpired() || !m_socket.waitForReadyRead(int(deadline.remainingTime()))) {
+            m_errorString = QString("No response: %1").arg(m_socket.errorString());
+            return false;
+        }
+        m_buffer.append(m_socket.readAll());
+    }
+
+    if (result == IpcProtocol::FrameResult::Invalid ||
+        !IpcProtocol::decodeResponse(payload, response)) {
+        m_errorString = "Malformed response";
+        return false;
+    }
+    return true;
+}
+
+QString IpcClient::errorString() const
+{
+    return m_errorString;
+}
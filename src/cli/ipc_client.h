@@ -0,0 +1,51 @@
+#ifndef IPC_CLIENT_H
+#define IPC_CLIENT_H
+
+#include <QLocalSocket>
+#include <QString>
+
+#include "../services/ipc_protocol.h"
+
+/**
+ * @brief Blocking client for the running instance's IPC server
+ *
+ * Used by the command-line client mode: it needs no event loop and no GUI,
+ * so a query costs a connection and one round trip instead of an
+ * application startup and a history load.
+ */
+class IpcClient
+{
+public:
+    /**
+     * @brief Connect to a running instance
+     * @param name Server name or socket path
+     * @param timeoutMs Time to wait for the connection
+     * @return false if no instance is listening
+     */
+    bool connectToServer(const QString& name = IpcProtocol::defaultServerName(),
+                         int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /**
+     * @brief Send a request and wait for its response
+     * @param request Request to send
+     * @param response Filled with the decoded response
+     * @param timeoutMs Time to wait for the complete response
+     * @return false on a connection, timeout or protocol error
+     */
+    bool send(const IpcProtocol::Request& request, IpcProtocol::Response& response,
+              int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /**
+     * @brief Get description of the last connection or protocol error
+     */
+    QString errorString() const;
+
+private:
+    static constexpr int DEFAULT_TIMEOUT_MS = 2000;
+
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+    QString m_errorString;
+};
+
+#endif // IPC_CLIENT_H
@@ -0,0 +1,63 @@
+#include "display_session.h"
+#include <QGuiApplication>
+
+#ifdef Q_OS_LINUX
+#include <X11/Xlib.h>
+#endif
+
+bool DisplaySession::isCompositing()
+{
+    const QString platform = QGuiApplication::platformName();
+    if (platform.startsWith("wayland") || platform == "windows" || platform == "cocoa") {
+        return true;
+    }
+    if (platform == "xcb") {
+        return hasX11CompositingManager();
+    }
+    return false;
+}
+
+bool DisplaySession::isRemote()
+{
+    if (QGuiApplication::platformName() != "xcb") {
+        return false;
+    }
+    // SSH X forwarding sets DISPLAY to localhost:10 and up
+    return !qEnvironmentVariableIsEmpty("SSH_CONNECTION") ||
+           isRemoteDisplayName(qEnvironmentVariable("DISPLAY"));
+}
+
+bool DisplaySession::isRemoteDisplayName(const QString& display)
+{
+    // "host:display.screen"; local sockets are ":0", "unix:0" or a path (XQuartz)
+    const qsizetype colon = display.lastIndexOf(':');
+    if (colon <= 0) {
+        return false;
+    }
+    const QString host = display.left(colon);
+    return host != "unix" && !host.startsWith('/');
+}
+
+bool DisplaySession::hasX11CompositingManager()
+{
+#ifdef Q_OS_LINUX
+    // Qt's own connection when running on xcb, so no second connection is opened
+    Display* display = nullptr;
+#if QT_CONFIG(xcb)
+    if (qGuiApp) {
+        if (auto* x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>()) {
+            display = x11->display();
+        }
+    }
+#endif
+    if (!display) {
+        return false;
+    }
+
+    const QByteArray selection = "_NET_WM_CM_S" + QByteArray::number(DefaultScreen(display));
+    const Atom atom = XInternAtom(display, selection.constData(), True);
+    return atom != None && XGetSelectionOwner(display, atom) != None;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QString>
+
+/**
+ * DisplaySession - What the display the application runs on can afford
+ *
+ * Translucent windows are only cheap when a compositor blends them on
+ * the GPU. Without one, or when the display is forwarded over the
+ * network, every translucent repaint is blended in software and sent in
+ * full. These checks let the UI pick a cheaper way to draw itself.
+ *
+ * Detection:
+ * - Wayland, Windows and macOS always composite
+ * - X11 composites when a manager owns the _NET_WM_CM_Sn selection
+ * - Offscreen, VNC, framebuffer and other platforms are treated as not
+ *   compositing
+ * - A display is remote when DISPLAY names another host or the X
+ *   connection arrived through SSH forwarding
+ */
+class DisplaySession
+{
+public:
+    /**
+     * Check if a compositor blends the application's windows
+     * @return true if translucent windows are composited
+     */
+    static bool isCompositing();
+
+    /**
+     * Check if the display is reached over the network
+     * @return true for forwarded or remote X displays
+     */
+    static bool isRemote();
+
+    /**
+     * Check if a display name refers to another machine
+     * @param display X display name, e.g. ":0" or "localhost:10.0"
+     * @return true if the name has a host part
+     */
+    static bool isRemoteDisplayName(const QString& display);
+
+private:
+    /**
+     * Ask the X server whether a compositing manager is running
+     * @return true if the _NET_WM_CM_Sn selection of the default screen has an owner
+     */
+    static bool hasX11CompositingManager();
+};
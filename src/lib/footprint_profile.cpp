@@ -0,0 +1,201 @@
+#include "footprint_profile.h"
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTimer>
+#include <algorithm>
+
+FootprintProfile::FootprintProfile(QObject* parent)
+    : QObject(parent)
+    , m_started(false)
+    , m_wakeups(0)
+    , m_activityWakeups(0)
+    , m_activities(0)
+{
+}
+
+FootprintProfile::~FootprintProfile()
+{
+    if (m_started && QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeEventFilter(this);
+    }
+}
+
+void FootprintProfile::start()
+{
+    if (m_started || !QCoreApplication::instance()) {
+        return;
+    }
+
+    // The filter sees every event of every GUI thread object, but only
+    // timer events are counted and the cost is only paid while profiling
+    QCoreApplication::instance()->installEventFilter(this);
+    if (QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance()) {
+        connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() {
+            ++m_wakeups;
+        });
+    }
+    m_uptime.start();
+    m_quiet.start();
+    m_started = true;
+}
+
+void FootprintProfile::addPhase(const QString& phase, qint64 msecs)
+{
+    m_phases.append({phase, msecs});
+}
+
+void FootprintProfile::setHeapUsage(const QString& subsystem, qint64 bytes)
+{
+    for (QPair<QString, qint64>& entry : m_heap) {
+        if (entry.first == subsystem) {
+            entry.second = bytes;
+            return;
+        }
+    }
+    m_heap.append({subsystem, bytes});
+}
+
+void FootprintProfile::markActivity()
+{
+    ++m_activities;
+    m_activityWakeups = m_wakeups;
+    m_quiet.restart();
+}
+
+QString FootprintProfile::report() const
+{
+    QStringList lines;
+    const qint64 uptime = m_started ? m_uptime.elapsed() : 0;
+    lines << QString("uptime_s %1").arg(uptime / 1000);
+
+    const qint64 rss = residentBytes();
+    if (rss >= 0) {
+        lines << QString("rss_bytes %1").arg(rss);
+        lines << QString("rss_peak_bytes %1").arg(residentBytes(true));
+    }
+
+    for (const auto& [phase, msecs] : m_phases) {
+        lines << QString("startup_%1_ms %2").arg(keyFor(phase)).arg(msecs);
+    }
+
+    qint64 heapTotal = 0;
+    for (const auto& [subsystem, bytes] : m_heap) {
+        lines << QString("heap_%1_bytes %2").arg(keyFor(subsystem)).arg(bytes);
+        heapTotal += bytes;
+    }
+    lines << QString("heap_total_bytes %1").arg(heapTotal);
+
+    lines << QString("wakeups %1").arg(m_wakeups);
+    lines << QString("wakeups_per_min %1").arg(perMinute(m_wakeups, uptime));
+
+    // Since the last clipboard activity, or since start() without any
+    const qint64 quiet = m_started ? m_quiet.elapsed() : 0;
+    lines << QString("activities %1").arg(m_activities);
+    lines << QString("quiet_s %1").arg(quiet / 1000);
+    lines << QString("quiet_wakeups %1").arg(quietWakeups());
+    lines << QString("quiet_wakeups_per_min %1").arg(perMinute(quietWakeups(), quiet));
+
+    // Busiest timers first
+    QList<QPair<QString, quint64>> timers;
+    for (auto it = m_timerEvents.constBegin(); it != m_timerEvents.constEnd(); ++it) {
+        timers.append({it.key(), it.value()});
+    }
+    std::sort(timers.begin(), timers.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    for (const auto& [timer, events] : timers) {
+        lines << QString("timer_%1_per_min %2").arg(keyFor(timer), perMinute(events, uptime));
+    }
+
+    return lines.join('\n') + '\n';
+}
+
+bool FootprintProfile::writeReport(const QString& path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open footprint report" << path << ":" << file.errorString();
+        return false;
+    }
+    file.write(report().toUtf8());
+    if (!file.commit()) {
+        qWarning() << "Failed to write footprint report" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString FootprintProfile::keyFor(const QString& name)
+{
+    QString key;
+    key.reserve(name.size());
+    for (QChar c : name) {
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+            key += c;
+        } else if (c >= 'A' && c <= 'Z') {
+            key += c.toLower();
+        } else if (!key.isEmpty() && !key.endsWith('_')) {
+            key += '_';
+        }
+    }
+    if (key.endsWith('_')) {
+        key.chop(1);
+    }
+    return key;
+}
+
+qint64 FootprintProfile::residentBytes(bool peak)
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    const QByteArray field = peak ? "VmHWM:" : "VmRSS:";
+    while (!status.atEnd()) {
+        const QByteArray line = status.readLine();
+        if (line.startsWith(field)) {
+            // e.g. "VmRSS:\t   23456 kB"
+            return line.mid(field.size()).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return -1;
+#else
+    Q_UNUSED(peak)
+    return -1;
+#endif
+}
+
+bool FootprintProfile::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::Timer) {
+        ++m_timerEvents[timerName(watched)];
+    }
+    return false;
+}
+
+QString FootprintProfile::timerName(const QObject* receiver)
+{
+    // A QTimer is named after its owner; other objects run their own timers
+    const QObject* owner = receiver;
+    if (qobject_cast<const QTimer*>(receiver) && receiver->parent()) {
+        owner = receiver->parent();
+    }
+    QString name = QString::fromLatin1(owner->metaObject()->className());
+    if (owner != receiver || !receiver->objectName().isEmpty()) {
+        name += "::" + (receiver->objectName().isEmpty()
+                            ? QString::fromLatin1(receiver->metaObject()->className())
+                            : receiver->objectName());
+    }
+    return name;
+}
+
+QString FootprintProfile::perMinute(quint64 count, qint64 msecs)
+{
+    return QString::number(double(count) * 60000.0 / double(qMax<qint64>(msecs, 1)), 'f', 2);
+}
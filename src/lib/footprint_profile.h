@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+/**
+ * FootprintProfile - Startup, memory and wakeup profile of a session
+ *
+ * Collects what decides the cost of an application that mostly sits in
+ * the tray: how long each startup phase took, how much heap each
+ * subsystem holds, and how often the process wakes up while nothing
+ * happens. report() formats everything as "name value" lines.
+ *
+ * Wakeups are counted two ways once start() is called:
+ * - Event loop wakeups, from QAbstractEventDispatcher::awake()
+ * - Timer events per timer, through an application event filter. A
+ *   timer is named "Owner::objectName" after the class of its parent,
+ *   so name the timers that should be told apart
+ *
+ * markActivity() starts a new quiet period; wakeups since the last
+ * activity show whether the process is idle while the clipboard is.
+ * Only timers of GUI thread objects are seen. Heap sizes are estimates
+ * supplied by the subsystems themselves through setHeapUsage().
+ *
+ * The profile must only be used from the GUI thread.
+ */
+class FootprintProfile : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor - Creates an idle profile
+     * @param parent QObject parent for memory management
+     */
+    explicit FootprintProfile(QObject* parent = nullptr);
+    ~FootprintProfile() override;
+
+    /**
+     * Start counting wakeups and timer events
+     * Needs a QCoreApplication; calling it again does nothing
+     */
+    void start();
+
+    /**
+     * Check if wakeups are being counted
+     */
+    bool isStarted() const { return m_started; }
+
+    /**
+     * Record the time since process start at which a startup phase ended
+     * @param phase Phase name, e.g. "tray icon"
+     * @param msecs Milliseconds since process start
+     */
+    void addPhase(const QString& phase, qint64 msecs);
+
+    /**
+     * Set the estimated heap held by a subsystem
+     * @param subsystem Subsystem name, e.g. "history"
+     * @param bytes Estimated bytes; replaces an earlier value
+     */
+    void setHeapUsage(const QString& subsystem, qint64 bytes);
+
+    /**
+     * Start a new quiet period, e.g. on clipboard activity
+     */
+    void markActivity();
+
+    // Counters
+    quint64 wakeups() const { return m_wakeups; }
+    quint64 quietWakeups() const { return m_wakeups - m_activityWakeups; }
+    quint64 timerEvents(const QString& timer) const { return m_timerEvents.value(timer); }
+
+    /**
+     * Format the profile
+     * @return One "name value" pair per line; rates are per minute since start()
+     */
+    QString report() const;
+
+    /**
+     * Write report() to a file, replacing it atomically
+     * @param path Report file
+     * @return true if the report was written
+     */
+    bool writeReport(const QString& path) const;
+
+    /**
+     * Turn a free-form name into a report key
+     * @return Lowercase letters, digits and '_', e.g. "history loaded (empty)" -> "history_loaded_empty"
+     */
+    static QString keyFor(const QString& name);
+
+    /**
+     * Read the resident set size of the process
+     * @param peak true for the high-water mark instead of the current size
+     * @return Bytes, or -1 where the platform does not report it
+     */
+    static qint64 residentBytes(bool peak = false);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    /**
+     * Name the timer a timer event belongs to
+     */
+    static QString timerName(const QObject* receiver);
+
+    /**
+     * Convert a count to a rate over the profiled time
+     */
+    static QString perMinute(quint64 count, qint64 msecs);
+
+    bool m_started;
+    QElapsedTimer m_uptime;                  ///< Started by start()
+    QElapsedTimer m_quiet;                   ///< Restarted by markActivity()
+    quint64 m_wakeups;                       ///< Event dispatcher wakeups since start()
+    quint64 m_activityWakeups;               ///< m_wakeups at the last activity
+    quint64 m_activities;                    ///< markActivity() calls
+    QHash<QString, quint64> m_timerEvents;   ///< Timer name -> events
+    QList<QPair<QString, qint64>> m_phases;  ///< Startup phases in order
+    QList<QPair<QString, qint64>> m_heap;    ///< Subsystem -> bytes, in order set
+};
@@ -1,24 +1,122 @@
 #include "global_hotkey.h"
+#include "latency_trace.h"
 #include <QDebug>
 #include <QStringList>
 #include <QCoreApplication>
+#include <QGuiApplication>
+#include <QAbstractNativeEventFilter>
+#include <QSocketNotifier>
 #include <QTimer>
 #include <QShortcut>
+#include <functional>
+#include <memory>
 
 // Platform-specific includes
 #ifdef Q_OS_LINUX
-// Only include X11 headers if X11 is available
-#ifdef QT_X11EXTRAS_LIB
-#include <QX11Info>
-#endif
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
+#include <xcb/xcb.h>
 #endif
 
 // Static test mode variable
 bool GlobalHotkey::s_testMode = false;
 QStringList GlobalHotkey::s_testModeRegisteredHotkeys;
 
+#ifdef Q_OS_LINUX
+namespace {
+
+// CapsLock (Lock) and NumLock (Mod2) must not stop the hotkey from
+// matching, so every combination of them is grabbed as well
+constexpr unsigned int LOCK_MODIFIER_VARIANTS[] = {0, LockMask, Mod2Mask, LockMask | Mod2Mask};
+constexpr unsigned int HOTKEY_MODIFIERS = ShiftMask | ControlMask | Mod1Mask | Mod4Mask;
+
+int s_grabError = Success;
+
+int recordGrabError(Display* display, XErrorEvent* error)
+{
+    Q_UNUSED(display)
+    s_grabError = error->error_code;
+    return 0;
+}
+
+bool matchesGrab(int keycode, unsigned int modifiers, int eventKeycode, unsigned int eventState)
+{
+    return eventKeycode == keycode && (eventState & HOTKEY_MODIFIERS) == modifiers;
+}
+
+/**
+ * Translate a Qt key code into an X11 keysym
+ */
+KeySym toKeysym(int key)
+{
+    if ((key >= Qt::Key_A && key <= Qt::Key_Z) || (key >= Qt::Key_0 && key <= Qt::Key_9)) {
+        return KeySym(key); // Latin-1 keysyms match the Qt codes
+    }
+    if (key >= Qt::Key_F1 && key <= Qt::Key_F24) {
+        return XK_F1 + (key - Qt::Key_F1);
+    }
+    switch (key) {
+        case Qt::Key_Space: return XK_space;
+        case Qt::Key_Tab: return XK_Tab;
+        case Qt::Key_Return: return XK_Return;
+        case Qt::Key_Escape: return XK_Escape;
+        case Qt::Key_Delete: return XK_Delete;
+        case Qt::Key_Backspace: return XK_BackSpace;
+        case Qt::Key_Insert: return XK_Insert;
+        case Qt::Key_Home: return XK_Home;
+        case Qt::Key_End: return XK_End;
+        case Qt::Key_PageUp: return XK_Prior;
+        case Qt::Key_PageDown: return XK_Next;
+        case Qt::Key_Up: return XK_Up;
+        case Qt::Key_Down: return XK_Down;
+        case Qt::Key_Left: return XK_Left;
+        case Qt::Key_Right: return XK_Right;
+        default: return NoSymbol;
+    }
+}
+
+/**
+ * Picks the grabbed key presses out of Qt's own XCB event stream
+ */
+class X11KeyFilter : public QAbstractNativeEventFilter
+{
+public:
+    X11KeyFilter(int keycode, unsigned int modifiers, std::function<void()> trigger)
+        : m_keycode(keycode)
+        , m_modifiers(modifiers)
+        , m_trigger(std::move(trigger))
+    {
+    }
+
+    bool nativeEventFilter(const QByteArray& eventType, void* message, qintptr* result) override
+    {
+        Q_UNUSED(result)
+        if (eventType != "xcb_generic_event_t") {
+            return false;
+        }
+
+        auto* event = static_cast<xcb_generic_event_t*>(message);
+        if ((event->response_type & ~0x80) != XCB_KEY_PRESS) {
+            return false;
+        }
+
+        auto* keyEvent = reinterpret_cast<xcb_key_press_event_t*>(event);
+        if (!matchesGrab(m_keycode, m_modifiers, keyEvent->detail, keyEvent->state)) {
+            return false;
+        }
+        m_trigger();
+        return true;
+    }
+
+private:
+    int m_keycode;
+    unsigned int m_modifiers;
+    std::function<void()> m_trigger;
+};
+
+} // namespace
+#endif
+
 /**
  * Platform-specific data structure
  */
@@ -30,6 +128,9 @@ struct GlobalHotkey::PlatformData
     int x11Modifiers = 0;
     int x11Keycode = 0;
     bool x11Registered = false;
+    bool ownDisplay = false;                     // Opened by us rather than shared with Qt
+    std::unique_ptr<X11KeyFilter> keyFilter;     // Key events on Qt's connection
+    QSocketNotifier* displayNotifier = nullptr;  // Key events on our own connection
 #endif
     
     // Fallback Qt shortcut
@@ -173,6 +274,11 @@ QString GlobalHotkey::getHotkeyString() const
     return m_hotkeyString;
 }
 
+qint64 GlobalHotkey::nsecsSinceTrigger() const
+{
+    return m_triggerTimer.isValid() ? m_triggerTimer.nsecsElapsed() : -1;
+}
+
 QString GlobalHotkey::lastError() const
 {
     return m_lastError;
@@ -215,6 +321,8 @@ bool GlobalHotkey::isWaylandAvailable()
 void GlobalHotkey::handleHotkeyEvent()
 {
     if (m_registered) {
+        m_triggerTimer.start();
+        LatencyTrace::mark(LatencyTrace::HotkeyPressed);
         qDebug() << "GlobalHotkey: Hotkey triggered:" << m_hotkeyString;
         emit hotkeyTriggered();
     }
@@ -250,29 +358,27 @@ bool GlobalHotkey::parseHotkeyString(const QString& hotkeyString, int& modifiers
 bool GlobalHotkey::registerX11Hotkey(int modifiers, int key)
 {
 #ifdef Q_OS_LINUX
-#ifdef QT_X11EXTRAS_LIB
-    if (!QX11Info::isPlatformX11()) {
-        setError("X11 platform not available");
-        return false;
+    // Grab on Qt's own connection, so key presses arrive through its event
+    // loop; a private connection is only used outside the xcb platform
+    Display* display = nullptr;
+#if QT_CONFIG(xcb)
+    if (qGuiApp) {
+        if (auto* x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>()) {
+            display = x11->display();
+        }
     }
-    
-    m_platformData->display = QX11Info::display();
-    if (!m_platformData->display) {
-        setError("Could not get X11 display");
-        return false;
+#endif
+    m_platformData->ownDisplay = display == nullptr;
+    if (!display) {
+        display = XOpenDisplay(nullptr);
     }
-    
-    m_platformData->rootWindow = QX11Info::appRootWindow();
-#else
-    // Fallback when QX11Info is not available
-    m_platformData->display = XOpenDisplay(nullptr);
-    if (!m_platformData->display) {
+    if (!display) {
         setError("Could not open X11 display");
         return false;
     }
     
-    m_platformData->rootWindow = DefaultRootWindow(m_platformData->display);
-#endif
+    m_platformData->display = display;
+    m_platformData->rootWindow = DefaultRootWindow(display);
     
     // Convert Qt modifiers to X11 modifiers
     int x11Modifiers = 0;
@@ -282,42 +388,53 @@ bool GlobalHotkey::registerX11Hotkey(int modifiers, int key)
     if (modifiers & Qt::MetaModifier) x11Modifiers |= Mod4Mask;  // Super/Windows key
     
     m_platformData->x11Modifiers = x11Modifiers;
-    m_platformData->x11Keycode = XKeysymToKeycode(m_platformData->display, key);
+    KeySym keysym = toKeysym(key);
+    m_platformData->x11Keycode = keysym != NoSymbol ? XKeysymToKeycode(display, keysym) : 0;
     
-    qDebug() << "GlobalHotkey: X11 Debug - Keycode:" << m_platformData->x11Keycode 
-             << "Modifiers:" << x11Modifiers << "Display:" << (void*)m_platformData->display 
-             << "RootWindow:" << m_platformData->rootWindow;
+    qDebug() << "GlobalHotkey: X11 keycode:" << m_platformData->x11Keycode 
+             << "modifiers:" << x11Modifiers << "shared connection:" << !m_platformData->ownDisplay;
     
     if (m_platformData->x11Keycode == 0) {
         setError("Could not convert key to X11 keycode");
+        ungrabX11Hotkey();
         return false;
     }
     
-    // Register the hotkey with X11
-    // Try simple registration first to debug
-    int result = XGrabKey(m_platformData->display, 
-                         m_platformData->x11Keycode,
-                         m_platformData->x11Modifiers,
-                         m_platformData->rootWindow,
-                         False,
-                         GrabModeAsync,
-                         GrabModeAsync);
-    
-    qDebug() << "GlobalHotkey: Simple registration result:" << result;
+    // Grab every lock key variant; grab errors arrive asynchronously, so
+    // collect them with a round trip
+    s_grabError = Success;
+    XErrorHandler previousHandler = XSetErrorHandler(recordGrabError);
+    for (unsigned int lockModifiers : LOCK_MODIFIER_VARIANTS) {
+        XGrabKey(display, m_platformData->x11Keycode, x11Modifiers | lockModifiers,
+                 m_platformData->rootWindow, False, GrabModeAsync, GrabModeAsync);
+    }
+    XSync(display, False);
+    XSetErrorHandler(previousHandler);
+    m_platformData->x11Registered = true;
     
-    if (result == Success) {
-        m_platformData->x11Registered = true;
-        return true;
-    } else if (result == BadAccess) {
-        setError("Hotkey already in use by another application");
-        return false;
-    } else {
-        setError(QString("X11 XGrabKey failed with code: %1 (keycode=%2, modifiers=%3)")
-                .arg(result).arg(m_platformData->x11Keycode).arg(m_platformData->x11Modifiers));
+    if (s_grabError != Success) {
+        if (s_grabError == BadAccess) {
+            setError("Hotkey already in use by another application");
+        } else {
+            setError(QString("X11 XGrabKey failed with code: %1 (keycode=%2, modifiers=%3)")
+                    .arg(s_grabError).arg(m_platformData->x11Keycode).arg(x11Modifiers));
+        }
+        ungrabX11Hotkey();
         return false;
     }
     
-    XSync(m_platformData->display, False);
+    // Key presses are delivered as events; nothing polls the display
+    if (m_platformData->ownDisplay) {
+        m_platformData->displayNotifier = new QSocketNotifier(ConnectionNumber(display),
+                                                              QSocketNotifier::Read, this);
+        connect(m_platformData->displayNotifier, &QSocketNotifier::activated,
+                this, &GlobalHotkey::processX11Events);
+    } else {
+        m_platformData->keyFilter = std::make_unique<X11KeyFilter>(
+            m_platformData->x11Keycode, unsigned(x11Modifiers), [this]() { handleHotkeyEvent(); });
+        QCoreApplication::instance()->installNativeEventFilter(m_platformData->keyFilter.get());
+    }
+    return true;
 #else
     Q_UNUSED(modifiers)
     Q_UNUSED(key)
@@ -326,6 +443,57 @@ bool GlobalHotkey::registerX11Hotkey(int modifiers, int key)
 #endif
 }
 
+void GlobalHotkey::processX11Events()
+{
+#ifdef Q_OS_LINUX
+    Display* display = m_platformData->display;
+    if (!display) {
+        return;
+    }
+    
+    while (XPending(display) > 0) {
+        XEvent event;
+        XNextEvent(display, &event);
+        if (event.type == KeyPress &&
+            matchesGrab(m_platformData->x11Keycode, unsigned(m_platformData->x11Modifiers),
+                        int(event.xkey.keycode), event.xkey.state)) {
+            handleHotkeyEvent();
+        }
+    }
+#endif
+}
+
+void GlobalHotkey::ungrabX11Hotkey()
+{
+#ifdef Q_OS_LINUX
+    if (m_platformData->keyFilter) {
+        QCoreApplication::instance()->removeNativeEventFilter(m_platformData->keyFilter.get());
+        m_platformData->keyFilter.reset();
+    }
+    delete m_platformData->displayNotifier;
+    m_platformData->displayNotifier = nullptr;
+    
+    if (!m_platformData->display) {
+        return;
+    }
+    
+    if (m_platformData->x11Registered) {
+        for (unsigned int lockModifiers : LOCK_MODIFIER_VARIANTS) {
+            XUngrabKey(m_platformData->display, m_platformData->x11Keycode,
+                       m_platformData->x11Modifiers | lockModifiers, m_platformData->rootWindow);
+        }
+        XSync(m_platformData->display, False);
+        m_platformData->x11Registered = false;
+    }
+    
+    // Qt's connection is not ours to close
+    if (m_platformData->ownDisplay) {
+        XCloseDisplay(m_platformData->display);
+    }
+    m_platformData->display = nullptr;
+#endif
+}
+
 bool GlobalHotkey::registerWaylandHotkey(int modifiers, int key)
 {
     Q_UNUSED(modifiers)
@@ -363,23 +531,7 @@ bool GlobalHotkey::registerFallbackHotkey(int modifiers, int key)
 
 void GlobalHotkey::unregisterPlatformHotkey()
 {
-#ifdef Q_OS_LINUX
-    if (m_platformData->x11Registered && m_platformData->display) {
-        XUngrabKey(m_platformData->display,
-                  m_platformData->x11Keycode,
-                  m_platformData->x11Modifiers,
-                  m_platformData->rootWindow);
-        XSync(m_platformData->display, False);
-        
-#ifndef QT_X11EXTRAS_LIB
-        // If we opened the display ourselves, close it
-        XCloseDisplay(m_platformData->display);
-        m_platformData->display = nullptr;
-#endif
-        
-        m_platformData->x11Registered = false;
-    }
-#endif
+    ungrabX11Hotkey();
     
     if (m_platformData->fallbackShortcut) {
         delete m_platformData->fallbackShortcut;
@@ -528,6 +680,8 @@ void GlobalHotkey::simulateHotkeyTrigger()
 {
     if (s_testMode && m_registered) {
         qDebug() << "GlobalHotkey: Test mode - simulating hotkey trigger for" << m_hotkeyString;
+        m_triggerTimer.start();
+        LatencyTrace::mark(LatencyTrace::HotkeyPressed);
         emit hotkeyTriggered();
     }
 }
@@ -14,7 +14,9 @@
  * triggered.
  * 
  * Supported platforms:
- * - X11: Uses XGrabKey with Qt integration
+ * - X11: Uses XGrabKey on Qt's own connection (with every CapsLock/NumLock
+ *   variant) and picks the key presses out of its event stream with a
+ *   native event filter, so triggers are delivered without polling
  * - Wayland: Uses compositor-specific protocols (future enhancement)
  * - Fallback: Basic QShortcut implementation
  * 
@@ -71,6 +73,13 @@ public:
      * @return String representation of registered hotkey, empty if none
      */
     QString getHotkeyString() const;
+    
+    /**
+     * Get the time since the hotkey was last triggered
+     * @return Nanoseconds since the key press was received, -1 if never;
+     *         read it once the popup is shown to measure hotkey-to-popup latency
+     */
+    qint64 nsecsSinceTrigger() const;
 
     // Error Handling Methods
     /**
@@ -134,12 +143,18 @@ private slots:
      * Handle platform-specific hotkey events
      */
     void handleHotkeyEvent();
+    
+    /**
+     * Read pending events from a private X11 connection
+     */
+    void processX11Events();
 
 private:
     // Internal state
     bool m_registered;
     QString m_hotkeyString;
     QString m_lastError;
+    QElapsedTimer m_triggerTimer;        ///< Started when a trigger is received
     
     // Platform-specific data
     struct PlatformData;
@@ -155,6 +170,7 @@ private:
     bool registerWaylandHotkey(int modifiers, int key);
     bool registerFallbackHotkey(int modifiers, int key);
     void unregisterPlatformHotkey();
+    void ungrabX11Hotkey();
     void setError(const QString& error);
     
     // Helper methods for parsing
@@ -0,0 +1,152 @@
+#include "latency_trace.h"
+#include <QStringList>
+#include <bit>
+#include <cmath>
+
+bool LatencyTrace::s_enabled = false;
+
+// LatencyHistogram
+
+void LatencyHistogram::record(qint64 nsecs)
+{
+    nsecs = qMax<qint64>(0, nsecs);
+    m_buckets[bucketFor(quint64(nsecs) / 1000)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    qint64 max = m_max.load(std::memory_order_relaxed);
+    while (nsecs > max && !m_max.compare_exchange_weak(max, nsecs, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 LatencyHistogram::percentile(double percentile) const
+{
+    const quint64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    const double fraction = qBound(0.0, percentile, 100.0) / 100.0;
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(fraction * double(total))));
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // The bucket bound can overshoot the largest recorded value
+            return qMin(qint64(bucketUpperBound(bucket)) * 1000, max());
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<quint64>& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketFor(quint64 usecs)
+{
+    if (usecs < EXACT_BUCKETS) {
+        return int(usecs);
+    }
+
+    if (usecs >> 32) {
+        return BUCKET_COUNT - 1;  // Over an hour; clamped
+    }
+
+    const int exponent = int(std::bit_width(usecs)) - 1;
+    const int sub = int(usecs >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return EXACT_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub;
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < EXACT_BUCKETS) {
+        return quint64(bucket);
+    }
+
+    const int exponent = 4 + (bucket - EXACT_BUCKETS) / SUB_BUCKETS;
+    const int sub = (bucket - EXACT_BUCKETS) % SUB_BUCKETS;
+    return (quint64(SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1;
+}
+
+// LatencyTrace
+
+void LatencyTrace::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+    instance().m_sequence.invalidate();
+}
+
+const LatencyHistogram& LatencyTrace::histogram(Stage stage)
+{
+    return instance().m_histograms[stage];
+}
+
+QString LatencyTrace::report()
+{
+    QStringList lines;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        const LatencyHistogram& histogram = instance().m_histograms[stage];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        lines.append(QString("%1: n=%2 p50=%3us p99=%4us max=%5us")
+                         .arg(QLatin1String(stageName(Stage(stage))), -14)
+                         .arg(histogram.count())
+                         .arg(histogram.percentile(50) / 1000)
+                         .arg(histogram.percentile(99) / 1000)
+                         .arg(histogram.max() / 1000));
+    }
+    if (lines.isEmpty()) {
+        return QStringLiteral("No latencies recorded");
+    }
+    return lines.join('\n');
+}
+
+void LatencyTrace::reset()
+{
+    LatencyTrace& trace = instance();
+    trace.m_sequence.invalidate();
+    for (LatencyHistogram& histogram : trace.m_histograms) {
+        histogram.reset();
+    }
+}
+
+const char* LatencyTrace::stageName(Stage stage)
+{
+    switch (stage) {
+        case HotkeyPressed: return "hotkey";
+        case ShowRequested: return "show-request";
+        case HistorySet: return "set-history";
+        case WindowShown: return "show-event";
+        case FirstPaint: return "first-paint";
+        default: return "unknown";
+    }
+}
+
+LatencyTrace& LatencyTrace::instance()
+{
+    static LatencyTrace trace;
+    return trace;
+}
+
+void LatencyTrace::record(Stage stage)
+{
+    // A hotkey press always starts over; a show request only starts a
+    // sequence when there is none, so later stages need an open one
+    if (stage == HotkeyPressed || (stage == ShowRequested && !m_sequence.isValid())) {
+        m_sequence.start();
+        m_reached.fill(false);
+    } else if (!m_sequence.isValid() || m_reached[stage]) {
+        return;
+    }
+
+    m_reached[stage] = true;
+    m_histograms[stage].record(m_sequence.nsecsElapsed());
+    if (stage == FirstPaint) {
+        m_sequence.invalidate();
+    }
+}
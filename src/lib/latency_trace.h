@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <array>
+#include <atomic>
+
+/**
+ * LatencyHistogram - Fixed-size histogram of durations
+ *
+ * Durations are bucketed in microseconds with eight buckets per power of
+ * two, so percentiles are accurate to within 12.5% at any scale while
+ * recording stays a handful of integer operations with no allocation.
+ *
+ * Recording is lock-free, so any thread may record while another reads;
+ * a concurrent reader may see a duration in count() before its bucket.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * Record a duration
+     * @param nsecs Duration in nanoseconds; negative values count as zero
+     */
+    void record(qint64 nsecs);
+
+    /**
+     * Get a percentile of the recorded durations
+     * @param percentile Percentile between 0 and 100
+     * @return Upper bound of the bucket holding it in nanoseconds, 0 if empty
+     */
+    qint64 percentile(double percentile) const;
+
+    // Histogram state
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 max() const { return m_max.load(std::memory_order_relaxed); }
+    void reset();
+
+private:
+    static constexpr int EXACT_BUCKETS = 16;   // 0..15 us are counted exactly
+    static constexpr int SUB_BUCKETS = 8;      // Buckets per power of two above that
+    static constexpr int BUCKET_COUNT = EXACT_BUCKETS + (32 - 4) * SUB_BUCKETS;
+
+    static int bucketFor(quint64 usecs);
+    static quint64 bucketUpperBound(int bucket);
+
+    std::array<std::atomic<quint64>, BUCKET_COUNT> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<qint64> m_max{0};
+};
+
+/**
+ * LatencyTrace - Hotkey-to-paint latency tracing
+ *
+ * Each hotkey press starts a sequence; every later stage records its
+ * offset from that press once, and the first paint of the popup ends the
+ * sequence. A popup shown without the hotkey (e.g. from the tray) starts
+ * its sequence when it is requested. Offsets are aggregated per stage in
+ * LatencyHistogram instances and reported as p50/p99.
+ *
+ * Tracing is disabled by default; a disabled mark() is a single inline
+ * test of a flag. All marks come from the GUI thread, so the trace is
+ * not synchronized.
+ */
+class LatencyTrace
+{
+public:
+    enum Stage {
+        HotkeyPressed,      // GlobalHotkey received the key press
+        ShowRequested,      // ClipboardWindow::showAt*
+        HistorySet,         // ClipboardWindow::setHistory
+        WindowShown,        // ClipboardWindow::showEvent
+        FirstPaint,         // First paint of the popup
+        StageCount
+    };
+
+    /**
+     * Enable or disable tracing
+     * @param enabled true to record marks; disabling drops the open sequence
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled; }
+
+    /**
+     * Mark that a stage was reached
+     * @param stage Stage reached now
+     */
+    static void mark(Stage stage)
+    {
+        if (s_enabled) {
+            instance().record(stage);
+        }
+    }
+
+    /**
+     * Get the histogram of a stage
+     * @param stage Traced stage
+     * @return Offsets of the stage from the start of its sequences
+     */
+    static const LatencyHistogram& histogram(Stage stage);
+
+    /**
+     * Format the p50/p99/max of every stage reached so far
+     * @return One line per stage, in microseconds
+     */
+    static QString report();
+
+    /**
+     * Clear all recorded latencies
+     */
+    static void reset();
+
+    /**
+     * Get the name of a stage
+     */
+    static const char* stageName(Stage stage);
+
+private:
+    static LatencyTrace& instance();
+    void record(Stage stage);
+
+    static bool s_enabled;
+
+    QElapsedTimer m_sequence;                ///< Started by the first stage of a sequence
+    std::array<bool, StageCount> m_reached{}; ///< Stages recorded in the open sequence
+    std::array<LatencyHistogram, StageCount> m_histograms;
+};
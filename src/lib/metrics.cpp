@@ -0,0 +1,61 @@
+#include "metrics.h"
+#include <QStringList>
+
+std::array<std::atomic<quint64>, Metrics::CounterCount> Metrics::s_counters{};
+std::array<LatencyHistogram, Metrics::TimingCount> Metrics::s_timings;
+
+QString Metrics::report()
+{
+    QStringList lines;
+    for (int counter = 0; counter < CounterCount; ++counter) {
+        lines.append(QString("%1 %2").arg(QLatin1String(counterName(Counter(counter))))
+                                     .arg(value(Counter(counter))));
+    }
+
+    for (int timing = 0; timing < TimingCount; ++timing) {
+        const QLatin1String name(timingName(Timing(timing)));
+        const LatencyHistogram& histogram = s_timings[timing];
+        lines.append(QString("%1_count %2").arg(name).arg(histogram.count()));
+        lines.append(QString("%1_p50_us %2").arg(name).arg(histogram.percentile(50) / 1000));
+        lines.append(QString("%1_p90_us %2").arg(name).arg(histogram.percentile(90) / 1000));
+        lines.append(QString("%1_p99_us %2").arg(name).arg(histogram.percentile(99) / 1000));
+        lines.append(QString("%1_max_us %2").arg(name).arg(histogram.max() / 1000));
+    }
+    return lines.join('\n') + '\n';
+}
+
+void Metrics::reset()
+{
+    for (std::atomic<quint64>& counter : s_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (LatencyHistogram& histogram : s_timings) {
+        histogram.reset();
+    }
+}
+
+const char* Metrics::counterName(Counter counter)
+{
+    switch (counter) {
+        case EventsCaptured: return "events_captured";
+        case DuplicateHits: return "duplicate_hits";
+        case Evictions: return "evictions";
+        case Saves: return "saves";
+        case SaveFailures: return "save_failures";
+        case SavedBytes: return "saved_bytes";
+        case ContentFiltered: return "content_filtered";
+        default: return "unknown";
+    }
+}
+
+const char* Metrics::timingName(Timing timing)
+{
+    switch (timing) {
+        case CaptureLatency: return "capture_latency";
+        case SaveLatency: return "save_latency";
+        case LoadTime: return "load_time";
+        case SearchLatency: return "search_latency";
+        case PopupShowLatency: return "popup_show_latency";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include "latency_trace.h"
+
+/**
+ * Metrics - Process-wide registry of runtime counters and latencies
+ *
+ * Counters are relaxed atomics and durations go into LatencyHistogram
+ * instances, so recording is lock-free and cheap enough to stay enabled
+ * on every path, including the persistence thread. The registry is
+ * fixed: each metric is an enum value with a stable name used in reports.
+ *
+ * report() formats everything as "name value" lines, one metric per line,
+ * for the --metrics client command, the IPC Metrics request and the
+ * About dialog alike.
+ */
+class Metrics
+{
+public:
+    enum Counter {
+        EventsCaptured,     // Clipboard contents read after a change
+        DuplicateHits,      // Copies that refreshed an existing item
+        Evictions,          // Items dropped by the size limit or retention
+        Saves,              // Snapshots written
+        SaveFailures,       // Snapshots that could not be written
+        SavedBytes,         // Bytes of all snapshots written
+        ContentFiltered,    // Captures rejected by the content classifier
+        CounterCount
+    };
+
+    enum Timing {
+        CaptureLatency,     // Processing of one captured clipboard content
+        SaveLatency,        // Writing one snapshot
+        LoadTime,           // Loading the persisted history
+        SearchLatency,      // One search over the history
+        PopupShowLatency,   // Popup show request to first paint
+        TimingCount
+    };
+
+    /**
+     * Add to a counter
+     * @param counter Counter to increase
+     * @param amount Amount to add
+     */
+    static void add(Counter counter, quint64 amount = 1)
+    {
+        s_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * Record a duration
+     * @param timing Histogram to record into
+     * @param nsecs Duration in nanoseconds
+     */
+    static void record(Timing timing, qint64 nsecs) { s_timings[timing].record(nsecs); }
+
+    // Current values
+    static quint64 value(Counter counter) { return s_counters[counter].load(std::memory_order_relaxed); }
+    static const LatencyHistogram& histogram(Timing timing) { return s_timings[timing]; }
+
+    /**
+     * Format all metrics, one "name value" line each
+     * @return Counters, then count/p50/p90/p99/max of every histogram in microseconds
+     */
+    static QString report();
+
+    /**
+     * Clear all counters and histograms
+     */
+    static void reset();
+
+    // Metric names used in reports
+    static const char* counterName(Counter counter);
+    static const char* timingName(Timing timing);
+
+private:
+    static std::array<std::atomic<quint64>, CounterCount> s_counters;
+    static std::array<LatencyHistogram, TimingCount> s_timings;
+};
@@ -7,6 +7,8 @@
 #include <QDebug>
 #include <QMessageBox>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QTextStream>
 #include <memory>
 
 // Include our components
@@ -15,14 +17,24 @@
 #include "ui/tray_icon.h"
 #include "ui/settings_dialog.h"
 #include "ui/about_dialog.h"
+#include "ui/preview_cache.h"
 #include "models/configuration.h"
 #include "lib/global_hotkey.h"
+#include "lib/footprint_profile.h"
+#include "lib/latency_trace.h"
+#include "cli/argument_parser.h"
+#include "cli/ipc_client.h"
+#include "services/ipc_server.h"
 
 /**
  * @brief Main application class for Clipboard History Manager
  * 
  * Handles application lifecycle, component initialization, and coordination
  * between ClipboardManager, ClipboardWindow, and TrayIcon.
+ *
+ * Startup is staged so the tray icon and the hotkey are live first: the
+ * history is decoded in the background, and the popup is built and
+ * pre-warmed once it has loaded, or on first use if that comes earlier.
  */
 class ClipboardHistoryApp
 {
@@ -39,6 +51,13 @@ public:
     int run(int argc, char* argv[]);
     
 private:
+    /**
+     * @brief Send a client command to the running instance and print the result
+     * @param app Core application; no GUI is created in client mode
+     * @return Exit code (0 = success, 1 = error, 2 = no running instance)
+     */
+    int runClient(QCoreApplication& app);
+    
     /**
      * @brief Parse command line arguments
      * @param app QApplication instance
@@ -63,6 +82,33 @@ private:
      */
     void connectComponents();
     
+    /**
+     * @brief Get the popup window, creating and connecting it on first use
+     */
+    ClipboardWindow* clipboardWindow();
+    
+    /**
+     * @brief Finish startup once the history has been loaded
+     * @param success true if stored history was found
+     */
+    void onHistoryLoaded(bool success);
+    
+    /**
+     * @brief Record the time from process start to a startup stage
+     * @param stage Name of the stage that just completed
+     */
+    void markStartup(const QString& stage);
+    
+    /**
+     * @brief Print the recorded startup stages (verbose or --trace-latency)
+     */
+    void reportStartup() const;
+    
+    /**
+     * @brief Collect the heap of each subsystem and write the --profile-footprint report
+     */
+    void writeFootprintReport();
+    
     /**
      * @brief Check system requirements and capabilities
      * @return true if system is compatible
@@ -87,6 +133,8 @@ private:
     std::unique_ptr<TrayIcon> m_trayIcon;
     std::unique_ptr<Configuration> m_configuration;
     std::unique_ptr<GlobalHotkey> m_globalHotkey;
+    std::unique_ptr<IpcServer> m_ipcServer;
+    std::unique_ptr<FootprintProfile> m_footprint;
     
     // Command line options
     QCommandLineParser m_parser;
@@ -94,16 +142,32 @@ private:
     int m_historyLimit = -1;
     bool m_verbose = false;
     bool m_noTray = false;
+    ClipboardWindow::RenderMode m_renderMode = ClipboardWindow::Glass;
+    bool m_traceLatency = false;
+    QString m_recordTracePath;
+    QString m_profileFootprintPath;
     QString m_customHotkey;
     bool m_testMode = false;
     
     // Application state
     bool m_componentsInitialized = false;
+    
+    // Startup timing
+    QElapsedTimer m_startupTimer;
+    QList<QPair<QString, qint64>> m_startupStages;
 };
 
 int ClipboardHistoryApp::run(int argc, char* argv[])
 {
+    // Commands for a running instance need neither a GUI nor the history
+    if (ArgumentParser::isClientInvocation(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return runClient(app);
+    }
+    
+    m_startupTimer.start();
     QApplication app(argc, argv);
+    markStartup("application");
     
     // Set application metadata
     app.setApplicationName("Clipboard History Manager");
@@ -132,6 +196,17 @@ int ClipboardHistoryApp::run(int argc, char* argv[])
         return runSystemTests() ? 0 : 1;
     }
     
+    // A second launch only brings up the window of the running instance
+    IpcClient instance;
+    if (instance.connectToServer(IpcProtocol::defaultServerName(), 100)) {
+        IpcProtocol::Request show;
+        show.command = IpcProtocol::Command::Show;
+        IpcProtocol::Response response;
+        instance.send(show, response);
+        qInfo() << "Clipboard History Manager is already running";
+        return 0;
+    }
+    
     // Initialize core components
     if (!initializeComponents()) {
         qCritical() << "Failed to initialize components";
@@ -140,6 +215,7 @@ int ClipboardHistoryApp::run(int argc, char* argv[])
     
     // Connect component signals
     connectComponents();
+    markStartup("event loop");
     
     if (m_verbose) {
         qDebug() << "Clipboard History Manager started successfully";
@@ -153,7 +229,55 @@ int ClipboardHistoryApp::run(int argc, char* argv[])
     app.setQuitOnLastWindowClosed(false);
     
     // Start the event loop
-    return app.exec();
+    int result = app.exec();
+    
+    // Settings applied just before exit may still be waiting for their write
+    if (!m_configuration->flush()) {
+        qWarning() << "Failed to save configuration to" << m_configuration->configPath();
+    }
+    
+    if (m_traceLatency) {
+        qInfo().noquote() << "Hotkey-to-paint latency:\n" + LatencyTrace::report();
+    }
+    if (m_footprint) {
+        writeFootprintReport();
+    }
+    return result;
+}
+
+int ClipboardHistoryApp::runClient(QCoreApplication& app)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    
+    ArgumentParser parser;
+    if (!parser.parse(app.arguments())) {
+        err << parser.getErrorString() << Qt::endl;
+        return 1;
+    }
+    
+    IpcClient client;
+    if (!client.connectToServer()) {
+        err << "Clipboard History Manager is not running (" << client.errorString() << ")" << Qt::endl;
+        return 2;
+    }
+    
+    IpcProtocol::Response response;
+    if (!client.send(parser.getClientRequest(), response)) {
+        err << client.errorString() << Qt::endl;
+        return 1;
+    }
+    if (response.status != IpcProtocol::Status::Ok) {
+        err << response.message << Qt::endl;
+        return 1;
+    }
+    
+    // One tab-separated line per item: ID, pin marker, preview
+    for (const IpcProtocol::Entry& entry : response.entries) {
+        out << entry.id << '\t' << (entry.pinned ? '*' : '-') << '\t' << entry.preview << '\n';
+    }
+    out << response.text;
+    return 0;
 }
 
 bool ClipboardHistoryApp::parseCommandLine(QApplication& app)
@@ -168,7 +292,7 @@ bool ClipboardHistoryApp::parseCommandLine(QApplication& app)
     m_parser.addOption(configPathOption);
     
     QCommandLineOption historyLimitOption({"l", "history-limit"}, 
-        "Set maximum number of history items (10-100)", "count");
+        "Set maximum number of history items (10-100000)", "count");
     m_parser.addOption(historyLimitOption);
     
     QCommandLineOption hotkeyOption({"k", "hotkey"}, 
@@ -184,6 +308,23 @@ bool ClipboardHistoryApp::parseCommandLine(QApplication& app)
         "Disable system tray icon");
     m_parser.addOption(noTrayOption);
     
+    QCommandLineOption renderModeOption("render-mode", 
+        "Popup rendering: auto, glass or low-power (default: auto)", "mode", "auto");
+    m_parser.addOption(renderModeOption);
+    
+    // Diagnostics options
+    QCommandLineOption traceLatencyOption("trace-latency", 
+        "Record hotkey-to-paint latencies and print them on exit");
+    m_parser.addOption(traceLatencyOption);
+    
+    QCommandLineOption recordTraceOption("record-trace", 
+        "Record an anonymized trace of clipboard captures to a file", "file");
+    m_parser.addOption(recordTraceOption);
+    
+    QCommandLineOption profileFootprintOption("profile-footprint", 
+        "Profile startup, memory and timer wakeups and write a report to a file on exit", "file");
+    m_parser.addOption(profileFootprintOption);
+    
     // Test options
     QCommandLineOption verifyClipboardOption("verify-clipboard", 
         "Test clipboard access and exit");
@@ -212,8 +353,9 @@ bool ClipboardHistoryApp::parseCommandLine(QApplication& app)
     if (m_parser.isSet(historyLimitOption)) {
         bool ok;
         m_historyLimit = m_parser.value(historyLimitOption).toInt(&ok);
-        if (!ok || m_historyLimit < 10 || m_historyLimit > 100) {
-            qCritical() << "Invalid history limit. Must be between 10 and 100.";
+        if (!ok || !Configuration::isValidMaxHistoryItems(m_historyLimit)) {
+            qCritical() << "Invalid history limit. Must be between"
+                        << Configuration::minHistoryLimit() << "and" << Configuration::maxHistoryLimit();
             return false;
         }
     }
@@ -225,6 +367,24 @@ bool ClipboardHistoryApp::parseCommandLine(QApplication& app)
     m_verbose = m_parser.isSet(verboseOption);
     m_noTray = m_parser.isSet(noTrayOption);
     
+    bool renderModeOk = false;
+    m_renderMode = ClipboardWindow::renderModeFromName(m_parser.value(renderModeOption), &renderModeOk);
+    if (!renderModeOk) {
+        qCritical() << "Invalid render mode. Must be auto, glass or low-power";
+        return false;
+    }
+    
+    m_traceLatency = m_parser.isSet(traceLatencyOption);
+    LatencyTrace::setEnabled(m_traceLatency);
+    m_recordTracePath = m_parser.value(recordTraceOption);
+    
+    // Wakeups are counted from here on, so startup timers are included
+    m_profileFootprintPath = m_parser.value(profileFootprintOption);
+    if (!m_profileFootprintPath.isEmpty()) {
+        m_footprint = std::make_unique<FootprintProfile>();
+        m_footprint->start();
+    }
+    
     // Check for test modes
     m_testMode = m_parser.isSet(verifyClipboardOption) || 
                 m_parser.isSet(testHotkeyOption) || 
@@ -261,6 +421,7 @@ bool ClipboardHistoryApp::initializeConfiguration()
     }
     
     // Apply command line overrides
+    m_configuration->beginUpdate();
     if (m_historyLimit > 0) {
         m_configuration->setMaxHistoryItems(m_historyLimit);
     }
@@ -268,11 +429,11 @@ bool ClipboardHistoryApp::initializeConfiguration()
     if (!m_customHotkey.isEmpty()) {
         m_configuration->setHotkey(m_customHotkey);
     }
+    m_configuration->commitUpdate();
     
-    // Save configuration with any updates
-    if (!m_configuration->save()) {
-        qWarning() << "Failed to save configuration to" << configFile;
-    }
+    // Save configuration with any updates off the GUI thread; an unchanged
+    // file is left alone
+    m_configuration->scheduleSave();
     
     return true;
 }
@@ -280,20 +441,13 @@ bool ClipboardHistoryApp::initializeConfiguration()
 bool ClipboardHistoryApp::initializeComponents()
 {
     try {
-        // Create ClipboardManager
-        m_clipboardManager = std::make_unique<ClipboardManager>();
-        m_clipboardManager->setMaxHistoryItems(m_configuration->maxHistoryItems());
-        
-        // Load history (ClipboardManager handles the file path internally)
-        m_clipboardManager->loadHistory();
-        
-        // Create ClipboardWindow
-        m_clipboardWindow = std::make_unique<ClipboardWindow>();
-        
-        // Create TrayIcon if system tray is available and not disabled
+        // The tray icon and the hotkey come first; they are what the user sees
+        // and presses while the rest starts
         if (!m_noTray && QSystemTrayIcon::isSystemTrayAvailable()) {
             m_trayIcon = std::make_unique<TrayIcon>();
+            m_trayIcon->setLoading(true);
             m_trayIcon->show();
+            markStartup("tray icon");
         } else if (!m_noTray) {
             qWarning() << "System tray not available, running without tray icon";
         }
@@ -310,6 +464,24 @@ bool ClipboardHistoryApp::initializeComponents()
         } else {
             qDebug() << "Successfully registered global hotkey:" << hotkeyString;
         }
+        markStartup("hotkey");
+        
+        // Create ClipboardManager; the history is decoded on the thread pool
+        m_clipboardManager = std::make_unique<ClipboardManager>(ClipboardManager::LoadMode::Background);
+        m_clipboardManager->setMaxHistoryItems(m_configuration->maxHistoryItems());
+        if (!m_recordTracePath.isEmpty()) {
+            m_clipboardManager->startTraceRecording(m_recordTracePath);
+        }
+        markStartup("history load started");
+        
+        // Serve the history to command-line clients
+        m_ipcServer = std::make_unique<IpcServer>(m_clipboardManager.get());
+        if (!m_ipcServer->listen()) {
+            qWarning() << "Command-line clients will not be able to reach this instance";
+        } else if (m_verbose) {
+            qDebug() << "Listening for clients on" << m_ipcServer->serverName();
+        }
+        markStartup("ipc server");
         
         m_componentsInitialized = true;
         return true;
@@ -326,27 +498,17 @@ void ClipboardHistoryApp::connectComponents()
         return;
     }
     
-    // Connect ClipboardManager to ClipboardWindow
-    // When history changes, update the window display
-    QObject::connect(m_clipboardManager.get(), &ClipboardManager::historyChanged,
-                     [this]() {
-                         m_clipboardWindow->setHistory(m_clipboardManager->getHistory());
-                     });
-    
-    // When an item is added, update the window
-    QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemAdded,
-                     [this](const ClipboardItem& item) {
-                         m_clipboardWindow->updateItem(item);
+    // The popup window is connected when it is created, see clipboardWindow()
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::historyLoaded,
+                     [this](bool success) {
+                         onHistoryLoaded(success);
                      });
     
-    // When user selects an item in the window, it gets copied to clipboard automatically
-    QObject::connect(m_clipboardWindow.get(), &ClipboardWindow::itemSelected,
-                     [this](const ClipboardItem& item) {
-                         // The ClipboardManager will detect this clipboard change and handle it
-                         QClipboard* clipboard = QApplication::clipboard();
-                         clipboard->setText(item.text());
-                         m_clipboardWindow->hideWindow();
-                     });
+    // Wakeups after the last capture show whether the process idles with the clipboard
+    if (m_footprint) {
+        QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemAdded,
+                         m_footprint.get(), &FootprintProfile::markActivity);
+    }
     
     // Connect TrayIcon if available
     if (m_trayIcon) {
@@ -354,7 +516,7 @@ void ClipboardHistoryApp::connectComponents()
         QObject::connect(m_trayIcon.get(), &TrayIcon::historyWindowRequested,
                          [this]() {
                              // Show at center when invoked from tray icon
-                             m_clipboardWindow->showAtCenter();
+                             clipboardWindow()->showAtCenter();
                          });
         
         // Toggle monitoring (for now, just emit a debug message)
@@ -418,7 +580,7 @@ void ClipboardHistoryApp::connectComponents()
                              // Get current clipboard count
                              int clipboardCount = 0;
                              if (m_clipboardManager) {
-                                 clipboardCount = m_clipboardManager->getHistory().size();
+                                 clipboardCount = m_clipboardManager->historyCount();
                              }
                              
                              // Create and show about dialog with proper modal behavior
@@ -428,20 +590,41 @@ void ClipboardHistoryApp::connectComponents()
                              aboutDialog->show();
                          });
         
-        // Update tray with current history
-        QObject::connect(m_clipboardManager.get(), &ClipboardManager::historyChanged,
+        // Update tray with current history; only changes near the top touch the menu
+        QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemInsertedAt,
+                         [this](int index) {
+                             m_trayIcon->applyHistoryChange(index, m_clipboardManager->historyView(),
+                                                            m_clipboardManager->historyCount());
+                         });
+        QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemRemovedAt,
+                         [this](int index) {
+                             m_trayIcon->applyHistoryChange(index, m_clipboardManager->historyView(),
+                                                            m_clipboardManager->historyCount());
+                         });
+        QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemMoved,
+                         [this](int from, int to) {
+                             m_trayIcon->applyHistoryChange(qMin(from, to), m_clipboardManager->historyView(),
+                                                            m_clipboardManager->historyCount());
+                         });
+        QObject::connect(m_clipboardManager.get(), &ClipboardManager::historyReset,
                          [this]() {
-                             m_trayIcon->updateRecentItems(m_clipboardManager->getHistory());
+                             m_trayIcon->updateRecentItems(m_clipboardManager->historyView());
+                             m_trayIcon->setHistoryCount(m_clipboardManager->historyCount());
                          });
         
         // Handle recent item selection from tray
         QObject::connect(m_trayIcon.get(), &TrayIcon::recentItemSelected,
                          [this](const ClipboardItem& item) {
-                             QClipboard* clipboard = QApplication::clipboard();
-                             clipboard->setText(item.text());
+                             m_clipboardManager->copyToClipboard(item);
                          });
     }
     
+    // Clients (e.g. compositor keybindings) can ask for the window
+    QObject::connect(m_ipcServer.get(), &IpcServer::showRequested,
+                     [this]() {
+                         clipboardWindow()->showAtCursor();
+                     });
+    
     // Connect GlobalHotkey if available
     if (m_globalHotkey && m_globalHotkey->isRegistered()) {
         QObject::connect(m_globalHotkey.get(), &GlobalHotkey::hotkeyTriggered,
@@ -449,7 +632,11 @@ void ClipboardHistoryApp::connectComponents()
                              if (m_verbose) {
                                  qDebug() << "Global hotkey triggered - showing clipboard window";
                              }
-                             m_clipboardWindow->showAtCursor();
+                             clipboardWindow()->showAtCursor();
+                             if (m_verbose) {
+                                 qDebug() << "Hotkey to popup:"
+                                          << m_globalHotkey->nsecsSinceTrigger() / 1000 << "us";
+                             }
                          });
         
         if (m_verbose) {
@@ -457,13 +644,119 @@ void ClipboardHistoryApp::connectComponents()
         }
     }
     
-    // Start clipboard monitoring
+    // Start clipboard monitoring; the manager holds it back until the history is loaded
     m_clipboardManager->startMonitoring();
     
-    // Initial setup: populate tray with current history
+    // A load that did not need the thread pool has already finished
+    if (!m_clipboardManager->isLoadingHistory()) {
+        onHistoryLoaded(m_clipboardManager->historyCount() > 0);
+    }
+}
+
+ClipboardWindow* ClipboardHistoryApp::clipboardWindow()
+{
+    if (m_clipboardWindow) {
+        return m_clipboardWindow.get();
+    }
+    
+    m_clipboardWindow = std::make_unique<ClipboardWindow>(m_renderMode);
+    ClipboardWindow* window = m_clipboardWindow.get();
+    
+    // Apply each history change to the window display, reloading only on resets
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemInsertedAt,
+                     window, &ClipboardWindow::insertItemAt);
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemRemovedAt,
+                     window, [window](int index) {
+                         window->removeItemAt(index);
+                     });
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemMoved,
+                     window, &ClipboardWindow::moveItem);
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::historyReset,
+                     window, [this, window]() {
+                         window->setHistory(m_clipboardManager->historyView());
+                     });
+    
+    // When an item is added, update the window
+    QObject::connect(m_clipboardManager.get(), &ClipboardManager::itemAdded,
+                     window, [window](const ClipboardItem& item) {
+                         window->updateItem(item);
+                     });
+    
+    // Searches also reach the items demoted to the cold tier
+    window->setColdSearch([this](const QString& query, int limit) {
+        return m_clipboardManager->findColdItems(query, limit);
+    });
+    
+    // When user selects an item in the window, it gets copied to clipboard automatically
+    QObject::connect(window, &ClipboardWindow::itemSelected,
+                     [this, window](const ClipboardItem& item) {
+                         // The ClipboardManager will detect this clipboard change and handle it
+                         m_clipboardManager->copyToClipboard(item);
+                         window->hideWindow();
+                     });
+    
+    window->setHistory(m_clipboardManager->historyView());
+    markStartup("popup window");
+    return window;
+}
+
+void ClipboardHistoryApp::onHistoryLoaded(bool success)
+{
+    markStartup(success ? "history loaded" : "history loaded (empty)");
+    if (m_verbose) {
+        const ClipboardHistory::MemoryUsage memory = m_clipboardManager->memoryUsage();
+        qDebug() << "History loaded:" << memory.hotItems << "items in memory," << memory.coldEntries
+                 << "on disk;" << memory.totalBytes() / 1024 << "KiB," << memory.bytesPerItem()
+                 << "bytes per item";
+    }
+    
     if (m_trayIcon) {
-        m_trayIcon->updateRecentItems(m_clipboardManager->getHistory());
-        m_trayIcon->setHistoryCount(m_clipboardManager->getHistory().size());
+        m_trayIcon->setLoading(false);
+        m_trayIcon->setHistoryCount(m_clipboardManager->historyCount());
+    }
+    
+    // Pay for styling and the first render once the loop is idle rather than
+    // on the first hotkey press
+    QTimer::singleShot(0, QApplication::instance(), [this]() {
+        ClipboardWindow* window = clipboardWindow();
+        if (!window->isPrewarmed()) {
+            window->prewarm();
+            markStartup("popup prewarmed");
+        }
+        reportStartup();
+    });
+}
+
+void ClipboardHistoryApp::markStartup(const QString& stage)
+{
+    m_startupStages.append({stage, m_startupTimer.elapsed()});
+}
+
+void ClipboardHistoryApp::reportStartup() const
+{
+    if (m_verbose || m_traceLatency) {
+        QStringList lines;
+        for (const auto& [stage, msecs] : m_startupStages) {
+            lines.append(QString("%1: %2 ms").arg(stage).arg(msecs));
+        }
+        qInfo().noquote() << "Startup timeline:\n  " + lines.join("\n  ");
+    }
+}
+
+void ClipboardHistoryApp::writeFootprintReport()
+{
+    for (const auto& [stage, msecs] : m_startupStages) {
+        m_footprint->addPhase(stage, msecs);
+    }
+    
+    // Components that were never created hold nothing
+    m_footprint->setHeapUsage("history", m_clipboardManager ? m_clipboardManager->memoryUsage().totalBytes() : 0);
+    m_footprint->setHeapUsage("previews", PreviewCache::shared().memoryUsage());
+    m_footprint->setHeapUsage("ui", m_clipboardWindow ? m_clipboardWindow->memoryUsage() : 0);
+    m_footprint->setHeapUsage("tray menu", m_trayIcon ? m_trayIcon->memoryUsage() : 0);
+    
+    if (m_footprint->writeReport(m_profileFootprintPath)) {
+        qInfo() << "Footprint report written to" << m_profileFootprintPath;
     }
 }
 
@@ -0,0 +1,153 @@
+#include "blob_store.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+struct BlobStore::Blob::Mapping {
+    ~Mapping()
+    {
+        if (data) {
+            file.unmap(data);
+        }
+    }
+
+    QFile file;
+    uchar* data = nullptr;
+    qint64 size = 0;
+};
+
+qint64 BlobStore::Blob::size() const
+{
+    return m_mapping ? m_mapping->size : 0;
+}
+
+QByteArray BlobStore::Blob::bytes() const
+{
+    if (!m_mapping) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_mapping->data),
+                                   qsizetype(m_mapping->size));
+}
+
+BlobStore::BlobStore(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+QString BlobStore::put(const QByteArray& data)
+{
+    if (data.isEmpty()) {
+        return QString();
+    }
+
+    const QString key = keyFor(data);
+    const QString path = filePath(key);
+    if (QFileInfo(path).size() == data.size()) {
+        return key; // Already stored
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot create clipboard blob" << path << file.errorString();
+        return QString();
+    }
+    if (file.write(data) != data.size()) {
+        qWarning() << "Failed to write clipboard blob" << path << file.errorString();
+        file.cancelWriting();
+        return QString();
+    }
+    if (!file.commit()) {
+        qWarning() << "Failed to commit clipboard blob" << path << file.errorString();
+        return QString();
+    }
+    return key;
+}
+
+BlobStore::Blob BlobStore::open(const QString& key) const
+{
+    Blob blob;
+    const QString path = filePath(key);
+    if (path.isEmpty()) {
+        return blob;
+    }
+
+    auto mapping = QSharedPointer<Blob::Mapping>::create();
+    mapping->file.setFileName(path);
+    if (!mapping->file.open(QIODevice::ReadOnly)) {
+        return blob;
+    }
+
+    mapping->size = mapping->file.size();
+    mapping->data = mapping->size > 0 ? mapping->file.map(0, mapping->size) : nullptr;
+    if (!mapping->data) {
+        qWarning() << "Cannot map clipboard blob" << path;
+        return blob;
+    }
+
+    blob.m_mapping = mapping;
+    return blob;
+}
+
+bool BlobStore::contains(const QString& key) const
+{
+    const QString path = filePath(key);
+    return !path.isEmpty() && QFileInfo::exists(path);
+}
+
+bool BlobStore::remove(const QString& key)
+{
+    const QString path = filePath(key);
+    return !path.isEmpty() && QFile::remove(path);
+}
+
+int BlobStore::collectGarbage(const QSet<QString>& liveKeys)
+{
+    int removed = 0;
+    QDirIterator it(m_directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString key = info.fileName();
+        // Leave anything that is not a blob alone, including unfinished writes
+        if (!isValidKey(key) || liveKeys.contains(key)) {
+            continue;
+        }
+        if (QFile::remove(info.filePath())) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+QString BlobStore::filePath(const QString& key) const
+{
+    if (!isValidKey(key)) {
+        return QString();
+    }
+    return m_directory + QLatin1Char('/') + key.left(FANOUT_LENGTH) + QLatin1Char('/') + key;
+}
+
+QString BlobStore::keyFor(const QByteArray& data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+bool BlobStore::isValidKey(const QString& key)
+{
+    if (key.size() != KEY_LENGTH) {
+        return false;
+    }
+    for (QChar c : key) {
+        if (!((c >= QLatin1Char('0') && c <= QLatin1Char('9')) ||
+              (c >= QLatin1Char('a') && c <= QLatin1Char('f')))) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+/**
+ * @brief Content-addressed on-disk store for clipboard payloads
+ *
+ * Each payload is written once, to a file named after the SHA-256 of its
+ * bytes under a two-character fan-out directory; storing the same bytes
+ * again only returns the existing key. Payloads are read back through a
+ * read-only memory mapping, so handing one to the clipboard copies
+ * nothing and memory use does not grow with payload size.
+ *
+ * Blobs are not reference counted. Whoever owns the references sweeps
+ * the store with collectGarbage() and the set of keys still in use.
+ */
+class BlobStore
+{
+public:
+    /**
+     * @brief Read-only mapping of a stored payload
+     *
+     * Copies share the mapping, which is released with the last copy.
+     */
+    class Blob
+    {
+    public:
+        Blob() = default;
+
+        bool isValid() const { return m_mapping != nullptr; }
+        qint64 size() const;
+
+        /**
+         * @brief Get the payload without copying it
+         * @return Bytes backed by the mapping; only valid while a copy of
+         *         this Blob is alive
+         */
+        QByteArray bytes() const;
+
+    private:
+        friend class BlobStore;
+        struct Mapping;
+
+        QSharedPointer<Mapping> m_mapping;
+    };
+
+    /**
+     * @brief Create a store rooted at directory
+     * @param directory Directory holding the blobs (created on first write)
+     */
+    explicit BlobStore(const QString& directory);
+
+    // Getters
+    const QString& directory() const { return m_directory; }
+
+    /**
+     * @brief Store a payload
+     * @param data Bytes to store
+     * @return Key of the payload, or an empty string if it is empty or
+     *         could not be written
+     */
+    QString put(const QByteArray& data);
+
+    /**
+     * @brief Map a stored payload
+     * @param key Payload key
+     * @return Mapping, invalid if the key is unknown or malformed
+     */
+    Blob open(const QString& key) const;
+
+    /**
+     * @brief Check if a payload is stored
+     */
+    bool contains(const QString& key) const;
+
+    /**
+     * @brief Delete a stored payload
+     * @return true if the payload existed and was deleted
+     */
+    bool remove(const QString& key);
+
+    /**
+     * @brief Delete every payload whose key is not in liveKeys
+     * @param liveKeys Keys still referenced
+     * @return Number of payloads deleted
+     */
+    int collectGarbage(const QSet<QString>& liveKeys);
+
+    /**
+     * @brief Get the path a payload is stored at
+     * @return Path, or an empty string for malformed keys
+     */
+    QString filePath(const QString& key) const;
+
+    /**
+     * @brief Compute the key bytes would be stored under
+     * @param data Payload bytes
+     * @return SHA-256 of data in lowercase hex
+     */
+    static QString keyFor(const QByteArray& data);
+
+    /**
+     * @brief Check that key names a blob and nothing else on disk
+     * @return true for 64 lowercase hex digits
+     */
+    static bool isValidKey(const QString& key);
+
+private:
+    static constexpr int KEY_LENGTH = 64;
+    static constexpr int FANOUT_LENGTH = 2;
+
+    QString m_directory;             ///< Root directory of the store
+};
@@ -4,52 +4,111 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include "history_snapshot.h"
+#include "text_matcher.h"
+#include "../lib/metrics.h"
 #include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr int DECODE_CHUNK_SIZE = 1024;
+
+/**
+ * @brief Decode count items, spreading chunks of them over the thread pool
+ * @param count Number of items
+ * @param decode Callable returning the item at an index; must be thread-safe
+ * @return Decoded items in index order
+ */
+template <typename Decode>
+QList<ClipboardItem> decodeItems(int count, Decode decode)
+{
+    QList<ClipboardItem> items(count);
+    ClipboardItem* out = items.data();
+    auto decodeChunk = [&](int start) {
+        const int end = qMin(start + DECODE_CHUNK_SIZE, count);
+        for (int i = start; i < end; ++i) {
+            out[i] = decode(i);
+        }
+    };
+    
+    if (count <= DECODE_CHUNK_SIZE) {
+        decodeChunk(0);
+        return items;
+    }
+    
+    // Each chunk writes its own slots, and the calling thread takes chunks too
+    QList<int> chunks;
+    chunks.reserve(count / DECODE_CHUNK_SIZE + 1);
+    for (int start = 0; start < count; start += DECODE_CHUNK_SIZE) {
+        chunks.append(start);
+    }
+    QtConcurrent::blockingMap(chunks, decodeChunk);
+    return items;
+}
+
+} // namespace
 
 ClipboardHistory::ClipboardHistory(QObject* parent)
     : QObject(parent)
     , m_maxItems(DEFAULT_MAX_ITEMS)
-    , m_pinnedCount(0)
 {
 }
 
 ClipboardHistory::ClipboardHistory(int maxItems, QObject* parent)
     : QObject(parent)
     , m_maxItems(qBound(MIN_MAX_ITEMS, maxItems, MAX_MAX_ITEMS))
-    , m_pinnedCount(0)
 {
 }
 
 ClipboardHistory::ClipboardHistory(const QJsonObject& json, QObject* parent)
     : QObject(parent)
     , m_maxItems(DEFAULT_MAX_ITEMS)
-    , m_pinnedCount(0)
 {
     fromJson(json);
 }
 
-QList<ClipboardItem> ClipboardHistory::pinnedItems() const
+QList<ClipboardItem> ClipboardHistory::items() const
 {
-    QList<ClipboardItem> pinned;
-    for (const auto& item : m_items) {
-        if (item.pinned()) {
-            pinned.append(item);
-        } else {
-            break; // Pinned items are always at the beginning
-        }
+    // Without pins the unpinned segment already is the display order
+    if (m_pinned.isEmpty()) {
+        return m_unpinned.items();
     }
-    return pinned;
+    
+    QList<ClipboardItem> ordered;
+    ordered.reserve(count());
+    ordered.append(m_pinned.items());
+    ordered.append(m_unpinned.items());
+    return ordered;
 }
 
-QList<ClipboardItem> ClipboardHistory::unpinnedItems() const
+HistoryView ClipboardHistory::view() const
 {
-    QList<ClipboardItem> unpinned;
-    for (const auto& item : m_items) {
-        if (!item.pinned()) {
-            unpinned.append(item);
-        }
+    return HistoryView(m_version, m_pinned.items(), m_unpinned.items());
+}
+
+void ClipboardHistory::publishSnapshot()
+{
+    m_publishPending = false;
+    if (m_published.version() != m_version) {
+        m_published.publish(view());
+    }
+}
+
+void ClipboardHistory::postItem(const QString& text)
+{
+    QMetaObject::invokeMethod(this, [this, text]() { addItem(text); }, Qt::QueuedConnection);
+}
+
+void ClipboardHistory::touch()
+{
+    ++m_version;
+    if (!m_publishPending) {
+        m_publishPending = true;
+        QMetaObject::invokeMethod(this, &ClipboardHistory::publishSnapshot, Qt::QueuedConnection);
     }
-    return unpinned;
 }
 
 void ClipboardHistory::setMaxItems(int maxItems)
@@ -61,10 +120,51 @@ void ClipboardHistory::setMaxItems(int maxItems)
     }
 }
 
+void ClipboardHistory::setHotItemLimit(int hotItemLimit)
+{
+    int newLimit = qMax(MIN_MAX_ITEMS, hotItemLimit);
+    if (newLimit != m_hotItemLimit) {
+        m_hotItemLimit = newLimit;
+        demoteColdItems();
+        promoteColdItems();
+    }
+}
+
+bool ClipboardHistory::attachColdStore(const QString& filePath)
+{
+    auto store = std::make_unique<ColdHistoryStore>(filePath);
+    if (!store->open()) {
+        return false;
+    }
+    
+    m_cold = std::move(store);
+    indexColdEntries();
+    enforceSizeLimit();
+    return true;
+}
+
 QString ClipboardHistory::addItem(const QString& text)
 {
-    ClipboardItem item(text);
-    return addItem(item);
+    if (!ClipboardItem::validateText(text)) {
+        return QString();
+    }
+    
+    // Key the content once and look it up before building anything
+    const quint64 contentKey = ClipboardItem::generateContentKey(text);
+    QString existingId = findDuplicateId(text, contentKey);
+    if (!existingId.isEmpty()) {
+        return refreshItem(existingId, text, contentKey);
+    }
+    
+    ClipboardItem item = ClipboardItem::fromFields(ClipboardItem::generateId(), text, QString(),
+                                                   QDateTime::currentMSecsSinceEpoch(),
+                                                   false, contentKey);
+    insertItem(item);
+    enforceSizeLimit();
+    
+    emit itemAdded(item);
+    notifyOrderChanged();
+    return item.id();
 }
 
 QString ClipboardHistory::addItem(const ClipboardItem& item)
@@ -73,170 +173,363 @@ QString ClipboardHistory::addItem(const ClipboardItem& item)
         return QString();
     }
 
-    // Check for duplicate by hash
-    auto existingIt = findItemByHash(item.hash());
-    if (existingIt != m_items.end()) {
-        // Update existing item timestamp and move to appropriate position
-        ClipboardItem updatedItem = *existingIt;
-        updatedItem = ClipboardItem(item.text()); // Create new with current timestamp
-        if (existingIt->pinned()) {
-            updatedItem.pin(); // Preserve pin state
-        }
-        
-        m_items.erase(existingIt);
-        m_items.append(updatedItem);
-        reorderItems();
-        
-        emit itemUpdated(updatedItem);
-        emit orderChanged();
-        return updatedItem.id();
+    // Check for duplicate content
+    QString existingId = findDuplicateId(item.text(), item.contentKey());
+    if (!existingId.isEmpty()) {
+        return refreshItem(existingId, item.text(), item.contentKey());
     }
 
     // Add new item
-    m_items.append(item);
-    reorderItems();
+    insertItem(item);
     enforceSizeLimit();
-    updatePinnedCount();
 
     emit itemAdded(item);
-    emit orderChanged();
+    notifyOrderChanged();
     return item.id();
 }
 
-bool ClipboardHistory::pinItem(const QString& id)
+QString ClipboardHistory::refreshItem(const QString& existingId, const QString& text,
+                                      quint64 contentKey)
 {
-    auto it = findItem(id);
-    if (it != m_items.end() && !it->pinned()) {
-        it->pin();
-        reorderItems();
-        updatePinnedCount();
-        
-        emit itemPinned(id);
+    Metrics::add(Metrics::DuplicateHits);
+    
+    // Replace existing item with a fresh copy at the top of its segment; the
+    // preview and payload describe the same content, so they are carried over
+    int from = hotIndexOf(existingId);
+    ClipboardItem existingItem = takeItem(existingId, false);
+    ClipboardItem updatedItem = ClipboardItem::fromFields(ClipboardItem::generateId(), text,
+                                                          existingItem.storedPreview(),
+                                                          QDateTime::currentMSecsSinceEpoch(),
+                                                          existingItem.pinned(), contentKey,
+                                                          QString(), existingItem.payload());
+    insertItem(updatedItem, false);
+    
+    int to = hotIndexOf(updatedItem.id());
+    if (from >= 0) {
+        emit itemMoved(from, to, updatedItem);
+    } else {
+        emit itemInsertedAt(to, updatedItem);
+    }
+    demoteColdItems();
+    
+    emit itemUpdated(updatedItem);
+    notifyOrderChanged();
+    return updatedItem.id();
+}
+
+void ClipboardHistory::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void ClipboardHistory::endUpdate()
+{
+    if (m_updateDepth == 0 || --m_updateDepth > 0) {
+        return;
+    }
+    if (m_orderChangePending) {
+        m_orderChangePending = false;
         emit orderChanged();
-        return true;
     }
-    return false;
+}
+
+void ClipboardHistory::restoreItem(const ClipboardItem& item)
+{
+    if (!item.isValid()) {
+        return;
+    }
+    
+    takeItem(item.id());
+    QString existingId = findDuplicateId(item.text(), item.contentKey());
+    if (!existingId.isEmpty()) {
+        takeItem(existingId);
+    }
+    
+    insertItem(item);
+    enforceSizeLimit();
+}
+
+bool ClipboardHistory::pinItem(const QString& id)
+{
+    ClipboardItem item;
+    int from = -1;
+    int position = m_unpinned.indexOf(id);
+    if (position >= 0) {
+        from = m_pinned.count() + position;
+        item = m_unpinned.takeAt(position);
+    } else {
+        // Pinned items are always hot, so bring a cold item back into memory
+        position = m_cold ? m_cold->indexOf(id) : -1;
+        if (position < 0) {
+            return false;
+        }
+        item = m_cold->load(position);
+        if (!item.isValid()) {
+            return false;
+        }
+        m_cold->removeAt(position);
+    }
+    
+    item.pin();
+    m_pinned.insert(item);
+    touch();
+    
+    int to = m_pinned.indexOf(id);
+    if (from >= 0) {
+        emit itemMoved(from, to, item);
+        promoteColdItems();
+    } else {
+        emit itemInsertedAt(to, item);
+    }
+    
+    emit itemPinned(id);
+    notifyOrderChanged();
+    return true;
 }
 
 bool ClipboardHistory::unpinItem(const QString& id)
 {
-    auto it = findItem(id);
-    if (it != m_items.end() && it->pinned()) {
-        it->unpin();
-        reorderItems();
-        updatePinnedCount();
-        
-        emit itemUnpinned(id);
-        emit orderChanged();
-        return true;
+    int position = m_pinned.indexOf(id);
+    if (position < 0) {
+        return false;
     }
-    return false;
+    
+    ClipboardItem item = m_pinned.takeAt(position);
+    item.unpin();
+    m_unpinned.insert(item);
+    touch();
+    emit itemMoved(position, m_pinned.count() + m_unpinned.indexOf(id), item);
+    demoteColdItems();
+    
+    emit itemUnpinned(id);
+    notifyOrderChanged();
+    return true;
 }
 
 bool ClipboardHistory::togglePinItem(const QString& id)
 {
-    auto it = findItem(id);
-    if (it != m_items.end()) {
-        if (it->pinned()) {
-            return unpinItem(id);
-        } else {
-            return pinItem(id);
-        }
+    if (m_pinned.contains(id)) {
+        return unpinItem(id);
+    }
+    if (m_unpinned.contains(id) || (m_cold && m_cold->contains(id))) {
+        return pinItem(id);
     }
     return false;
 }
 
 bool ClipboardHistory::removeItem(const QString& id)
 {
-    auto it = findItem(id);
-    if (it != m_items.end() && !it->pinned()) {
-        m_items.erase(it);
-        updatePinnedCount();
-        
-        emit itemRemoved(id);
-        emit orderChanged();
-        return true;
+    if (m_pinned.contains(id)) {
+        return false;
     }
-    return false;
+    
+    ClipboardItem item = takeItem(id);
+    if (item.id().isEmpty()) {
+        return false;
+    }
+    promoteColdItems();
+    
+    emit itemRemoved(id);
+    notifyOrderChanged();
+    return true;
 }
 
 void ClipboardHistory::clear()
 {
-    bool changed = false;
-    auto it = m_items.begin();
-    while (it != m_items.end()) {
-        if (!it->pinned()) {
-            QString removedId = it->id();
-            it = m_items.erase(it);
-            emit itemRemoved(removedId);
-            changed = true;
-        } else {
-            ++it;
+    if (m_unpinned.isEmpty() && coldCount() == 0) {
+        return;
+    }
+    
+    // Cold IDs are read from the arena without decoding the records
+    QStringList removedIds;
+    removedIds.reserve(m_unpinned.count() + coldCount());
+    for (const auto& item : m_unpinned.items()) {
+        removedIds.append(item.id());
+    }
+    m_unpinned.clear();
+    if (m_cold) {
+        for (int position = 0; position < m_cold->count(); ++position) {
+            removedIds.append(m_cold->idAt(position));
         }
+        m_cold->clear();
     }
     
-    if (changed) {
-        updatePinnedCount();
-        emit historyCleared();
-        emit orderChanged();
+    // Only the pinned items remain; index them afresh instead of unindexing the rest
+    m_hashIndex.clear();
+    for (const auto& item : m_pinned.items()) {
+        if (!m_hashIndex.contains(item.contentKey())) {
+            m_hashIndex.insert(item.contentKey(), item.id());
+        }
     }
+    touch();
+    
+    emit itemsRemoved(removedIds);
+    emit itemsReset();
+    emit historyCleared();
+    notifyOrderChanged();
 }
 
 void ClipboardHistory::clearAll()
 {
-    if (!m_items.isEmpty()) {
+    if (!isEmpty()) {
         QStringList removedIds;
-        for (const auto& item : m_items) {
+        removedIds.reserve(count());
+        for (const auto& item : m_pinned.items()) {
             removedIds.append(item.id());
         }
+        for (const auto& item : m_unpinned.items()) {
+            removedIds.append(item.id());
+        }
+        if (m_cold) {
+            for (int position = 0; position < m_cold->count(); ++position) {
+                removedIds.append(m_cold->idAt(position));
+            }
+            m_cold->clear();
+        }
         
-        m_items.clear();
-        m_pinnedCount = 0;
+        m_pinned.clear();
+        m_unpinned.clear();
+        m_hashIndex.clear();
+        touch();
         
-        for (const QString& id : removedIds) {
-            emit itemRemoved(id);
-        }
+        emit itemsRemoved(removedIds);
+        emit itemsReset();
         emit historyCleared();
-        emit orderChanged();
+        notifyOrderChanged();
     }
 }
 
 ClipboardItem ClipboardHistory::getItem(const QString& id) const
 {
-    auto it = findItem(id);
-    if (it != m_items.end()) {
-        return *it;
+    const ClipboardItem* item = findItem(id);
+    if (item) {
+        return *item;
+    }
+    
+    int position = m_cold ? m_cold->indexOf(id) : -1;
+    if (position >= 0) {
+        return m_cold->load(position);
     }
     return ClipboardItem(); // Invalid item
 }
 
 ClipboardItem ClipboardHistory::getItemAt(int index) const
 {
-    if (index >= 0 && index < m_items.count()) {
-        return m_items.at(index);
+    if (index >= 0 && index < m_pinned.count()) {
+        return m_pinned.at(index);
+    }
+    
+    index -= m_pinned.count();
+    if (index >= 0 && index < m_unpinned.count()) {
+        return m_unpinned.at(index);
+    }
+    
+    index -= m_unpinned.count();
+    if (index >= 0 && index < coldCount()) {
+        return m_cold->load(index);
     }
     return ClipboardItem(); // Invalid item
 }
 
 int ClipboardHistory::findItemIndex(const QString& id) const
 {
-    for (int i = 0; i < m_items.count(); ++i) {
-        if (m_items.at(i).id() == id) {
-            return i;
-        }
+    int index = hotIndexOf(id);
+    if (index >= 0) {
+        return index;
     }
-    return -1;
+    
+    int position = m_cold ? m_cold->indexOf(id) : -1;
+    return position >= 0 ? hotCount() + position : -1;
 }
 
 bool ClipboardHistory::hasItem(const QString& id) const
 {
-    return findItem(id) != m_items.end();
+    return m_pinned.contains(id) || m_unpinned.contains(id) ||
+           (m_cold && m_cold->contains(id));
 }
 
 bool ClipboardHistory::hasDuplicate(const QString& text) const
 {
-    QString hash = ClipboardItem::generateHash(text);
-    return findItemByHash(hash) != m_items.end();
+    return !findDuplicateId(text, ClipboardItem::generateContentKey(text)).isEmpty();
+}
+
+QList<ClipboardItem> ClipboardHistory::findColdItems(const QString& query, int limit) const
+{
+    QList<ClipboardItem> found;
+    if (!m_cold || query.isEmpty()) {
+        return found;
+    }
+    
+    const TextMatcher matcher(query);
+    for (int position = 0; position < m_cold->count() && found.size() < limit; ++position) {
+        if (matcher.contains(m_cold->previewAt(position))) {
+            found.append(m_cold->at(position));
+        }
+    }
+    return found;
+}
+
+QList<ClipboardItem> ClipboardHistory::coldItems(int from, int count, bool withText) const
+{
+    QList<ClipboardItem> items;
+    if (!m_cold || count <= 0) {
+        return items;
+    }
+    
+    const int end = int(qMin(qint64(m_cold->count()), qint64(qMax(0, from)) + count));
+    items.reserve(qMax(0, end - from));
+    for (int position = qMax(0, from); position < end; ++position) {
+        ClipboardItem item = withText ? m_cold->load(position) : m_cold->at(position);
+        if (!item.id().isEmpty()) {
+            items.append(item);
+        }
+    }
+    return items;
+}
+
+QSet<QString> ClipboardHistory::payloadKeys() const
+{
+    QSet<QString> keys;
+    auto collect = [&keys](const QList<ClipboardItem>& items) {
+        for (const ClipboardItem& item : items) {
+            if (item.hasPayload()) {
+                keys.insert(item.payload().key);
+            }
+        }
+    };
+    collect(m_pinned.items());
+    collect(m_unpinned.items());
+    if (m_cold) {
+        m_cold->collectPayloadKeys(keys);
+    }
+    return keys;
+}
+
+ClipboardHistory::MemoryUsage ClipboardHistory::memoryUsage() const
+{
+    MemoryUsage usage;
+    auto add = [&usage](const QList<ClipboardItem>& items) {
+        usage.hotItems += int(items.size());
+        usage.hotBytes += qint64(items.capacity() - items.size()) * qint64(sizeof(ClipboardItem));
+        for (const ClipboardItem& item : items) {
+            usage.hotBytes += item.memoryUsage();
+        }
+    };
+    add(m_pinned.items());
+    add(m_unpinned.items());
+    
+    if (m_cold) {
+        const ItemArena::Usage cold = m_cold->memoryUsage();
+        usage.coldEntries = cold.entries;
+        usage.coldBytes = cold.totalBytes();
+    }
+    
+    // Keys and node bookkeeping, plus the ID string each node holds
+    usage.hashIndexBytes = qint64(m_hashIndex.capacity()) * qint64(sizeof(quint64) + sizeof(QString) + 1);
+    for (const QString& id : m_hashIndex) {
+        usage.hashIndexBytes += qint64(id.capacity()) * qint64(sizeof(QChar));
+    }
+    return usage;
 }
 
 QJsonObject ClipboardHistory::toJson() const
@@ -245,7 +538,10 @@ QJsonObject ClipboardHistory::toJson() const
     json["maxItems"] = m_maxItems;
     
     QJsonArray itemsArray;
-    for (const auto& item : m_items) {
+    for (const auto& item : m_pinned.items()) {
+        itemsArray.append(item.toJson());
+    }
+    for (const auto& item : m_unpinned.items()) {
         itemsArray.append(item.toJson());
     }
     json["items"] = itemsArray;
@@ -255,111 +551,386 @@ QJsonObject ClipboardHistory::toJson() const
 
 bool ClipboardHistory::fromJson(const QJsonObject& json)
 {
-    m_items.clear();
-    m_pinnedCount = 0;
+    m_pinned.clear();
+    m_unpinned.clear();
+    m_hashIndex.clear();
     
     // Load maxItems
     if (json.contains("maxItems")) {
         setMaxItems(json["maxItems"].toInt(DEFAULT_MAX_ITEMS));
     }
     
-    // Load items
+    // Load items; entries that are not objects decode as invalid items and are dropped
+    QList<ClipboardItem> loaded;
     if (json.contains("items") && json["items"].isArray()) {
-        QJsonArray itemsArray = json["items"].toArray();
-        for (const auto& value : itemsArray) {
-            if (value.isObject()) {
-                ClipboardItem item(value.toObject());
-                if (item.isValid()) {
-                    m_items.append(item);
-                }
-            }
-        }
+        const QJsonArray itemsArray = json["items"].toArray();
+        loaded = decodeItems(int(itemsArray.size()), [&itemsArray](int index) {
+            const QJsonValue value = itemsArray.at(index);
+            return value.isObject() ? ClipboardItem(value.toObject()) : ClipboardItem();
+        });
     }
     
-    reorderItems();
-    updatePinnedCount();
+    loadItems(loaded);
     return true;
 }
 
-void ClipboardHistory::enforceSizeLimit()
+bool ClipboardHistory::loadFromSnapshot(const QString& filePath)
 {
-    while (m_items.count() > m_maxItems) {
-        // Remove oldest unpinned item
-        bool removed = false;
-        for (auto it = m_items.end() - 1; it >= m_items.begin(); --it) {
-            if (!it->pinned()) {
-                QString removedId = it->id();
-                m_items.erase(it);
-                emit itemRemoved(removedId);
-                removed = true;
-                break;
-            }
+    QList<ClipboardItem> loaded;
+    int maxItems = DEFAULT_MAX_ITEMS;
+    if (!readSnapshot(filePath, loaded, maxItems)) {
+        return false;
+    }
+    
+    loadDecodedItems(loaded, maxItems);
+    return true;
+}
+
+bool ClipboardHistory::readSnapshot(const QString& filePath, QList<ClipboardItem>& items, int& maxItems)
+{
+    HistorySnapshot snapshot(filePath);
+    if (!snapshot.open()) {
+        return false;
+    }
+    
+    maxItems = snapshot.maxItems();
+    items = decodeItems(snapshot.count(), [&snapshot](int index) {
+        return snapshot.itemAt(index);
+    });
+    return true;
+}
+
+void ClipboardHistory::loadDecodedItems(const QList<ClipboardItem>& items, int maxItems)
+{
+    m_pinned.clear();
+    m_unpinned.clear();
+    m_hashIndex.clear();
+    setMaxItems(maxItems);
+    
+    loadItems(items);
+}
+
+bool ClipboardHistory::saveToSnapshot(const QString& filePath) const
+{
+    return HistorySnapshot::write(filePath, m_maxItems, items());
+}
+
+void ClipboardHistory::loadItems(const QList<ClipboardItem>& candidates)
+{
+    m_loading = true;
+    
+    // Drop invalid entries and repeated IDs or content, keeping the first
+    QList<ClipboardItem> loaded;
+    QHash<QString, int> loadedIds; // ID -> position in loaded
+    loaded.reserve(candidates.size());
+    loadedIds.reserve(candidates.size());
+    for (const auto& item : candidates) {
+        if (!item.isValid() || loadedIds.contains(item.id())) {
+            continue;
         }
         
-        if (!removed) {
-            // All items are pinned, can't remove any more
+        auto indexed = m_hashIndex.constFind(item.contentKey());
+        if (indexed != m_hashIndex.cend()) {
+            if (loaded.at(loadedIds.value(*indexed)).text() == item.text()) {
+                continue;
+            }
+            // Different text under the same key: keep the item, unindexed
+        } else {
+            m_hashIndex.insert(item.contentKey(), item.id());
+        }
+        loadedIds.insert(item.id(), int(loaded.size()));
+        loaded.append(item);
+    }
+    
+    // Files are written in display order, so this is a single pass in practice
+    std::stable_sort(loaded.begin(), loaded.end(), [](const ClipboardItem& a, const ClipboardItem& b) {
+        return a.timestampMs() > b.timestampMs();
+    });
+    for (const auto& item : loaded) {
+        if (item.pinned()) {
+            m_pinned.append(item);
+        } else {
+            m_unpinned.append(item);
+        }
+    }
+    
+    touch();
+    
+    // Anything the file still holds in memory wins over its cold copy
+    indexColdEntries();
+    demoteColdItems();
+    
+    m_loading = false;
+    emit itemsReset();
+}
+
+void ClipboardHistory::enforceSizeLimit()
+{
+    demoteColdItems();
+    
+    // Remove oldest unpinned items, cold ones first; pinned items are never evicted
+    QStringList removedIds;
+    while (count() > m_maxItems) {
+        ClipboardItem removed;
+        if (coldCount() > 0) {
+            removed = m_cold->removeAt(m_cold->count() - 1);
+        } else if (!m_unpinned.isEmpty()) {
+            removed = m_unpinned.takeLast();
+            touch();
+            notifyRemoved(hotCount(), removed.id());
+        } else {
             break;
         }
+        unindexItem(removed);
+        removedIds.append(removed.id());
+    }
+    
+    Metrics::add(Metrics::Evictions, quint64(removedIds.size()));
+    for (const QString& id : removedIds) {
+        emit itemRemoved(id);
     }
 }
 
-void ClipboardHistory::reorderItems()
+QStringList ClipboardHistory::applyRetention(qint64 nowMs)
 {
-    // Sort items: pinned first (by timestamp desc), then unpinned by timestamp desc
-    std::stable_sort(m_items.begin(), m_items.end(), [](const ClipboardItem& a, const ClipboardItem& b) {
-        // Pinned items always come first
-        if (a.pinned() && !b.pinned()) {
+    QStringList removedIds;
+    if (!m_retention.isEnabled()) {
+        return removedIds;
+    }
+    
+    // Items are in timestamp order, hot before cold: once one is too old or
+    // the budget is used up, every older item goes too
+    const qint64 oldestKept = m_retention.maxAgeMs > 0 ? nowMs - m_retention.maxAgeMs
+                                                       : std::numeric_limits<qint64>::min();
+    qint64 keptBytes = 0;
+    bool evictRest = false;
+    auto evict = [&](qint64 timestampMs, qint64 size) {
+        if (!evictRest && timestampMs < oldestKept) {
+            evictRest = true;
+        }
+        if (evictRest || (m_retention.maxItemBytes > 0 && size > m_retention.maxItemBytes)) {
             return true;
         }
-        if (!a.pinned() && b.pinned()) {
-            return false;
+        if (m_retention.maxTotalBytes > 0 && keptBytes + size > m_retention.maxTotalBytes) {
+            evictRest = true;
+            return true;
         }
-        
-        // Within same pin state, sort by timestamp (newer first)
-        return a.timestamp() > b.timestamp();
-    });
+        keptBytes += size;
+        return false;
+    };
+    
+    QList<int> hotPositions;
+    for (int position = 0; position < m_unpinned.count(); ++position) {
+        const ClipboardItem& item = m_unpinned.at(position);
+        if (evict(item.timestampMs(), item.contentSize())) {
+            hotPositions.append(position);
+        }
+    }
+    QList<int> coldPositions;
+    for (int position = 0; position < coldCount(); ++position) {
+        if (evict(m_cold->timestampAt(position), m_cold->contentSizeAt(position))) {
+            coldPositions.append(position);
+        }
+    }
+    if (hotPositions.isEmpty() && coldPositions.isEmpty()) {
+        return removedIds;
+    }
+    
+    // Back to front, so the positions still to remove stay valid
+    beginUpdate();
+    for (auto it = coldPositions.crbegin(); it != coldPositions.crend(); ++it) {
+        const ClipboardItem removed = m_cold->removeAt(*it);
+        unindexItem(removed);
+        removedIds.append(removed.id());
+    }
+    for (auto it = hotPositions.crbegin(); it != hotPositions.crend(); ++it) {
+        const ClipboardItem removed = m_unpinned.takeAt(*it);
+        touch();
+        notifyRemoved(m_pinned.count() + *it, removed.id());
+        unindexItem(removed);
+        removedIds.append(removed.id());
+    }
+    promoteColdItems();
+    
+    Metrics::add(Metrics::Evictions, quint64(removedIds.size()));
+    emit itemsRemoved(removedIds);
+    notifyOrderChanged();
+    endUpdate();
+    return removedIds;
 }
 
-void ClipboardHistory::updatePinnedCount()
+void ClipboardHistory::demoteColdItems()
 {
-    m_pinnedCount = 0;
-    for (const auto& item : m_items) {
-        if (item.pinned()) {
-            ++m_pinnedCount;
+    if (!m_cold) {
+        return;
+    }
+    
+    while (m_unpinned.count() > m_hotItemLimit) {
+        // The hash index already points at the item's ID, whichever tier holds it
+        if (!m_cold->add(m_unpinned.at(m_unpinned.count() - 1))) {
+            break; // Keep the item hot if it cannot be written
         }
+        ClipboardItem demoted = m_unpinned.takeLast();
+        touch();
+        notifyRemoved(hotCount(), demoted.id());
     }
 }
 
-QList<ClipboardItem>::iterator ClipboardHistory::findItem(const QString& id)
+void ClipboardHistory::promoteColdItems()
 {
-    return std::find_if(m_items.begin(), m_items.end(), 
-                       [&id](const ClipboardItem& item) {
-                           return item.id() == id;
-                       });
+    if (!m_cold) {
+        return;
+    }
+    
+    // The cold head is older than every hot item, so it joins at the hot tail
+    while (m_unpinned.count() < m_hotItemLimit && m_cold->count() > 0) {
+        ClipboardItem promoted = m_cold->load(0);
+        if (!promoted.isValid()) {
+            break; // Leave it cold; getItem() reports it the same way
+        }
+        m_cold->removeAt(0);
+        const int index = m_pinned.count() + m_unpinned.insert(promoted);
+        touch();
+        if (!m_loading) {
+            emit itemInsertedAt(index, promoted);
+        }
+    }
 }
 
-QList<ClipboardItem>::const_iterator ClipboardHistory::findItem(const QString& id) const
+void ClipboardHistory::indexColdEntries()
 {
-    return std::find_if(m_items.begin(), m_items.end(), 
-                       [&id](const ClipboardItem& item) {
-                           return item.id() == id;
-                       });
+    if (!m_cold) {
+        return;
+    }
+    
+    // Newest entries are indexed first, so they win over older duplicates.
+    // Cold entries have no text in memory, so a matching key counts as a duplicate.
+    int position = 0;
+    while (position < m_cold->count()) {
+        const ClipboardItem entry = m_cold->at(position);
+        bool isHot = m_pinned.contains(entry.id()) || m_unpinned.contains(entry.id());
+        if (isHot || m_hashIndex.value(entry.contentKey(), entry.id()) != entry.id()) {
+            m_cold->removeAt(position);
+        } else {
+            m_hashIndex.insert(entry.contentKey(), entry.id());
+            ++position;
+        }
+    }
 }
 
-QList<ClipboardItem>::iterator ClipboardHistory::findItemByHash(const QString& hash)
+void ClipboardHistory::insertItem(const ClipboardItem& item, bool notify)
 {
-    return std::find_if(m_items.begin(), m_items.end(), 
-                       [&hash](const ClipboardItem& item) {
-                           return item.hash() == hash;
-                       });
+    if (item.pinned()) {
+        m_pinned.insert(item);
+    } else {
+        m_unpinned.insert(item);
+    }
+    touch();
+    
+    // On a key collision the item already indexed keeps the key
+    if (!m_hashIndex.contains(item.contentKey())) {
+        m_hashIndex.insert(item.contentKey(), item.id());
+    }
+    
+    if (notify && !m_loading) {
+        emit itemInsertedAt(hotIndexOf(item.id()), item);
+    }
 }
 
-QList<ClipboardItem>::const_iterator ClipboardHistory::findItemByHash(const QString& hash) const
+ClipboardItem ClipboardHistory::takeItem(const QString& id, bool notify)
 {
-    return std::find_if(m_items.begin(), m_items.end(), 
-                       [&hash](const ClipboardItem& item) {
-                           return item.hash() == hash;
-                       });
+    ClipboardItem item;
+    int index = -1;
+    int position = m_pinned.indexOf(id);
+    if (position >= 0) {
+        index = position;
+        item = m_pinned.takeAt(position);
+        touch();
+    } else {
+        position = m_unpinned.indexOf(id);
+        if (position >= 0) {
+            index = m_pinned.count() + position;
+            item = m_unpinned.takeAt(position);
+            touch();
+        } else {
+            position = m_cold ? m_cold->indexOf(id) : -1;
+            if (position < 0) {
+                return item;
+            }
+            item = m_cold->removeAt(position);
+        }
+    }
+    
+    unindexItem(item);
+    if (notify && index >= 0) {
+        notifyRemoved(index, id);
+    }
+    return item;
+}
+
+void ClipboardHistory::unindexItem(const ClipboardItem& item)
+{
+    auto indexed = m_hashIndex.find(item.contentKey());
+    if (indexed != m_hashIndex.end() && *indexed == item.id()) {
+        m_hashIndex.erase(indexed);
+    }
+}
+
+const ClipboardItem* ClipboardHistory::findItem(const QString& id) const
+{
+    int position = m_pinned.indexOf(id);
+    if (position >= 0) {
+        return &m_pinned.at(position);
+    }
+    
+    position = m_unpinned.indexOf(id);
+    return position >= 0 ? &m_unpinned.at(position) : nullptr;
+}
+
+int ClipboardHistory::hotIndexOf(const QString& id) const
+{
+    int position = m_pinned.indexOf(id);
+    if (position >= 0) {
+        return position;
+    }
+    
+    position = m_unpinned.indexOf(id);
+    return position >= 0 ? m_pinned.count() + position : -1;
+}
+
+void ClipboardHistory::notifyOrderChanged()
+{
+    if (m_updateDepth > 0) {
+        m_orderChangePending = true;
+        return;
+    }
+    emit orderChanged();
+}
+
+void ClipboardHistory::notifyRemoved(int index, const QString& id)
+{
+    if (!m_loading) {
+        emit itemRemovedAt(index, id);
+    }
+}
+
+QString ClipboardHistory::findDuplicateId(const QString& text, quint64 contentKey) const
+{
+    QString id = m_hashIndex.value(contentKey);
+    if (id.isEmpty()) {
+        return id;
+    }
+    
+    // Matching keys are confirmed against the text, read back for cold items
+    const ClipboardItem* item = findItem(id);
+    if (item) {
+        return item->text() == text ? id : QString();
+    }
+    int position = m_cold ? m_cold->indexOf(id) : -1;
+    if (position >= 0 && m_cold->load(position).text() != text) {
+        return QString();
+    }
+    return id;
 }
 
 bool ClipboardHistory::loadFromFile(const QString& filePath)
@@ -388,10 +959,14 @@ bool ClipboardHistory::saveToFile(const QString& filePath)
     QFileInfo fileInfo(filePath);
     QDir().mkpath(fileInfo.absolutePath());
     
-    QFile file(filePath);
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
     
-    return file.write(doc.toJson()) != -1;
+    if (file.write(doc.toJson()) == -1) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
 }
@@ -2,10 +2,18 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <memory>
 #include "clipboard_item.h"
+#include "history_segment.h"
+#include "history_view.h"
+#include "published_history.h"
+#include "cold_history_store.h"
 
 /**
  * @brief Manages a collection of clipboard items with ordering and size limits
@@ -15,6 +23,30 @@
  * - Regular items are ordered by timestamp (newest first)
  * - The total number of items never exceeds maxItems
  * - Duplicate items are handled by updating existing items
+ *
+ * Pinned and unpinned items live in two separately ordered segments, so a
+ * new clipboard entry is a prepend and eviction drops the segment tail
+ * instead of resorting the whole history.
+ *
+ * With a cold store attached, only the newest hotItemLimit() unpinned items
+ * stay fully in memory. Older items are demoted to the on-disk cold segment,
+ * which keeps their metadata indexed and loads the text on demand. When
+ * removals leave fewer hot items, the newest cold items are promoted back.
+ * Pinned items are always kept hot.
+ *
+ * Besides the item signals, every change to the in-memory items is also
+ * reported as a positional delta (itemInsertedAt, itemRemovedAt, itemMoved)
+ * against items(), so views of the history can be updated in O(1) per
+ * change. Deltas are emitted in order; each one applies to the list left
+ * by the previous one. Bulk changes emit itemsReset instead.
+ *
+ * Threading: the history has a single writer, the thread it lives in, and
+ * its signals are delivered there. Other threads read through snapshot(),
+ * which returns the last published HistoryView without touching the
+ * history; changes made during one event loop iteration are published
+ * together when it returns to the event loop, so a burst of changes costs
+ * at most one copy of each segment it touches. Producers on other threads
+ * hand content to the writer with postItem().
  */
 class ClipboardHistory : public QObject
 {
@@ -28,7 +60,7 @@ public:
     
     /**
      * @brief Constructor with custom maximum items
-     * @param maxItems Maximum number of items to store (10-100)
+     * @param maxItems Maximum number of items to store (10-100000)
      * @param parent Parent QObject
      */
     explicit ClipboardHistory(int maxItems, QObject* parent = nullptr);
@@ -42,31 +74,126 @@ public:
 
     // Getters
     int maxItems() const { return m_maxItems; }
-    int count() const { return m_items.count(); }
-    int pinnedCount() const { return m_pinnedCount; }
-    bool isEmpty() const { return m_items.isEmpty(); }
-    bool isFull() const { return m_items.count() >= m_maxItems; }
+    int count() const { return hotCount() + coldCount(); }
+    int hotCount() const { return m_pinned.count() + m_unpinned.count(); }
+    int coldCount() const { return m_cold ? m_cold->count() : 0; }
+    int pinnedCount() const { return m_pinned.count(); }
+    bool isEmpty() const { return count() == 0; }
+    bool isFull() const { return count() >= m_maxItems; }
+    int hotItemLimit() const { return m_hotItemLimit; }
     
     /**
-     * @brief Get all items in display order (pinned first, then by timestamp)
-     * @return Ordered list of all items
+     * @brief Get the history version
+     * @return Number that changes with every change to the in-memory items
      */
-    QList<ClipboardItem> items() const { return m_items; }
+    quint64 version() const { return m_version; }
+    
+    /**
+     * @brief Get an immutable snapshot of the in-memory items
+     * @return View sharing the current segments
+     *
+     * Views are cheap to take; holding one makes the next change copy the
+     * segment it touches, so consumers should not keep views longer than
+     * they need them.
+     */
+    HistoryView view() const;
+    
+    /**
+     * @brief Get the last published snapshot of the in-memory items
+     * @return Published view; safe to call from any thread
+     *
+     * Lags view() until pending changes are published, either by the
+     * event loop or by publishSnapshot().
+     */
+    HistoryView snapshot() const { return m_published.current(); }
+    
+    /**
+     * @brief Get the version of snapshot()
+     * @return Published version; safe to call from any thread
+     */
+    quint64 snapshotVersion() const { return m_published.version(); }
+    
+    /**
+     * @brief Publish the current items to snapshot() readers now
+     */
+    void publishSnapshot();
+    
+    /**
+     * @brief Get in-memory items in display order (pinned first, then by timestamp)
+     * @return Ordered list of hot items
+     *
+     * Cold items follow these in display order and are reached through
+     * getItemAt() and getItem().
+     */
+    QList<ClipboardItem> items() const;
     
     /**
      * @brief Get only pinned items
      * @return List of pinned items
      */
-    QList<ClipboardItem> pinnedItems() const;
+    QList<ClipboardItem> pinnedItems() const { return m_pinned.items(); }
     
     /**
      * @brief Get only unpinned items
      * @return List of unpinned items ordered by timestamp
      */
-    QList<ClipboardItem> unpinnedItems() const;
+    QList<ClipboardItem> unpinnedItems() const { return m_unpinned.items(); }
 
     // Configuration
     void setMaxItems(int maxItems);
+    
+    /**
+     * @brief Set how many unpinned items stay fully in memory
+     * @param hotItemLimit Number of newest unpinned items to keep hot
+     *
+     * Only takes effect while a cold store is attached.
+     */
+    void setHotItemLimit(int hotItemLimit);
+    
+    /**
+     * @brief Limits on unpinned items beyond the item count
+     *
+     * Sizes are ClipboardItem::contentSize(). A limit of 0 is no limit.
+     */
+    struct RetentionPolicy {
+        qint64 maxAgeMs = 0;          ///< Items copied longer ago are evicted
+        qint64 maxTotalBytes = 0;     ///< Budget for all unpinned items; the oldest go first
+        qint64 maxItemBytes = 0;      ///< Larger items are evicted
+        
+        bool isEnabled() const { return maxAgeMs > 0 || maxTotalBytes > 0 || maxItemBytes > 0; }
+        bool operator==(const RetentionPolicy& other) const = default;
+    };
+    
+    /**
+     * @brief Set the retention limits applied by applyRetention()
+     *
+     * Nothing is evicted until applyRetention() runs, so the limits cost
+     * nothing when content is added.
+     */
+    void setRetentionPolicy(const RetentionPolicy& policy) { m_retention = policy; }
+    const RetentionPolicy& retentionPolicy() const { return m_retention; }
+    
+    /**
+     * @brief Evict unpinned items that violate the retention policy
+     * @param nowMs Current time in ms since the epoch
+     * @return IDs of the evicted items
+     *
+     * Walks the unpinned items newest first, hot then cold, without reading
+     * any cold text. All evictions form one batch: itemRemovedAt is emitted
+     * per hot item, itemInsertedAt per cold item promoted into the freed
+     * slots, then itemsRemoved and orderChanged once.
+     */
+    QStringList applyRetention(qint64 nowMs);
+    
+    /**
+     * @brief Keep items beyond the hot limit in an on-disk cold segment
+     * @param filePath Path of the cold segment file
+     * @return true if the segment was opened
+     *
+     * Items already in the segment become part of the history. Without a
+     * cold store every item stays in memory.
+     */
+    bool attachColdStore(const QString& filePath);
 
     // Item Operations
     /**
@@ -76,6 +203,9 @@ public:
      * 
      * Handles duplicates by updating existing items and moving to top.
      * Enforces size limits by removing oldest unpinned items if needed.
+     *
+     * The content key is computed once and looked up first; an item is
+     * only built for content that is not in the history yet.
      */
     QString addItem(const QString& text);
     
@@ -86,6 +216,38 @@ public:
      */
     QString addItem(const ClipboardItem& item);
     
+    /**
+     * @brief Queue text to be added by the history's own thread
+     * @param text Text content to add
+     *
+     * Safe to call from any thread; the item is added like addItem() once
+     * the history's event loop runs.
+     */
+    void postItem(const QString& text);
+    
+    /**
+     * @brief Start a batch of changes
+     *
+     * Until the matching endUpdate(), orderChanged is held back and emitted
+     * once at the end if anything changed. Item and delta signals are still
+     * emitted as the changes happen. Batches nest.
+     */
+    void beginUpdate();
+    
+    /**
+     * @brief Finish a batch started with beginUpdate()
+     */
+    void endUpdate();
+    
+    /**
+     * @brief Put back an item exactly as it was recorded
+     * @param item Item with its original ID, timestamp and pin state
+     *
+     * Replaces any item with the same ID or content. Unlike addItem() this
+     * does not emit itemAdded; it is meant for replaying persisted changes.
+     */
+    void restoreItem(const ClipboardItem& item);
+    
     /**
      * @brief Pin item by ID
      * @param id Item ID to pin
@@ -116,11 +278,14 @@ public:
     
     /**
      * @brief Remove all unpinned items
+     *
+     * The removed items, cold ones included, are reported in one
+     * itemsRemoved, followed by itemsReset and historyCleared.
      */
     void clear();
     
     /**
-     * @brief Remove all items (including pinned)
+     * @brief Remove all items (including pinned), reported like clear()
      */
     void clearAll();
     
@@ -158,11 +323,64 @@ public:
      * @return true if duplicate content exists
      */
     bool hasDuplicate(const QString& text) const;
+    
+    /**
+     * @brief Find cold items whose preview contains a query
+     * @param query Text to find, ignoring case
+     * @param limit Maximum number of items
+     * @return Metadata-only items, newest first
+     *
+     * Only the previews kept in memory are searched, so nothing is read
+     * from disk; a match past the start of an item's text is not found.
+     */
+    QList<ClipboardItem> findColdItems(const QString& query, int limit) const;
+    
+    /**
+     * @brief Get a range of the cold segment
+     * @param from First cold position (0 = newest cold item)
+     * @param count Maximum number of items
+     * @param withText true to read each item's text from disk
+     * @return Items newest first; metadata only unless withText, and
+     *         records that cannot be read are skipped
+     */
+    QList<ClipboardItem> coldItems(int from, int count, bool withText = false) const;
+    
+    /**
+     * @brief Collect the blob keys referenced by any item, hot or cold
+     * @return Keys to keep when sweeping the BlobStore
+     */
+    QSet<QString> payloadKeys() const;
+    
+    /**
+     * @brief Memory held by the history, by tier
+     */
+    struct MemoryUsage {
+        int hotItems = 0;
+        qint64 hotBytes = 0;         ///< Hot items and their strings
+        int coldEntries = 0;
+        qint64 coldBytes = 0;        ///< Metadata arena of the cold segment
+        qint64 hashIndexBytes = 0;   ///< Duplicate detection index
+        
+        qint64 totalBytes() const { return hotBytes + coldBytes + hashIndexBytes; }
+        qint64 bytesPerItem() const {
+            const int items = hotItems + coldEntries;
+            return items > 0 ? totalBytes() / items : 0;
+        }
+    };
+    
+    /**
+     * @brief Report the memory held by the history
+     * @return Estimated bytes per tier; shared strings are counted per item
+     */
+    MemoryUsage memoryUsage() const;
 
     // Serialization
     /**
      * @brief Serialize to JSON object
      * @return JSON representation of the history
+     *
+     * Only hot items are written; cold items are already persisted in the
+     * cold segment.
      */
     QJsonObject toJson() const;
     
@@ -170,18 +388,55 @@ public:
      * @brief Load data from JSON object
      * @param json JSON object to load from
      * @return true if loading was successful
+     *
+     * Large histories are decoded in chunks on the global thread pool.
      */
     bool fromJson(const QJsonObject& json);
     
     /**
-     * @brief Load history from file
+     * @brief Load history from a binary snapshot file
+     * @param filePath Path to load from
+     * @return true if the snapshot was read successfully
+     *
+     * Large snapshots are decoded in chunks on the global thread pool.
+     */
+    bool loadFromSnapshot(const QString& filePath);
+    
+    /**
+     * @brief Read and decode a binary snapshot without touching any history
+     * @param filePath Path to load from
+     * @param items Filled with the decoded items, in file order
+     * @param maxItems Filled with the size limit stored in the snapshot
+     * @return true if the snapshot was read successfully
+     *
+     * Safe to call from any thread; pair with loadDecodedItems() on the
+     * history's own thread to load a snapshot in the background.
+     */
+    static bool readSnapshot(const QString& filePath, QList<ClipboardItem>& items, int& maxItems);
+    
+    /**
+     * @brief Replace the history with items decoded by readSnapshot()
+     * @param items Decoded items
+     * @param maxItems Size limit stored with them
+     */
+    void loadDecodedItems(const QList<ClipboardItem>& items, int maxItems);
+    
+    /**
+     * @brief Save hot items to a binary snapshot file
+     * @param filePath Path to save to
+     * @return true if the snapshot was written atomically
+     */
+    bool saveToSnapshot(const QString& filePath) const;
+    
+    /**
+     * @brief Load history from JSON file (import path)
      * @param filePath Path to load from
      * @return true if loading was successful
      */
     bool loadFromFile(const QString& filePath);
     
     /**
-     * @brief Save history to file
+     * @brief Save history to JSON file (export path)
      * @param filePath Path to save to
      * @return true if saving was successful
      */
@@ -206,6 +461,12 @@ signals:
      */
     void itemRemoved(const QString& id);
     
+    /**
+     * @brief Emitted instead of itemRemoved when a batch of items is evicted or cleared
+     * @param ids IDs of the removed items
+     */
+    void itemsRemoved(const QStringList& ids);
+    
     /**
      * @brief Emitted when an item is pinned
      * @param id ID of the pinned item
@@ -227,6 +488,34 @@ signals:
      * @brief Emitted when the order of items changes
      */
     void orderChanged();
+    
+    /**
+     * @brief Emitted when an item appears in items()
+     * @param index Position of the new item
+     * @param item The inserted item
+     */
+    void itemInsertedAt(int index, const ClipboardItem& item);
+    
+    /**
+     * @brief Emitted when an item leaves items() (removed, evicted or demoted)
+     * @param index Position the item had
+     * @param id ID of the item
+     */
+    void itemRemovedAt(int index, const QString& id);
+    
+    /**
+     * @brief Emitted when an item moves within items()
+     * @param from Position the item had
+     * @param to Position after removing it from there and reinserting it
+     * @param item The item in its new state (pin state, or a fresh copy of
+     *             re-copied content with a new ID)
+     */
+    void itemMoved(int from, int to, const ClipboardItem& item);
+    
+    /**
+     * @brief Emitted when items() was replaced as a whole (load or clear)
+     */
+    void itemsReset();
 
 private:
     /**
@@ -235,48 +524,115 @@ private:
     void enforceSizeLimit();
     
     /**
-     * @brief Reorder items to maintain display order (pinned first, then by timestamp)
+     * @brief Move re-copied content to the top under a new ID and timestamp
+     * @param existingId ID of the item holding the content
+     * @param text The content
+     * @param contentKey ClipboardItem::generateContentKey() of text
+     * @return ID of the refreshed item
+     */
+    QString refreshItem(const QString& existingId, const QString& text, quint64 contentKey);
+    
+    /**
+     * @brief Replace the hot items with freshly loaded ones
+     * @param candidates Loaded items; invalid and duplicate entries are dropped
+     *
+     * Expects the segments and hash index to have been cleared.
+     */
+    void loadItems(const QList<ClipboardItem>& candidates);
+    
+    /**
+     * @brief Move the oldest unpinned items to the cold store while over the hot limit
+     */
+    void demoteColdItems();
+    
+    /**
+     * @brief Move the newest cold items back into memory while under the hot limit
+     */
+    void promoteColdItems();
+    
+    /**
+     * @brief Index cold entries, dropping those already present in memory
      */
-    void reorderItems();
+    void indexColdEntries();
     
     /**
-     * @brief Update pinned count based on current items
+     * @brief Insert item into the segment matching its pin state
+     * @param item Item to insert
+     * @param notify false to leave the delta signal to the caller
      */
-    void updatePinnedCount();
+    void insertItem(const ClipboardItem& item, bool notify = true);
+    
+    /**
+     * @brief Remove item by ID from whichever segment holds it
+     * @param id Item ID to remove
+     * @param notify false to leave the delta signal to the caller
+     * @return The removed item, or an invalid item if not found
+     *
+     * Items taken from the cold store are returned without their text.
+     */
+    ClipboardItem takeItem(const QString& id, bool notify = true);
     
     /**
      * @brief Find item by ID
      * @param id Item ID to find
-     * @return Iterator to the item, or end() if not found
+     * @return Pointer to the item, or nullptr if not found
      */
-    QList<ClipboardItem>::iterator findItem(const QString& id);
+    const ClipboardItem* findItem(const QString& id) const;
     
     /**
-     * @brief Find item by ID (const version)
+     * @brief Find the position of a hot item in items()
      * @param id Item ID to find
-     * @return Const iterator to the item, or end() if not found
+     * @return Position, or -1 if the item is not in memory
+     */
+    int hotIndexOf(const QString& id) const;
+    
+    /**
+     * @brief Emit orderChanged, or defer it to endUpdate() inside a batch
+     */
+    void notifyOrderChanged();
+    
+    /**
+     * @brief Emit itemRemovedAt unless a bulk load is in progress
+     */
+    void notifyRemoved(int index, const QString& id);
+    
+    /**
+     * @brief Find the item holding the given content
+     * @param text Content to find
+     * @param contentKey ClipboardItem::generateContentKey() of text
+     * @return ID of the item with that content, or empty string if not found
      */
-    QList<ClipboardItem>::const_iterator findItem(const QString& id) const;
+    QString findDuplicateId(const QString& text, quint64 contentKey) const;
     
     /**
-     * @brief Find item by content hash
-     * @param hash Content hash to find
-     * @return Iterator to the item, or end() if not found
+     * @brief Mark the in-memory items as changed
+     *
+     * Schedules one publish for all changes until the event loop runs.
      */
-    QList<ClipboardItem>::iterator findItemByHash(const QString& hash);
+    void touch();
     
     /**
-     * @brief Find item by content hash (const version)
-     * @param hash Content hash to find
-     * @return Const iterator to the item, or end() if not found
+     * @brief Drop item from the content index if the index points at it
+     * @param item Item leaving the history
      */
-    QList<ClipboardItem>::const_iterator findItemByHash(const QString& hash) const;
+    void unindexItem(const ClipboardItem& item);
 
     static constexpr int DEFAULT_MAX_ITEMS = 50;
     static constexpr int MIN_MAX_ITEMS = 10;
-    static constexpr int MAX_MAX_ITEMS = 100;
+    static constexpr int MAX_MAX_ITEMS = 100000;
+    static constexpr int DEFAULT_HOT_ITEM_LIMIT = 100;
 
-    QList<ClipboardItem> m_items;      ///< Ordered list of clipboard items
+    HistorySegment m_pinned;           ///< Pinned items, newest first
+    HistorySegment m_unpinned;         ///< Hot unpinned items, newest first
+    std::unique_ptr<ColdHistoryStore> m_cold; ///< Older unpinned items on disk (optional)
+    QHash<quint64, QString> m_hashIndex; ///< Content key -> item ID, across all tiers
     int m_maxItems;                    ///< Maximum number of items to store
-    int m_pinnedCount;                 ///< Current number of pinned items
+    int m_hotItemLimit = DEFAULT_HOT_ITEM_LIMIT; ///< Unpinned items kept in memory
+    RetentionPolicy m_retention;       ///< Age and size limits for unpinned items
+    quint64 m_version = 1;             ///< Bumped on every change to the hot items
+    bool m_loading = false;            ///< Bulk load in progress, deltas are folded into itemsReset
+    int m_updateDepth = 0;             ///< Nesting level of beginUpdate()
+    bool m_orderChangePending = false; ///< orderChanged held back by a batch
+    PublishedHistory m_published;      ///< Snapshot for readers on other threads
+    bool m_publishPending = false;     ///< A publish is queued on the event loop
 };
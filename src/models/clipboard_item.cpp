@@ -1,59 +1,89 @@
 #include "clipboard_item.h"
-#include <QRegularExpression>
 #include <QJsonDocument>
+#include <QRandomGenerator>
+#include <algorithm>
+
+namespace {
+
+constexpr quint64 KEY_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * @brief splitmix64 finalizer, spreads every input bit over the result
+ */
+inline quint64 mixBits(quint64 value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+} // namespace
 
 ClipboardItem::ClipboardItem()
-    : m_pinned(false)
 {
     // Invalid item by default - no content
 }
 
 ClipboardItem::ClipboardItem(const QString& text, const QDateTime& timestamp)
     : m_text(text)
-    , m_timestamp(timestamp.isValid() ? timestamp : QDateTime::currentDateTime())
-    , m_pinned(false)
+    , m_timestampMs(timestamp.isValid() ? timestamp.toMSecsSinceEpoch()
+                                        : QDateTime::currentMSecsSinceEpoch())
 {
     if (validateText(text)) {
-        m_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        m_id = generateId();
         initializeDerivedFields();
     }
 }
 
 ClipboardItem::ClipboardItem(const QJsonObject& json)
-    : m_pinned(false)
 {
     fromJson(json);
 }
 
-ClipboardItem::ClipboardItem(const ClipboardItem& other)
-    : m_id(other.m_id)
-    , m_text(other.m_text)
-    , m_preview(other.m_preview)
-    , m_timestamp(other.m_timestamp)
-    , m_pinned(other.m_pinned)
-    , m_hash(other.m_hash)
+QDateTime ClipboardItem::timestamp() const
+{
+    if (m_timestampMs == INVALID_TIMESTAMP) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(m_timestampMs);
+}
+
+QString ClipboardItem::preview() const
+{
+    if (!m_preview.isEmpty() || m_text.isEmpty()) {
+        return m_preview;
+    }
+    return generatePreview(m_text);
+}
+
+QString ClipboardItem::hash() const
 {
+    if (!m_storedHash.isEmpty()) {
+        return m_storedHash;
+    }
+    if (m_payload) {
+        return m_payload->key;
+    }
+    return m_contentKey != 0 ? generateHash(m_text) : QString();
 }
 
-ClipboardItem& ClipboardItem::operator=(const ClipboardItem& other)
+bool ClipboardItem::sameContent(const ClipboardItem& other) const
 {
-    if (this != &other) {
-        m_id = other.m_id;
-        m_text = other.m_text;
-        m_preview = other.m_preview;
-        m_timestamp = other.m_timestamp;
-        m_pinned = other.m_pinned;
-        m_hash = other.m_hash;
+    if (m_contentKey != other.m_contentKey || m_contentKey == 0) {
+        return false;
     }
-    return *this;
+    return !hasText() || !other.hasText() || m_text == other.m_text;
 }
 
 bool ClipboardItem::isValid() const
 {
     return !m_id.isEmpty() && 
            validateText(m_text) && 
-           m_timestamp.isValid() &&
-           !m_hash.isEmpty();
+           m_timestampMs != INVALID_TIMESTAMP &&
+           m_contentKey != 0;
 }
 
 void ClipboardItem::pin()
@@ -76,10 +106,17 @@ QJsonObject ClipboardItem::toJson() const
     QJsonObject json;
     json["id"] = m_id;
     json["text"] = m_text;
-    json["preview"] = m_preview;
-    json["timestamp"] = m_timestamp.toString(Qt::ISODate);
+    json["preview"] = preview();
+    json["timestamp"] = timestamp().toString(Qt::ISODate);
     json["pinned"] = m_pinned;
-    json["hash"] = m_hash;
+    json["hash"] = hash();
+    if (m_payload) {
+        QJsonObject payload;
+        payload["mimeType"] = m_payload->mimeType;
+        payload["key"] = m_payload->key;
+        payload["size"] = m_payload->size;
+        json["payload"] = payload;
+    }
     return json;
 }
 
@@ -89,9 +126,11 @@ bool ClipboardItem::fromJson(const QJsonObject& json)
     m_id.clear();
     m_text.clear();
     m_preview.clear();
-    m_timestamp = QDateTime();
+    m_storedHash.clear();
+    m_contentKey = 0;
+    m_timestampMs = INVALID_TIMESTAMP;
     m_pinned = false;
-    m_hash.clear();
+    m_payload.reset();
     
     // Validate required fields
     if (!json.contains("text") || !json.contains("timestamp")) {
@@ -111,35 +150,129 @@ bool ClipboardItem::fromJson(const QJsonObject& json)
     // Load all fields
     m_id = json.value("id").toString();
     m_text = text;
-    m_timestamp = timestamp;
+    m_timestampMs = timestamp.toMSecsSinceEpoch();
     m_pinned = json.value("pinned").toBool();
+    m_contentKey = generateContentKey(m_text);
     
     // Generate missing derived fields
     if (m_id.isEmpty()) {
-        m_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        m_id = generateId();
     }
     
-    // Load or generate preview
-    if (json.contains("preview")) {
-        m_preview = json["preview"].toString();
-    } else {
-        m_preview = generatePreview(m_text);
+    // Missing previews are derived from the text when needed
+    m_preview = json.value("preview").toString();
+    
+    if (json.contains("payload")) {
+        QJsonObject object = json["payload"].toObject();
+        Payload payload;
+        payload.mimeType = object.value("mimeType").toString();
+        payload.key = object.value("key").toString();
+        payload.size = object.value("size").toInteger();
+        if (payload.isNull() || payload.mimeType.isEmpty()) {
+            m_id.clear();
+            return false;
+        }
+        setPayload(payload);
     }
     
-    // Load or generate hash
+    // Hashes written by this class are derived from the content again on demand
     if (json.contains("hash")) {
-        m_hash = json["hash"].toString();
-    } else {
-        m_hash = generateHash(m_text);
+        setStoredHash(json["hash"].toString());
     }
     
     return isValid();
 }
 
+bool ClipboardItem::writeTo(QDataStream& out, StreamFormat format) const
+{
+    if (format == StreamWithoutPayload && m_payload) {
+        return false;
+    }
+    
+    // Metadata-only readers cannot derive the preview, so it is always written
+    out << m_id << m_contentKey << m_storedHash << m_timestampMs << preview() << m_pinned;
+    if (format == StreamWithPayload) {
+        const Payload payload = this->payload();
+        out << payload.mimeType << payload.key << payload.size;
+    }
+    out << m_text;
+    return out.status() == QDataStream::Ok;
+}
+
+bool ClipboardItem::readFrom(QDataStream& in, bool withText, StreamFormat format)
+{
+    in >> m_id >> m_contentKey >> m_storedHash >> m_timestampMs >> m_preview >> m_pinned;
+    
+    m_payload.reset();
+    if (format == StreamWithPayload) {
+        Payload payload;
+        in >> payload.mimeType >> payload.key >> payload.size;
+        if (!payload.isNull()) {
+            m_payload = QSharedPointer<const Payload>::create(payload);
+        }
+    }
+    
+    m_text.clear();
+    if (withText) {
+        in >> m_text;
+    } else {
+        // QString is stored as a byte length followed by UTF-16 data
+        quint32 length = 0;
+        in >> length;
+        if (length != 0xffffffff) {
+            in.skipRawData(int(length));
+        }
+    }
+    
+    return in.status() == QDataStream::Ok && !m_id.isEmpty() && m_contentKey != 0;
+}
+
+ClipboardItem ClipboardItem::metadata() const
+{
+    ClipboardItem entry(*this);
+    entry.m_preview = preview();
+    entry.m_text.clear();
+    return entry;
+}
+
+qint64 ClipboardItem::contentSize() const
+{
+    return m_payload ? m_payload->size : utf8Size(m_text);
+}
+
+qint64 ClipboardItem::utf8Size(QStringView text)
+{
+    qint64 size = 0;
+    for (QChar c : text) {
+        const char16_t unit = c.unicode();
+        if (unit < 0x80) {
+            size += 1;
+        } else if (unit < 0x800) {
+            size += 2;
+        } else if (QChar::isHighSurrogate(unit)) {
+            size += 4; // The pair's low surrogate adds nothing
+        } else if (!QChar::isLowSurrogate(unit)) {
+            size += 3;
+        }
+    }
+    return size;
+}
+
+qint64 ClipboardItem::memoryUsage() const
+{
+    qint64 chars = m_id.capacity() + m_text.capacity() + m_preview.capacity() + m_storedHash.capacity();
+    qint64 bytes = qint64(sizeof(ClipboardItem)) + chars * qint64(sizeof(QChar));
+    if (m_payload) {
+        bytes += qint64(sizeof(Payload)) +
+                 qint64(m_payload->mimeType.capacity() + m_payload->key.capacity()) * qint64(sizeof(QChar));
+    }
+    return bytes;
+}
+
 bool ClipboardItem::operator==(const ClipboardItem& other) const
 {
-    // Items are equal if they have the same content hash
-    return m_hash == other.m_hash && !m_hash.isEmpty();
+    // Items are equal if they have the same content
+    return sameContent(other);
 }
 
 bool ClipboardItem::operator!=(const ClipboardItem& other) const
@@ -150,25 +283,76 @@ bool ClipboardItem::operator!=(const ClipboardItem& other) const
 bool ClipboardItem::operator<(const ClipboardItem& other) const
 {
     // For sorting: newer items are "less" (come first)
-    return m_timestamp > other.m_timestamp;
+    return m_timestampMs > other.m_timestampMs;
 }
 
-QString ClipboardItem::generatePreview(const QString& text, int maxLength)
+ClipboardItem ClipboardItem::fromFields(const QString& id, const QString& text, const QString& preview,
+                                        qint64 timestampMs, bool pinned, quint64 contentKey,
+                                        const QString& hash, const Payload& payload)
 {
-    if (text.isEmpty()) {
-        return QString();
+    ClipboardItem item;
+    item.m_id = id;
+    item.m_text = text;
+    item.m_preview = preview;
+    item.m_storedHash = hash;
+    item.m_contentKey = contentKey != 0 ? contentKey : generateContentKey(text);
+    item.m_timestampMs = timestampMs;
+    item.m_pinned = pinned;
+    if (!payload.isNull()) {
+        item.m_payload = QSharedPointer<const Payload>::create(payload);
+        if (contentKey == 0) {
+            item.m_contentKey = generateContentKey(payload.key);
+        }
+    }
+    return item;
+}
+
+ClipboardItem ClipboardItem::fromPayload(const Payload& payload, const QString& text,
+                                         const QString& preview)
+{
+    ClipboardItem item;
+    if (payload.isNull() || !validateText(text)) {
+        return item;
     }
     
-    // Remove excessive whitespace and newlines for preview
-    QString cleaned = text.trimmed();
-    cleaned.replace(QRegularExpression("\\s+"), " ");
+    item.m_id = generateId();
+    item.m_text = text;
+    item.m_preview = preview;
+    item.m_timestampMs = QDateTime::currentMSecsSinceEpoch();
+    item.setPayload(payload);
+    return item;
+}
+
+QString ClipboardItem::generatePreview(const QString& text, int maxLength)
+{
+    // Collapse whitespace runs in one pass, stopping as soon as the text is
+    // known not to fit; trailing whitespace is never appended
+    QString preview;
+    preview.reserve(qMin(text.size(), qsizetype(maxLength) + 1));
+    bool pendingSpace = false;
+    for (QChar c : text) {
+        if (c.isSpace()) {
+            pendingSpace = !preview.isEmpty();
+            continue;
+        }
+        if (pendingSpace) {
+            preview.append(QLatin1Char(' '));
+            pendingSpace = false;
+        }
+        preview.append(c);
+        if (preview.size() > maxLength) {
+            break;
+        }
+    }
     
-    if (cleaned.length() <= maxLength) {
-        return cleaned;
+    if (preview.size() <= maxLength) {
+        return preview;
     }
     
     // Truncate and add ellipsis
-    return cleaned.left(maxLength - 3) + "...";
+    preview.truncate(maxLength - 3);
+    preview.append(QLatin1String("..."));
+    return preview;
 }
 
 QString ClipboardItem::generateHash(const QString& text)
@@ -182,19 +366,70 @@ QString ClipboardItem::generateHash(const QString& text)
     return QString(hash.result().toHex());
 }
 
-bool ClipboardItem::validateText(const QString& text)
+quint64 ClipboardItem::generateContentKey(QStringView text)
 {
     if (text.isEmpty()) {
-        return false;
+        return 0;
     }
     
-    // Check if text is only whitespace
-    QString trimmed = text.trimmed();
-    return !trimmed.isEmpty();
+    // Multiply-xorshift over the UTF-16 code units, four at a time
+    const char16_t* data = text.utf16();
+    const qsizetype size = text.size();
+    quint64 key = quint64(size) * KEY_MULTIPLIER;
+    qsizetype i = 0;
+    for (; i + 4 <= size; i += 4) {
+        quint64 chunk = quint64(data[i]) | quint64(data[i + 1]) << 16 |
+                        quint64(data[i + 2]) << 32 | quint64(data[i + 3]) << 48;
+        key = (key ^ mixBits(chunk)) * KEY_MULTIPLIER;
+    }
+    
+    quint64 tail = 0;
+    for (int shift = 0; i < size; ++i, shift += 16) {
+        tail |= quint64(data[i]) << shift;
+    }
+    key = mixBits(key ^ mixBits(tail));
+    
+    // 0 marks items without content
+    return key != 0 ? key : 1;
+}
+
+QString ClipboardItem::generateId()
+{
+    quint64 value = 0;
+    while (value == 0) {
+        value = QRandomGenerator::global()->generate64();
+    }
+    return QString::number(value, 16).rightJustified(16, QLatin1Char('0'));
+}
+
+bool ClipboardItem::validateText(const QString& text)
+{
+    // Reject empty and whitespace-only text without building a trimmed copy
+    return std::any_of(text.begin(), text.end(), [](QChar c) { return !c.isSpace(); });
 }
 
 void ClipboardItem::initializeDerivedFields()
 {
-    m_preview = generatePreview(m_text);
-    m_hash = generateHash(m_text);
+    m_contentKey = generateContentKey(m_text);
+}
+
+void ClipboardItem::setStoredHash(const QString& hash)
+{
+    m_storedHash.clear();
+    if (hash.isEmpty()) {
+        return;
+    }
+    
+    const QString derived = m_payload ? m_payload->key : generateHash(m_text);
+    if (hash != derived) {
+        m_storedHash = hash;
+    }
+}
+
+void ClipboardItem::setPayload(const Payload& payload)
+{
+    m_payload = QSharedPointer<const Payload>::create(payload);
+    
+    // Stand-in texts can repeat, the stored bytes cannot
+    m_contentKey = generateContentKey(payload.key);
 }
@@ -2,10 +2,13 @@
 #define CLIPBOARD_ITEM_H
 
 #include <QString>
+#include <QStringView>
 #include <QDateTime>
-#include <QUuid>
 #include <QJsonObject>
 #include <QCryptographicHash>
+#include <QDataStream>
+#include <QSharedPointer>
+#include <limits>
 
 /**
  * @brief Represents a single clipboard entry with metadata and content
@@ -13,10 +16,44 @@
  * ClipboardItem stores clipboard content along with metadata like timestamps,
  * pin status, and derived fields like preview text and content hash.
  * Items are immutable once created except for the pinned state.
+ *
+ * Previews are derived from the text when asked for, unless one was given
+ * or loaded with the item, so creating and loading items never formats
+ * text that is not displayed.
+ *
+ * Items are kept compact so large histories stay cheap to hold and copy:
+ * IDs are 64-bit random values in hex, implicitly shared by every copy of
+ * the item; duplicate detection uses a 64-bit content key; timestamps are
+ * stored as milliseconds since the epoch. The SHA-256 hash is only
+ * computed when asked for (for export), never kept per item.
+ *
+ * Content that should not live in memory (images, file lists, very long
+ * text) is kept in a BlobStore. Such items hold a Payload reference and a
+ * short searchable stand-in as their text; the payload key also replaces
+ * the text hash.
  */
 class ClipboardItem
 {
 public:
+    /**
+     * @brief Reference to content kept in a BlobStore
+     */
+    struct Payload {
+        QString mimeType;            ///< Format of the stored bytes
+        QString key;                 ///< Blob key (SHA-256 of the bytes, in hex)
+        qint64 size = 0;             ///< Size of the stored bytes
+
+        bool isNull() const { return key.isEmpty(); }
+    };
+    
+    /**
+     * @brief Binary stream layouts understood by readFrom()
+     */
+    enum StreamFormat {
+        StreamWithoutPayload = 2,    ///< Written before payloads existed
+        StreamWithPayload = 3        ///< Current layout
+    };
+    
     /**
      * @brief Default constructor creates an invalid item
      */
@@ -35,28 +72,60 @@ public:
      */
     explicit ClipboardItem(const QJsonObject& json);
     
+    // Copy and move
+    ClipboardItem(const ClipboardItem& other) = default;
+    ClipboardItem(ClipboardItem&& other) noexcept = default;
+    ClipboardItem& operator=(const ClipboardItem& other) = default;
+    ClipboardItem& operator=(ClipboardItem&& other) noexcept = default;
+    ~ClipboardItem() = default;
+    
+    // Accessors
+    const QString& id() const { return m_id; }
+    const QString& text() const { return m_text; }
+    QDateTime timestamp() const;
+    qint64 timestampMs() const { return m_timestampMs; }
+    bool hasTimestamp() const { return m_timestampMs != INVALID_TIMESTAMP; }
+    bool pinned() const { return m_pinned; }
+    quint64 contentKey() const { return m_contentKey; }
+    
     /**
-     * @brief Copy constructor
+     * @brief Get the display preview
+     * @return Stored preview, or one generated from the text on each call
      */
-    ClipboardItem(const ClipboardItem& other);
+    QString preview() const;
     
     /**
-     * @brief Assignment operator
+     * @brief Get the preview given or loaded with this item
+     * @return Stored preview, empty if it is derived from the text
      */
-    ClipboardItem& operator=(const ClipboardItem& other);
+    const QString& storedPreview() const { return m_preview; }
+    
+    bool hasPayload() const { return m_payload != nullptr; }
+    Payload payload() const { return m_payload ? *m_payload : Payload(); }
     
     /**
-     * @brief Destructor
+     * @brief Get the content hash
+     * @return Stored hash for items loaded with one, the payload key for
+     *         payload items, otherwise the SHA-256 of the text (computed on
+     *         each call); empty for invalid items
      */
-    ~ClipboardItem() = default;
+    QString hash() const;
     
-    // Accessors
-    QString id() const { return m_id; }
-    QString text() const { return m_text; }
-    QString preview() const { return m_preview; }
-    QDateTime timestamp() const { return m_timestamp; }
-    bool pinned() const { return m_pinned; }
-    QString hash() const { return m_hash; }
+    /**
+     * @brief Get the hash loaded with this item, if it is not derived from the text
+     * @return Stored hash, usually empty
+     */
+    const QString& storedHash() const { return m_storedHash; }
+    
+    /**
+     * @brief Check if another item holds the same content
+     * @param other Item to compare with
+     * @return true if the content keys match and, when both texts are
+     *         loaded, the texts are equal
+     *
+     * The full comparison only runs when the 64-bit keys collide.
+     */
+    bool sameContent(const ClipboardItem& other) const;
     
     /**
      * @brief Check if this item is valid
@@ -93,7 +162,60 @@ public:
     bool fromJson(const QJsonObject& json);
     
     /**
-     * @brief Compare items for equality (based on content hash)
+     * @brief Serialize to a binary stream
+     * @param out Stream to write to
+     * @param format Layout to write
+     * @return false if the item cannot be represented in format
+     *
+     * Metadata is written ahead of the text so that readers can skip it.
+     */
+    bool writeTo(QDataStream& out, StreamFormat format = StreamWithPayload) const;
+    
+    /**
+     * @brief Load data from a binary stream written by writeTo()
+     * @param in Stream to read from
+     * @param withText false to skip the text and keep metadata only
+     * @param format Layout the data was written in
+     * @return true if the item was read successfully
+     *
+     * Metadata-only items have no text and are therefore not valid items;
+     * they only describe entries whose text lives elsewhere.
+     */
+    bool readFrom(QDataStream& in, bool withText = true, StreamFormat format = StreamWithPayload);
+    
+    /**
+     * @brief Check if the full text is loaded
+     * @return true unless this is a metadata-only item
+     */
+    bool hasText() const { return !m_text.isEmpty(); }
+    
+    /**
+     * @brief Estimate the memory this item holds
+     * @return Bytes of the item itself and the strings it refers to
+     */
+    qint64 memoryUsage() const;
+    
+    /**
+     * @brief Get the size of the content this item stands for
+     * @return Payload size for payload items, otherwise the UTF-8 size of
+     *         the text (0 for metadata-only items)
+     */
+    qint64 contentSize() const;
+    
+    /**
+     * @brief Get the UTF-8 size of text without converting it
+     */
+    static qint64 utf8Size(QStringView text);
+    
+    /**
+     * @brief Copy of this item without its text
+     * @return Metadata-only item keeping id, content key, preview and timestamp;
+     *         the preview is generated first, as it cannot be derived later
+     */
+    ClipboardItem metadata() const;
+    
+    /**
+     * @brief Compare items for equality (based on content)
      * @param other Item to compare with
      * @return true if items have the same content
      */
@@ -113,6 +235,34 @@ public:
      */
     bool operator<(const ClipboardItem& other) const;
     
+    /**
+     * @brief Recreate a stored item from its fields without recomputing them
+     * @param id Stored item ID
+     * @param text Full text content
+     * @param preview Stored preview text (empty to derive it from text)
+     * @param timestampMs When the item was copied, in ms since the epoch
+     * @param pinned Stored pin state
+     * @param contentKey Stored content key (0 to compute it from text)
+     * @param hash Stored content hash, if it is not the SHA-256 of text
+     * @param payload Stored payload reference, if any
+     * @return The item (invalid if the fields do not describe a valid item)
+     */
+    static ClipboardItem fromFields(const QString& id, const QString& text, const QString& preview,
+                                    qint64 timestampMs, bool pinned, quint64 contentKey,
+                                    const QString& hash = QString(),
+                                    const Payload& payload = Payload());
+    
+    /**
+     * @brief Create an item for content stored in a BlobStore
+     * @param payload Reference to the stored content
+     * @param text Searchable stand-in for the content
+     * @param preview Display text (empty to derive it from text)
+     * @return New item with a fresh ID and the current time (invalid if
+     *         the payload or text is empty)
+     */
+    static ClipboardItem fromPayload(const Payload& payload, const QString& text,
+                                     const QString& preview);
+    
     /**
      * @brief Generate preview text from full content
      * @param text Full text content
@@ -128,6 +278,19 @@ public:
      */
     static QString generateHash(const QString& text);
     
+    /**
+     * @brief Generate the 64-bit key used for duplicate detection
+     * @param text Text content to hash
+     * @return Non-zero key, stable across runs and platforms; 0 for empty text
+     */
+    static quint64 generateContentKey(QStringView text);
+    
+    /**
+     * @brief Generate a new unique item ID
+     * @return 64-bit random value as 16 hex digits
+     */
+    static QString generateId();
+    
     /**
      * @brief Validate text content
      * @param text Text to validate
@@ -136,12 +299,26 @@ public:
     static bool validateText(const QString& text);
 
 private:
-    QString m_id;           ///< Unique identifier (UUID)
+    /**
+     * @brief Keep a loaded hash only if it differs from the derived one
+     */
+    void setStoredHash(const QString& hash);
+    
+    /**
+     * @brief Attach a payload reference and key the item by it
+     */
+    void setPayload(const Payload& payload);
+    
+    static constexpr qint64 INVALID_TIMESTAMP = std::numeric_limits<qint64>::min();
+    
+    QString m_id;           ///< Unique identifier (64-bit hex, or a loaded legacy ID)
     QString m_text;         ///< Full clipboard text content
-    QString m_preview;      ///< Truncated display text
-    QDateTime m_timestamp;  ///< When the item was copied
-    bool m_pinned;          ///< Whether item is pinned
-    QString m_hash;         ///< Content hash for duplicate detection
+    QString m_preview;      ///< Stored display text, empty when derived from the text
+    QString m_storedHash;   ///< Loaded hash that is not derived from the text (usually empty)
+    quint64 m_contentKey = 0; ///< Content key for duplicate detection
+    qint64 m_timestampMs = INVALID_TIMESTAMP; ///< When the item was copied
+    bool m_pinned = false;  ///< Whether item is pinned
+    QSharedPointer<const Payload> m_payload; ///< Stored content, null for plain text items
     
     /**
      * @brief Initialize derived fields from text content
@@ -149,4 +326,7 @@ private:
     void initializeDerivedFields();
 };
 
+// Members are all relocatable, so lists can move items with memmove
+Q_DECLARE_TYPEINFO(ClipboardItem, Q_RELOCATABLE_TYPE);
+
 #endif // CLIPBOARD_ITEM_H
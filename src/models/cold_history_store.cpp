@@ -0,0 +1,570 @@
+#include "cold_history_store.h"
+#include "text_codec.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr quint8 RECORD_DEAD = 0;
+constexpr quint8 RECORD_LIVE = 1;
+constexpr quint8 RECORD_DICTIONARY = 2;
+
+// Version 2 records had no payload reference and version 3 records kept
+// their text uncompressed; such files are converted on open
+constexpr quint16 VERSION_2 = 2;
+constexpr quint16 VERSION_3 = 3;
+
+// Long texts contribute only their start to a dictionary, so one large
+// item cannot crowd out the many short ones that benefit most
+constexpr qsizetype MAX_SAMPLE_CHARS = 1024;
+
+// The first dictionary is trained early; later ones replace it periodically
+constexpr qsizetype MIN_TRAINING_BYTES = 8 * 1024;
+
+void prepareStream(QDataStream& stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+}
+
+ClipboardItem::StreamFormat streamFormat(quint16 version)
+{
+    return version == VERSION_2 ? ClipboardItem::StreamWithoutPayload
+                                : ClipboardItem::StreamWithPayload;
+}
+
+// Read the metadata of an item record and the UTF-8 size of its text from
+// a stream over data. Encoded text carries its size up front; text of older
+// versions is read to be measured.
+bool readEntry(QDataStream& in, const QByteArray& data, quint16 version, ClipboardItem& entry,
+               qint64& textBytes)
+{
+    const bool encoded = version != VERSION_2 && version != VERSION_3;
+    if (!entry.readFrom(in, !encoded, streamFormat(version))) {
+        return false;
+    }
+
+    if (!encoded) {
+        textBytes = ClipboardItem::utf8Size(entry.text());
+        entry = entry.metadata();
+        return true;
+    }
+
+    quint32 length = 0;
+    in >> length;
+    const qint64 start = in.device()->pos();
+    if (in.status() != QDataStream::Ok || start > data.size()) {
+        return false;
+    }
+    const qint64 available = qMin(qint64(length), qint64(data.size()) - start);
+    textBytes = TextCodec::decodedSize(QByteArrayView(data).sliced(start, available));
+    return textBytes >= 0;
+}
+
+} // namespace
+
+ColdHistoryStore::ColdHistoryStore(const QString& filePath)
+    : m_filePath(filePath)
+{
+}
+
+ColdHistoryStore::~ColdHistoryStore()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool ColdHistoryStore::open()
+{
+    if (m_file.isOpen()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open cold history segment" << m_filePath << m_file.errorString();
+        return false;
+    }
+
+    if (m_file.size() > 0 && !scanRecords()) {
+        // Keep an unreadable segment (e.g. from another format version) aside
+        qWarning() << "Setting aside unrecognized cold history segment" << m_filePath;
+        m_file.close();
+        QFile::remove(m_filePath + ".bak");
+        if (!QFile::rename(m_filePath, m_filePath + ".bak") || !m_file.open(QIODevice::ReadWrite)) {
+            m_file.close();
+            return false;
+        }
+    }
+
+    if (m_file.size() == 0) {
+        QDataStream out(&m_file);
+        prepareStream(out);
+        out << FILE_MAGIC << FILE_VERSION;
+        return out.status() == QDataStream::Ok;
+    }
+
+    if (m_version != FILE_VERSION) {
+        // Records of the old version are rewritten in the current layout, so
+        // a file never mixes the two
+        if (!compact()) {
+            m_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    compactIfNeeded();
+    return true;
+}
+
+bool ColdHistoryStore::add(const ClipboardItem& item)
+{
+    if (!m_file.isOpen() || !item.isValid() || m_entries.contains(item.id())) {
+        return false;
+    }
+
+    qint64 offset = writeRecord(item);
+    if (offset < 0) {
+        return false;
+    }
+
+    if (m_entries.insert(item, offset) < 0) {
+        // Not indexable; the record is unreachable, so count it as dead
+        removeRecord(offset);
+        return false;
+    }
+
+    trainDictionary(item.text());
+    return true;
+}
+
+ClipboardItem ColdHistoryStore::load(int position) const
+{
+    return readRecord(m_entries.idAt(position), m_entries.tagAt(position));
+}
+
+ClipboardItem ColdHistoryStore::removeAt(int position)
+{
+    const qint64 offset = m_entries.tagAt(position);
+    ClipboardItem entry = m_entries.takeAt(position);
+    removeRecord(offset);
+    return entry;
+}
+
+void ColdHistoryStore::removeRecord(qint64 offset)
+{
+    // Mark the record dead in place; compaction reclaims the space later
+    QDataStream stream(&m_file);
+    prepareStream(stream);
+    quint32 dictionaryId = 0;
+    if (m_file.seek(offset + RECORD_HEADER_SIZE)) {
+        stream >> dictionaryId;
+    }
+
+    markDead(offset);
+    if (dictionaryId != 0) {
+        releaseDictionary(dictionaryId);
+    }
+    compactIfNeeded();
+}
+
+qint64 ColdHistoryStore::markDead(qint64 offset)
+{
+    QDataStream stream(&m_file);
+    prepareStream(stream);
+    quint32 payloadSize = 0;
+    if (m_file.seek(offset + 1)) {
+        stream >> payloadSize;
+    }
+    if (m_file.seek(offset)) {
+        stream << RECORD_DEAD;
+    }
+
+    qint64 recordSize = RECORD_HEADER_SIZE + payloadSize;
+    m_liveBytes -= recordSize;
+    m_deadBytes += recordSize;
+    return recordSize;
+}
+
+void ColdHistoryStore::releaseDictionary(quint32 id, int references)
+{
+    auto dictionary = m_dictionaries.find(id);
+    if (dictionary == m_dictionaries.end()) {
+        return;
+    }
+
+    dictionary->references -= references;
+    if (dictionary->references <= 0 && id != m_dictionaryId) {
+        markDead(dictionary->offset);
+        m_dictionaries.erase(dictionary);
+    }
+}
+
+void ColdHistoryStore::trainDictionary(const QString& text)
+{
+    if (!m_compress || !TextCodec::isCompressionAvailable() || text.isEmpty()) {
+        return;
+    }
+
+    m_samples.append(text.left(MAX_SAMPLE_CHARS).toUtf8());
+    m_sampleBytes += m_samples.last().size();
+    while (m_sampleBytes - m_samples.first().size() >= 2 * TextCodec::MAX_DICTIONARY_SIZE) {
+        m_sampleBytes -= m_samples.takeFirst().size();
+    }
+
+    const bool due = m_dictionaryId == 0 ? m_sampleBytes >= MIN_TRAINING_BYTES
+                                         : m_recordsSinceTraining >= RETRAIN_RECORDS;
+    if (!due) {
+        return;
+    }
+
+    Dictionary dictionary;
+    dictionary.bytes = TextCodec::trainDictionary(m_samples);
+    dictionary.offset = appendRecord(encodeDictionary(m_nextDictionaryId, dictionary.bytes));
+    if (dictionary.offset < 0) {
+        return;
+    }
+
+    // Records already written keep the dictionary they were encoded with
+    const quint32 previous = m_dictionaryId;
+    m_dictionaryId = m_nextDictionaryId++;
+    m_dictionaries.insert(m_dictionaryId, dictionary);
+    m_recordsSinceTraining = 0;
+    releaseDictionary(previous, 0);
+}
+
+void ColdHistoryStore::clear()
+{
+    m_entries.clear();
+    m_liveBytes = 0;
+    m_deadBytes = 0;
+    m_dictionaries.clear();
+    m_dictionaryId = 0;
+    m_nextDictionaryId = 1;
+    m_samples.clear();
+    m_sampleBytes = 0;
+    m_recordsSinceTraining = 0;
+
+    if (m_file.isOpen()) {
+        m_file.resize(HEADER_SIZE);
+    }
+}
+
+ClipboardItem ColdHistoryStore::readRecord(const QString& id, qint64 offset) const
+{
+    if (offset < 0 || !m_file.seek(offset + RECORD_HEADER_SIZE)) {
+        return ClipboardItem();
+    }
+
+    QDataStream in(&m_file);
+    prepareStream(in);
+    ClipboardItem item;
+    bool readable = false;
+    if (m_version == FILE_VERSION) {
+        quint32 dictionaryId = 0;
+        ClipboardItem entry;
+        QByteArray encoded;
+        in >> dictionaryId;
+        readable = entry.readFrom(in, false);
+        in >> encoded;
+
+        QString text;
+        auto dictionary = m_dictionaries.constFind(dictionaryId);
+        readable = readable && in.status() == QDataStream::Ok &&
+                   (dictionaryId == 0 || dictionary != m_dictionaries.constEnd()) &&
+                   TextCodec::decode(encoded, dictionaryId == 0 ? QByteArray() : dictionary->bytes, text);
+        if (readable) {
+            item = ClipboardItem::fromFields(entry.id(), text, entry.preview(), entry.timestampMs(),
+                                             entry.pinned(), entry.contentKey(), entry.storedHash(),
+                                             entry.payload());
+        }
+    } else {
+        readable = item.readFrom(in, true, streamFormat(m_version));
+    }
+
+    if (!readable || item.id() != id) {
+        qWarning() << "Corrupt cold history record for item" << id;
+        return ClipboardItem();
+    }
+    return item;
+}
+
+QByteArray ColdHistoryStore::encodeRecord(const ClipboardItem& item, quint32 dictionaryId) const
+{
+    if (!item.isValid()) {
+        return QByteArray();
+    }
+
+    // The metadata comes first, so scanning can skip the text unread
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        prepareStream(out);
+        out << dictionaryId;
+        if (!item.metadata().writeTo(out, streamFormat(FILE_VERSION))) {
+            return QByteArray();
+        }
+        const QByteArray dictionary = m_dictionaries.value(dictionaryId).bytes;
+        out << TextCodec::encode(item.text(), dictionary, m_compress);
+        if (out.status() != QDataStream::Ok) {
+            return QByteArray();
+        }
+    }
+
+    QByteArray record;
+    {
+        QDataStream out(&record, QIODevice::WriteOnly);
+        prepareStream(out);
+        out << RECORD_LIVE << quint32(payload.size());
+    }
+    record.append(payload);
+    return record;
+}
+
+QByteArray ColdHistoryStore::encodeDictionary(quint32 id, const QByteArray& bytes)
+{
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        prepareStream(out);
+        out << id << bytes;
+    }
+
+    QByteArray record;
+    {
+        QDataStream out(&record, QIODevice::WriteOnly);
+        prepareStream(out);
+        out << RECORD_DICTIONARY << quint32(payload.size());
+    }
+    record.append(payload);
+    return record;
+}
+
+qint64 ColdHistoryStore::writeRecord(const ClipboardItem& item)
+{
+    const quint32 dictionaryId = m_compress ? m_dictionaryId : 0;
+    const qint64 offset = appendRecord(encodeRecord(item, dictionaryId));
+    if (offset >= 0 && dictionaryId != 0) {
+        ++m_dictionaries[dictionaryId].references;
+        ++m_recordsSinceTraining;
+    }
+    return offset;
+}
+
+qint64 ColdHistoryStore::appendRecord(const QByteArray& record)
+{
+    if (record.isEmpty()) {
+        return -1;
+    }
+
+    qint64 offset = m_file.size();
+    if (!m_file.seek(offset) || m_file.write(record) != record.size()) {
+        qWarning() << "Failed to write cold history record" << m_file.errorString();
+        m_file.resize(offset);
+        return -1;
+    }
+
+    m_liveBytes += record.size();
+    return offset;
+}
+
+bool ColdHistoryStore::scanRecords()
+{
+    // Scan through a mapping so skipping over record text costs no reads
+    const qint64 fileSize = m_file.size();
+    uchar* mapped = m_file.map(0, fileSize);
+    if (!mapped) {
+        m_file.seek(0);
+    }
+    const QByteArray data = mapped
+        ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), fileSize)
+        : m_file.readAll();
+    QDataStream in(data);
+    prepareStream(in);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC ||
+        (version != FILE_VERSION && version != VERSION_3 && version != VERSION_2)) {
+        if (mapped) {
+            m_file.unmap(mapped);
+        }
+        return false;
+    }
+
+    m_version = version;
+    struct ScannedEntry {
+        ClipboardItem entry;
+        qint64 offset;
+        qint64 textBytes;
+    };
+    QList<ScannedEntry> entries;
+    QSet<QString> ids;
+    qint64 offset = HEADER_SIZE;
+
+    while (offset + RECORD_HEADER_SIZE <= fileSize) {
+        in.device()->seek(offset);
+        quint8 state = RECORD_DEAD;
+        quint32 payloadSize = 0;
+        in >> state >> payloadSize;
+
+        qint64 recordSize = RECORD_HEADER_SIZE + payloadSize;
+        if (offset + recordSize > fileSize) {
+            break; // Torn write at the tail
+        }
+
+        quint32 dictionaryId = 0;
+        QByteArray dictionary;
+        ClipboardItem entry;
+        qint64 textBytes = 0;
+        if (state == RECORD_DICTIONARY && version == FILE_VERSION) {
+            in >> dictionaryId >> dictionary;
+        } else if (state == RECORD_LIVE && version == FILE_VERSION) {
+            in >> dictionaryId;
+        }
+
+        if (state == RECORD_DICTIONARY && in.status() == QDataStream::Ok && dictionaryId != 0 &&
+            !m_dictionaries.contains(dictionaryId)) {
+            // The newest dictionary stays the one new records are encoded with
+            m_dictionaries.insert(dictionaryId, {dictionary, offset, 0});
+            m_dictionaryId = qMax(m_dictionaryId, dictionaryId);
+            m_liveBytes += recordSize;
+        } else if (state == RECORD_LIVE && readEntry(in, data, version, entry, textBytes) &&
+                   !ids.contains(entry.id())) {
+            ids.insert(entry.id());
+            entries.append({entry, offset, textBytes});
+            m_liveBytes += recordSize;
+            auto used = m_dictionaries.find(dictionaryId);
+            if (used != m_dictionaries.end()) {
+                ++used->references;
+            }
+        } else {
+            m_deadBytes += recordSize;
+        }
+        in.resetStatus();
+        offset += recordSize;
+    }
+
+    if (mapped) {
+        m_file.unmap(mapped);
+    }
+    if (offset < fileSize) {
+        qWarning() << "Truncating incomplete cold history record at" << offset;
+        m_file.resize(offset);
+    }
+
+    // Older dictionaries whose records are all gone are dead already
+    m_nextDictionaryId = m_dictionaryId + 1;
+    for (quint32 id : m_dictionaries.keys()) {
+        releaseDictionary(id, 0);
+    }
+
+    // Records are appended in demotion order, which is mostly newest last.
+    // Indexing oldest first puts every entry at the front.
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.entry.timestampMs() > b.entry.timestampMs();
+    });
+    for (auto it = entries.crbegin(); it != entries.crend(); ++it) {
+        if (m_entries.insert(it->entry, it->offset, it->textBytes) < 0) {
+            qWarning() << "Cannot index cold history record for item" << it->entry.id();
+        }
+    }
+
+    return true;
+}
+
+void ColdHistoryStore::compactIfNeeded()
+{
+    if (m_deadBytes >= COMPACT_MIN_DEAD_BYTES && m_deadBytes > m_liveBytes) {
+        compact();
+    }
+}
+
+bool ColdHistoryStore::compact()
+{
+    QSaveFile out(m_filePath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot compact cold history segment" << out.errorString();
+        return false;
+    }
+
+    {
+        QDataStream header(&out);
+        prepareStream(header);
+        header << FILE_MAGIC << FILE_VERSION;
+    }
+
+    // Dictionaries go first, ahead of every record encoded with them
+    QList<quint32> dictionaryIds = m_dictionaries.keys();
+    std::sort(dictionaryIds.begin(), dictionaryIds.end());
+    QList<qint64> dictionaryOffsets;
+    qint64 liveBytes = 0;
+    for (quint32 id : dictionaryIds) {
+        const QByteArray record = encodeDictionary(id, m_dictionaries.value(id).bytes);
+        dictionaryOffsets.append(out.pos());
+        out.write(record);
+        liveBytes += record.size();
+    }
+
+    // Oldest first, so the rewritten file is already in timestamp order.
+    // Converted records are compressed without a dictionary, as older
+    // versions had none to train from.
+    QList<qint64> offsets(m_entries.count());
+    QDataStream in(&m_file);
+    prepareStream(in);
+    const bool convert = m_version != FILE_VERSION;
+    for (int position = m_entries.count() - 1; position >= 0; --position) {
+        const qint64 offset = m_entries.tagAt(position);
+        QByteArray record;
+        if (convert) {
+            record = encodeRecord(readRecord(m_entries.idAt(position), offset), 0);
+        } else {
+            quint8 state = RECORD_DEAD;
+            quint32 payloadSize = 0;
+            m_file.seek(offset);
+            in >> state >> payloadSize;
+
+            m_file.seek(offset);
+            record = m_file.read(RECORD_HEADER_SIZE + payloadSize);
+        }
+        if (record.isEmpty()) {
+            out.cancelWriting();
+            qWarning() << "Cannot rewrite cold history record for item" << m_entries.idAt(position);
+            return false;
+        }
+        offsets[position] = out.pos();
+        out.write(record);
+        liveBytes += record.size();
+    }
+
+    m_file.close();
+    bool committed = out.commit();
+    if (!committed) {
+        qWarning() << "Failed to compact cold history segment" << out.errorString();
+    }
+
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot reopen cold history segment" << m_file.errorString();
+        return false;
+    }
+
+    if (committed) {
+        for (int position = 0; position < offsets.count(); ++position) {
+            m_entries.setTagAt(position, offsets.at(position));
+        }
+        for (int i = 0; i < dictionaryIds.count(); ++i) {
+            m_dictionaries[dictionaryIds.at(i)].offset = dictionaryOffsets.at(i);
+        }
+        m_liveBytes = liveBytes;
+        m_deadBytes = 0;
+        m_version = FILE_VERSION;
+    }
+    return committed;
+}
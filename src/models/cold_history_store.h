@@ -0,0 +1,262 @@
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include "clipboard_item.h"
+#include "item_arena.h"
+
+/**
+ * @brief On-disk segment holding the older part of the clipboard history
+ *
+ * ColdHistoryStore keeps only item metadata (id, hash, timestamp and
+ * preview) in memory and leaves the full text in an append-only record
+ * file, from which it is read on demand. Removed records are marked dead
+ * in place and reclaimed by compaction once they outweigh the live ones.
+ *
+ * The metadata lives in an ItemArena, so even a large segment costs a few
+ * contiguous allocations rather than several per entry.
+ *
+ * Record text is compressed with TextCodec against a dictionary trained on
+ * recently stored texts. Dictionaries are records of the file themselves;
+ * each item record names the one it was encoded with, and a dictionary is
+ * dropped by compaction once no live record refers to it.
+ *
+ * Entries are kept newest first, like the in-memory history segments.
+ */
+class ColdHistoryStore
+{
+public:
+    /**
+     * @brief Create a store backed by the given file
+     * @param filePath Path of the segment file (created on open if missing)
+     */
+    explicit ColdHistoryStore(const QString& filePath);
+    ~ColdHistoryStore();
+
+    ColdHistoryStore(const ColdHistoryStore&) = delete;
+    ColdHistoryStore& operator=(const ColdHistoryStore&) = delete;
+
+    /**
+     * @brief Open the segment file and index its live records
+     * @return true if the file could be opened or created
+     *
+     * A file in an unrecognized format is renamed to ".bak" and replaced
+     * by an empty segment; a file of the previous version is rewritten in
+     * the current one.
+     */
+    bool open();
+
+    /**
+     * @brief Choose whether records written from now on are compressed
+     * @param enabled false to store text as plain UTF-8
+     *
+     * Existing records stay readable either way. Set before open() to also
+     * govern how records of an older file version are rewritten.
+     */
+    void setCompressionEnabled(bool enabled) { m_compress = enabled; }
+    bool compressionEnabled() const { return m_compress; }
+
+    // Getters
+    QString filePath() const { return m_filePath; }
+    bool isOpen() const { return m_file.isOpen(); }
+    int count() const { return m_entries.count(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+    /**
+     * @brief Get metadata entry at position
+     * @param position Position in the segment (0 = newest)
+     * @return Metadata-only item
+     */
+    ClipboardItem at(int position) const { return m_entries.at(position); }
+
+    /**
+     * @brief Get the ID of the entry at position without materializing it
+     */
+    QString idAt(int position) const { return m_entries.idAt(position); }
+
+    /**
+     * @brief Get the preview of the entry at position without materializing it
+     * @return View valid until the segment changes
+     */
+    QStringView previewAt(int position) const { return m_entries.previewAt(position); }
+
+    /**
+     * @brief Get the timestamp of the entry at position
+     */
+    qint64 timestampAt(int position) const { return m_entries.timestampAt(position); }
+
+    /**
+     * @brief Get the content size of the entry at position without reading it
+     * @return Same as ClipboardItem::contentSize() of the full item
+     */
+    qint64 contentSizeAt(int position) const { return m_entries.contentSizeAt(position); }
+
+    /**
+     * @brief Add the blob keys of all payload entries to a set
+     * @param keys Set to add to
+     */
+    void collectPayloadKeys(QSet<QString>& keys) const { m_entries.collectPayloadKeys(keys); }
+
+    /**
+     * @brief Report the memory held by the metadata index
+     */
+    ItemArena::Usage memoryUsage() const { return m_entries.usage(); }
+
+    /**
+     * @brief Get the size of the segment file
+     * @return Bytes on disk, including dead records not yet compacted
+     */
+    qint64 fileSize() const { return m_file.isOpen() ? m_file.size() : 0; }
+
+    /**
+     * @brief Get position of an entry by item ID
+     * @param id Item ID to find
+     * @return Position in the segment, or -1 if not found
+     */
+    int indexOf(const QString& id) const { return m_entries.indexOf(id); }
+
+    /**
+     * @brief Check if an item is stored in this segment
+     * @param id Item ID to check
+     * @return true if the item exists in this segment
+     */
+    bool contains(const QString& id) const { return m_entries.contains(id); }
+
+    /**
+     * @brief Write item to disk and index its metadata
+     * @param item Fully materialized item to store
+     * @return true if the record was written
+     */
+    bool add(const ClipboardItem& item);
+
+    /**
+     * @brief Read the full item at position from disk
+     * @param position Position in the segment
+     * @return Full item, or an invalid item if the record cannot be read
+     */
+    ClipboardItem load(int position) const;
+
+    /**
+     * @brief Remove the entry at position
+     * @param position Position in the segment
+     * @return Metadata-only copy of the removed entry
+     */
+    ClipboardItem removeAt(int position);
+
+    /**
+     * @brief Remove all entries and truncate the segment file
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Read the full item stored at offset
+     * @param id Expected item ID
+     * @param offset Record offset
+     * @return Full item, or an invalid item if the record cannot be read
+     */
+    ClipboardItem readRecord(const QString& id, qint64 offset) const;
+
+    /**
+     * @brief Mark the record at offset dead and compact if worthwhile
+     */
+    void removeRecord(qint64 offset);
+
+    /**
+     * @brief Encode a live record for item in the current version
+     * @param item Item to encode
+     * @param dictionaryId Dictionary to compress the text with (0 for none)
+     * @return Record bytes, empty if the item cannot be encoded
+     */
+    QByteArray encodeRecord(const ClipboardItem& item, quint32 dictionaryId) const;
+
+    /**
+     * @brief Encode a dictionary record
+     */
+    static QByteArray encodeDictionary(quint32 id, const QByteArray& bytes);
+
+    /**
+     * @brief Append raw record bytes at the end of the file
+     * @return Offset of the record, or -1 on error
+     */
+    qint64 appendRecord(const QByteArray& record);
+
+    /**
+     * @brief Remember text for training and write a new dictionary when due
+     * @param text Text of a stored item
+     */
+    void trainDictionary(const QString& text);
+
+    /**
+     * @brief Drop references to a dictionary
+     * @param id Dictionary ID
+     * @param references Number of references to drop (0 to only check)
+     *
+     * A dictionary that is neither referenced nor the current one is
+     * marked dead.
+     */
+    void releaseDictionary(quint32 id, int references = 1);
+
+    /**
+     * @brief Mark the record at offset dead and account for its size
+     * @return Size of the record
+     */
+    qint64 markDead(qint64 offset);
+
+    /**
+     * @brief Append a record for item at the end of the file
+     * @param item Item to write
+     * @return Offset of the record, or -1 on error
+     */
+    qint64 writeRecord(const ClipboardItem& item);
+
+    /**
+     * @brief Scan the file and index all live records
+     * @return true if the file header is valid
+     */
+    bool scanRecords();
+
+    /**
+     * @brief Rewrite the file without dead records if they dominate
+     */
+    void compactIfNeeded();
+
+    /**
+     * @brief Rewrite the file keeping only live records
+     * @return true if compaction succeeded
+     */
+    bool compact();
+
+    static constexpr quint32 FILE_MAGIC = 0x43484353; // "CHCS"
+    static constexpr quint16 FILE_VERSION = 4;
+    static constexpr qint64 HEADER_SIZE = 6;
+    static constexpr qint64 RECORD_HEADER_SIZE = 5;   // state byte + payload size
+    static constexpr qint64 COMPACT_MIN_DEAD_BYTES = 1024 * 1024;
+    static constexpr int RETRAIN_RECORDS = 4096;      // Records written before a new dictionary
+
+    /**
+     * @brief Compression dictionary stored in the file
+     */
+    struct Dictionary {
+        QByteArray bytes;
+        qint64 offset = -1;      ///< Record offset
+        int references = 0;      ///< Live item records encoded with it
+    };
+
+    QString m_filePath;                    ///< Path of the segment file
+    mutable QFile m_file;                  ///< Open segment file
+    ItemArena m_entries;                   ///< Metadata entries, newest first, tagged with record offsets
+    qint64 m_liveBytes = 0;                ///< Bytes used by live records
+    qint64 m_deadBytes = 0;                ///< Bytes used by removed records
+    quint16 m_version = FILE_VERSION;      ///< Format version of the open file
+    bool m_compress = true;                ///< Compress the text of new records
+    QHash<quint32, Dictionary> m_dictionaries; ///< Dictionaries by ID
+    quint32 m_dictionaryId = 0;            ///< Dictionary for new records (0 = none)
+    quint32 m_nextDictionaryId = 1;        ///< ID for the next trained dictionary
+    QList<QByteArray> m_samples;           ///< Recent texts for training, oldest first
+    qsizetype m_sampleBytes = 0;           ///< Total size of m_samples
+    int m_recordsSinceTraining = 0;        ///< Records written with the current dictionary
+};
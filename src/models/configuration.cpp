@@ -7,19 +7,37 @@
 #include <QDebug>
 #include <QRegularExpression>
 #include <QKeySequence>
+#include <QtConcurrent>
 
 Configuration::Configuration(QObject* parent)
-    : QObject(parent)
-    , m_configPath(defaultConfigPath())
+    : Configuration(defaultConfigPath(), parent)
 {
-    applyDefaults();
 }
 
 Configuration::Configuration(const QString& configPath, QObject* parent)
     : QObject(parent)
     , m_configPath(configPath)
+    , m_updateDepth(0)
+    , m_saveTimer(new QTimer(this))
+    , m_writing(false)
+    , m_writeAgain(false)
 {
     applyDefaults();
+    m_savedState = toJson();
+    
+    m_saveTimer->setObjectName("saveTimer");
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &Configuration::writeAsync);
+    connect(&m_writeWatcher, &QFutureWatcher<bool>::finished,
+            this, &Configuration::onWriteFinished);
+}
+
+Configuration::~Configuration()
+{
+    if (isSavePending()) {
+        flush();
+    }
 }
 
 void Configuration::setMaxHistoryItems(int maxItems)
@@ -27,7 +45,43 @@ void Configuration::setMaxHistoryItems(int maxItems)
     int validatedMax = qBound(MIN_MAX_HISTORY_ITEMS, maxItems, MAX_MAX_HISTORY_ITEMS);
     if (validatedMax != m_maxHistoryItems) {
         m_maxHistoryItems = validatedMax;
-        emit maxHistoryItemsChanged(m_maxHistoryItems);
+        notifyChanged("maxHistoryItems");
+    }
+}
+
+void Configuration::setRetentionDays(int days)
+{
+    int validatedDays = qBound(0, days, MAX_RETENTION_DAYS);
+    if (validatedDays != m_retentionDays) {
+        m_retentionDays = validatedDays;
+        notifyChanged("retentionDays");
+    }
+}
+
+void Configuration::setMaxHistorySizeMb(int sizeMb)
+{
+    int validatedSize = qBound(0, sizeMb, MAX_HISTORY_SIZE_MB);
+    if (validatedSize != m_maxHistorySizeMb) {
+        m_maxHistorySizeMb = validatedSize;
+        notifyChanged("maxHistorySizeMb");
+    }
+}
+
+void Configuration::setMaxItemSizeKb(int sizeKb)
+{
+    int validatedSize = qBound(0, sizeKb, MAX_ITEM_SIZE_KB);
+    if (validatedSize != m_maxItemSizeKb) {
+        m_maxItemSizeKb = validatedSize;
+        notifyChanged("maxItemSizeKb");
+    }
+}
+
+void Configuration::setCaptureDebounceMs(int debounceMs)
+{
+    int validatedDebounce = qBound(0, debounceMs, MAX_CAPTURE_DEBOUNCE_MS);
+    if (validatedDebounce != m_captureDebounceMs) {
+        m_captureDebounceMs = validatedDebounce;
+        notifyChanged("captureDebounceMs");
     }
 }
 
@@ -35,7 +89,7 @@ void Configuration::setHotkey(const QString& hotkey)
 {
     if (isValidHotkey(hotkey) && hotkey != m_hotkey) {
         m_hotkey = hotkey;
-        emit hotkeyChanged(m_hotkey);
+        notifyChanged("hotkey");
     }
 }
 
@@ -43,7 +97,7 @@ void Configuration::setAutostart(bool autostart)
 {
     if (autostart != m_autostart) {
         m_autostart = autostart;
-        emit autostartChanged(m_autostart);
+        notifyChanged("autostart");
     }
 }
 
@@ -51,7 +105,7 @@ void Configuration::setShowNotifications(bool show)
 {
     if (show != m_showNotifications) {
         m_showNotifications = show;
-        emit showNotificationsChanged(m_showNotifications);
+        notifyChanged("showNotifications");
     }
 }
 
@@ -59,7 +113,7 @@ void Configuration::setWindowPosition(const QPoint& position)
 {
     if (position != m_windowPosition) {
         m_windowPosition = position;
-        emit windowPositionChanged(m_windowPosition);
+        notifyChanged("windowPosition");
     }
 }
 
@@ -67,7 +121,7 @@ void Configuration::setWindowSize(const QSize& size)
 {
     if (size != m_windowSize && size.width() > 0 && size.height() > 0) {
         m_windowSize = size;
-        emit windowSizeChanged(m_windowSize);
+        notifyChanged("windowSize");
     }
 }
 
@@ -113,6 +167,7 @@ bool Configuration::load()
 
     bool success = fromJson(json);
     if (success) {
+        m_savedState = toJson();
         emit configurationLoaded();
     }
     return success;
@@ -120,41 +175,189 @@ bool Configuration::load()
 
 bool Configuration::save()
 {
-    if (!ensureConfigDirectory()) {
-        qWarning() << "Failed to create configuration directory";
-        return false;
+    // A background write must not land after this one, nor be followed
+    // by a rewrite started from onWriteFinished()
+    m_saveTimer->stop();
+    m_writeAgain = false;
+    if (m_writing) {
+        m_writeWatcher.waitForFinished();
+        onWriteFinished();
     }
-
-    QJsonDocument doc(toJson());
     
-    // Use QSaveFile for atomic write operations
-    QSaveFile file(m_configPath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open configuration file for writing:" << m_configPath;
+    if (!ensureConfigDirectory()) {
+        qWarning() << "Failed to create configuration directory";
         return false;
     }
 
-    qint64 bytesWritten = file.write(doc.toJson());
-    if (bytesWritten == -1 || !file.commit()) {
-        qWarning() << "Failed to write configuration file:" << file.errorString();
+    QJsonObject state = toJson();
+    if (!writeFile(m_configPath, QJsonDocument(state).toJson())) {
         return false;
     }
 
+    m_savedState = state;
     emit configurationSaved();
     return true;
 }
 
+void Configuration::scheduleSave()
+{
+    m_saveTimer->start();
+}
+
+bool Configuration::flush()
+{
+    // Cancel pending writes first so finishing the running one starts none
+    const bool scheduled = m_saveTimer->isActive() || m_writeAgain;
+    m_saveTimer->stop();
+    m_writeAgain = false;
+    if (m_writing) {
+        m_writeWatcher.waitForFinished();
+        onWriteFinished();
+    }
+    if (isDirty() || (scheduled && !exists())) {
+        return save();
+    }
+    return true;
+}
+
+bool Configuration::isSavePending() const
+{
+    return m_saveTimer->isActive() || m_writing;
+}
+
+bool Configuration::isDirty() const
+{
+    return toJson() != m_savedState;
+}
+
 void Configuration::resetToDefaults()
 {
+    beginUpdate();
     applyDefaults();
+    commitUpdate();
+}
+
+void Configuration::beginUpdate()
+{
+    if (m_updateDepth++ == 0) {
+        m_updateBase = toJson();
+    }
+}
+
+bool Configuration::commitUpdate()
+{
+    if (m_updateDepth == 0) {
+        qWarning() << "Configuration::commitUpdate called without beginUpdate";
+        return false;
+    }
+    if (--m_updateDepth > 0) {
+        return false;
+    }
+    
+    // Values changed and changed back within the batch are not reported
+    const QJsonObject current = toJson();
+    bool changed = false;
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        if (m_updateBase.value(it.key()) != it.value()) {
+            emitChanged(it.key());
+            changed = true;
+        }
+    }
+    m_updateBase = QJsonObject();
+    return changed;
+}
+
+void Configuration::writeAsync()
+{
+    // One write at a time; changes made meanwhile get a write of their own
+    if (m_writing) {
+        m_writeAgain = true;
+        return;
+    }
+    // A missing file is written even with default settings
+    if (!isDirty() && exists()) {
+        return;
+    }
+    if (!ensureConfigDirectory()) {
+        qWarning() << "Failed to create configuration directory";
+        return;
+    }
+    
+    m_writing = true;
+    m_writingState = toJson();
+    const QString filePath = m_configPath;
+    const QByteArray data = QJsonDocument(m_writingState).toJson();
+    m_writeWatcher.setFuture(QtConcurrent::run([filePath, data]() {
+        return writeFile(filePath, data);
+    }));
+}
+
+void Configuration::onWriteFinished()
+{
+    // Also reached through flush() and save() before the watcher reports
+    if (!m_writing) {
+        return;
+    }
     
-    // Emit all change signals
-    emit maxHistoryItemsChanged(m_maxHistoryItems);
-    emit hotkeyChanged(m_hotkey);
-    emit autostartChanged(m_autostart);
-    emit showNotificationsChanged(m_showNotifications);
-    emit windowPositionChanged(m_windowPosition);
-    emit windowSizeChanged(m_windowSize);
+    m_writing = false;
+    if (m_writeWatcher.result()) {
+        m_savedState = m_writingState;
+        emit configurationSaved();
+    }
+    
+    if (m_writeAgain) {
+        m_writeAgain = false;
+        writeAsync();
+    }
+}
+
+void Configuration::notifyChanged(const QString& key)
+{
+    if (m_updateDepth == 0) {
+        emitChanged(key);
+    }
+}
+
+void Configuration::emitChanged(const QString& key)
+{
+    if (key == "maxHistoryItems") {
+        emit maxHistoryItemsChanged(m_maxHistoryItems);
+    } else if (key == "retentionDays") {
+        emit retentionDaysChanged(m_retentionDays);
+    } else if (key == "maxHistorySizeMb") {
+        emit maxHistorySizeMbChanged(m_maxHistorySizeMb);
+    } else if (key == "maxItemSizeKb") {
+        emit maxItemSizeKbChanged(m_maxItemSizeKb);
+    } else if (key == "captureDebounceMs") {
+        emit captureDebounceMsChanged(m_captureDebounceMs);
+    } else if (key == "hotkey") {
+        emit hotkeyChanged(m_hotkey);
+    } else if (key == "autostart") {
+        emit autostartChanged(m_autostart);
+    } else if (key == "showNotifications") {
+        emit showNotificationsChanged(m_showNotifications);
+    } else if (key == "windowPosition") {
+        emit windowPositionChanged(m_windowPosition);
+    } else if (key == "windowSize") {
+        emit windowSizeChanged(m_windowSize);
+    }
+}
+
+bool Configuration::writeFile(const QString& filePath, const QByteArray& data)
+{
+    // Use QSaveFile for atomic write operations
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open configuration file for writing:" << filePath;
+        return false;
+    }
+
+    qint64 bytesWritten = file.write(data);
+    if (bytesWritten == -1 || !file.commit()) {
+        qWarning() << "Failed to write configuration file:" << file.errorString();
+        return false;
+    }
+    return true;
 }
 
 bool Configuration::exists() const
@@ -168,6 +371,10 @@ QJsonObject Configuration::toJson() const
     
     json["version"] = m_version;
     json["maxHistoryItems"] = m_maxHistoryItems;
+    json["retentionDays"] = m_retentionDays;
+    json["maxHistorySizeMb"] = m_maxHistorySizeMb;
+    json["maxItemSizeKb"] = m_maxItemSizeKb;
+    json["captureDebounceMs"] = m_captureDebounceMs;
     json["hotkey"] = m_hotkey;
     json["autostart"] = m_autostart;
     json["showNotifications"] = m_showNotifications;
@@ -194,6 +401,15 @@ bool Configuration::fromJson(const QJsonObject& json)
     int maxItems = json.value("maxHistoryItems").toInt(DEFAULT_MAX_HISTORY_ITEMS);
     m_maxHistoryItems = qBound(MIN_MAX_HISTORY_ITEMS, maxItems, MAX_MAX_HISTORY_ITEMS);
     
+    // Load and validate retention limits (0 = unlimited)
+    m_retentionDays = qBound(0, json.value("retentionDays").toInt(0), MAX_RETENTION_DAYS);
+    m_maxHistorySizeMb = qBound(0, json.value("maxHistorySizeMb").toInt(0), MAX_HISTORY_SIZE_MB);
+    m_maxItemSizeKb = qBound(0, json.value("maxItemSizeKb").toInt(0), MAX_ITEM_SIZE_KB);
+    
+    // Load and validate capture debounce window
+    int debounceMs = json.value("captureDebounceMs").toInt(DEFAULT_CAPTURE_DEBOUNCE_MS);
+    m_captureDebounceMs = qBound(0, debounceMs, MAX_CAPTURE_DEBOUNCE_MS);
+    
     // Load and validate hotkey
     QString hotkey = json.value("hotkey").toString(DEFAULT_HOTKEY);
     m_hotkey = isValidHotkey(hotkey) ? hotkey : DEFAULT_HOTKEY;
@@ -295,6 +511,10 @@ void Configuration::applyDefaults()
 {
     m_version = currentVersion();
     m_maxHistoryItems = DEFAULT_MAX_HISTORY_ITEMS;
+    m_retentionDays = 0;
+    m_maxHistorySizeMb = 0;
+    m_maxItemSizeKb = 0;
+    m_captureDebounceMs = DEFAULT_CAPTURE_DEBOUNCE_MS;
     m_hotkey = DEFAULT_HOTKEY;
     m_autostart = DEFAULT_AUTOSTART;
     m_showNotifications = DEFAULT_SHOW_NOTIFICATIONS;
@@ -306,6 +526,10 @@ void Configuration::validateSettings()
 {
     // Ensure all settings are within valid ranges
     m_maxHistoryItems = qBound(MIN_MAX_HISTORY_ITEMS, m_maxHistoryItems, MAX_MAX_HISTORY_ITEMS);
+    m_captureDebounceMs = qBound(0, m_captureDebounceMs, MAX_CAPTURE_DEBOUNCE_MS);
+    m_retentionDays = qBound(0, m_retentionDays, MAX_RETENTION_DAYS);
+    m_maxHistorySizeMb = qBound(0, m_maxHistorySizeMb, MAX_HISTORY_SIZE_MB);
+    m_maxItemSizeKb = qBound(0, m_maxItemSizeKb, MAX_ITEM_SIZE_KB);
     
     if (!isValidHotkey(m_hotkey)) {
         m_hotkey = DEFAULT_HOTKEY;
@@ -7,6 +7,8 @@
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDir>
+#include <QTimer>
+#include <QFutureWatcher>
 
 /**
  * @brief Manages user preferences and application settings
@@ -16,6 +18,12 @@
  * - Automatic migration between configuration versions
  * - Atomic write operations to prevent corruption
  * - Default values for all settings
+ *
+ * Setters only signal real changes. Between beginUpdate() and commitUpdate()
+ * signals are held back and emitted once per setting that ended up changed.
+ * save() writes immediately; scheduleSave() coalesces repeated requests
+ * into one write on the thread pool, so frequent small changes (a window
+ * being dragged) cost a single file write once they settle.
  */
 class Configuration : public QObject
 {
@@ -33,6 +41,11 @@ public:
      * @param parent Parent QObject
      */
     explicit Configuration(const QString& configPath, QObject* parent = nullptr);
+    
+    /**
+     * @brief Destructor - Writes a scheduled save that has not run yet
+     */
+    ~Configuration() override;
 
     // Version information
     static QString currentVersion() { return "1.0.0"; }
@@ -42,6 +55,35 @@ public:
     int maxHistoryItems() const { return m_maxHistoryItems; }
     void setMaxHistoryItems(int maxItems);
     
+    /**
+     * @brief Get how long unpinned items are kept
+     * @return Maximum age in days (0 keeps items until the count limit evicts them)
+     */
+    int retentionDays() const { return m_retentionDays; }
+    void setRetentionDays(int days);
+    
+    /**
+     * @brief Get the size budget for all unpinned items
+     * @return Budget in MiB (0 for no budget)
+     */
+    int maxHistorySizeMb() const { return m_maxHistorySizeMb; }
+    void setMaxHistorySizeMb(int sizeMb);
+    
+    /**
+     * @brief Get the size above which unpinned items are evicted
+     * @return Limit in KiB (0 for no limit)
+     */
+    int maxItemSizeKb() const { return m_maxItemSizeKb; }
+    void setMaxItemSizeKb(int sizeKb);
+    
+    // Capture settings
+    /**
+     * @brief Get how long clipboard changes are coalesced before capture
+     * @return Debounce window in milliseconds (0 captures every change)
+     */
+    int captureDebounceMs() const { return m_captureDebounceMs; }
+    void setCaptureDebounceMs(int debounceMs);
+    
     // Hotkey settings
     QString hotkey() const { return m_hotkey; }
     void setHotkey(const QString& hotkey);
@@ -79,10 +121,58 @@ public:
      */
     bool save();
     
+    /**
+     * @brief Save once changes have settled
+     *
+     * Requests within SAVE_DELAY_MS of each other coalesce into one atomic
+     * write on the thread pool; configurationSaved() is emitted when it lands.
+     * Nothing is written if the file already holds the current settings.
+     */
+    void scheduleSave();
+    
+    /**
+     * @brief Complete any scheduled or running save now
+     * @return true if the file holds the current settings
+     */
+    bool flush();
+    
+    /**
+     * @brief Check if a scheduled save has not completed yet
+     */
+    bool isSavePending() const;
+    
+    /**
+     * @brief Check if settings changed since they were last loaded or saved
+     */
+    bool isDirty() const;
+    
     /**
      * @brief Reset all settings to defaults
      */
     void resetToDefaults();
+
+    // Batched updates
+    /**
+     * @brief Start a batch of setter calls
+     *
+     * Change signals are held back until the matching commitUpdate().
+     * Batches nest; only the outermost commit emits.
+     */
+    void beginUpdate();
+    
+    /**
+     * @brief End a batch started by beginUpdate()
+     * @return true if the outermost batch changed any setting
+     *
+     * Emits one change signal per setting whose value differs from the one
+     * it had when the batch began.
+     */
+    bool commitUpdate();
+    
+    /**
+     * @brief Check if a batch is open
+     */
+    bool isUpdating() const { return m_updateDepth > 0; }
     
     /**
      * @brief Check if configuration file exists
@@ -118,6 +208,16 @@ public:
      * @return true if value is valid
      */
     static bool isValidMaxHistoryItems(int maxItems);
+    
+    /**
+     * @brief Smallest accepted max history items value
+     */
+    static int minHistoryLimit() { return MIN_MAX_HISTORY_ITEMS; }
+    
+    /**
+     * @brief Largest accepted max history items value
+     */
+    static int maxHistoryLimit() { return MAX_MAX_HISTORY_ITEMS; }
 
 signals:
     /**
@@ -126,6 +226,30 @@ signals:
      */
     void maxHistoryItemsChanged(int maxItems);
     
+    /**
+     * @brief Emitted when the retention age changes
+     * @param days New maximum age in days
+     */
+    void retentionDaysChanged(int days);
+    
+    /**
+     * @brief Emitted when the history size budget changes
+     * @param sizeMb New budget in MiB
+     */
+    void maxHistorySizeMbChanged(int sizeMb);
+    
+    /**
+     * @brief Emitted when the item size limit changes
+     * @param sizeKb New limit in KiB
+     */
+    void maxItemSizeKbChanged(int sizeKb);
+    
+    /**
+     * @brief Emitted when capture debounce window changes
+     * @param debounceMs New debounce window in milliseconds
+     */
+    void captureDebounceMsChanged(int debounceMs);
+    
     /**
      * @brief Emitted when hotkey setting changes
      * @param hotkey New hotkey string
@@ -166,7 +290,41 @@ signals:
      */
     void configurationSaved();
 
+private slots:
+    /**
+     * @brief Serialize the settings and write them on the thread pool
+     * Called when the save timer fires
+     */
+    void writeAsync();
+    
+    /**
+     * @brief Record the result of a background write
+     */
+    void onWriteFinished();
+
 private:
+    /**
+     * @brief Emit the change signal of a setting, unless a batch is open
+     * @param key JSON key of the setting
+     */
+    void notifyChanged(const QString& key);
+    
+    /**
+     * @brief Emit the change signal of a setting
+     * @param key JSON key of the setting
+     */
+    void emitChanged(const QString& key);
+    
+    /**
+     * @brief Write serialized settings atomically
+     * @param filePath Configuration file
+     * @param data JSON document bytes
+     * @return true if the file was committed
+     *
+     * Safe to call from any thread.
+     */
+    static bool writeFile(const QString& filePath, const QByteArray& data);
+    
     /**
      * @brief Ensure configuration directory exists
      * @return true if directory exists or was created
@@ -193,7 +351,12 @@ private:
     // Default values
     static constexpr int DEFAULT_MAX_HISTORY_ITEMS = 50;
     static constexpr int MIN_MAX_HISTORY_ITEMS = 10;
-    static constexpr int MAX_MAX_HISTORY_ITEMS = 100;
+    static constexpr int MAX_MAX_HISTORY_ITEMS = 100000;
+    static constexpr int MAX_RETENTION_DAYS = 3650;
+    static constexpr int MAX_HISTORY_SIZE_MB = 100 * 1024;
+    static constexpr int MAX_ITEM_SIZE_KB = 64 * 1024;
+    static constexpr int DEFAULT_CAPTURE_DEBOUNCE_MS = 15;
+    static constexpr int MAX_CAPTURE_DEBOUNCE_MS = 1000;
     static constexpr const char* DEFAULT_HOTKEY = "Meta+V";
     static constexpr bool DEFAULT_AUTOSTART = false;
     static constexpr bool DEFAULT_SHOW_NOTIFICATIONS = true;
@@ -201,10 +364,15 @@ private:
     static constexpr int DEFAULT_WINDOW_HEIGHT = 600;
     static constexpr int DEFAULT_WINDOW_X = 100;
     static constexpr int DEFAULT_WINDOW_Y = 100;
+    static constexpr int SAVE_DELAY_MS = 500;
 
     // Configuration values
     QString m_version;                 ///< Configuration format version
     int m_maxHistoryItems;             ///< Maximum items in history
+    int m_retentionDays;               ///< Maximum age of unpinned items (0 = unlimited)
+    int m_maxHistorySizeMb;            ///< Size budget of unpinned items (0 = unlimited)
+    int m_maxItemSizeKb;               ///< Size limit per unpinned item (0 = unlimited)
+    int m_captureDebounceMs;           ///< Clipboard change coalescing window
     QString m_hotkey;                  ///< Global hotkey combination
     bool m_autostart;                  ///< Start with system
     bool m_showNotifications;          ///< Show tray notifications
@@ -213,4 +381,16 @@ private:
 
     // File system
     QString m_configPath;              ///< Path to configuration file
+    
+    // Change tracking
+    int m_updateDepth;                 ///< Open beginUpdate() batches
+    QJsonObject m_updateBase;          ///< Settings when the outermost batch began
+    QJsonObject m_savedState;          ///< Settings last loaded or written
+    
+    // Deferred saves
+    QTimer* m_saveTimer;               ///< Coalesces scheduleSave() requests
+    QFutureWatcher<bool> m_writeWatcher; ///< Running background write
+    QJsonObject m_writingState;        ///< Settings being written
+    bool m_writing;                    ///< Background write not yet recorded
+    bool m_writeAgain;                 ///< Changed while a write was running
 };
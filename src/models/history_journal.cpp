@@ -0,0 +1,239 @@
+#include "history_journal.h"
+#include "clipboard_history.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSignalBlocker>
+
+HistoryJournal::HistoryJournal(const QString& filePath)
+    : m_filePath(filePath)
+{
+}
+
+HistoryJournal::~HistoryJournal()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void HistoryJournal::setFilePath(const QString& filePath)
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_filePath = filePath;
+    m_recordCount = 0;
+}
+
+bool HistoryJournal::recordAdded(const ClipboardItem& item)
+{
+    QJsonObject record;
+    record["op"] = "add";
+    record["item"] = item.toJson();
+    return append(record);
+}
+
+bool HistoryJournal::recordPinned(const QString& id)
+{
+    QJsonObject record;
+    record["op"] = "pin";
+    record["id"] = id;
+    return append(record);
+}
+
+bool HistoryJournal::recordUnpinned(const QString& id)
+{
+    QJsonObject record;
+    record["op"] = "unpin";
+    record["id"] = id;
+    return append(record);
+}
+
+bool HistoryJournal::recordRemoved(const QString& id)
+{
+    QJsonObject record;
+    record["op"] = "remove";
+    record["id"] = id;
+    return append(record);
+}
+
+bool HistoryJournal::recordRemoved(const QStringList& ids)
+{
+    QJsonObject record;
+    record["op"] = "remove";
+    record["ids"] = QJsonArray::fromStringList(ids);
+    return append(record);
+}
+
+int HistoryJournal::replay(ClipboardHistory& history)
+{
+    QSignalBlocker blocker(&history);
+    int lines = 0;
+    int applied = replayFile(pendingFilePath(), history, &lines);
+    applied += replayFile(m_filePath, history, &lines);
+
+    m_recordCount = lines;
+    return applied;
+}
+
+bool HistoryJournal::beginCompaction()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_recordCount = 0;
+
+    QFile current(m_filePath);
+    if (!current.exists()) {
+        return true;
+    }
+
+    QString pendingPath = pendingFilePath();
+    if (!QFile::exists(pendingPath)) {
+        return current.rename(pendingPath);
+    }
+
+    // A previous compaction failed; its records are still needed too
+    QFile pending(pendingPath);
+    if (!current.open(QIODevice::ReadOnly) ||
+        !pending.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot merge history journals" << pending.errorString();
+        return false;
+    }
+    QByteArray records = current.readAll();
+    if (pending.write(records) != records.size() || !pending.flush()) {
+        return false;
+    }
+    current.close();
+    return current.remove();
+}
+
+void HistoryJournal::finishCompaction(bool snapshotWritten)
+{
+    // On failure the pending records stay and are replayed with the journal
+    if (snapshotWritten) {
+        QFile::remove(pendingFilePath());
+    }
+}
+
+int HistoryJournal::replayFile(const QString& filePath, ClipboardHistory& history, int* lines)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    int applied = 0;
+    qint64 validSize = 0;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) {
+            qWarning() << "Ignoring incomplete journal record in" << filePath;
+            break;
+        }
+
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            qWarning() << "Ignoring corrupt journal record in" << filePath;
+            break;
+        }
+
+        ++*lines;
+        validSize = file.pos();
+        if (applyRecord(doc.object(), history)) {
+            ++applied;
+        }
+    }
+
+    // Drop a torn tail so new records are not appended after garbage
+    if (validSize < file.size()) {
+        file.close();
+        QFile::resize(filePath, validSize);
+    }
+
+    return applied;
+}
+
+bool HistoryJournal::reset()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_recordCount = 0;
+
+    QFile::remove(pendingFilePath());
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        return true;
+    }
+    return file.resize(0);
+}
+
+bool HistoryJournal::append(const QJsonObject& record)
+{
+    if (m_filePath.isEmpty()) {
+        return false;
+    }
+
+    if (!m_file.isOpen()) {
+        QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+        m_file.setFileName(m_filePath);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "Cannot open history journal" << m_filePath << m_file.errorString();
+            return false;
+        }
+    }
+
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    // Flush each record so a crash loses at most the change in flight
+    if (m_file.write(line) != line.size() || !m_file.flush()) {
+        qWarning() << "Failed to append history journal record" << m_file.errorString();
+        return false;
+    }
+
+    ++m_recordCount;
+    return true;
+}
+
+bool HistoryJournal::applyRecord(const QJsonObject& record, ClipboardHistory& history)
+{
+    const QString op = record.value("op").toString();
+    if (op == "add") {
+        ClipboardItem item(record.value("item").toObject());
+        if (!item.isValid()) {
+            return false;
+        }
+        history.restoreItem(item);
+        return true;
+    }
+
+    if (op == "remove" && record.contains("ids")) {
+        // Batched eviction or clear; clearAll() includes pinned items
+        for (const QJsonValue& value : record.value("ids").toArray()) {
+            const QString id = value.toString();
+            history.unpinItem(id);
+            history.removeItem(id);
+        }
+        return true;
+    }
+
+    const QString id = record.value("id").toString();
+    if (op == "pin") {
+        history.pinItem(id);
+    } else if (op == "unpin") {
+        history.unpinItem(id);
+    } else if (op == "remove") {
+        // Removal is recorded for pinned items too (clearAll)
+        history.unpinItem(id);
+        history.removeItem(id);
+    } else {
+        return false;
+    }
+    return true;
+}
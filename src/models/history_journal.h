@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QFile>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include "clipboard_item.h"
+
+class ClipboardHistory;
+
+/**
+ * @brief Append-only log of history changes made since the last snapshot
+ *
+ * Every add, pin, unpin and remove is written as one compact JSON line, so
+ * persisting a change costs a single small append instead of rewriting the
+ * whole history. Loading replays the journal on top of the last snapshot;
+ * compaction writes a new snapshot and resets the journal.
+ *
+ * Records are idempotent, so replaying a journal over a snapshot that
+ * already contains some of its changes yields the same history.
+ */
+class HistoryJournal
+{
+public:
+    /**
+     * @brief Create a journal backed by the given file
+     * @param filePath Path of the journal file (created on first append)
+     */
+    explicit HistoryJournal(const QString& filePath = QString());
+    ~HistoryJournal();
+
+    HistoryJournal(const HistoryJournal&) = delete;
+    HistoryJournal& operator=(const HistoryJournal&) = delete;
+
+    // Getters
+    QString filePath() const { return m_filePath; }
+    int recordCount() const { return m_recordCount; }
+    bool isEmpty() const { return m_recordCount == 0; }
+
+    /**
+     * @brief Change the journal file, closing the current one
+     * @param filePath New journal file path
+     */
+    void setFilePath(const QString& filePath);
+
+    // Recording
+    bool recordAdded(const ClipboardItem& item);
+    bool recordPinned(const QString& id);
+    bool recordUnpinned(const QString& id);
+    bool recordRemoved(const QString& id);
+
+    /**
+     * @brief Record the removal of several items as one record
+     * @param ids IDs of the removed items
+     */
+    bool recordRemoved(const QStringList& ids);
+
+    /**
+     * @brief Apply all journal records to history
+     * @param history History already loaded from the last snapshot
+     * @return Number of records applied
+     *
+     * Records set aside by an unfinished compaction are replayed first.
+     * History signals are blocked while replaying. A torn record at the
+     * end of a file (from a crash mid-append) ends that file's replay.
+     */
+    int replay(ClipboardHistory& history);
+
+    /**
+     * @brief Discard all records once they are folded into a snapshot
+     * @return true if the journal file was truncated
+     */
+    bool reset();
+
+    /**
+     * @brief Set the current records aside before a snapshot is written
+     * @return true if the records were moved to the pending file
+     *
+     * Records appended afterwards go to a fresh journal, so changes made
+     * while the snapshot is being written are never discarded with it.
+     */
+    bool beginCompaction();
+
+    /**
+     * @brief Complete a compaction started with beginCompaction()
+     * @param snapshotWritten true if the snapshot now holds the pending records
+     */
+    void finishCompaction(bool snapshotWritten);
+
+private:
+    /**
+     * @brief Append one record line to the journal file
+     * @param record Record to append
+     * @return true if the record was written
+     */
+    bool append(const QJsonObject& record);
+
+    /**
+     * @brief Path of the records set aside by beginCompaction()
+     */
+    QString pendingFilePath() const { return m_filePath + ".pending"; }
+
+    /**
+     * @brief Apply the records of one journal file
+     * @param lines Incremented for every complete record
+     * @return Number of records applied
+     */
+    static int replayFile(const QString& filePath, ClipboardHistory& history, int* lines);
+
+    /**
+     * @brief Apply a single record to history
+     * @return true if the record was recognized
+     */
+    static bool applyRecord(const QJsonObject& record, ClipboardHistory& history);
+
+    QString m_filePath;    ///< Path of the journal file
+    QFile m_file;          ///< Journal file, opened for appending on demand
+    int m_recordCount = 0; ///< Records since the last reset
+};
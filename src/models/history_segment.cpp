@@ -0,0 +1,91 @@
+#include "history_segment.h"
+#include <algorithm>
+
+int HistorySegment::indexOf(const QString& id) const
+{
+    auto ordinal = m_ordinals.constFind(id);
+    if (ordinal == m_ordinals.constEnd()) {
+        return -1;
+    }
+    return int(m_base - ordinal.value());
+}
+
+int HistorySegment::insert(const ClipboardItem& item)
+{
+    int position = insertionPosition(item);
+    int count = m_items.count();
+
+    if (position < count - position) {
+        // Keep the newer items in place by moving the origin up
+        ++m_base;
+        shiftOrdinals(0, position, 1);
+    } else {
+        // Push the older items one position further from the origin
+        shiftOrdinals(position, count, -1);
+    }
+
+    m_items.insert(position, item);
+    m_ordinals.insert(item.id(), m_base - position);
+    return position;
+}
+
+void HistorySegment::append(const ClipboardItem& item)
+{
+    m_ordinals.insert(item.id(), m_base - m_items.count());
+    m_items.append(item);
+}
+
+ClipboardItem HistorySegment::takeAt(int position)
+{
+    ClipboardItem item = m_items.takeAt(position);
+    m_ordinals.remove(item.id());
+
+    int count = m_items.count();
+    if (position < count - position) {
+        // Newer items stay put relative to the lowered origin
+        --m_base;
+        shiftOrdinals(0, position, -1);
+    } else {
+        // Older items move one position closer to the origin
+        shiftOrdinals(position, count, 1);
+    }
+
+    return item;
+}
+
+ClipboardItem HistorySegment::takeLast()
+{
+    ClipboardItem item = m_items.takeLast();
+    m_ordinals.remove(item.id());
+    return item;
+}
+
+void HistorySegment::clear()
+{
+    m_items.clear();
+    m_ordinals.clear();
+    m_base = 0;
+}
+
+int HistorySegment::insertionPosition(const ClipboardItem& item) const
+{
+    const qint64 timestamp = item.timestampMs();
+
+    // Fast path: new clipboard content is always the newest
+    if (m_items.isEmpty() || m_items.first().timestampMs() <= timestamp) {
+        return 0;
+    }
+
+    auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), timestamp,
+                               [](const ClipboardItem& existing, qint64 value) {
+                                   return existing.timestampMs() > value;
+                               });
+    return int(it - m_items.cbegin());
+}
+
+void HistorySegment::shiftOrdinals(int from, int to, qint64 delta)
+{
+    for (int i = from; i < to; ++i) {
+        m_ordinals[m_items.at(i).id()] += delta;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QList>
+#include <QHash>
+#include <QString>
+#include "clipboard_item.h"
+
+/**
+ * @brief Timestamp-ordered run of clipboard items with O(1) id lookup
+ *
+ * HistorySegment keeps items newest first and maps each item ID to an
+ * ordinal from which its position is derived. Prepending the newest item
+ * or dropping the oldest one never touches the index, and inserting or
+ * removing in the middle only renumbers the shorter side of the split.
+ */
+class HistorySegment
+{
+public:
+    HistorySegment() = default;
+
+    // Getters
+    int count() const { return m_items.count(); }
+    bool isEmpty() const { return m_items.isEmpty(); }
+
+    /**
+     * @brief Get all items of the segment, newest first
+     * @return Implicitly shared list of items
+     */
+    const QList<ClipboardItem>& items() const { return m_items; }
+
+    /**
+     * @brief Get item at position
+     * @param position Position in the segment (0 = newest)
+     * @return Reference to the item
+     */
+    const ClipboardItem& at(int position) const { return m_items.at(position); }
+
+    /**
+     * @brief Get position of an item by ID
+     * @param id Item ID to find
+     * @return Position in the segment, or -1 if not found
+     */
+    int indexOf(const QString& id) const;
+
+    /**
+     * @brief Check if item with ID is part of this segment
+     * @param id Item ID to check
+     * @return true if item exists in this segment
+     */
+    bool contains(const QString& id) const { return m_ordinals.contains(id); }
+
+    // Mutation
+    /**
+     * @brief Insert item at its timestamp position
+     * @param item Item to insert
+     * @return Position the item was inserted at
+     *
+     * Items newer than or as new as the current head are prepended in O(1).
+     */
+    int insert(const ClipboardItem& item);
+
+    /**
+     * @brief Append item as the oldest entry (for pre-sorted bulk loads)
+     * @param item Item to append
+     */
+    void append(const ClipboardItem& item);
+
+    /**
+     * @brief Remove and return the item at position
+     * @param position Position in the segment
+     * @return The removed item
+     */
+    ClipboardItem takeAt(int position);
+
+    /**
+     * @brief Remove and return the oldest item
+     * @return The removed item
+     */
+    ClipboardItem takeLast();
+
+    /**
+     * @brief Remove all items
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Find insertion position that keeps newest-first order
+     * @param item Item being inserted
+     * @return Position before all items that are not newer than item
+     */
+    int insertionPosition(const ClipboardItem& item) const;
+
+    /**
+     * @brief Add delta to the ordinals of items in [from, to)
+     */
+    void shiftOrdinals(int from, int to, qint64 delta);
+
+    QList<ClipboardItem> m_items;          ///< Items, newest first
+    QHash<QString, qint64> m_ordinals;     ///< Item ID -> ordinal (position = m_base - ordinal)
+    qint64 m_base = 0;                     ///< Ordinal of the item at position 0
+};
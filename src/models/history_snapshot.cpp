@@ -0,0 +1,228 @@
+#include "history_snapshot.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <limits>
+
+namespace {
+
+// Record field offsets
+constexpr int RECORD_TIMESTAMP = 0;
+constexpr int RECORD_FLAGS = 8;
+constexpr int RECORD_CONTENT_KEY = 16;
+constexpr int RECORD_ID = 24;
+constexpr int RECORD_HASH = 32;
+constexpr int RECORD_PREVIEW = 40;
+constexpr int RECORD_TEXT = 48;
+constexpr int RECORD_PAYLOAD_TYPE = 56;
+constexpr int RECORD_PAYLOAD_KEY = 64;
+constexpr int RECORD_PAYLOAD_SIZE = 72;
+
+// Version 1 records had no content key and always stored the SHA-256 hash
+constexpr quint16 VERSION_1 = 1;
+constexpr qint64 VERSION_1_RECORD_SIZE = 48;
+constexpr int VERSION_1_SHIFT = 8;
+
+// Version 2 records ended before the payload reference
+constexpr quint16 VERSION_2 = 2;
+constexpr qint64 VERSION_2_RECORD_SIZE = 56;
+
+/**
+ * @brief Append text to the blob as little-endian UTF-16 and store its reference
+ */
+bool appendString(QByteArray& blob, uchar* ref, const QString& text)
+{
+    quint64 offset = quint64(blob.size()) / 2;
+    if (offset + quint64(text.size()) > std::numeric_limits<quint32>::max()) {
+        return false;
+    }
+
+    qToLittleEndian<quint32>(quint32(offset), ref);
+    qToLittleEndian<quint32>(quint32(text.size()), ref + 4);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    blob.append(reinterpret_cast<const char*>(text.utf16()), text.size() * 2);
+#else
+    qsizetype start = blob.size();
+    blob.resize(start + text.size() * 2);
+    qToLittleEndian<quint16>(text.utf16(), text.size(), blob.data() + start);
+#endif
+    return true;
+}
+
+} // namespace
+
+HistorySnapshot::HistorySnapshot(const QString& filePath)
+    : m_file(filePath)
+{
+}
+
+HistorySnapshot::~HistorySnapshot()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+bool HistorySnapshot::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < HEADER_SIZE) {
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "Cannot map history snapshot" << m_file.fileName();
+        return false;
+    }
+
+    quint32 magic = qFromLittleEndian<quint32>(m_data);
+    quint16 version = qFromLittleEndian<quint16>(m_data + 4);
+    quint32 maxItems = qFromLittleEndian<quint32>(m_data + 8);
+    quint32 count = qFromLittleEndian<quint32>(m_data + 12);
+    quint64 stringsOffset = qFromLittleEndian<quint64>(m_data + 16);
+    quint64 stringCount = qFromLittleEndian<quint64>(m_data + 24);
+
+    m_recordSize = version == VERSION_1 ? VERSION_1_RECORD_SIZE
+                 : version == VERSION_2 ? VERSION_2_RECORD_SIZE
+                                        : RECORD_SIZE;
+    bool valid = magic == FILE_MAGIC &&
+                 (version == FILE_VERSION || version == VERSION_2 || version == VERSION_1) &&
+                 count <= quint32(std::numeric_limits<int>::max()) &&
+                 stringsOffset == quint64(HEADER_SIZE + m_recordSize * qint64(count)) &&
+                 stringCount <= quint64(m_size) &&
+                 stringsOffset + stringCount * 2 <= quint64(m_size);
+    if (!valid) {
+        qWarning() << "Unrecognized history snapshot" << m_file.fileName();
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+        return false;
+    }
+
+    m_version = version;
+    m_maxItems = int(maxItems);
+    m_count = int(count);
+    m_records = m_data + HEADER_SIZE;
+    m_strings = reinterpret_cast<const QChar*>(m_data + stringsOffset);
+    m_stringCount = stringCount;
+    return true;
+}
+
+ClipboardItem HistorySnapshot::itemAt(int index) const
+{
+    if (!m_data || index < 0 || index >= m_count) {
+        return ClipboardItem();
+    }
+
+    const uchar* record = m_records + qint64(index) * m_recordSize;
+    const bool version1 = m_version == VERSION_1;
+    const int shift = version1 ? VERSION_1_SHIFT : 0;
+    bool ok = true;
+    QString id = stringAt(record + RECORD_ID - shift, &ok);
+    QString hash = stringAt(record + RECORD_HASH - shift, &ok);
+    QString preview = stringAt(record + RECORD_PREVIEW - shift, &ok);
+    QString text = stringAt(record + RECORD_TEXT - shift, &ok);
+    ClipboardItem::Payload payload;
+    if (m_version >= FILE_VERSION) {
+        payload.mimeType = stringAt(record + RECORD_PAYLOAD_TYPE, &ok);
+        payload.key = stringAt(record + RECORD_PAYLOAD_KEY, &ok);
+        payload.size = qFromLittleEndian<qint64>(record + RECORD_PAYLOAD_SIZE);
+    }
+    if (!ok) {
+        return ClipboardItem();
+    }
+
+    qint64 timestampMs = qFromLittleEndian<qint64>(record + RECORD_TIMESTAMP);
+    quint32 flags = qFromLittleEndian<quint32>(record + RECORD_FLAGS);
+    quint64 contentKey = version1 ? 0 : qFromLittleEndian<quint64>(record + RECORD_CONTENT_KEY);
+    if (version1 && hash == ClipboardItem::generateHash(text)) {
+        hash.clear();
+    }
+    return ClipboardItem::fromFields(id, text, preview, timestampMs, flags & FLAG_PINNED,
+                                     contentKey, hash, payload);
+}
+
+QString HistorySnapshot::stringAt(const uchar* ref, bool* ok) const
+{
+    quint64 offset = qFromLittleEndian<quint32>(ref);
+    quint64 length = qFromLittleEndian<quint32>(ref + 4);
+    if (offset + length > m_stringCount) {
+        *ok = false;
+        return QString();
+    }
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return QString(m_strings + offset, qsizetype(length));
+#else
+    QString result(qsizetype(length), Qt::Uninitialized);
+    qFromLittleEndian<quint16>(m_strings + offset, qsizetype(length), result.data());
+    return result;
+#endif
+}
+
+bool HistorySnapshot::write(const QString& filePath, int maxItems, const QList<ClipboardItem>& items)
+{
+    QByteArray table(RECORD_SIZE * items.size(), '\0');
+    QByteArray blob;
+    for (int i = 0; i < items.size(); ++i) {
+        const ClipboardItem& item = items.at(i);
+        uchar* record = reinterpret_cast<uchar*>(table.data()) + qint64(i) * RECORD_SIZE;
+        qToLittleEndian<qint64>(item.timestampMs(), record + RECORD_TIMESTAMP);
+        qToLittleEndian<quint32>(item.pinned() ? FLAG_PINNED : 0, record + RECORD_FLAGS);
+        qToLittleEndian<quint64>(item.contentKey(), record + RECORD_CONTENT_KEY);
+
+        const ClipboardItem::Payload payload = item.payload();
+        qToLittleEndian<qint64>(payload.size, record + RECORD_PAYLOAD_SIZE);
+        bool ok = appendString(blob, record + RECORD_ID, item.id()) &&
+                  appendString(blob, record + RECORD_HASH, item.storedHash()) &&
+                  appendString(blob, record + RECORD_PREVIEW, item.storedPreview()) &&
+                  appendString(blob, record + RECORD_TEXT, item.text()) &&
+                  appendString(blob, record + RECORD_PAYLOAD_TYPE, payload.mimeType) &&
+                  appendString(blob, record + RECORD_PAYLOAD_KEY, payload.key);
+        if (!ok) {
+            qWarning() << "History too large for snapshot format";
+            return false;
+        }
+    }
+
+    uchar header[HEADER_SIZE] = {};
+    qToLittleEndian<quint32>(FILE_MAGIC, header);
+    qToLittleEndian<quint16>(FILE_VERSION, header + 4);
+    qToLittleEndian<quint32>(quint32(qMax(0, maxItems)), header + 8);
+    qToLittleEndian<quint32>(quint32(items.size()), header + 12);
+    qToLittleEndian<quint64>(quint64(HEADER_SIZE + table.size()), header + 16);
+    qToLittleEndian<quint64>(quint64(blob.size() / 2), header + 24);
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    bool written = file.write(reinterpret_cast<const char*>(header), HEADER_SIZE) == HEADER_SIZE &&
+                   file.write(table) == table.size() &&
+                   file.write(blob) == blob.size();
+    if (!written) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool HistorySnapshot::isSnapshotFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray magic = file.read(4);
+    return magic.size() == 4 && qFromLittleEndian<quint32>(magic.constData()) == FILE_MAGIC;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include "clipboard_item.h"
+
+/**
+ * @brief Versioned binary snapshot of the history, read through mmap
+ *
+ * The file starts with a fixed header followed by a table of fixed-size
+ * records, one per item, and a UTF-16 string blob that the records point
+ * into. Opening a snapshot only maps the file and validates the header;
+ * items are built from the mapped records when asked for, without any
+ * parsing beyond copying their strings out of the blob.
+ *
+ * All integers are little-endian. Version 1 files, which stored the
+ * SHA-256 hash instead of the content key, and version 2 files, which had
+ * no payload references, can still be read.
+ */
+class HistorySnapshot
+{
+public:
+    /**
+     * @brief Create a reader for the snapshot at filePath
+     * @param filePath Path of the snapshot file
+     */
+    explicit HistorySnapshot(const QString& filePath);
+    ~HistorySnapshot();
+
+    HistorySnapshot(const HistorySnapshot&) = delete;
+    HistorySnapshot& operator=(const HistorySnapshot&) = delete;
+
+    /**
+     * @brief Map the snapshot file and validate its layout
+     * @return true if the file is a readable snapshot of a known version
+     */
+    bool open();
+
+    // Getters
+    bool isOpen() const { return m_data != nullptr; }
+    int count() const { return m_count; }
+    int maxItems() const { return m_maxItems; }
+
+    /**
+     * @brief Build the item stored in record index
+     * @param index Record index (records are stored in display order)
+     * @return Item, or an invalid item if the record is out of bounds
+     */
+    ClipboardItem itemAt(int index) const;
+
+    /**
+     * @brief Write a snapshot atomically
+     * @param filePath Destination path
+     * @param maxItems History size limit to store
+     * @param items Items in display order
+     * @return true if the snapshot was written and committed
+     */
+    static bool write(const QString& filePath, int maxItems, const QList<ClipboardItem>& items);
+
+    /**
+     * @brief Check if a file starts with the snapshot magic number
+     * @param filePath Path to check
+     * @return true if the file looks like a binary snapshot
+     */
+    static bool isSnapshotFile(const QString& filePath);
+
+private:
+    /**
+     * @brief Copy a string out of the blob
+     * @param ref Pointer to an (offset, length) pair in the record table
+     * @param ok Set to false if the reference is out of bounds
+     */
+    QString stringAt(const uchar* ref, bool* ok) const;
+
+    static constexpr quint32 FILE_MAGIC = 0x4e534843; // "CHSN"
+    static constexpr quint16 FILE_VERSION = 3;
+    static constexpr qint64 HEADER_SIZE = 32;
+    static constexpr qint64 RECORD_SIZE = 80;
+    static constexpr quint32 FLAG_PINNED = 0x1;
+
+    QFile m_file;                  ///< Snapshot file
+    const uchar* m_data = nullptr; ///< Mapped file contents
+    qint64 m_size = 0;             ///< Mapped size in bytes
+    quint16 m_version = 0;         ///< Format version of the open file
+    qint64 m_recordSize = RECORD_SIZE; ///< Record size for that version
+    int m_count = 0;               ///< Number of records
+    int m_maxItems = 0;            ///< Stored history size limit
+    const uchar* m_records = nullptr; ///< Start of the record table
+    const QChar* m_strings = nullptr; ///< Start of the string blob
+    quint64 m_stringCount = 0;     ///< Blob length in UTF-16 code units
+};
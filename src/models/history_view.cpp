@@ -0,0 +1,46 @@
+#include "history_view.h"
+
+HistoryView::HistoryView()
+{
+    static const QExplicitlySharedDataPointer<Data> empty(new Data);
+    d = empty;
+}
+
+HistoryView::HistoryView(quint64 version, const QList<ClipboardItem>& pinned,
+                         const QList<ClipboardItem>& unpinned)
+{
+    Data* data = new Data;
+    data->version = version;
+    data->pinned = pinned;
+    data->unpinned = unpinned;
+    d = QExplicitlySharedDataPointer<Data>(data);
+}
+
+const ClipboardItem& HistoryView::at(int index) const
+{
+    if (index < d->pinned.size()) {
+        return d->pinned.at(index);
+    }
+    return d->unpinned.at(index - d->pinned.size());
+}
+
+QList<ClipboardItem> HistoryView::items(int limit) const
+{
+    const int total = count();
+    if (limit < 0 || limit > total) {
+        limit = total;
+    }
+    if (d->pinned.isEmpty() && limit == total) {
+        return d->unpinned;
+    }
+    if (d->unpinned.isEmpty() && limit == total) {
+        return d->pinned;
+    }
+
+    QList<ClipboardItem> ordered;
+    ordered.reserve(limit);
+    for (int i = 0; i < limit; ++i) {
+        ordered.append(at(i));
+    }
+    return ordered;
+}
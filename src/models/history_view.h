@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QList>
+#include <QSharedData>
+#include "clipboard_item.h"
+
+/**
+ * @brief Immutable, reference-counted snapshot of the in-memory history
+ *
+ * A view shares the item lists of the history it was taken from, so taking
+ * and copying views costs a reference count, not a list copy. The history
+ * only copies a segment when it changes that segment while a view still
+ * holds it; the other segment stays shared.
+ *
+ * Every view carries the history version it was taken at. Consumers keep
+ * the last version they rendered and skip work when it has not changed.
+ */
+class HistoryView
+{
+public:
+    /**
+     * @brief Create an empty view (version 0, never produced by a history)
+     */
+    HistoryView();
+
+    /**
+     * @brief Create a view over the given segments
+     * @param version History version the segments belong to
+     * @param pinned Pinned items, newest first
+     * @param unpinned Hot unpinned items, newest first
+     */
+    HistoryView(quint64 version, const QList<ClipboardItem>& pinned,
+                const QList<ClipboardItem>& unpinned);
+
+    // Getters
+    quint64 version() const { return d->version; }
+    int count() const { return int(d->pinned.size() + d->unpinned.size()); }
+    int pinnedCount() const { return int(d->pinned.size()); }
+    bool isEmpty() const { return count() == 0; }
+
+    /**
+     * @brief Get item at display position
+     * @param index Position (pinned items first)
+     * @return Reference to the item, valid as long as the view
+     */
+    const ClipboardItem& at(int index) const;
+
+    /**
+     * @brief Get pinned items, newest first
+     */
+    const QList<ClipboardItem>& pinnedItems() const { return d->pinned; }
+
+    /**
+     * @brief Get hot unpinned items, newest first
+     */
+    const QList<ClipboardItem>& unpinnedItems() const { return d->unpinned; }
+
+    /**
+     * @brief Get items in display order
+     * @param limit Maximum number of items to return (-1 for all)
+     * @return Shared list when nothing is pinned and no limit applies,
+     *         otherwise a list of the first items
+     */
+    QList<ClipboardItem> items(int limit = -1) const;
+
+private:
+    struct Data : public QSharedData
+    {
+        quint64 version = 0;
+        QList<ClipboardItem> pinned;
+        QList<ClipboardItem> unpinned;
+    };
+
+    QExplicitlySharedDataPointer<Data> d;
+};
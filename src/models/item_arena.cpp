@@ -0,0 +1,220 @@
+#include "item_arena.h"
+#include <algorithm>
+#include <limits>
+
+ClipboardItem ItemArena::at(int position) const
+{
+    const Record& record = m_records.at(position);
+    quint32 offset = record.text;
+    auto next = [&](quint16 length) {
+        QString value = textAt(offset, length).toString();
+        offset += length;
+        return value;
+    };
+
+    const QString id = next(record.idLength);
+    const QString preview = next(record.previewLength);
+    const QString hash = next(record.hashLength);
+    ClipboardItem::Payload payload;
+    payload.mimeType = next(record.mimeTypeLength);
+    payload.key = next(record.payloadKeyLength);
+    payload.size = record.payloadSize;
+
+    return ClipboardItem::fromFields(id, QString(), preview, record.timestampMs, record.pinned,
+                                     record.contentKey, hash, payload);
+}
+
+QString ItemArena::idAt(int position) const
+{
+    const Record& record = m_records.at(position);
+    return textAt(record.text, record.idLength).toString();
+}
+
+QStringView ItemArena::previewAt(int position) const
+{
+    const Record& record = m_records.at(position);
+    return textAt(record.text + record.idLength, record.previewLength);
+}
+
+qint64 ItemArena::contentSizeAt(int position) const
+{
+    const Record& record = m_records.at(position);
+    return record.payloadKeyLength > 0 ? record.payloadSize : qint64(record.textBytes);
+}
+
+int ItemArena::indexOf(const QString& id) const
+{
+    auto ordinal = m_ordinals.constFind(idKey(id));
+    if (ordinal == m_ordinals.constEnd()) {
+        return -1;
+    }
+
+    // The key is a hash; confirm it is this ID
+    const int position = int(m_base - ordinal.value());
+    const Record& record = m_records.at(position);
+    return textAt(record.text, record.idLength) == id ? position : -1;
+}
+
+int ItemArena::insert(const ClipboardItem& item, qint64 tag, qint64 textBytes)
+{
+    const QString preview = item.preview();
+    const ClipboardItem::Payload payload = item.payload();
+    const QString strings[] = {item.id(), preview, item.storedHash(), payload.mimeType, payload.key};
+
+    qsizetype length = 0;
+    for (const QString& string : strings) {
+        if (string.size() > std::numeric_limits<quint16>::max()) {
+            return -1;
+        }
+        length += string.size();
+    }
+
+    const quint64 key = idKey(item.id());
+    if (m_ordinals.contains(key) ||
+        m_text.size() + length > qsizetype(std::numeric_limits<quint32>::max())) {
+        return -1;
+    }
+
+    Record record;
+    record.timestampMs = item.timestampMs();
+    record.contentKey = item.contentKey();
+    record.idKey = key;
+    record.tag = tag;
+    record.payloadSize = payload.size;
+    if (textBytes < 0) {
+        textBytes = ClipboardItem::utf8Size(item.text());
+    }
+    record.textBytes = quint32(qMin(textBytes, qint64(std::numeric_limits<quint32>::max())));
+    record.text = quint32(m_text.size());
+    record.idLength = quint16(strings[0].size());
+    record.previewLength = quint16(strings[1].size());
+    record.hashLength = quint16(strings[2].size());
+    record.mimeTypeLength = quint16(strings[3].size());
+    record.payloadKeyLength = quint16(strings[4].size());
+    record.pinned = item.pinned();
+    for (const QString& string : strings) {
+        m_text.append(string);
+    }
+
+    const int position = insertionPosition(record.timestampMs);
+    const int count = m_records.count();
+    if (position < count - position) {
+        // Keep the newer entries in place by moving the origin up
+        ++m_base;
+        shiftOrdinals(0, position, 1);
+    } else {
+        // Push the older entries one position further from the origin
+        shiftOrdinals(position, count, -1);
+    }
+
+    m_records.insert(position, record);
+    m_ordinals.insert(key, m_base - position);
+    return position;
+}
+
+ClipboardItem ItemArena::takeAt(int position)
+{
+    ClipboardItem item = at(position);
+    const Record record = m_records.takeAt(position);
+    m_ordinals.remove(record.idKey);
+    m_deadChars += record.textLength();
+
+    const int count = m_records.count();
+    if (position < count - position) {
+        // Newer entries stay put relative to the lowered origin
+        --m_base;
+        shiftOrdinals(0, position, -1);
+    } else {
+        // Older entries move one position closer to the origin
+        shiftOrdinals(position, count, 1);
+    }
+
+    compactIfNeeded();
+    return item;
+}
+
+void ItemArena::clear()
+{
+    m_records = QList<Record>();
+    m_text = QString();
+    m_ordinals = QHash<quint64, qint64>();
+    m_base = 0;
+    m_deadChars = 0;
+}
+
+void ItemArena::collectPayloadKeys(QSet<QString>& keys) const
+{
+    for (const Record& record : m_records) {
+        if (record.payloadKeyLength > 0) {
+            const quint32 offset = record.text + record.textLength() - record.payloadKeyLength;
+            keys.insert(textAt(offset, record.payloadKeyLength).toString());
+        }
+    }
+}
+
+ItemArena::Usage ItemArena::usage() const
+{
+    Usage usage;
+    usage.entries = m_records.count();
+    usage.recordBytes = qint64(m_records.capacity()) * qint64(sizeof(Record));
+    usage.textBytes = qint64(m_text.capacity()) * qint64(sizeof(QChar));
+    usage.deadTextBytes = m_deadChars * qint64(sizeof(QChar));
+    // A hash node is the key and value plus about one byte of span bookkeeping
+    usage.indexBytes = qint64(m_ordinals.capacity()) * qint64(sizeof(quint64) + sizeof(qint64) + 1);
+    return usage;
+}
+
+QStringView ItemArena::textAt(quint32 offset, quint16 length) const
+{
+    return QStringView(m_text).mid(offset, length);
+}
+
+int ItemArena::insertionPosition(qint64 timestampMs) const
+{
+    // Fast path: demoted items are newer than everything already stored
+    if (m_records.isEmpty() || m_records.first().timestampMs <= timestampMs) {
+        return 0;
+    }
+
+    auto it = std::lower_bound(m_records.cbegin(), m_records.cend(), timestampMs,
+                               [](const Record& existing, qint64 value) {
+                                   return existing.timestampMs > value;
+                               });
+    return int(it - m_records.cbegin());
+}
+
+void ItemArena::shiftOrdinals(int from, int to, qint64 delta)
+{
+    for (int i = from; i < to; ++i) {
+        m_ordinals[m_records.at(i).idKey] += delta;
+    }
+}
+
+void ItemArena::compactIfNeeded()
+{
+    if (m_deadChars >= COMPACT_MIN_DEAD_CHARS && m_deadChars > m_text.size() - m_deadChars) {
+        compact();
+    }
+}
+
+void ItemArena::compact()
+{
+    QString text;
+    text.reserve(m_text.size() - m_deadChars);
+    for (Record& record : m_records) {
+        const int length = record.textLength();
+        const quint32 offset = quint32(text.size());
+        text.append(QStringView(m_text).mid(record.text, length));
+        record.text = offset;
+    }
+
+    m_text = text;
+    m_records.squeeze();
+    m_ordinals.squeeze();
+    m_deadChars = 0;
+}
+
+quint64 ItemArena::idKey(QStringView id)
+{
+    return ClipboardItem::generateContentKey(id);
+}
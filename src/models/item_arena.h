@@ -0,0 +1,192 @@
+#pragma once
+
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include "clipboard_item.h"
+
+/**
+ * @brief Compact in-memory index of metadata-only items
+ *
+ * ItemArena stores one fixed-size record per item in a single array and
+ * all of the items' strings (ID, preview, stored hash, payload reference)
+ * back to back in one shared text buffer, so an entry costs no heap
+ * allocation of its own. Items are materialized on access.
+ *
+ * Removing an entry leaves a hole in the text buffer; once holes outweigh
+ * the live text the buffer is rebuilt and the record array squeezed, which
+ * hands the memory back instead of leaving it fragmented.
+ *
+ * Entries are kept newest first, like HistorySegment, and each carries a
+ * caller-defined tag (the cold store keeps the record file offset there).
+ */
+class ItemArena
+{
+public:
+    /**
+     * @brief Memory held by the arena
+     */
+    struct Usage {
+        int entries = 0;
+        qint64 recordBytes = 0;      ///< Record array capacity
+        qint64 textBytes = 0;        ///< Text buffer capacity
+        qint64 deadTextBytes = 0;    ///< Text of removed entries not yet reclaimed
+        qint64 indexBytes = 0;       ///< Approximate size of the ID index
+
+        qint64 totalBytes() const { return recordBytes + textBytes + indexBytes; }
+    };
+
+    ItemArena() = default;
+
+    // Getters
+    int count() const { return m_records.count(); }
+    bool isEmpty() const { return m_records.isEmpty(); }
+
+    /**
+     * @brief Materialize the entry at position
+     * @param position Position in the arena (0 = newest)
+     * @return Metadata-only item (no text)
+     */
+    ClipboardItem at(int position) const;
+
+    /**
+     * @brief Get the ID of the entry at position without materializing it
+     */
+    QString idAt(int position) const;
+
+    /**
+     * @brief Get the preview of the entry at position without copying it
+     * @return View into the arena, valid until the arena changes
+     */
+    QStringView previewAt(int position) const;
+
+    /**
+     * @brief Get the timestamp of the entry at position
+     */
+    qint64 timestampAt(int position) const { return m_records.at(position).timestampMs; }
+
+    /**
+     * @brief Get the content size of the entry at position
+     * @return Same as ClipboardItem::contentSize() of the full item
+     */
+    qint64 contentSizeAt(int position) const;
+
+    /**
+     * @brief Get the tag stored with the entry at position
+     */
+    qint64 tagAt(int position) const { return m_records.at(position).tag; }
+
+    /**
+     * @brief Replace the tag of the entry at position
+     */
+    void setTagAt(int position, qint64 tag) { m_records[position].tag = tag; }
+
+    /**
+     * @brief Get position of an entry by item ID
+     * @param id Item ID to find
+     * @return Position in the arena, or -1 if not found
+     */
+    int indexOf(const QString& id) const;
+
+    /**
+     * @brief Check if an item is stored in the arena
+     */
+    bool contains(const QString& id) const { return indexOf(id) >= 0; }
+
+    /**
+     * @brief Add metadata of item at its timestamp position
+     * @param item Item to index; its text is not stored
+     * @param tag Caller-defined value kept with the entry
+     * @param textBytes UTF-8 size of the item's text, or -1 to measure it
+     *                  (for items passed without their text)
+     * @return Position of the new entry, or -1 if the ID is already indexed
+     *         or a string is too long for a record
+     */
+    int insert(const ClipboardItem& item, qint64 tag, qint64 textBytes = -1);
+
+    /**
+     * @brief Remove the entry at position
+     * @param position Position in the arena
+     * @return Metadata-only copy of the removed entry
+     */
+    ClipboardItem takeAt(int position);
+
+    /**
+     * @brief Remove all entries and release their memory
+     */
+    void clear();
+
+    /**
+     * @brief Add the blob keys of all payload entries to a set
+     * @param keys Set to add to
+     */
+    void collectPayloadKeys(QSet<QString>& keys) const;
+
+    /**
+     * @brief Report the memory held by the arena
+     */
+    Usage usage() const;
+
+private:
+    /**
+     * @brief Fixed-size entry; strings are ranges of m_text
+     *
+     * The ID, preview, stored hash, payload MIME type and payload key are
+     * stored consecutively starting at text.
+     */
+    struct Record {
+        qint64 timestampMs;
+        quint64 contentKey;
+        quint64 idKey;
+        qint64 tag;
+        qint64 payloadSize;
+        quint32 textBytes;       ///< UTF-8 size of the item text, which is not stored
+        quint32 text;
+        quint16 idLength;
+        quint16 previewLength;
+        quint16 hashLength;
+        quint16 mimeTypeLength;
+        quint16 payloadKeyLength;
+        bool pinned;
+
+        int textLength() const {
+            return idLength + previewLength + hashLength + mimeTypeLength + payloadKeyLength;
+        }
+    };
+
+    /**
+     * @brief Get a string range of the text buffer
+     */
+    QStringView textAt(quint32 offset, quint16 length) const;
+
+    /**
+     * @brief Find the position where an entry with timestamp belongs
+     */
+    int insertionPosition(qint64 timestampMs) const;
+
+    /**
+     * @brief Adjust the ordinals of entries in [from, to)
+     */
+    void shiftOrdinals(int from, int to, qint64 delta);
+
+    /**
+     * @brief Rebuild the text buffer without holes once they dominate
+     */
+    void compactIfNeeded();
+
+    /**
+     * @brief Rebuild the text buffer from the live entries
+     */
+    void compact();
+
+    static quint64 idKey(QStringView id);
+
+    static constexpr qint64 COMPACT_MIN_DEAD_CHARS = 16 * 1024;
+
+    QList<Record> m_records;               ///< Entries, newest first
+    QString m_text;                        ///< Strings of all entries, back to back
+    QHash<quint64, qint64> m_ordinals;     ///< ID key -> ordinal (position = m_base - ordinal)
+    qint64 m_base = 0;                     ///< Ordinal of the entry at position 0
+    qint64 m_deadChars = 0;                ///< Characters of removed entries in m_text
+};
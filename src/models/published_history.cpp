@@ -0,0 +1,26 @@
+#include "published_history.h"
+
+PublishedHistory::PublishedHistory()
+    : m_current(std::make_shared<const HistoryView>())
+{
+}
+
+void PublishedHistory::publish(const HistoryView& view)
+{
+    auto next = std::make_shared<const HistoryView>(view);
+#if defined(__cpp_lib_atomic_shared_ptr)
+    m_current.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store_explicit(&m_current, std::move(next), std::memory_order_release);
+#endif
+    m_version.store(view.version(), std::memory_order_release);
+}
+
+HistoryView PublishedHistory::current() const
+{
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return *m_current.load(std::memory_order_acquire);
+#else
+    return *std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+#endif
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "history_view.h"
+
+/**
+ * @brief Latest history snapshot, readable from any thread
+ *
+ * The history has a single writer, its own thread. After a change the
+ * writer publishes a new HistoryView here, and readers on any thread
+ * take the current one without touching the history object: a view is
+ * immutable and shares its lists by atomic reference counts, so reading
+ * it never races with the writer, which copies a list before changing
+ * one still held by a view.
+ *
+ * Publishing replaces a shared pointer; readers copy it. Neither side
+ * holds a lock while building or reading a view, so a slow reader never
+ * delays the writer and readers never see a half-applied change. A
+ * reader sees either the previous or the new snapshot.
+ */
+class PublishedHistory
+{
+public:
+    PublishedHistory();
+
+    /**
+     * @brief Make a view the current snapshot (writer thread)
+     * @param view Snapshot to publish
+     */
+    void publish(const HistoryView& view);
+
+    /**
+     * @brief Get the current snapshot (any thread)
+     * @return Last published view, or an empty view before the first publish
+     */
+    HistoryView current() const;
+
+    /**
+     * @brief Get the version of the current snapshot (any thread)
+     * @return HistoryView::version() of the last published view
+     */
+    quint64 version() const { return m_version.load(std::memory_order_acquire); }
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const HistoryView>> m_current;
+#else
+    std::shared_ptr<const HistoryView> m_current; ///< Accessed through std::atomic_load/store only
+#endif
+    std::atomic<quint64> m_version{0};
+};
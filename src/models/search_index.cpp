@@ -0,0 +1,340 @@
+#include "search_index.h"
+#include <algorithm>
+#include <iterator>
+
+SearchIndex::Query::Query(const QString& text, MatchMode mode, Qt::CaseSensitivity caseSensitivity)
+    : text(text)
+    , folded(text.toCaseFolded())
+    , mode(mode)
+    , caseSensitivity(caseSensitivity)
+    , matcher(text)
+{
+}
+
+SearchIndex::SearchIndex(int minIndexedItems)
+    : m_minIndexedItems(qMax(0, minIndexedItems))
+    , m_indexed(m_minIndexedItems == 0)
+{
+}
+
+bool SearchIndex::Matches::contains(const QString& id) const
+{
+    if (!m_index || m_index->m_numbering != m_numbering) {
+        return false;
+    }
+    int document = m_index->m_documentIds.value(id, -1);
+    return document >= 0 && document < m_hits.size() && m_hits.testBit(document);
+}
+
+void SearchIndex::addItem(const ClipboardItem& item)
+{
+    auto existing = m_documentIds.constFind(item.id());
+    if (existing != m_documentIds.constEnd()) {
+        if (m_documents.at(*existing).text == item.text()) {
+            return; // Pin changes and the like leave the text alone
+        }
+        removeItem(item.id());
+    }
+
+    Document document;
+    document.id = item.id();
+    document.text = item.text();
+    document.live = true;
+    document.partial = document.text.size() > MAX_INDEXED_LENGTH;
+
+    int number = int(m_documents.size());
+    m_documents.append(document);
+    m_documentIds.insert(document.id, number);
+    if (m_indexed) {
+        indexDocument(number);
+        if (document.partial) {
+            m_partialDocuments.append(number);
+        }
+    } else if (count() >= m_minIndexedItems) {
+        buildPostings();
+    }
+    ++m_generation;
+}
+
+void SearchIndex::removeItem(const QString& id)
+{
+    auto it = m_documentIds.find(id);
+    if (it == m_documentIds.end()) {
+        return;
+    }
+
+    int number = *it;
+    m_documentIds.erase(it);
+
+    // Leave a tombstone; the posting lists are swept in compact()
+    Document& document = m_documents[number];
+    if (document.partial) {
+        m_partialDocuments.removeOne(number);
+    }
+    document = Document();
+    ++m_tombstones;
+    ++m_generation;
+
+    if (m_tombstones >= MIN_COMPACT_TOMBSTONES && m_tombstones > m_documentIds.size()) {
+        compact();
+    }
+}
+
+void SearchIndex::setItems(const QList<ClipboardItem>& items)
+{
+    clear();
+    m_documents.reserve(items.size());
+    m_documentIds.reserve(items.size());
+    for (const ClipboardItem& item : items) {
+        addItem(item);
+    }
+}
+
+void SearchIndex::clear()
+{
+    m_documents.clear();
+    m_documentIds.clear();
+    m_postings.clear();
+    m_partialDocuments.clear();
+    m_indexed = m_minIndexedItems == 0;
+    m_tombstones = 0;
+    ++m_generation;
+    ++m_numbering;
+}
+
+qint64 SearchIndex::memoryUsage() const
+{
+    // Hash nodes hold key, value and a pointer of bookkeeping
+    qint64 bytes = qint64(m_documents.capacity()) * qint64(sizeof(Document));
+    bytes += qint64(m_documentIds.capacity()) * qint64(sizeof(QString) + sizeof(int) + sizeof(void*));
+    bytes += qint64(m_postings.capacity()) * qint64(sizeof(quint64) + sizeof(QList<int>) + sizeof(void*));
+    for (const QList<int>& posting : m_postings) {
+        bytes += qint64(posting.capacity()) * qint64(sizeof(int));
+    }
+    bytes += qint64(m_partialDocuments.capacity()) * qint64(sizeof(int));
+    return bytes;
+}
+
+SearchIndex::Matches SearchIndex::search(const QString& query, MatchMode mode,
+                                         Qt::CaseSensitivity caseSensitivity) const
+{
+    const Query prepared(query, mode, caseSensitivity);
+    Matches result = emptyResult(prepared);
+
+    if (query.isEmpty() || !m_indexed) {
+        for (int number = 0; number < m_documents.size(); ++number) {
+            if (matches(m_documents.at(number), prepared)) {
+                result.m_hits.setBit(number);
+                ++result.m_count;
+            }
+        }
+        return result;
+    }
+
+    bool exact = false;
+    const QList<int> found = candidates(prepared.folded, &exact);
+    const bool verify = !exact || mode != Substring || caseSensitivity == Qt::CaseSensitive;
+
+    for (int number : found) {
+        const Document& document = m_documents.at(number);
+        if (!document.live || (verify && !matches(document, prepared))) {
+            continue;
+        }
+        result.m_hits.setBit(number);
+        ++result.m_count;
+    }
+
+    // Text past the indexed length can only be found by looking at it
+    for (int number : m_partialDocuments) {
+        if (!result.m_hits.testBit(number) && matches(m_documents.at(number), prepared)) {
+            result.m_hits.setBit(number);
+            ++result.m_count;
+        }
+    }
+    return result;
+}
+
+SearchIndex::Matches SearchIndex::refine(const Matches& previous, const QString& query) const
+{
+    if (previous.m_generation != m_generation || previous.m_query.isEmpty() ||
+        !narrows(previous, query)) {
+        return search(query, previous.m_mode, previous.m_caseSensitivity);
+    }
+
+    const Query prepared(query, previous.m_mode, previous.m_caseSensitivity);
+    Matches result = emptyResult(prepared);
+    auto check = [&](int number) {
+        if (matches(m_documents.at(number), prepared)) {
+            result.m_hits.setBit(number);
+            ++result.m_count;
+        }
+    };
+
+    // Look only at documents that matched before, from whichever set is smaller
+    QList<int> found;
+    bool exact = false;
+    if (m_indexed && m_partialDocuments.isEmpty()) {
+        found = candidates(prepared.folded, &exact);
+    }
+    if (!m_indexed || !m_partialDocuments.isEmpty() || previous.m_count < found.size()) {
+        for (int number = 0; number < previous.m_hits.size(); ++number) {
+            if (previous.m_hits.testBit(number)) {
+                check(number);
+            }
+        }
+    } else {
+        for (int number : std::as_const(found)) {
+            if (previous.m_hits.testBit(number)) {
+                check(number);
+            }
+        }
+    }
+    return result;
+}
+
+quint64 SearchIndex::gramKey(const QChar* units, int length)
+{
+    quint64 key = quint64(length) << 48;
+    for (int i = 0; i < length; ++i) {
+        key |= quint64(units[i].unicode()) << (32 - 16 * i);
+    }
+    return key;
+}
+
+void SearchIndex::indexDocument(int document)
+{
+    const QString folded = m_documents.at(document).text.left(MAX_INDEXED_LENGTH).toCaseFolded();
+    const int length = qMin(int(folded.size()), MAX_INDEXED_LENGTH);
+
+    QList<quint64> grams;
+    grams.reserve(qsizetype(length) * MAX_GRAM);
+    for (int i = 0; i < length; ++i) {
+        for (int n = 1; n <= MAX_GRAM && i + n <= length; ++n) {
+            grams.append(gramKey(folded.constData() + i, n));
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    // Document numbers only grow, so appending keeps every list sorted
+    for (quint64 gram : grams) {
+        m_postings[gram].append(document);
+    }
+}
+
+void SearchIndex::buildPostings()
+{
+    m_postings.clear();
+    m_partialDocuments.clear();
+    for (int number = 0; number < m_documents.size(); ++number) {
+        const Document& document = m_documents.at(number);
+        if (!document.live) {
+            continue;
+        }
+        indexDocument(number);
+        if (document.partial) {
+            m_partialDocuments.append(number);
+        }
+    }
+    m_indexed = true;
+}
+
+SearchIndex::Matches SearchIndex::emptyResult(const Query& query) const
+{
+    Matches result;
+    result.m_index = this;
+    result.m_hits.resize(m_documents.size());
+    result.m_query = query.text;
+    result.m_mode = query.mode;
+    result.m_caseSensitivity = query.caseSensitivity;
+    result.m_generation = m_generation;
+    result.m_numbering = m_numbering;
+    return result;
+}
+
+void SearchIndex::compact()
+{
+    QList<Document> documents;
+    documents.reserve(m_documentIds.size());
+    for (const Document& document : std::as_const(m_documents)) {
+        if (document.live) {
+            documents.append(document);
+        }
+    }
+
+    m_documents = documents;
+    m_documentIds.clear();
+    for (int number = 0; number < m_documents.size(); ++number) {
+        m_documentIds.insert(m_documents.at(number).id, number);
+    }
+    if (m_indexed) {
+        buildPostings();
+    }
+    m_tombstones = 0;
+    ++m_numbering;
+}
+
+QList<int> SearchIndex::candidates(const QString& folded, bool* exact) const
+{
+    // Short queries are grams themselves
+    if (folded.size() <= MAX_GRAM) {
+        *exact = true;
+        return m_postings.value(gramKey(folded.constData(), int(folded.size())));
+    }
+
+    *exact = false;
+    QList<const QList<int>*> lists;
+    for (int i = 0; i + MAX_GRAM <= folded.size(); ++i) {
+        auto it = m_postings.constFind(gramKey(folded.constData() + i, MAX_GRAM));
+        if (it == m_postings.constEnd()) {
+            return QList<int>();
+        }
+        lists.append(&*it);
+    }
+    std::sort(lists.begin(), lists.end(), [](const QList<int>* a, const QList<int>* b) {
+        return a->size() < b->size();
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    // Intersect from the rarest gram up; probe long lists instead of merging them
+    QList<int> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        const QList<int>& list = *lists.at(i);
+        QList<int> next;
+        next.reserve(result.size());
+        if (result.size() * 16 < list.size()) {
+            for (int number : std::as_const(result)) {
+                if (std::binary_search(list.begin(), list.end(), number)) {
+                    next.append(number);
+                }
+            }
+        } else {
+            std::set_intersection(result.begin(), result.end(), list.begin(), list.end(),
+                                  std::back_inserter(next));
+        }
+        result = next;
+    }
+    return result;
+}
+
+bool SearchIndex::matches(const Document& document, const Query& query)
+{
+    if (!document.live) {
+        return false;
+    }
+
+    if (query.caseSensitivity == Qt::CaseSensitive) {
+        return query.mode == Prefix ? document.text.startsWith(query.text)
+                                    : document.text.contains(query.text);
+    }
+    return query.mode == Prefix ? query.matcher.isPrefixOf(document.text)
+                                : query.matcher.contains(document.text);
+}
+
+bool SearchIndex::narrows(const Matches& previous, const QString& query)
+{
+    const bool sensitive = previous.m_caseSensitivity == Qt::CaseSensitive;
+    const QString current = sensitive ? query : query.toCaseFolded();
+    const QString before = sensitive ? previous.m_query : previous.m_query.toCaseFolded();
+    return previous.m_mode == Prefix ? current.startsWith(before) : current.contains(before);
+}
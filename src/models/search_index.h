@@ -0,0 +1,225 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "clipboard_item.h"
+#include "text_matcher.h"
+
+/**
+ * @brief Inverted n-gram index over clipboard item text
+ *
+ * Every item's case-folded text is broken into its distinct 1-, 2- and
+ * 3-grams, each mapped to a posting list of document numbers. A query of
+ * up to three characters is answered directly from one posting list; a
+ * longer query intersects the posting lists of its trigrams and only the
+ * surviving candidates are checked against the query, so a search never
+ * scans the whole history.
+ *
+ * Below minIndexedItems() items, building posting lists costs more than it
+ * saves; the index then scans every item with TextMatcher instead and
+ * builds its posting lists once the item count reaches the threshold.
+ *
+ * Adding and removing items is incremental. Removed documents are left as
+ * tombstones in the posting lists and swept out once they outnumber the
+ * live ones, which keeps removal O(1).
+ */
+class SearchIndex
+{
+public:
+    /**
+     * @brief How a query must appear in an item's text
+     */
+    enum MatchMode {
+        Substring,                   ///< Anywhere in the text
+        Prefix                       ///< At the start of the text
+    };
+
+    /**
+     * @brief Immutable result of a search
+     *
+     * Tests membership by item ID in O(1) by looking the ID up in the index
+     * that produced the result, which must outlive it; results hold no copy
+     * of the index's ID map, so keeping one does not make the next change
+     * to the index copy the map. After the index changes, a result only
+     * describes the items indexed at search time that are still indexed,
+     * and once the index renumbers its documents (compaction or clear())
+     * it matches nothing.
+     */
+    class Matches
+    {
+    public:
+        Matches() = default;
+
+        /**
+         * @brief Check if an item matched
+         * @param id Item ID
+         * @return true if the item was indexed and matched the query
+         */
+        bool contains(const QString& id) const;
+
+        int count() const { return m_count; }
+        bool isEmpty() const { return m_count == 0; }
+        const QString& query() const { return m_query; }
+
+    private:
+        friend class SearchIndex;
+
+        const SearchIndex* m_index = nullptr; ///< Index resolving IDs to document numbers
+        QBitArray m_hits;                ///< Matching document numbers
+        QString m_query;                 ///< Query as given
+        MatchMode m_mode = Substring;
+        Qt::CaseSensitivity m_caseSensitivity = Qt::CaseInsensitive;
+        quint64 m_generation = 0;        ///< Index generation the result belongs to
+        quint64 m_numbering = 0;         ///< Document numbering m_hits refers to
+        int m_count = 0;
+    };
+
+    /**
+     * @brief Create an empty index
+     * @param minIndexedItems Item count from which posting lists are kept
+     */
+    explicit SearchIndex(int minIndexedItems = DEFAULT_MIN_INDEXED_ITEMS);
+
+    // Getters
+    int count() const { return int(m_documentIds.size()); }
+    int minIndexedItems() const { return m_minIndexedItems; }
+    bool isIndexed() const { return m_indexed; }
+    bool isEmpty() const { return m_documentIds.isEmpty(); }
+    bool contains(const QString& id) const { return m_documentIds.contains(id); }
+
+    /**
+     * @brief Index an item, replacing any item with the same ID
+     * @param item Item to index
+     */
+    void addItem(const ClipboardItem& item);
+
+    /**
+     * @brief Drop an item from the index
+     * @param id Item ID
+     */
+    void removeItem(const QString& id);
+
+    /**
+     * @brief Replace the indexed items
+     * @param items Items to index
+     */
+    void setItems(const QList<ClipboardItem>& items);
+
+    /**
+     * @brief Drop all items
+     */
+    void clear();
+
+    /**
+     * @brief Estimate the memory held by the index
+     * @return Bytes of documents, ID map and posting lists; item texts and
+     *         IDs are shared with the indexed items and not counted
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * @brief Find the items containing query
+     * @param query Text to find; an empty query matches every item
+     * @param mode Whether the text must contain or start with query
+     * @param caseSensitivity Whether letter case must match
+     * @return Matching items
+     */
+    Matches search(const QString& query, MatchMode mode = Substring,
+                   Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive) const;
+
+    /**
+     * @brief Search for a query that extends a previous one
+     * @param previous Result of an earlier search
+     * @param query New query
+     * @return Matching items
+     *
+     * When query still implies the previous query and the index has not
+     * changed since, only the previous matches are considered; otherwise
+     * this is a plain search() with the previous mode and case sensitivity.
+     */
+    Matches refine(const Matches& previous, const QString& query) const;
+
+private:
+    /**
+     * @brief Indexed item text
+     */
+    struct Document {
+        QString id;                  ///< Item ID
+        QString text;                ///< Item text, empty once removed
+        bool live = false;           ///< false for tombstones
+        bool partial = false;        ///< Text longer than MAX_INDEXED_LENGTH
+    };
+
+    /**
+     * @brief Query prepared for checking documents
+     */
+    struct Query {
+        Query(const QString& text, MatchMode mode, Qt::CaseSensitivity caseSensitivity);
+
+        QString text;                ///< Query as given
+        QString folded;              ///< Case-folded query, for posting lookups
+        MatchMode mode;
+        Qt::CaseSensitivity caseSensitivity;
+        TextMatcher matcher;         ///< Case-insensitive scanner for text
+    };
+
+    /**
+     * @brief Pack up to three UTF-16 code units into a posting key
+     */
+    static quint64 gramKey(const QChar* units, int length);
+
+    /**
+     * @brief Add the distinct grams of a document to the posting lists
+     */
+    void indexDocument(int document);
+
+    /**
+     * @brief Build the posting lists of all live documents
+     */
+    void buildPostings();
+
+    /**
+     * @brief Start a result for query
+     */
+    Matches emptyResult(const Query& query) const;
+
+    /**
+     * @brief Renumber live documents and rebuild the posting lists
+     */
+    void compact();
+
+    /**
+     * @brief Collect the documents that can contain folded query
+     * @param folded Case-folded query
+     * @param exact Set to true if every candidate is known to match
+     * @return Ascending document numbers, including tombstones
+     */
+    QList<int> candidates(const QString& folded, bool* exact) const;
+
+    /**
+     * @brief Check a document against a query
+     */
+    static bool matches(const Document& document, const Query& query);
+
+    /**
+     * @brief Check if every match of query must also match the previous query
+     */
+    static bool narrows(const Matches& previous, const QString& query);
+
+    static constexpr int DEFAULT_MIN_INDEXED_ITEMS = 2000;
+    static constexpr int MAX_GRAM = 3;
+    static constexpr int MAX_INDEXED_LENGTH = 4096;  ///< Longer texts are indexed by their start
+    static constexpr int MIN_COMPACT_TOMBSTONES = 256;
+
+    QList<Document> m_documents;               ///< Document number -> content
+    QHash<QString, int> m_documentIds;         ///< Live item ID -> document number
+    QHash<quint64, QList<int>> m_postings;     ///< Gram -> ascending document numbers
+    QList<int> m_partialDocuments;             ///< Live documents not fully indexed
+    int m_minIndexedItems;                     ///< Item count from which postings are kept
+    bool m_indexed;                            ///< Posting lists are built
+    int m_tombstones = 0;                      ///< Removed documents still in postings
+    quint64 m_generation = 1;                  ///< Bumped on every change
+    quint64 m_numbering = 1;                   ///< Bumped when document numbers are reassigned
+};
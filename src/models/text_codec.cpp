@@ -0,0 +1,199 @@
+#include "text_codec.h"
+#include <QDebug>
+#include <QSet>
+#include <QtEndian>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr int SIZE_FIELD_BYTES = 4;
+
+#ifdef HAVE_ZLIB
+
+// Deflate encodes at most 258 bytes per match in no less than two bits,
+// so no stream inflates to more than 1032 times its own size
+constexpr qint64 MAX_DEFLATE_RATIO = 1032;
+
+/**
+ * Check a stored size field before anything is allocated for it
+ */
+bool isPlausibleSize(quint32 size, qsizetype deflatedBytes)
+{
+    return size <= TextCodec::MAX_DECODED_SIZE && qint64(size) <= qint64(deflatedBytes) * MAX_DEFLATE_RATIO;
+}
+
+// Raw deflate: the method byte and size field replace the zlib header
+constexpr int RAW_WINDOW_BITS = -15;
+constexpr int MEMORY_LEVEL = 8;
+
+QByteArray deflateText(const QByteArray& utf8, const QByteArray& dictionary)
+{
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, RAW_WINDOW_BITS, MEMORY_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return QByteArray();
+    }
+    if (!dictionary.isEmpty() &&
+        deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()),
+                             uInt(dictionary.size())) != Z_OK) {
+        deflateEnd(&stream);
+        return QByteArray();
+    }
+
+    QByteArray out(qsizetype(deflateBound(&stream, uLong(utf8.size()))), Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(utf8.constData()));
+    stream.avail_in = uInt(utf8.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = uInt(out.size());
+    const int result = deflate(&stream, Z_FINISH);
+    out.resize(qsizetype(stream.total_out));
+    deflateEnd(&stream);
+    return result == Z_STREAM_END ? out : QByteArray();
+}
+
+bool inflateText(const char* data, qsizetype size, const QByteArray& dictionary, QByteArray& utf8)
+{
+    z_stream stream = {};
+    if (inflateInit2(&stream, RAW_WINDOW_BITS) != Z_OK) {
+        return false;
+    }
+    if (!dictionary.isEmpty() &&
+        inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()),
+                             uInt(dictionary.size())) != Z_OK) {
+        inflateEnd(&stream);
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = uInt(size);
+    stream.next_out = reinterpret_cast<Bytef*>(utf8.data());
+    stream.avail_out = uInt(utf8.size());
+    const int result = inflate(&stream, Z_FINISH);
+    const bool complete = result == Z_STREAM_END && stream.total_out == uLong(utf8.size());
+    inflateEnd(&stream);
+    return complete;
+}
+#endif
+
+} // namespace
+
+QByteArray TextCodec::encode(const QString& text, const QByteArray& dictionary, bool compress)
+{
+    const QByteArray utf8 = text.toUtf8();
+    QByteArray plain;
+    plain.reserve(utf8.size() + 1);
+    plain.append(char(Plain));
+    plain.append(utf8);
+
+#ifdef HAVE_ZLIB
+    if (compress && utf8.size() >= MIN_COMPRESS_BYTES) {
+        const QByteArray deflated = deflateText(utf8, dictionary);
+        const qsizetype encodedSize = 1 + SIZE_FIELD_BYTES + deflated.size();
+        if (!deflated.isEmpty() && encodedSize < plain.size()) {
+            QByteArray encoded(1 + SIZE_FIELD_BYTES, Qt::Uninitialized);
+            encoded[0] = char(Deflate);
+            qToLittleEndian<quint32>(quint32(utf8.size()), encoded.data() + 1);
+            encoded.append(deflated);
+            return encoded;
+        }
+    }
+#else
+    Q_UNUSED(dictionary)
+    Q_UNUSED(compress)
+#endif
+
+    return plain;
+}
+
+bool TextCodec::decode(const QByteArray& data, const QByteArray& dictionary, QString& text)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    switch (quint8(data.at(0))) {
+        case Plain:
+            text = QString::fromUtf8(data.constData() + 1, data.size() - 1);
+            return true;
+        case Deflate: {
+#ifdef HAVE_ZLIB
+            if (data.size() < 1 + SIZE_FIELD_BYTES) {
+                return false;
+            }
+            // The size field comes from disk; a corrupt one must not drive the allocation
+            const quint32 size = qFromLittleEndian<quint32>(data.constData() + 1);
+            const qsizetype deflatedBytes = data.size() - 1 - SIZE_FIELD_BYTES;
+            if (!isPlausibleSize(size, deflatedBytes)) {
+                return false;
+            }
+            QByteArray utf8(qsizetype(size), Qt::Uninitialized);
+            if (!inflateText(data.constData() + 1 + SIZE_FIELD_BYTES, deflatedBytes, dictionary, utf8)) {
+                return false;
+            }
+            text = QString::fromUtf8(utf8);
+            return true;
+#else
+            Q_UNUSED(dictionary)
+            qWarning() << "TextCodec: Stored text is compressed, but this build has no zlib";
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+qint64 TextCodec::decodedSize(QByteArrayView data)
+{
+    if (data.isEmpty()) {
+        return -1;
+    }
+
+    switch (quint8(data.at(0))) {
+        case Plain:
+            return data.size() - 1;
+        case Deflate: {
+            if (data.size() < 1 + SIZE_FIELD_BYTES) {
+                return -1;
+            }
+            // Only the start may be given, so the ratio check of decode() does not apply
+            const quint32 size = qFromLittleEndian<quint32>(data.data() + 1);
+            return size <= MAX_DECODED_SIZE ? qint64(size) : -1;
+        }
+    }
+    return -1;
+}
+
+QByteArray TextCodec::trainDictionary(const QList<QByteArray>& samples)
+{
+    // Walk from the newest sample back, so the newest end up last
+    QList<QByteArray> picked;
+    QSet<QByteArray> seen;
+    qsizetype size = 0;
+    for (auto it = samples.crbegin(); it != samples.crend() && size < MAX_DICTIONARY_SIZE; ++it) {
+        if (it->isEmpty() || seen.contains(*it)) {
+            continue;
+        }
+        seen.insert(*it);
+        picked.prepend(it->right(MAX_DICTIONARY_SIZE - size));
+        size += picked.first().size();
+    }
+
+    QByteArray dictionary;
+    dictionary.reserve(size);
+    for (const QByteArray& sample : picked) {
+        dictionary.append(sample);
+    }
+    return dictionary;
+}
+
+bool TextCodec::isCompressionAvailable()
+{
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
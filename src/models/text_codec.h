@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Compact on-disk encoding of item text
+ *
+ * Text is stored as UTF-8, deflated against an optional preset dictionary
+ * when that makes it smaller. A dictionary built from the user's own
+ * history lets even short, near-identical snippets (log lines, URLs that
+ * differ in a query string) compress well, which per-item compression
+ * alone cannot do.
+ *
+ * Encoded data starts with a method byte. Deflate needs zlib; builds
+ * without it write plain UTF-8 and cannot decode deflated text.
+ */
+class TextCodec
+{
+public:
+    /**
+     * @brief Encoding of a stored text
+     */
+    enum Method : quint8 {
+        Plain = 0,      ///< UTF-8
+        Deflate = 1     ///< Raw deflate of the UTF-8, against the dictionary if any
+    };
+
+    /**
+     * @brief Encode text for storage
+     * @param text Text to encode
+     * @param dictionary Preset dictionary (may be empty)
+     * @param compress false to always store plain UTF-8
+     * @return Encoded bytes
+     */
+    static QByteArray encode(const QString& text, const QByteArray& dictionary = QByteArray(),
+                             bool compress = true);
+
+    /**
+     * @brief Decode text written by encode()
+     * @param data Encoded bytes
+     * @param dictionary The dictionary used for encoding
+     * @param text Filled with the decoded text
+     * @return false if the data is corrupt or cannot be decoded in this build
+     *
+     * A stored size above MAX_DECODED_SIZE, or above what the compressed
+     * bytes can possibly inflate to, is rejected before anything is allocated.
+     */
+    static bool decode(const QByteArray& data, const QByteArray& dictionary, QString& text);
+
+    /**
+     * @brief Get the UTF-8 size of encoded text without decoding it
+     * @param data Encoded bytes, or at least their start
+     * @return Size of the decoded UTF-8, or -1 if data is not encoded text
+     *         or claims more than MAX_DECODED_SIZE
+     */
+    static qint64 decodedSize(QByteArrayView data);
+
+    /**
+     * @brief Build a preset dictionary from sample texts
+     * @param samples UTF-8 samples, oldest first
+     * @return Dictionary of at most MAX_DICTIONARY_SIZE bytes
+     *
+     * Deflate finds matches best near the end of the dictionary, so the
+     * newest samples go last; repeated samples are kept only once.
+     */
+    static QByteArray trainDictionary(const QList<QByteArray>& samples);
+
+    /**
+     * @brief Check if this build can deflate
+     */
+    static bool isCompressionAvailable();
+
+    static constexpr int MAX_DICTIONARY_SIZE = 32 * 1024;   ///< Deflate window size
+    static constexpr int MIN_COMPRESS_BYTES = 32;           ///< Shorter text is stored plain
+    static constexpr quint32 MAX_DECODED_SIZE = 64 * 1024 * 1024; ///< Larger texts are never captured
+};
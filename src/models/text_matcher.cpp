@@ -0,0 +1,410 @@
+#include "text_matcher.h"
+#include <QAtomicInt>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TEXT_MATCHER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Scanning kernels. Each one finds the first position at or after from
+// whose code unit equals either variant of a pattern character; the pair
+// variants additionally require the unit span - 1 places later to equal
+// either variant of a second character.
+
+qsizetype findEitherScalar(const char16_t* text, qsizetype length, qsizetype from,
+                           char16_t a, char16_t b)
+{
+    for (qsizetype i = from; i < length; ++i) {
+        if (text[i] == a || text[i] == b) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+qsizetype findPairScalar(const char16_t* text, qsizetype length, qsizetype from, qsizetype span,
+                         char16_t first0, char16_t first1, char16_t last0, char16_t last1)
+{
+    for (qsizetype i = from; i + span <= length; ++i) {
+        char16_t first = text[i];
+        char16_t last = text[i + span - 1];
+        if ((first == first0 || first == first1) && (last == last0 || last == last1)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#ifdef TEXT_MATCHER_X86
+
+__attribute__((target("sse2")))
+qsizetype findEitherSse2(const char16_t* text, qsizetype length, qsizetype from,
+                         char16_t a, char16_t b)
+{
+    const __m128i va = _mm_set1_epi16(short(a));
+    const __m128i vb = _mm_set1_epi16(short(b));
+    qsizetype i = from;
+    for (; i + 8 <= length; i += 8) {
+        __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi16(units, va), _mm_cmpeq_epi16(units, vb));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            return i + (__builtin_ctz(unsigned(mask)) >> 1);
+        }
+    }
+    return findEitherScalar(text, length, i, a, b);
+}
+
+__attribute__((target("sse2")))
+qsizetype findPairSse2(const char16_t* text, qsizetype length, qsizetype from, qsizetype span,
+                       char16_t first0, char16_t first1, char16_t last0, char16_t last1)
+{
+    const __m128i f0 = _mm_set1_epi16(short(first0));
+    const __m128i f1 = _mm_set1_epi16(short(first1));
+    const __m128i l0 = _mm_set1_epi16(short(last0));
+    const __m128i l1 = _mm_set1_epi16(short(last1));
+    qsizetype i = from;
+    for (; i + 8 + span - 1 <= length; i += 8) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + span - 1));
+        __m128i hits = _mm_and_si128(
+            _mm_or_si128(_mm_cmpeq_epi16(first, f0), _mm_cmpeq_epi16(first, f1)),
+            _mm_or_si128(_mm_cmpeq_epi16(last, l0), _mm_cmpeq_epi16(last, l1)));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            return i + (__builtin_ctz(unsigned(mask)) >> 1);
+        }
+    }
+    return findPairScalar(text, length, i, span, first0, first1, last0, last1);
+}
+
+__attribute__((target("avx2")))
+qsizetype findEitherAvx2(const char16_t* text, qsizetype length, qsizetype from,
+                         char16_t a, char16_t b)
+{
+    const __m256i va = _mm256_set1_epi16(short(a));
+    const __m256i vb = _mm256_set1_epi16(short(b));
+    qsizetype i = from;
+    for (; i + 16 <= length; i += 16) {
+        __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi16(units, va), _mm256_cmpeq_epi16(units, vb));
+        unsigned mask = unsigned(_mm256_movemask_epi8(hits));
+        if (mask) {
+            return i + (__builtin_ctz(mask) >> 1);
+        }
+    }
+    return findEitherSse2(text, length, i, a, b);
+}
+
+__attribute__((target("avx2")))
+qsizetype findPairAvx2(const char16_t* text, qsizetype length, qsizetype from, qsizetype span,
+                       char16_t first0, char16_t first1, char16_t last0, char16_t last1)
+{
+    const __m256i f0 = _mm256_set1_epi16(short(first0));
+    const __m256i f1 = _mm256_set1_epi16(short(first1));
+    const __m256i l0 = _mm256_set1_epi16(short(last0));
+    const __m256i l1 = _mm256_set1_epi16(short(last1));
+    qsizetype i = from;
+    for (; i + 16 + span - 1 <= length; i += 16) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + span - 1));
+        __m256i hits = _mm256_and_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi16(first, f0), _mm256_cmpeq_epi16(first, f1)),
+            _mm256_or_si256(_mm256_cmpeq_epi16(last, l0), _mm256_cmpeq_epi16(last, l1)));
+        unsigned mask = unsigned(_mm256_movemask_epi8(hits));
+        if (mask) {
+            return i + (__builtin_ctz(mask) >> 1);
+        }
+    }
+    return findPairSse2(text, length, i, span, first0, first1, last0, last1);
+}
+
+#endif // TEXT_MATCHER_X86
+
+TextMatcher::Kernel detectKernel()
+{
+#ifdef TEXT_MATCHER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return TextMatcher::Avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return TextMatcher::Sse2;
+    }
+#endif
+    return TextMatcher::Scalar;
+}
+
+QAtomicInt selectedKernel(-1); ///< Kernel forced by setKernel(), -1 for the best one
+
+qsizetype findEither(TextMatcher::Kernel kernel, const char16_t* text, qsizetype length,
+                     qsizetype from, char16_t a, char16_t b)
+{
+    switch (kernel) {
+#ifdef TEXT_MATCHER_X86
+        case TextMatcher::Avx2:
+            return findEitherAvx2(text, length, from, a, b);
+        case TextMatcher::Sse2:
+            return findEitherSse2(text, length, from, a, b);
+#endif
+        default:
+            return findEitherScalar(text, length, from, a, b);
+    }
+}
+
+qsizetype findPair(TextMatcher::Kernel kernel, const char16_t* text, qsizetype length,
+                   qsizetype from, qsizetype span,
+                   char16_t first0, char16_t first1, char16_t last0, char16_t last1)
+{
+    switch (kernel) {
+#ifdef TEXT_MATCHER_X86
+        case TextMatcher::Avx2:
+            return findPairAvx2(text, length, from, span, first0, first1, last0, last1);
+        case TextMatcher::Sse2:
+            return findPairSse2(text, length, from, span, first0, first1, last0, last1);
+#endif
+        default:
+            return findPairScalar(text, length, from, span, first0, first1, last0, last1);
+    }
+}
+
+// Fuzzy scoring weights per pattern character
+constexpr int FUZZY_MATCH = 4;
+constexpr int FUZZY_CONSECUTIVE = 6;
+constexpr int FUZZY_WORD_START = 3;
+constexpr int FUZZY_MAX_GAP_PENALTY = 4;
+constexpr int FUZZY_MAX_PER_CHARACTER = FUZZY_MATCH + FUZZY_CONSECUTIVE + FUZZY_WORD_START;
+
+bool isWordStart(QStringView text, qsizetype position)
+{
+    return position == 0 || !text.at(position - 1).isLetterOrNumber();
+}
+
+} // namespace
+
+TextMatcher::TextMatcher(const QString& pattern)
+    : m_pattern(pattern)
+{
+    m_lower.reserve(pattern.size());
+    m_upper.reserve(pattern.size());
+    for (QChar c : pattern) {
+        // Only ASCII characters whose case variants are all ASCII can be
+        // compared unit by unit; K and S also fold from U+212A and U+017F
+        char16_t folded = c.toCaseFolded().unicode();
+        bool vectorizable = c.unicode() < 0x80 && folded != u'k' && folded != u's';
+        bool letter = folded >= u'a' && folded <= u'z';
+        m_lower.append(vectorizable ? folded : 0);
+        m_upper.append(vectorizable ? (letter ? char16_t(folded - 0x20) : folded) : 0);
+    }
+}
+
+qsizetype TextMatcher::indexIn(QStringView text) const
+{
+    const qsizetype span = m_pattern.size();
+    if (span == 0) {
+        return 0;
+    }
+    if (text.size() < span) {
+        return -1;
+    }
+    if (m_lower.first() == 0 || m_lower.last() == 0) {
+        return text.indexOf(m_pattern, 0, Qt::CaseInsensitive);
+    }
+
+    const Kernel active = kernel();
+    const char16_t* units = text.utf16();
+    const QStringView middle = QStringView(m_pattern).mid(1, qMax<qsizetype>(span - 2, 0));
+    qsizetype from = 0;
+    for (;;) {
+        qsizetype position = findPair(active, units, text.size(), from, span,
+                                      m_lower.first(), m_upper.first(),
+                                      m_lower.last(), m_upper.last());
+        if (position < 0) {
+            return -1;
+        }
+        if (span <= 2 || text.mid(position + 1, span - 2).compare(middle, Qt::CaseInsensitive) == 0) {
+            return position;
+        }
+        from = position + 1;
+    }
+}
+
+bool TextMatcher::isPrefixOf(QStringView text) const
+{
+    return text.startsWith(m_pattern, Qt::CaseInsensitive);
+}
+
+int TextMatcher::fuzzyScore(QStringView text) const
+{
+    if (m_pattern.isEmpty()) {
+        return 1;
+    }
+
+    int score = 0;
+    qsizetype previous = -1;
+    for (int i = 0; i < m_pattern.size(); ++i) {
+        qsizetype position = findCharacter(text, previous + 1, i);
+        if (position < 0) {
+            return 0;
+        }
+
+        score += FUZZY_MATCH;
+        if (previous >= 0 && position == previous + 1) {
+            score += FUZZY_CONSECUTIVE;
+        } else if (previous >= 0) {
+            score -= int(qMin<qsizetype>(position - previous - 1, FUZZY_MAX_GAP_PENALTY));
+        }
+        if (isWordStart(text, position)) {
+            score += FUZZY_WORD_START;
+        }
+        previous = position;
+    }
+    return qMax(score, 1);
+}
+
+int TextMatcher::matchScore(QStringView text) const
+{
+    qsizetype position = indexIn(text);
+    if (position >= 0) {
+        int bonus = position == 0 ? PREFIX_BONUS : (isWordStart(text, position) ? WORD_START_BONUS : 0);
+        return SUBSTRING_SCORE + bonus + int(100 - qMin<qsizetype>(position, 100));
+    }
+
+    // Scale fuzzy scores below the weakest substring match
+    int fuzzy = fuzzyScore(text);
+    if (fuzzy == 0) {
+        return 0;
+    }
+    int best = FUZZY_MAX_PER_CHARACTER * int(m_pattern.size());
+    return qBound(1, fuzzy * (SUBSTRING_SCORE - 1) / best, SUBSTRING_SCORE - 1);
+}
+
+template <typename Score>
+QList<TextMatcher::RankedItem> TextMatcher::rankRange(int from, int to, int limit, Score score)
+{
+    QList<RankedItem> heap;
+    if (limit <= 0) {
+        return heap;
+    }
+
+    // Keep the best limit items in a heap whose front is the weakest of them
+    heap.reserve(qMin(limit, qMax(to - from, 0)));
+    for (int i = from; i < to; ++i) {
+        RankedItem ranked;
+        ranked.index = i;
+        ranked.score = score(i);
+        if (ranked.score == 0) {
+            continue;
+        }
+
+        if (heap.size() < limit) {
+            heap.append(ranked);
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        } else if (isBetter(ranked, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), isBetter);
+            heap.back() = ranked;
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), isBetter);
+    return heap;
+}
+
+QList<TextMatcher::RankedItem> TextMatcher::rank(const QList<ClipboardItem>& items, int limit,
+                                                 qint64 nowMs) const
+{
+    return rankRange(0, int(items.size()), limit, [&](int index) {
+        return itemScore(items.at(index), nowMs);
+    });
+}
+
+QList<TextMatcher::RankedItem> TextMatcher::rank(const HistoryView& view, int from, int to,
+                                                 int limit, qint64 nowMs) const
+{
+    return rankRange(qMax(from, 0), qMin(to, view.count()), limit, [&](int index) {
+        return itemScore(view.at(index), nowMs);
+    });
+}
+
+QList<TextMatcher::RankedItem> TextMatcher::mergeRanked(const QList<RankedItem>& a,
+                                                        const QList<RankedItem>& b, int limit)
+{
+    QList<RankedItem> merged;
+    merged.reserve(qMin(qMax(limit, 0), int(a.size() + b.size())));
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged), isBetter);
+    if (merged.size() > limit) {
+        merged.resize(qMax(limit, 0));
+    }
+    return merged;
+}
+
+int TextMatcher::itemScore(const ClipboardItem& item, qint64 nowMs) const
+{
+    int match = matchScore(item.text());
+    if (match == 0) {
+        return 0;
+    }
+
+    int score = match + (item.pinned() ? PINNED_BONUS : 0);
+    if (item.hasTimestamp()) {
+        double ageHours = double(qMax<qint64>(0, nowMs - item.timestampMs())) / 3600000.0;
+        score += int(RECENCY_BONUS / std::exp2(ageHours));
+    }
+    return score;
+}
+
+bool TextMatcher::isBetter(const RankedItem& a, const RankedItem& b)
+{
+    return a.score != b.score ? a.score > b.score : a.index < b.index;
+}
+
+TextMatcher::Kernel TextMatcher::kernel()
+{
+    int selected = selectedKernel.loadRelaxed();
+    return selected >= 0 ? Kernel(selected) : bestKernel();
+}
+
+TextMatcher::Kernel TextMatcher::bestKernel()
+{
+    static const Kernel best = detectKernel();
+    return best;
+}
+
+void TextMatcher::setKernel(Kernel kernel)
+{
+    selectedKernel.storeRelaxed(qMin(int(kernel), int(bestKernel())));
+}
+
+QString TextMatcher::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Avx2:
+            return "AVX2";
+        case Sse2:
+            return "SSE2";
+        default:
+            return "scalar";
+    }
+}
+
+qsizetype TextMatcher::findCharacter(QStringView text, qsizetype from, int index) const
+{
+    if (m_lower.at(index) != 0) {
+        return findEither(kernel(), text.utf16(), text.size(), from,
+                          m_lower.at(index), m_upper.at(index));
+    }
+
+    const QChar folded = m_pattern.at(index).toCaseFolded();
+    for (qsizetype i = from; i < text.size(); ++i) {
+        if (text.at(i).toCaseFolded() == folded) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include "clipboard_item.h"
+#include "history_view.h"
+
+/**
+ * @brief Case-insensitive substring and subsequence matcher for history text
+ *
+ * Scanning is done by a vectorized kernel that compares 8 (SSE2) or 16
+ * (AVX2) UTF-16 code units per step against the first and last pattern
+ * characters, so only positions where both ends match are compared in
+ * full. The kernel is picked at runtime from what the CPU supports, with
+ * a scalar fallback on other architectures.
+ *
+ * Patterns whose end characters have case variants outside ASCII (and the
+ * ASCII letters k and s, which have such variants) are matched with
+ * QStringView::indexOf() instead, so results always agree with
+ * QString::contains(pattern, Qt::CaseInsensitive).
+ */
+class TextMatcher
+{
+public:
+    /**
+     * @brief Scanning implementation
+     */
+    enum Kernel {
+        Scalar,                      ///< Portable code unit loop
+        Sse2,                        ///< 128-bit, baseline on x86-64
+        Avx2                         ///< 256-bit
+    };
+
+    /**
+     * @brief Item chosen by rank()
+     */
+    struct RankedItem {
+        int index = -1;              ///< Position in the ranked list
+        int score = 0;               ///< Combined score, higher is better
+    };
+
+    /**
+     * @brief Create matcher for a pattern
+     * @param pattern Text to look for
+     */
+    explicit TextMatcher(const QString& pattern);
+
+    // Getters
+    const QString& pattern() const { return m_pattern; }
+    bool isEmpty() const { return m_pattern.isEmpty(); }
+
+    /**
+     * @brief Find the pattern ignoring case
+     * @param text Text to search
+     * @return Position of the first occurrence, or -1 if not found
+     */
+    qsizetype indexIn(QStringView text) const;
+
+    /**
+     * @brief Check if text contains the pattern ignoring case
+     */
+    bool contains(QStringView text) const { return indexIn(text) >= 0; }
+
+    /**
+     * @brief Check if text starts with the pattern ignoring case
+     */
+    bool isPrefixOf(QStringView text) const;
+
+    /**
+     * @brief Score text as a subsequence ("fuzzy") match
+     * @param text Text to search
+     * @return Positive score if every pattern character occurs in order,
+     *         0 otherwise; consecutive and word-start matches score higher
+     */
+    int fuzzyScore(QStringView text) const;
+
+    /**
+     * @brief Score text combining the best match type
+     * @param text Text to search
+     * @return Substring matches score above any fuzzy match; 0 if no match
+     */
+    int matchScore(QStringView text) const;
+
+    /**
+     * @brief Find the best matching items
+     * @param items Items to rank
+     * @param limit Maximum number of results
+     * @param nowMs Current time for the recency bonus (ms since epoch)
+     * @return Up to limit items, best first
+     *
+     * The score adds a bonus that halves with every hour of item age and a
+     * fixed bonus for pinned items to matchScore(); items that do not match
+     * are never returned.
+     */
+    QList<RankedItem> rank(const QList<ClipboardItem>& items, int limit, qint64 nowMs) const;
+
+    /**
+     * @brief Find the best matching items in part of a history view
+     * @param view Items to rank
+     * @param from First display position to consider
+     * @param to Display position after the last one to consider
+     * @param limit Maximum number of results
+     * @param nowMs Current time for the recency bonus (ms since epoch)
+     * @return Up to limit items, best first, indexed by view position
+     */
+    QList<RankedItem> rank(const HistoryView& view, int from, int to, int limit, qint64 nowMs) const;
+
+    /**
+     * @brief Combine two rank() results over disjoint items
+     * @param a Ranked items, best first
+     * @param b Ranked items, best first
+     * @param limit Maximum number of results
+     * @return Up to limit items of both, best first
+     */
+    static QList<RankedItem> mergeRanked(const QList<RankedItem>& a, const QList<RankedItem>& b,
+                                         int limit);
+
+    /**
+     * @brief Get the kernel used for scanning
+     */
+    static Kernel kernel();
+
+    /**
+     * @brief Get the fastest kernel this CPU supports
+     */
+    static Kernel bestKernel();
+
+    /**
+     * @brief Select the kernel used for scanning (for tests and benchmarks)
+     * @param kernel Requested kernel; clamped to bestKernel()
+     */
+    static void setKernel(Kernel kernel);
+
+    /**
+     * @brief Get a kernel's display name
+     */
+    static QString kernelName(Kernel kernel);
+
+private:
+    /**
+     * @brief Find the next position holding a pattern character
+     * @param text Text to search
+     * @param from First position to look at
+     * @param index Index of the pattern character
+     * @return Position, or -1 if not found
+     */
+    qsizetype findCharacter(QStringView text, qsizetype from, int index) const;
+
+    /**
+     * @brief Rank positions from..to by score(position), skipping zero scores
+     */
+    template <typename Score>
+    static QList<RankedItem> rankRange(int from, int to, int limit, Score score);
+
+    /**
+     * @brief Score an item for rank(), 0 if it does not match
+     */
+    int itemScore(const ClipboardItem& item, qint64 nowMs) const;
+
+    /**
+     * @brief Ranking order: higher score first, then lower index
+     */
+    static bool isBetter(const RankedItem& a, const RankedItem& b);
+
+    static constexpr int SUBSTRING_SCORE = 1000;
+    static constexpr int PREFIX_BONUS = 200;
+    static constexpr int WORD_START_BONUS = 100;
+    static constexpr int RECENCY_BONUS = 200;
+    static constexpr int PINNED_BONUS = 300;
+
+    QString m_pattern;               ///< Pattern as given
+    QList<char16_t> m_lower;         ///< Lowercase ASCII variant per character, 0 if not vectorizable
+    QList<char16_t> m_upper;         ///< Uppercase ASCII variant per character
+};
@@ -3,13 +3,39 @@
 #include <QDir>
 #include <QDebug>
 #include <QMimeData>
+#include <QFile>
 #include <QElapsedTimer>
+#include <QDateTime>
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
+#include <QLocale>
+#include <QUrl>
+#include <QtConcurrent>
+#include "../lib/metrics.h"
+#include "../models/history_journal.h"
+#include "content_classifier.h"
+#include "history_search.h"
+#include "payload_mime_data.h"
 
 ClipboardManager::ClipboardManager(QObject* parent)
+    : ClipboardManager(LoadMode::Blocking, parent)
+{
+}
+
+ClipboardManager::ClipboardManager(LoadMode loadMode, QObject* parent)
     : QObject(parent)
     , m_clipboard(QApplication::clipboard())
+    , m_blobs(QString())
     , m_monitoring(false)
     , m_saveTimer(new QTimer(this))
+    , m_captureTimer(new QTimer(this))
+    , m_retentionTimer(new QTimer(this))
+    , m_persistence(nullptr)
+    , m_lastPayloadTicket(0)
+    , m_claimedPayloadTicket(0)
+    , m_loadingHistory(false)
+    , m_monitorAfterLoad(false)
     , m_lastProcessTime(0)
 {
     // Initialize configuration
@@ -20,32 +46,93 @@ ClipboardManager::ClipboardManager(QObject* parent)
             this, &ClipboardManager::itemAdded);
     connect(&m_history, &ClipboardHistory::itemRemoved,
             this, &ClipboardManager::itemRemoved);
+    connect(&m_history, &ClipboardHistory::itemsRemoved,
+            this, &ClipboardManager::itemsRemoved);
     connect(&m_history, &ClipboardHistory::itemPinned,
             this, &ClipboardManager::itemPinned);
     connect(&m_history, &ClipboardHistory::itemUnpinned,
             this, &ClipboardManager::itemUnpinned);
     connect(&m_history, &ClipboardHistory::orderChanged,
             this, &ClipboardManager::historyChanged);
+    connect(&m_history, &ClipboardHistory::itemInsertedAt,
+            this, &ClipboardManager::itemInsertedAt);
+    connect(&m_history, &ClipboardHistory::itemRemovedAt,
+            this, &ClipboardManager::itemRemovedAt);
+    connect(&m_history, &ClipboardHistory::itemMoved,
+            this, &ClipboardManager::itemMoved);
+    connect(&m_history, &ClipboardHistory::itemsReset,
+            this, &ClipboardManager::historyReset);
     connect(&m_config, &Configuration::maxHistoryItemsChanged,
             this, &ClipboardManager::onConfigurationChanged);
+    connect(&m_config, &Configuration::retentionDaysChanged,
+            this, &ClipboardManager::applyRetentionPolicy);
+    connect(&m_config, &Configuration::maxHistorySizeMbChanged,
+            this, &ClipboardManager::applyRetentionPolicy);
+    connect(&m_config, &Configuration::maxItemSizeKbChanged,
+            this, &ClipboardManager::applyRetentionPolicy);
+    
+    // Timers are named for the wakeup counts of --profile-footprint
+    m_saveTimer->setObjectName("saveTimer");
+    m_captureTimer->setObjectName("captureTimer");
+    m_retentionTimer->setObjectName("retentionTimer");
     
-    // Setup save timer for deferred persistence
+    // Setup save timer for deferred journal compaction
     m_saveTimer->setSingleShot(true);
     m_saveTimer->setInterval(1000); // 1 second delay for batching
     connect(m_saveTimer, &QTimer::timeout,
-            this, &ClipboardManager::saveHistory);
+            this, &ClipboardManager::requestSave);
     
-    // Load existing history
-    loadHistory();
+    // Clipboard bursts are coalesced; the clipboard is read once they settle
+    m_captureTimer->setSingleShot(true);
+    m_captureTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_captureTimer, &QTimer::timeout,
+            this, &ClipboardManager::captureClipboard);
+    
+    // Age and size limits are enforced by a coarse periodic sweep, off the capture path
+    m_retentionTimer->setInterval(RETENTION_SWEEP_MS);
+    m_retentionTimer->setTimerType(Qt::VeryCoarseTimer);
+    connect(m_retentionTimer, &QTimer::timeout,
+            this, &ClipboardManager::sweepRetention);
+    
+    // Images, file lists and large text are stored next to the history file
+    m_blobs = BlobStore(m_config.configDirectory() + "/blobs");
+    
+    // Older items live in an on-disk cold segment next to the history file
+    if (!m_history.attachColdStore(m_config.configDirectory() + "/clipboard-history.cold")) {
+        qWarning() << "Cold history segment unavailable, keeping all items in memory";
+    }
+    
+    connect(&m_loadWatcher, &QFutureWatcher<DecodedHistory>::finished,
+            this, &ClipboardManager::onHistoryDecoded);
+    
+    // Load existing history, then journal every change made from here on
+    m_persistence = new PersistenceWorker(m_config.configDirectory() + "/clipboard-history.bin",
+                                          m_config.configDirectory() + "/clipboard-history.journal",
+                                          m_blobs.directory());
+    if (loadMode == LoadMode::Blocking) {
+        loadHistory();
+    }
+    startPersistence();
+    connectJournal();
     
     // Apply configuration to history
     m_history.setMaxItems(m_config.maxHistoryItems());
+    applyRetentionPolicy();
+    
+    if (loadMode == LoadMode::Background) {
+        startBackgroundLoad();
+    }
 }
 
 ClipboardManager::~ClipboardManager()
 {
     stopMonitoring();
+    stopTraceRecording();
     saveHistory();
+    
+    m_persistenceThread.quit();
+    m_persistenceThread.wait();
+    delete m_persistence;
 }
 
 QList<ClipboardItem> ClipboardManager::getHistory() const
@@ -53,6 +140,68 @@ QList<ClipboardItem> ClipboardManager::getHistory() const
     return m_history.items();
 }
 
+HistoryView ClipboardManager::historyView() const
+{
+    return m_history.view();
+}
+
+QList<ClipboardItem> ClipboardManager::historyItems(int limit) const
+{
+    QList<ClipboardItem> items = historyView().items(limit);
+    if (items.size() < limit) {
+        items.append(m_history.coldItems(0, limit - int(items.size())));
+    }
+    return items;
+}
+
+QList<ClipboardItem> ClipboardManager::rankHistory(const QString& pattern, int limit) const
+{
+    using RankedItem = TextMatcher::RankedItem;
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    
+    // Ranked items index candidates; hot ones come first so ties keep display order
+    const HistoryView view = historyView();
+    QList<ClipboardItem> candidates;
+    QList<RankedItem> ranked = HistorySearch::rank(view, pattern, limit, nowMs);
+    for (RankedItem& item : ranked) {
+        candidates.append(view.at(item.index));
+        item.index = int(candidates.size()) - 1;
+    }
+    
+    const TextMatcher matcher(pattern);
+    for (int from = 0; from < m_history.coldCount(); from += COLD_RANK_CHUNK) {
+        const QList<ClipboardItem> chunk = m_history.coldItems(from, COLD_RANK_CHUNK, true);
+        QList<RankedItem> chunkRanked = matcher.rank(chunk, limit, nowMs);
+        for (RankedItem& item : chunkRanked) {
+            candidates.append(chunk.at(item.index));
+            item.index = int(candidates.size()) - 1;
+        }
+        ranked = TextMatcher::mergeRanked(ranked, chunkRanked, limit);
+        
+        // Only the current best stay loaded. Renumbering them in rank order
+        // keeps ties in display order, since later chunks hold older items.
+        QList<ClipboardItem> kept;
+        kept.reserve(ranked.size());
+        for (RankedItem& item : ranked) {
+            kept.append(candidates.at(item.index));
+            item.index = int(kept.size()) - 1;
+        }
+        candidates = kept;
+    }
+    
+    QList<ClipboardItem> items;
+    items.reserve(ranked.size());
+    for (const RankedItem& item : ranked) {
+        items.append(candidates.at(item.index));
+    }
+    return items;
+}
+
+ClipboardHistory::MemoryUsage ClipboardManager::memoryUsage() const
+{
+    return m_history.memoryUsage();
+}
+
 ClipboardItem ClipboardManager::getItem(const QString& id) const
 {
     return m_history.getItem(id);
@@ -106,6 +255,47 @@ bool ClipboardManager::removeItem(const QString& id)
     return false;
 }
 
+bool ClipboardManager::copyToClipboard(const ClipboardItem& item)
+{
+    if (!m_clipboard) {
+        return false;
+    }
+    
+    // Items from the cold segment may be handed out without their text
+    const ClipboardItem full = item.hasText() ? item : m_history.getItem(item.id());
+    if (!full.isValid()) {
+        return false;
+    }
+    
+    if (!full.hasPayload()) {
+        m_clipboard->setText(full.text());
+        return true;
+    }
+    
+    BlobStore::Blob blob = m_blobs.open(full.payload().key);
+    if (!blob.isValid()) {
+        emit error(QString("Stored clipboard content is missing: %1").arg(full.preview()));
+        return false;
+    }
+    m_clipboard->setMimeData(new PayloadMimeData(full, blob));
+    return true;
+}
+
+QString ClipboardManager::fullText(const ClipboardItem& item) const
+{
+    const ClipboardItem full = item.hasText() ? item : m_history.getItem(item.id());
+    if (!full.hasPayload() || full.payload().mimeType != QLatin1String("text/plain")) {
+        return full.text();
+    }
+
+    BlobStore::Blob blob = m_blobs.open(full.payload().key);
+    if (!blob.isValid()) {
+        qWarning() << "ClipboardManager: Stored text is missing, using its start:" << full.preview();
+        return full.text();
+    }
+    return QString::fromUtf8(blob.bytes());
+}
+
 int ClipboardManager::maxHistoryItems() const
 {
     return m_config.maxHistoryItems();
@@ -114,8 +304,11 @@ int ClipboardManager::maxHistoryItems() const
 void ClipboardManager::setMaxHistoryItems(int max)
 {
     // Validate range as per contract tests
-    if (max < 10 || max > 100) {
-        emit error(QString("Invalid max history items: %1. Must be 10-100.").arg(max));
+    if (!Configuration::isValidMaxHistoryItems(max)) {
+        emit error(QString("Invalid max history items: %1. Must be %2-%3.")
+                   .arg(max)
+                   .arg(Configuration::minHistoryLimit())
+                   .arg(Configuration::maxHistoryLimit()));
         return;
     }
     
@@ -126,12 +319,29 @@ void ClipboardManager::setMaxHistoryItems(int max)
 
 bool ClipboardManager::loadHistory()
 {
+    m_loadTimer.start();
+    
+    // Let queued journal writes land before reading the journal back
+    flushPersistence();
+    
     try {
-        QString historyPath = m_config.configDirectory() + "/clipboard-history.json";
-        if (m_history.loadFromFile(historyPath)) {
-            emit historyChanged();
-            return true;
+        QString snapshotPath = m_config.configDirectory() + "/clipboard-history.bin";
+        QString legacyPath = m_config.configDirectory() + "/clipboard-history.json";
+        bool loaded = false;
+        
+        // One-time import of the JSON history written by earlier versions
+        if (QFile::exists(legacyPath) && m_history.loadFromFile(legacyPath)) {
+            loaded = true;
+            if (m_history.saveToSnapshot(snapshotPath)) {
+                QFile::remove(legacyPath + ".bak");
+                QFile::rename(legacyPath, legacyPath + ".bak");
+            }
+        }
+        if (!loaded) {
+            loaded = m_history.loadFromSnapshot(snapshotPath);
         }
+        
+        return finishLoad(loaded);
     } catch (const std::exception& e) {
         emit error(QString("Failed to load history: %1").arg(e.what()));
     }
@@ -139,18 +349,56 @@ bool ClipboardManager::loadHistory()
     return false;
 }
 
+bool ClipboardManager::isLoadingHistory() const
+{
+    return m_loadingHistory;
+}
+
+void ClipboardManager::waitForHistoryLoaded()
+{
+    if (!m_loadingHistory) {
+        return;
+    }
+    m_loadWatcher.waitForFinished();
+    onHistoryDecoded();
+}
+
 bool ClipboardManager::saveHistory()
 {
-    try {
-        QString historyPath = m_config.configDirectory() + "/clipboard-history.json";
-        if (m_history.saveToFile(historyPath)) {
-            return true;
-        }
-    } catch (const std::exception& e) {
-        emit error(QString("Failed to save history: %1").arg(e.what()));
+    // The snapshot must not be replaced by a history that never finished loading
+    waitForHistoryLoaded();
+    
+    // Content still being coalesced belongs in the snapshot
+    if (m_captureTimer->isActive()) {
+        captureClipboard();
     }
     
-    return false;
+    // Runs behind any queued journal writes; only blocks for explicit saves
+    bool saved = false;
+    int maxItems = m_history.maxItems();
+    QList<ClipboardItem> items = m_history.items();
+    auto write = [&]() {
+        saved = m_persistence->writeSnapshot(maxItems, items);
+    };
+    
+    if (m_persistenceThread.isRunning()) {
+        QMetaObject::invokeMethod(m_persistence, write, Qt::BlockingQueuedConnection);
+    } else {
+        write();
+    }
+    return saved;
+}
+
+void ClipboardManager::requestSave()
+{
+    // Until the loaded history is applied a snapshot would drop it
+    if (m_loadingHistory) {
+        m_saveTimer->start();
+        return;
+    }
+    
+    // The item list is implicitly shared, so the worker gets an immutable copy
+    m_persistence->requestSnapshot(m_history.maxItems(), m_history.items());
 }
 
 void ClipboardManager::startMonitoring()
@@ -159,6 +407,12 @@ void ClipboardManager::startMonitoring()
         return;
     }
     
+    // Captures would race the loaded history; start once it is in place
+    if (m_loadingHistory) {
+        m_monitorAfterLoad = true;
+        return;
+    }
+    
     connect(m_clipboard, &QClipboard::dataChanged,
             this, &ClipboardManager::onClipboardChanged);
     
@@ -168,6 +422,7 @@ void ClipboardManager::startMonitoring()
 
 void ClipboardManager::stopMonitoring()
 {
+    m_monitorAfterLoad = false;
     if (!m_monitoring || !m_clipboard) {
         return;
     }
@@ -175,6 +430,11 @@ void ClipboardManager::stopMonitoring()
     disconnect(m_clipboard, &QClipboard::dataChanged,
                this, &ClipboardManager::onClipboardChanged);
     
+    // Changes still being coalesced arrived while monitoring; capture them
+    if (m_captureTimer->isActive()) {
+        captureClipboard();
+    }
+    
     m_monitoring = false;
     emit monitoringStateChanged(false);
 }
@@ -184,23 +444,116 @@ bool ClipboardManager::isMonitoring() const
     return m_monitoring;
 }
 
+bool ClipboardManager::processText(const QString& content)
+{
+    if (!m_tracePath.isEmpty()) {
+        m_trace.record(content);
+    }
+    if (!shouldAddContent(content)) {
+        return false;
+    }
+    return content.size() > MAX_INLINE_TEXT_LENGTH ? processLargeText(content)
+                                                   : processClipboardContent(content);
+}
+
+bool ClipboardManager::startTraceRecording(const QString& filePath)
+{
+    stopTraceRecording();
+    
+    // Fail early rather than losing the whole trace on exit
+    QFile probe(filePath);
+    if (!probe.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "ClipboardManager: Cannot record trace to" << filePath << ":" << probe.errorString();
+        return false;
+    }
+    
+    m_trace.start();
+    m_tracePath = filePath;
+    return true;
+}
+
+bool ClipboardManager::stopTraceRecording()
+{
+    if (m_tracePath.isEmpty()) {
+        return false;
+    }
+    
+    const bool saved = m_trace.save(m_tracePath);
+    if (saved) {
+        qInfo() << "ClipboardManager: Recorded" << m_trace.count() << "clipboard events to" << m_tracePath;
+    }
+    m_trace = WorkloadTrace();
+    m_tracePath.clear();
+    return saved;
+}
+
+bool ClipboardManager::isRecordingTrace() const
+{
+    return !m_tracePath.isEmpty();
+}
+
 void ClipboardManager::onClipboardChanged()
 {
     if (!m_clipboard) {
         return;
     }
     
+    const int debounceMs = m_config.captureDebounceMs();
+    if (debounceMs <= 0) {
+        captureClipboard();
+        return;
+    }
+    
+    // Latest wins: every change restarts the window, but a burst that never
+    // pauses is still captured once per MAX_COALESCE_WINDOWS windows
+    if (!m_burstTimer.isValid()) {
+        m_burstTimer.start();
+    }
+    if (!m_captureTimer->isActive() || m_burstTimer.elapsed() < qint64(debounceMs) * MAX_COALESCE_WINDOWS) {
+        m_captureTimer->start(debounceMs);
+    }
+}
+
+void ClipboardManager::captureClipboard()
+{
+    m_captureTimer->stop();
+    m_burstTimer.invalidate();
+    if (!m_clipboard) {
+        return;
+    }
+    
     QElapsedTimer timer;
     timer.start();
     
     const QMimeData* mimeData = m_clipboard->mimeData();
-    if (!mimeData || !mimeData->hasText()) {
+    if (!mimeData) {
         return;
     }
+    Metrics::add(Metrics::EventsCaptured);
     
-    QString content = mimeData->text();
+    // Password managers tag secrets; those are never read, let alone stored
+    if (ContentClassifier::isConcealed(mimeData)) {
+        Metrics::add(Metrics::ContentFiltered);
+        return;
+    }
+    
+    // File managers offer their selection as a URI list with the paths as
+    // text; keep the list so it pastes back as files. Other text wins over
+    // images, which applications often add as a rendering of it.
+    bool added = false;
+    if (const auto* pasted = qobject_cast<const PayloadMimeData*>(mimeData)) {
+        // Pasted back from the history; the payload is already stored
+        const ClipboardItem& item = pasted->item();
+        added = addCapturedItem(ClipboardItem::fromPayload(item.payload(), item.text(), item.preview()));
+    } else if (mimeData->hasUrls() && mimeData->urls().constFirst().isLocalFile()) {
+        added = processUriList(mimeData);
+    } else if (mimeData->hasText()) {
+        added = processText(mimeData->text());
+    } else if (mimeData->hasImage()) {
+        added = processImage(mimeData);
+    }
     
-    if (processClipboardContent(content)) {
+    if (added) {
         // Check performance contract: <50ms processing time
         qint64 elapsed = timer.elapsed();
         if (elapsed > 50) {
@@ -209,6 +562,7 @@ void ClipboardManager::onClipboardChanged()
         }
         
         m_lastProcessTime = elapsed;
+        Metrics::record(Metrics::CaptureLatency, timer.nsecsElapsed());
     }
 }
 
@@ -219,38 +573,151 @@ void ClipboardManager::onConfigurationChanged()
     scheduleSave();
 }
 
+void ClipboardManager::applyRetentionPolicy()
+{
+    ClipboardHistory::RetentionPolicy policy;
+    policy.maxAgeMs = qint64(m_config.retentionDays()) * 24 * 60 * 60 * 1000;
+    policy.maxTotalBytes = qint64(m_config.maxHistorySizeMb()) * 1024 * 1024;
+    policy.maxItemBytes = qint64(m_config.maxItemSizeKb()) * 1024;
+    m_history.setRetentionPolicy(policy);
+    
+    if (!policy.isEnabled()) {
+        m_retentionTimer->stop();
+        return;
+    }
+    if (!m_retentionTimer->isActive()) {
+        m_retentionTimer->start();
+    }
+    // Tightened limits apply right away rather than at the next tick
+    QTimer::singleShot(0, this, &ClipboardManager::sweepRetention);
+}
+
+void ClipboardManager::sweepRetention()
+{
+    // The loaded history is swept once it has been applied
+    if (m_loadingHistory) {
+        return;
+    }
+    m_history.applyRetention(QDateTime::currentMSecsSinceEpoch());
+}
+
 bool ClipboardManager::processClipboardContent(const QString& content)
 {
-    if (!shouldAddContent(content)) {
+    if (content.size() > MAX_INLINE_TEXT_LENGTH) {
         return false;
     }
     
-    ClipboardItem item(content);
-    if (!item.isValid()) {
+    // The history keys the content once and only builds an item for new content;
+    // re-copied content moves to the top. Evictions and demotions caused by
+    // the add are folded into a single change notification.
+    m_history.beginUpdate();
+    bool added = !m_history.addItem(content).isEmpty();
+    m_history.endUpdate();
+    return added;
+}
+
+bool ClipboardManager::processLargeText(const QString& content)
+{
+    if (!ClipboardItem::validateText(content)) {
         return false;
     }
     
-    // Check for duplicates using hasDuplicate method
-    if (m_history.hasDuplicate(content)) {
-        // Move existing item to top by removing and re-adding
-        // Find the item by hash (this is inefficient but works for now)
-        auto items = m_history.items();
-        for (const auto& existingItem : items) {
-            if (existingItem.hash() == item.hash()) {
-                m_history.removeItem(existingItem.id());
-                m_history.addItem(existingItem);
-                return true;
-            }
+    // Only the start is kept in memory, for display and search
+    return addPayload(QStringLiteral("text/plain"), content.toUtf8(),
+                      content.left(MAX_STAND_IN_LENGTH), ClipboardItem::generatePreview(content));
+}
+
+bool ClipboardManager::processUriList(const QMimeData* mimeData)
+{
+    const QList<QUrl> urls = mimeData->urls();
+    QStringList names;
+    names.reserve(urls.size());
+    for (const QUrl& url : urls) {
+        names.append(url.isLocalFile() ? url.toLocalFile() : url.toString());
+    }
+    
+    const QString joined = names.join(QStringLiteral(", "));
+    const QString preview = ClipboardItem::generatePreview(
+        names.size() > 1 ? QString("%1 files: %2").arg(names.size()).arg(joined) : joined);
+    return addPayload(QStringLiteral("text/uri-list"), mimeData->data(QStringLiteral("text/uri-list")),
+                      names.join(QLatin1Char('\n')), preview);
+}
+
+bool ClipboardManager::processImage(const QMimeData* mimeData)
+{
+    // Keep PNG data as offered; anything else is encoded to PNG once
+    QByteArray png = mimeData->data(QStringLiteral("image/png"));
+    if (png.isEmpty()) {
+        const QImage image = qvariant_cast<QImage>(mimeData->imageData());
+        if (image.isNull()) {
+            return false;
+        }
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (!image.save(&buffer, "PNG")) {
+            qWarning() << "ClipboardManager: Cannot encode clipboard image";
+            return false;
         }
     }
     
-    // Add new item - addItem returns the ID as QString
-    QString id = m_history.addItem(item);
-    if (!id.isEmpty()) {
-        return true;
+    // The header is enough for the dimensions; the image is never decoded
+    QBuffer buffer(&png);
+    QImageReader reader(&buffer, "png");
+    const QSize size = reader.size();
+    const QString text = size.isValid() ? QString("Image %1x%2").arg(size.width()).arg(size.height())
+                                        : QString("Image");
+    const QString preview = QString("%1 (%2)").arg(text, QLocale().formattedDataSize(png.size()));
+    return addPayload(QStringLiteral("image/png"), png, text, preview);
+}
+
+bool ClipboardManager::addPayload(const QString& mimeType, const QByteArray& data,
+                                  const QString& text, const QString& preview)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+    if (data.size() > MAX_PAYLOAD_BYTES) {
+        qWarning() << "ClipboardManager: Ignoring" << mimeType << "content of" << data.size()
+                   << "bytes, limit is" << MAX_PAYLOAD_BYTES;
+        return false;
     }
     
-    return false;
+    // Hashing and syncing the bytes happens on the persistence thread; the
+    // item is added once the key comes back
+    PendingPayload pending;
+    pending.mimeType = mimeType;
+    pending.size = data.size();
+    pending.text = text;
+    pending.preview = preview;
+    const quint64 ticket = ++m_lastPayloadTicket;
+    m_pendingPayloads.insert(ticket, pending);
+    m_persistence->storePayload(ticket, data);
+    return true;
+}
+
+void ClipboardManager::onPayloadStored(quint64 ticket, const QString& key)
+{
+    // Results arrive in ticket order
+    m_claimedPayloadTicket = ticket;
+    const PendingPayload pending = m_pendingPayloads.take(ticket);
+    if (key.isEmpty()) {
+        emit error(QString("Failed to store %1 clipboard content").arg(pending.mimeType));
+        return;
+    }
+    
+    ClipboardItem::Payload payload;
+    payload.mimeType = pending.mimeType;
+    payload.key = key;
+    payload.size = pending.size;
+    addCapturedItem(ClipboardItem::fromPayload(payload, pending.text, pending.preview));
+}
+
+bool ClipboardManager::addCapturedItem(const ClipboardItem& item)
+{
+    m_history.beginUpdate();
+    bool added = !m_history.addItem(item).isEmpty();
+    m_history.endUpdate();
+    return added;
 }
 
 void ClipboardManager::initializeConfiguration()
@@ -261,32 +728,154 @@ void ClipboardManager::initializeConfiguration()
         // Set defaults
         m_config.setMaxHistoryItems(50);
         m_config.setHotkey("Meta+V");
-        m_config.save();
+        m_config.scheduleSave();
     }
 }
 
 void ClipboardManager::scheduleSave()
 {
-    // Defer save operations to batch rapid changes
-    m_saveTimer->start();
+    // Changes are already durable in the journal; only compact once it has grown
+    if (m_persistence->pendingRecords() >= JOURNAL_COMPACT_RECORDS && !m_saveTimer->isActive()) {
+        m_saveTimer->start();
+    }
 }
 
-bool ClipboardManager::shouldAddContent(const QString& content) const
+void ClipboardManager::connectJournal()
 {
-    // Filter out empty or very short content
-    if (content.trimmed().isEmpty() || content.length() < 2) {
-        return false;
+    connect(&m_history, &ClipboardHistory::itemAdded, this, [this](const ClipboardItem& item) {
+        m_persistence->recordAdded(item);
+        scheduleSave();
+    });
+    connect(&m_history, &ClipboardHistory::itemUpdated, this, [this](const ClipboardItem& item) {
+        m_persistence->recordAdded(item);
+        scheduleSave();
+    });
+    connect(&m_history, &ClipboardHistory::itemRemoved, this, [this](const QString& id) {
+        m_persistence->recordRemoved(id);
+        scheduleSave();
+    });
+    connect(&m_history, &ClipboardHistory::itemsRemoved, this, [this](const QStringList& ids) {
+        m_persistence->recordRemoved(ids);
+        scheduleSave();
+    });
+    
+    // A cleared history is replaced by a snapshot, which also resets the journal
+    connect(&m_history, &ClipboardHistory::historyCleared, this, &ClipboardManager::requestSave);
+    connect(&m_history, &ClipboardHistory::itemPinned, this, [this](const QString& id) {
+        m_persistence->recordPinned(id);
+        scheduleSave();
+    });
+    connect(&m_history, &ClipboardHistory::itemUnpinned, this, [this](const QString& id) {
+        m_persistence->recordUnpinned(id);
+        scheduleSave();
+    });
+}
+
+void ClipboardManager::startPersistence()
+{
+    m_persistence->moveToThread(&m_persistenceThread);
+    connect(m_persistence, &PersistenceWorker::snapshotWritten,
+            this, &ClipboardManager::onSnapshotWritten);
+    connect(m_persistence, &PersistenceWorker::payloadStored,
+            this, &ClipboardManager::onPayloadStored);
+    connect(m_persistence, &PersistenceWorker::journalError,
+            this, &ClipboardManager::error);
+    m_persistenceThread.setObjectName("ClipboardPersistence");
+    m_persistenceThread.start(QThread::LowPriority);
+}
+
+void ClipboardManager::flushPersistence()
+{
+    if (m_persistenceThread.isRunning()) {
+        QMetaObject::invokeMethod(m_persistence, []() {}, Qt::BlockingQueuedConnection);
+    }
+}
+
+void ClipboardManager::startBackgroundLoad()
+{
+    // The import writes a new snapshot; it runs once, so it may block
+    if (QFile::exists(m_config.configDirectory() + "/clipboard-history.json")) {
+        emit historyLoaded(loadHistory());
+        return;
     }
     
-    // Filter out very long content that might be binary data
-    if (content.length() > 10000) {
-        return false;
+    m_loadingHistory = true;
+    m_loadTimer.start();
+    const QString snapshotPath = m_config.configDirectory() + "/clipboard-history.bin";
+    m_loadWatcher.setFuture(QtConcurrent::run([snapshotPath]() {
+        DecodedHistory decoded;
+        decoded.loaded = ClipboardHistory::readSnapshot(snapshotPath, decoded.items, decoded.maxItems);
+        return decoded;
+    }));
+}
+
+bool ClipboardManager::finishLoad(bool loaded)
+{
+    // Changes made after the snapshot was written
+    HistoryJournal journal(m_config.configDirectory() + "/clipboard-history.journal");
+    int replayed = journal.replay(m_history);
+    Metrics::record(Metrics::LoadTime, m_loadTimer.nsecsElapsed());
+    if (loaded || replayed > 0) {
+        emit historyChanged();
+        emit historyReset();
+        return true;
+    }
+    return false;
+}
+
+void ClipboardManager::onHistoryDecoded()
+{
+    // Also reached through waitForHistoryLoaded() before the watcher reports
+    if (!m_loadingHistory) {
+        return;
     }
     
-    // Filter out content that looks like passwords (all asterisks, etc.)
-    if (content.trimmed() == QString("*").repeated(content.trimmed().length())) {
-        return false;
+    DecodedHistory decoded = m_loadWatcher.result();
+    flushPersistence();
+    bool loaded = false;
+    {
+        // Loading is not a change; nothing here belongs in the journal
+        QSignalBlocker blocker(&m_history);
+        if (decoded.loaded) {
+            m_history.loadDecodedItems(decoded.items, decoded.maxItems);
+        }
+        m_loadingHistory = false;
+        loaded = finishLoad(decoded.loaded);
     }
+    m_history.setMaxItems(m_config.maxHistoryItems());
+    emit historyLoaded(loaded);
     
-    return true;
+    if (m_history.retentionPolicy().isEnabled()) {
+        QTimer::singleShot(0, this, &ClipboardManager::sweepRetention);
+    }
+    
+    if (m_monitorAfterLoad) {
+        m_monitorAfterLoad = false;
+        startMonitoring();
+    }
+}
+
+void ClipboardManager::onSnapshotWritten(bool success, const QString& message)
+{
+    if (!success) {
+        emit error(QString("Failed to save history: %1").arg(message));
+    } else {
+        // Payloads no item refers to any more are only deleted once the
+        // history that dropped them is on disk; the sweep runs on the worker
+        m_persistence->requestBlobCollection(m_claimedPayloadTicket, m_history.payloadKeys());
+    }
+    emit historySaved(success);
+}
+
+bool ClipboardManager::shouldAddContent(QStringView content) const
+{
+    // One scan of the text serves every rule
+    const ContentClassifier::Verdict verdict = ContentClassifier::classify(content);
+    if (verdict == ContentClassifier::Keep) {
+        return true;
+    }
+    
+    // Counted rather than logged; this runs on every filtered capture
+    Metrics::add(Metrics::ContentFiltered);
+    return false;
 }
@@ -3,13 +3,20 @@
 #include <QObject>
 #include <QClipboard>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QThread>
 #include <QPointer>
 #include <QApplication>
 #include <QList>
+#include <QHash>
+#include <QFutureWatcher>
 
 #include "../models/clipboard_item.h"
 #include "../models/clipboard_history.h"
 #include "../models/configuration.h"
+#include "../models/blob_store.h"
+#include "persistence_worker.h"
+#include "workload_trace.h"
 
 /**
  * ClipboardManager - Core service for monitoring clipboard and managing history
@@ -22,6 +29,21 @@
  * - Configurable monitoring with start/stop controls
  * - Automatic persistence with atomic file operations
  * - Performance contracts: <50ms processing, <10MB memory
+ *
+ * Clipboard changes are coalesced: a burst of dataChanged signals closer
+ * together than the configured debounce window is captured once, with the
+ * content of the latest change.
+ *
+ * Besides text, local file lists and images are captured. Those, and text
+ * too long to keep in memory, are stored once in a content-addressed
+ * BlobStore next to the history; their items only hold a reference, so
+ * memory use does not grow with payload size. Use copyToClipboard() to
+ * paste any item back.
+ *
+ * The history is either loaded before the constructor returns or, with
+ * LoadMode::Background, decoded on the thread pool while the caller sets
+ * up the rest of the application. Until historyLoaded() is emitted the
+ * history is empty, snapshots are held back and monitoring waits.
  */
 class ClipboardManager : public QObject
 {
@@ -34,6 +56,21 @@ public:
      */
     explicit ClipboardManager(QObject* parent = nullptr);
     
+    /**
+     * How the constructor loads the persisted history
+     */
+    enum class LoadMode {
+        Blocking,       ///< Loaded before the constructor returns
+        Background      ///< Decoded on the thread pool, see historyLoaded()
+    };
+    
+    /**
+     * Constructor - Creates manager, loading history as requested
+     * @param loadMode Whether to load the history before returning
+     * @param parent QObject parent for memory management
+     */
+    explicit ClipboardManager(LoadMode loadMode, QObject* parent = nullptr);
+    
     /**
      * Destructor - Ensures monitoring stops and history is saved
      */
@@ -46,6 +83,57 @@ public:
      */
     QList<ClipboardItem> getHistory() const;
     
+    /**
+     * Get an immutable snapshot of the current history
+     * @return Shared view in display order; compare version() to skip unchanged updates
+     */
+    HistoryView historyView() const;
+    
+    /**
+     * Get the last published history snapshot from any thread
+     * @return Published view, see ClipboardHistory::snapshot()
+     */
+    HistoryView historySnapshot() const { return m_history.snapshot(); }
+    
+    /**
+     * Get the number of items, cold ones included
+     * historyView() only holds the pinned and hot items.
+     */
+    int historyCount() const { return m_history.count(); }
+    
+    /**
+     * Get the first items in display order, cold ones included
+     * @param limit Maximum number of items
+     * @return Hot items in full, cold ones as metadata only
+     */
+    QList<ClipboardItem> historyItems(int limit) const;
+    
+    /**
+     * Rank every item against a pattern, cold ones included
+     * @param pattern Text to look for
+     * @param limit Maximum number of results
+     * @return Up to limit items, best first
+     *
+     * Cold items are read from disk a chunk at a time while they are
+     * ranked, so this suits one-off queries rather than as-you-type search.
+     */
+    QList<ClipboardItem> rankHistory(const QString& pattern, int limit) const;
+    
+    /**
+     * Find older items by their preview, without reading them from disk
+     * @return Metadata-only cold items, see ClipboardHistory::findColdItems()
+     */
+    QList<ClipboardItem> findColdItems(const QString& query, int limit) const
+    {
+        return m_history.findColdItems(query, limit);
+    }
+    
+    /**
+     * Estimate the memory held by the history
+     * @return Bytes per tier, see ClipboardHistory::memoryUsage()
+     */
+    ClipboardHistory::MemoryUsage memoryUsage() const;
+    
     /**
      * Retrieve specific item by ID
      * @param id UUID string identifier
@@ -74,17 +162,35 @@ public:
      * @return true if item was found and removed successfully
      */
     bool removeItem(const QString& id);
+    
+    /**
+     * Put an item's content back on the clipboard
+     * @param item Item to paste (its text is loaded if needed)
+     * @return true if the clipboard now holds the item's content
+     *
+     * Payload items are offered straight from their mapped blob, in their
+     * original format.
+     */
+    bool copyToClipboard(const ClipboardItem& item);
+
+    /**
+     * Get an item's complete text
+     * @param item Item to read (its text is loaded if needed)
+     * @return The stored text for large text items, whose text() is only
+     *         the searchable start, otherwise text()
+     */
+    QString fullText(const ClipboardItem& item) const;
 
     // Configuration Methods
     /**
      * Get maximum number of history items
-     * @return Current max history size (10-100)
+     * @return Current max history size (10-100000)
      */
     int maxHistoryItems() const;
     
     /**
      * Set maximum number of history items
-     * @param max New maximum size (must be 10-100)
+     * @param max New maximum size (must be 10-100000)
      */
     void setMaxHistoryItems(int max);
 
@@ -95,9 +201,25 @@ public:
      */
     bool loadHistory();
     
+    /**
+     * Check if a background history load is still running
+     * @return true until historyLoaded() has been emitted
+     */
+    bool isLoadingHistory() const;
+    
+    /**
+     * Block until a background history load has been applied
+     * Returns immediately if no load is running
+     */
+    void waitForHistoryLoaded();
+    
     /**
      * Save current history to persistent storage
      * @return true if history was saved successfully
+     *
+     * Writes a full snapshot and folds the change journal into it, waiting
+     * for the persistence thread to finish. Individual changes are journaled
+     * as they happen; routine compaction goes through requestSave() instead.
      */
     bool saveHistory();
 
@@ -119,6 +241,35 @@ public:
      * @return true if monitoring clipboard changes
      */
     bool isMonitoring() const;
+    
+    // Workload Methods
+    /**
+     * Add text to the history as if it had been copied
+     * @param content Text content, stored as a payload if it is too long
+     * @return true if content was added to history
+     *
+     * Bypasses the clipboard and its coalescing window; used to replay
+     * recorded workloads.
+     */
+    bool processText(const QString& content);
+    
+    /**
+     * Start recording captured text as an anonymized WorkloadTrace
+     * @param filePath File the trace is written to when recording stops
+     * @return true if the file is writable and recording started
+     */
+    bool startTraceRecording(const QString& filePath);
+    
+    /**
+     * Stop recording and write the trace
+     * @return true if a trace was being recorded and has been written
+     */
+    bool stopTraceRecording();
+    
+    /**
+     * Check if captured text is being recorded
+     */
+    bool isRecordingTrace() const;
 
 signals:
     /**
@@ -150,6 +301,51 @@ signals:
      */
     void itemRemoved(const QString& id);
     
+    /**
+     * Emitted when the retention sweep evicts a batch of items
+     * @param ids UUIDs of the removed items
+     */
+    void itemsRemoved(const QStringList& ids);
+    
+    /**
+     * Emitted when an item appears at a display position
+     * @param index Position of the item in getHistory()
+     * @param item The inserted item
+     */
+    void itemInsertedAt(int index, const ClipboardItem& item);
+    
+    /**
+     * Emitted when the item at a display position leaves the in-memory history
+     * @param index Position the item had
+     * @param id UUID of the item
+     */
+    void itemRemovedAt(int index, const QString& id);
+    
+    /**
+     * Emitted when an item moves between display positions
+     * @param from Position the item had
+     * @param to Position after reinserting it
+     * @param item The item in its new state
+     */
+    void itemMoved(int from, int to, const ClipboardItem& item);
+    
+    /**
+     * Emitted when the history was replaced as a whole; re-read historyView()
+     */
+    void historyReset();
+    
+    /**
+     * Emitted when a history snapshot write finishes on the persistence thread
+     * @param success true if the snapshot was committed to disk
+     */
+    void historySaved(bool success);
+    
+    /**
+     * Emitted when a background history load has been applied
+     * @param success true if a snapshot or journal was read
+     */
+    void historyLoaded(bool success);
+    
     /**
      * Emitted when monitoring state changes
      * @param monitoring true if monitoring started, false if stopped
@@ -165,28 +361,101 @@ signals:
 private slots:
     /**
      * Handle clipboard data change events
-     * Called when QClipboard::dataChanged is emitted
+     * Called when QClipboard::dataChanged is emitted; starts or extends the
+     * coalescing window so only the latest content of a burst is captured
      */
     void onClipboardChanged();
     
+    /**
+     * Read the clipboard and add its content to the history
+     * Called when the coalescing window closes
+     */
+    void captureClipboard();
+    
     /**
      * Handle configuration change notifications
      * Updates history size limits and persistence settings
      */
     void onConfigurationChanged();
+    
+    /**
+     * Queue a snapshot write on the persistence thread
+     * Called when the save timer fires; never blocks the caller
+     */
+    void requestSave();
+    
+    /**
+     * Handle snapshot results reported by the persistence worker
+     */
+    void onSnapshotWritten(bool success, const QString& message);
+    
+    /**
+     * Add the item for a payload the persistence worker has stored
+     * @param ticket Ticket handed out by addPayload()
+     * @param key Blob key, empty if the payload could not be written
+     */
+    void onPayloadStored(quint64 ticket, const QString& key);
+    
+    /**
+     * Apply a history decoded in the background
+     * Called when the load future finishes
+     */
+    void onHistoryDecoded();
+    
+    /**
+     * Evict items that fall outside the retention policy
+     * Called periodically by the retention timer, never on capture
+     */
+    void sweepRetention();
 
 private:
     // Core components
     QPointer<QClipboard> m_clipboard;        ///< Qt clipboard interface
     ClipboardHistory m_history;              ///< History model instance
     Configuration m_config;                  ///< Configuration model instance
+    BlobStore m_blobs;                       ///< Stored payloads of non-text and large items (written by the worker)
     
     // Monitoring state
     bool m_monitoring;                       ///< Current monitoring status
-    QTimer* m_saveTimer;                     ///< Deferred save operations
+    QTimer* m_saveTimer;                     ///< Deferred journal compaction
+    QTimer* m_captureTimer;                  ///< Closes the clipboard coalescing window
+    QTimer* m_retentionTimer;                ///< Periodic retention sweep
+    QElapsedTimer m_burstTimer;              ///< Time since the first change of the current burst
+    
+    // Persistence
+    QThread m_persistenceThread;             ///< Thread running all history file I/O
+    PersistenceWorker* m_persistence;        ///< Journal and snapshot writer (owned)
+    
+    /**
+     * Captured payload waiting for its blob key
+     */
+    struct PendingPayload {
+        QString mimeType;
+        qint64 size = 0;
+        QString text;
+        QString preview;
+    };
+    QHash<quint64, PendingPayload> m_pendingPayloads; ///< Payloads being stored, by ticket
+    quint64 m_lastPayloadTicket;             ///< Ticket of the newest payload handed to the worker
+    quint64 m_claimedPayloadTicket;          ///< Ticket of the newest payload the worker reported
+    
+    /**
+     * Snapshot contents decoded off the GUI thread
+     */
+    struct DecodedHistory {
+        bool loaded = false;
+        QList<ClipboardItem> items;
+        int maxItems = 0;
+    };
+    QFutureWatcher<DecodedHistory> m_loadWatcher; ///< Running background load
+    bool m_loadingHistory;                   ///< Background load not yet applied
+    bool m_monitorAfterLoad;                 ///< startMonitoring() called during the load
+    QElapsedTimer m_loadTimer;               ///< Started when the history load begins
     
     // Performance tracking
     qint64 m_lastProcessTime;                ///< Last clipboard processing timestamp
+    WorkloadTrace m_trace;                   ///< Captures recorded since startTraceRecording()
+    QString m_tracePath;                     ///< Trace destination, empty when not recording
     
     // Helper methods
     /**
@@ -196,6 +465,46 @@ private:
      */
     bool processClipboardContent(const QString& content);
     
+    /**
+     * Store text too long to keep in memory as a payload
+     * @param content Text content from clipboard
+     * @return true if content was added to history
+     */
+    bool processLargeText(const QString& content);
+    
+    /**
+     * Store the clipboard's file list as a payload
+     * @param mimeData Clipboard data offering text/uri-list
+     * @return true if the list was added to history
+     */
+    bool processUriList(const QMimeData* mimeData);
+    
+    /**
+     * Store the clipboard's image as a PNG payload
+     * @param mimeData Clipboard data offering an image
+     * @return true if the image was added to history
+     */
+    bool processImage(const QMimeData* mimeData);
+    
+    /**
+     * Store payload bytes and add an item referencing them
+     * @param mimeType Format of data
+     * @param data Bytes to store
+     * @param text Searchable stand-in for the content
+     * @param preview Display text (empty to derive it from text)
+     * @return true if the payload was accepted; the item is added once
+     *         the persistence worker has stored it
+     */
+    bool addPayload(const QString& mimeType, const QByteArray& data,
+                    const QString& text, const QString& preview = QString());
+    
+    /**
+     * Add an item to the history as a single change notification
+     * @param item Item to add
+     * @return true if the item was added or refreshed
+     */
+    bool addCapturedItem(const ClipboardItem& item);
+    
     /**
      * Initialize default configuration
      * Sets up config file path and default values
@@ -204,14 +513,56 @@ private:
     
     /**
      * Schedule deferred save operation
-     * Uses timer to batch multiple rapid changes
+     * Compacts the journal into a snapshot once it has grown large enough
      */
     void scheduleSave();
     
+    /**
+     * Connect history change signals to the journal
+     */
+    void connectJournal();
+    
+    /**
+     * Apply the retention settings to the history and (re)start the sweep
+     */
+    void applyRetentionPolicy();
+    
+    /**
+     * Move the persistence worker to its thread and start it
+     */
+    void startPersistence();
+    
+    /**
+     * Wait until all queued persistence requests have been written
+     */
+    void flushPersistence();
+    
+    /**
+     * Decode the snapshot on the thread pool
+     * Falls back to loadHistory() when a legacy JSON history must be imported
+     */
+    void startBackgroundLoad();
+    
+    /**
+     * Replay the journal on top of a loaded snapshot and announce the result
+     * @param loaded true if a snapshot or legacy history was read
+     * @return true if anything was loaded
+     */
+    bool finishLoad(bool loaded);
+    
     /**
      * Validate content before adding to history
+     * Classifies the text in one scan without copying it, see ContentClassifier
      * @param content Text content to validate
      * @return true if content should be added to history
      */
-    bool shouldAddContent(const QString& content) const;
+    bool shouldAddContent(QStringView content) const;
+    
+    static constexpr int JOURNAL_COMPACT_RECORDS = 256; ///< Journal size that triggers a snapshot
+    static constexpr int RETENTION_SWEEP_MS = 60 * 1000; ///< Interval of the retention sweep
+    static constexpr int MAX_COALESCE_WINDOWS = 8;      ///< Longest burst deferred, in debounce windows
+    static constexpr int MAX_INLINE_TEXT_LENGTH = 10000; ///< Longer text is stored as a payload
+    static constexpr int MAX_STAND_IN_LENGTH = 4096;    ///< Searchable start of large text
+    static constexpr int COLD_RANK_CHUNK = 1024;        ///< Cold items read at once by rankHistory()
+    static constexpr qint64 MAX_PAYLOAD_BYTES = 64 * 1024 * 1024; ///< Larger content is ignored
 };
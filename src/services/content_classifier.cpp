@@ -0,0 +1,131 @@
+#include "content_classifier.h"
+#include <QMimeData>
+#include <QStringList>
+
+namespace {
+
+enum CharClass : quint8 {
+    SpaceClass = 1 << 0,
+    MaskClass = 1 << 1,
+    NoiseClass = 1 << 2,
+    TokenClass = 1 << 3,
+    DigitClass = 1 << 4,
+    DotClass = 1 << 5
+};
+
+constexpr std::array<quint8, 128> makeAsciiClasses()
+{
+    std::array<quint8, 128> classes{};
+    for (int c = 0; c < 0x20; ++c) {
+        classes[c] = NoiseClass;
+    }
+    classes[0x7f] = NoiseClass;
+    for (char c : {' ', '\t', '\n', '\r', '\v', '\f'}) {
+        classes[quint8(c)] = SpaceClass;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        classes[c] = TokenClass | DigitClass;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        classes[c] = TokenClass;
+        classes[c - 'a' + 'A'] = TokenClass;
+    }
+    classes['-'] = TokenClass;
+    classes['_'] = TokenClass;
+    classes['*'] = MaskClass;
+    classes['.'] = DotClass;
+    return classes;
+}
+
+constexpr std::array<quint8, 128> ASCII_CLASSES = makeAsciiClasses();
+
+quint8 charClass(char16_t c)
+{
+    if (c < 128) {
+        return ASCII_CLASSES[c];
+    }
+    if (c == u'\u2022' || c == u'\u25cf') {   // Bullets used by password fields
+        return MaskClass;
+    }
+    if (c == u'\ufffd') {                      // Replacement for undecodable bytes
+        return NoiseClass;
+    }
+    return QChar::isSpace(c) ? SpaceClass : 0;
+}
+
+// Formats password managers add to what they copy. KDE's hint carries the
+// value "secret"; the others mark concealed content by being present.
+constexpr std::array<std::string_view, 3> CONCEALED_FORMATS = {
+    "org.nspasteboard.ConcealedType",
+    "application/x-nspasteboard-concealed-type",
+    "ExcludeClipboardContentFromMonitorProcessing"
+};
+
+} // namespace
+
+ContentClassifier::Features ContentClassifier::Features::scan(QStringView text)
+{
+    Features f;
+    f.length = text.size();
+    const char16_t* data = text.utf16();
+    for (qsizetype i = 0; i < f.length; ++i) {
+        const quint8 cls = charClass(data[i]);
+        if (cls & SpaceClass) {
+            ++f.spaces;
+            continue;
+        }
+        if (f.last < 0) {
+            f.first = i;
+        }
+        f.last = i;
+        f.masks += (cls & MaskClass) ? 1 : 0;
+        f.noise += (cls & NoiseClass) ? 1 : 0;
+        f.tokenChars += (cls & TokenClass) ? 1 : 0;
+        f.digits += (cls & DigitClass) ? 1 : 0;
+        f.dots += (cls & DotClass) ? 1 : 0;
+    }
+    if (f.last < 0) {
+        f.first = 0;
+    }
+    return f;
+}
+
+bool ContentClassifier::isConcealed(const QMimeData* mimeData)
+{
+    if (!mimeData) {
+        return false;
+    }
+
+    const QStringList formats = mimeData->formats();
+    for (const QString& format : formats) {
+        if (format == QLatin1String("x-kde-passwordManagerHint")) {
+            if (mimeData->data(format).trimmed() == "secret") {
+                return true;
+            }
+            continue;
+        }
+        // Platform formats may be wrapped, e.g. application/x-qt-windows-mime;value="..."
+        for (std::string_view concealed : CONCEALED_FORMATS) {
+            if (format.contains(QLatin1String(concealed.data(), qsizetype(concealed.size())))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const char* ContentClassifier::verdictName(Verdict verdict)
+{
+    switch (verdict) {
+        case Keep: return "keep";
+        case Empty: return "empty";
+        case TooShort: return "too-short";
+        case Masked: return "masked";
+        case BinaryNoise: return "binary-noise";
+        case PrivateKey: return "private-key";
+        case JsonWebToken: return "json-web-token";
+        case ApiKey: return "api-key";
+        case Concealed: return "concealed";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <array>
+#include <string_view>
+
+class QMimeData;
+
+/**
+ * ContentClassifier - Decides which captured text is kept in the history
+ *
+ * The text is scanned once into a Features summary: where the text
+ * between the outer whitespace starts and ends, and counts of the
+ * character classes the rules care about, looked up in a constexpr table
+ * for ASCII. Rules are small structs whose check() only reads that
+ * summary and, at most, a bounded prefix of the text. classifyWith()
+ * expands its rule list into one inlined chain at compile time, so adding
+ * a rule adds a few comparisons, never another pass or a regex.
+ *
+ * The default rules drop empty and masked text, binary noise, private
+ * keys, JSON Web Tokens and API keys with well-known prefixes.
+ * Password managers mark what they copy with MIME hints; isConcealed()
+ * checks those before the text is read.
+ */
+class ContentClassifier
+{
+public:
+    enum Verdict {
+        Keep,               // Ordinary content
+        Empty,              // Nothing but whitespace
+        TooShort,           // A single character
+        Masked,             // Only mask characters, e.g. "********"
+        BinaryNoise,        // Control characters or undecodable bytes
+        PrivateKey,         // PEM private key block
+        JsonWebToken,       // header.payload.signature token
+        ApiKey,             // Token with a known service key prefix
+        Concealed           // Marked secret by the source application
+    };
+
+    /**
+     * Character statistics of a text, gathered in a single pass
+     */
+    struct Features {
+        qsizetype length = 0;       ///< Code units in the whole text
+        qsizetype first = 0;        ///< Position of the first non-space
+        qsizetype last = -1;        ///< Position of the last non-space
+        qsizetype spaces = 0;       ///< Whitespace anywhere in the text
+        qsizetype masks = 0;        ///< '*' and bullet characters
+        qsizetype noise = 0;        ///< Control characters and U+FFFD
+        qsizetype tokenChars = 0;   ///< Letters, digits, '-' and '_'
+        qsizetype digits = 0;
+        qsizetype dots = 0;
+
+        qsizetype trimmedLength() const { return last - first + 1; }
+        qsizetype innerSpaces() const { return spaces - first - (length - 1 - last); }
+        bool isSingleToken() const { return trimmedLength() > 0 && innerSpaces() == 0; }
+
+        /**
+         * Scan a text once
+         * @param text Text to summarize
+         * @return Its features
+         */
+        static Features scan(QStringView text);
+    };
+
+    // Rules, checked in the order given to classifyWith()
+    struct EmptyRule {
+        static Verdict check(const Features& f, QStringView) { return f.trimmedLength() <= 0 ? Empty : Keep; }
+    };
+
+    struct TooShortRule {
+        static Verdict check(const Features& f, QStringView) { return f.length < 2 ? TooShort : Keep; }
+    };
+
+    struct MaskedRule {
+        static Verdict check(const Features& f, QStringView) {
+            return f.masks == f.trimmedLength() ? Masked : Keep;
+        }
+    };
+
+    struct BinaryNoiseRule {
+        // More than one in NOISE_DIVISOR code units is noise
+        static constexpr qsizetype NOISE_DIVISOR = 8;
+        static Verdict check(const Features& f, QStringView) {
+            return f.noise * NOISE_DIVISOR > f.trimmedLength() ? BinaryNoise : Keep;
+        }
+    };
+
+    struct PrivateKeyRule {
+        static constexpr qsizetype HEADER_SCAN_LENGTH = 64;   // "-----BEGIN ... PRIVATE KEY-----"
+        static Verdict check(const Features& f, QStringView trimmed) {
+            if (f.trimmedLength() < HEADER_SCAN_LENGTH || !trimmed.startsWith(QLatin1String("-----BEGIN "))) {
+                return Keep;
+            }
+            return trimmed.left(HEADER_SCAN_LENGTH).contains(QLatin1String("PRIVATE KEY-----")) ? PrivateKey : Keep;
+        }
+    };
+
+    struct JsonWebTokenRule {
+        static constexpr qsizetype MIN_LENGTH = 32;
+        static Verdict check(const Features& f, QStringView trimmed) {
+            // Three base64url parts; every JOSE header starts with {" -> eyJ
+            return f.isSingleToken() && f.dots == 2 && f.tokenChars + f.dots == f.trimmedLength() &&
+                   f.trimmedLength() >= MIN_LENGTH && trimmed.startsWith(QLatin1String("eyJ"))
+                       ? JsonWebToken : Keep;
+        }
+    };
+
+    struct ApiKeyRule {
+        static constexpr qsizetype MIN_SECRET_LENGTH = 16;    // Characters after the prefix
+        static constexpr std::array<std::string_view, 20> PREFIXES = {
+            "ghp_", "gho_", "ghu_", "ghs_", "ghr_", "github_pat_",  // GitHub
+            "glpat-",                                             // GitLab
+            "xoxb-", "xoxp-", "xoxa-", "xapp-",                   // Slack
+            "sk-", "sk_live_", "rk_live_",                         // OpenAI, Stripe
+            "AKIA", "ASIA",                                       // AWS access key IDs
+            "AIza",                                               // Google API keys
+            "npm_", "pypi-", "hf_"                                // Package registries, Hugging Face
+        };
+        static Verdict check(const Features& f, QStringView trimmed) {
+            if (!f.isSingleToken() || f.tokenChars != f.trimmedLength() || f.digits == 0) {
+                return Keep;
+            }
+            for (std::string_view prefix : PREFIXES) {
+                if (f.trimmedLength() >= qsizetype(prefix.size()) + MIN_SECRET_LENGTH &&
+                    trimmed.startsWith(QLatin1String(prefix.data(), qsizetype(prefix.size())))) {
+                    return ApiKey;
+                }
+            }
+            return Keep;
+        }
+    };
+
+    /**
+     * Classify text with the given rules
+     * @param text Captured text
+     * @return Verdict of the first rule that does not keep the text
+     */
+    template <typename... Rules>
+    static Verdict classifyWith(QStringView text)
+    {
+        const Features features = Features::scan(text);
+        const QStringView trimmed = features.trimmedLength() > 0
+            ? text.mid(features.first, features.trimmedLength()) : QStringView();
+        Verdict verdict = Keep;
+        (((verdict = Rules::check(features, trimmed)) == Keep) && ...);
+        return verdict;
+    }
+
+    /**
+     * Classify text with the default rules
+     * @param text Captured text
+     * @return Keep, or why the text should not be stored
+     */
+    static Verdict classify(QStringView text)
+    {
+        return classifyWith<EmptyRule, TooShortRule, MaskedRule, BinaryNoiseRule,
+                            PrivateKeyRule, JsonWebTokenRule, ApiKeyRule>(text);
+    }
+
+    /**
+     * Check if the source application marked the content as secret
+     * @param mimeData Clipboard contents
+     * @return true for password manager hints such as x-kde-passwordManagerHint
+     */
+    static bool isConcealed(const QMimeData* mimeData);
+
+    /**
+     * Get a short name for a verdict, for logs
+     */
+    static const char* verdictName(Verdict verdict);
+};
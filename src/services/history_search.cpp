@@ -0,0 +1,100 @@
+#include "history_search.h"
+#include <QDateTime>
+#include <QtConcurrent>
+
+HistorySearch::HistorySearch(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<QList<RankedItem>>::finished,
+            this, &HistorySearch::onSearchFinished);
+}
+
+HistorySearch::~HistorySearch()
+{
+    // Shards hold their own copies of the view, so there is nothing to wait for
+    cancel();
+}
+
+void HistorySearch::start(const HistoryView& view, const QString& pattern, int limit)
+{
+    cancel();
+    m_runningPattern = pattern;
+    m_runningView = view;
+    m_active = true;
+    m_watcher.setFuture(rankAsync(view, pattern, limit, QDateTime::currentMSecsSinceEpoch()));
+}
+
+void HistorySearch::cancel()
+{
+    // A cancelled search may still deliver its finished signal later
+    m_active = false;
+    if (m_watcher.isRunning()) {
+        m_watcher.cancel();
+    }
+}
+
+QFuture<QList<HistorySearch::RankedItem>> HistorySearch::rankAsync(const HistoryView& view,
+                                                                   const QString& pattern,
+                                                                   int limit, qint64 nowMs)
+{
+    const TextMatcher matcher(pattern);
+    if (view.count() <= SHARD_SIZE) {
+        return QtConcurrent::run([view, matcher, limit, nowMs]() {
+            return matcher.rank(view, 0, view.count(), limit, nowMs);
+        });
+    }
+
+    const QList<int> shards = shardStarts(view.count());
+
+    auto rankShard = [view, matcher, limit, nowMs](int start) {
+        return matcher.rank(view, start, start + SHARD_SIZE, limit, nowMs);
+    };
+    auto mergeShard = [limit](QList<RankedItem>& result, const QList<RankedItem>& shard) {
+        result = TextMatcher::mergeRanked(result, shard, limit);
+    };
+    return QtConcurrent::mappedReduced<QList<RankedItem>>(shards, rankShard, mergeShard,
+                                                          QtConcurrent::UnorderedReduce);
+}
+
+QList<HistorySearch::RankedItem> HistorySearch::rank(const HistoryView& view, const QString& pattern,
+                                                     int limit, qint64 nowMs)
+{
+    const TextMatcher matcher(pattern);
+    if (view.count() <= SHARD_SIZE) {
+        return matcher.rank(view, 0, view.count(), limit, nowMs);
+    }
+
+    const QList<int> shards = shardStarts(view.count());
+
+    return QtConcurrent::blockingMappedReduced<QList<RankedItem>>(
+        shards,
+        [&](int start) { return matcher.rank(view, start, start + SHARD_SIZE, limit, nowMs); },
+        [limit](QList<RankedItem>& result, const QList<RankedItem>& shard) {
+            result = TextMatcher::mergeRanked(result, shard, limit);
+        },
+        QtConcurrent::UnorderedReduce);
+}
+
+QList<int> HistorySearch::shardStarts(int count)
+{
+    QList<int> starts;
+    starts.reserve(count / SHARD_SIZE + 1);
+    for (int start = 0; start < count; start += SHARD_SIZE) {
+        starts.append(start);
+    }
+    return starts;
+}
+
+void HistorySearch::onSearchFinished()
+{
+    QFuture<QList<RankedItem>> future = m_watcher.future();
+    if (!m_active || !future.isFinished() || future.isCanceled() || future.resultCount() == 0) {
+        return;
+    }
+
+    m_active = false;
+    m_pattern = m_runningPattern;
+    m_view = m_runningView;
+    m_results = future.result();
+    emit finished(m_pattern);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+
+#include "../models/history_view.h"
+#include "../models/text_matcher.h"
+
+/**
+ * HistorySearch - Ranks history items against a query on the thread pool
+ *
+ * The view is split into fixed-size shards that are ranked in parallel on
+ * the global thread pool; each shard keeps its own top-k and the shard
+ * results are merged as they finish. Views are immutable snapshots, so
+ * the history can keep changing while a search runs.
+ *
+ * Starting a new search cancels the running one: shards that have not
+ * started yet are dropped and the old result is never reported, which
+ * keeps as-you-type searches from queueing up behind each other.
+ */
+class HistorySearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    using RankedItem = TextMatcher::RankedItem;
+
+    explicit HistorySearch(QObject* parent = nullptr);
+    ~HistorySearch() override;
+
+    /**
+     * Start ranking items, cancelling any search still running
+     * @param view Items to search
+     * @param pattern Text to look for
+     * @param limit Maximum number of results
+     */
+    void start(const HistoryView& view, const QString& pattern, int limit);
+
+    /**
+     * Cancel the running search; finished() is not emitted for it
+     */
+    void cancel();
+
+    /**
+     * Check if a search is running
+     */
+    bool isRunning() const { return m_active; }
+
+    // Last finished search
+    const QString& pattern() const { return m_pattern; }
+    const HistoryView& view() const { return m_view; }
+    const QList<RankedItem>& results() const { return m_results; }
+
+    /**
+     * Rank items on the thread pool
+     * @param view Items to search
+     * @param pattern Text to look for
+     * @param limit Maximum number of results
+     * @param nowMs Current time for the recency bonus (ms since epoch)
+     * @return Future for up to limit items, best first, indexed by view
+     *         position; cancelling it drops the shards not yet started
+     */
+    static QFuture<QList<RankedItem>> rankAsync(const HistoryView& view, const QString& pattern,
+                                                int limit, qint64 nowMs);
+
+    /**
+     * Rank items on the thread pool and wait for the result
+     * The calling thread ranks shards as well.
+     */
+    static QList<RankedItem> rank(const HistoryView& view, const QString& pattern,
+                                  int limit, qint64 nowMs);
+
+signals:
+    /**
+     * Emitted when a search completes without being cancelled
+     * @param pattern Pattern the search was started with
+     */
+    void finished(const QString& pattern);
+
+private slots:
+    void onSearchFinished();
+
+private:
+    /**
+     * First view position of every shard
+     */
+    static QList<int> shardStarts(int count);
+
+    static constexpr int SHARD_SIZE = 4096;
+
+    QFutureWatcher<QList<RankedItem>> m_watcher;
+    QString m_runningPattern;        ///< Pattern of the search being watched
+    HistoryView m_runningView;       ///< View of the search being watched
+    bool m_active = false;           ///< Watched search has not finished or been cancelled
+    QString m_pattern;
+    HistoryView m_view;
+    QList<RankedItem> m_results;
+};
@@ -0,0 +1,127 @@
+#include "ipc_protocol.h"
+#include <QDataStream>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtEndian>
+
+namespace {
+
+QDataStream& prepare(QDataStream& stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    return stream;
+}
+
+bool readHeader(QDataStream& in)
+{
+    quint32 magic = 0;
+    quint8 version = 0;
+    in >> magic >> version;
+    return in.status() == QDataStream::Ok && magic == IpcProtocol::MAGIC &&
+           version == IpcProtocol::VERSION;
+}
+
+} // namespace
+
+QByteArray IpcProtocol::encodeRequest(const Request& request)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    prepare(out) << MAGIC << VERSION << quint8(request.command) << request.argument << request.limit;
+    return payload;
+}
+
+bool IpcProtocol::decodeRequest(const QByteArray& payload, Request& request)
+{
+    QDataStream in(payload);
+    if (!readHeader(prepare(in))) {
+        return false;
+    }
+
+    quint8 command = 0;
+    in >> command >> request.argument >> request.limit;
+    if (in.status() != QDataStream::Ok || !in.atEnd() ||
+        command < quint8(Command::List) || command > quint8(Command::Metrics)) {
+        return false;
+    }
+    request.command = Command(command);
+    return true;
+}
+
+QByteArray IpcProtocol::encodeResponse(const Response& response)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    prepare(out) << MAGIC << VERSION << quint8(response.status) << response.message
+                 << quint32(response.entries.size());
+    for (const Entry& entry : response.entries) {
+        out << entry.id << entry.preview << entry.pinned << entry.timestamp;
+    }
+    out << response.text;
+    return payload;
+}
+
+bool IpcProtocol::decodeResponse(const QByteArray& payload, Response& response)
+{
+    QDataStream in(payload);
+    if (!readHeader(prepare(in))) {
+        return false;
+    }
+
+    quint8 status = 0;
+    quint32 count = 0;
+    in >> status >> response.message >> count;
+    if (in.status() != QDataStream::Ok || status > quint8(Status::Failed)) {
+        return false;
+    }
+    response.status = Status(status);
+
+    // Every entry takes at least a dozen bytes, which bounds a bogus count
+    response.entries.clear();
+    response.entries.reserve(qMin<qint64>(count, payload.size() / 12));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry.id >> entry.preview >> entry.pinned >> entry.timestamp;
+        response.entries.append(entry);
+    }
+    in >> response.text;
+    return in.status() == QDataStream::Ok && in.atEnd();
+}
+
+QByteArray IpcProtocol::frame(const QByteArray& payload)
+{
+    QByteArray framed(sizeof(quint32), Qt::Uninitialized);
+    qToBigEndian(quint32(payload.size()), framed.data());
+    framed.append(payload);
+    return framed;
+}
+
+IpcProtocol::FrameResult IpcProtocol::takeFrame(QByteArray& buffer, QByteArray& payload)
+{
+    if (buffer.size() < qsizetype(sizeof(quint32))) {
+        return FrameResult::Incomplete;
+    }
+
+    const quint32 length = qFromBigEndian<quint32>(buffer.constData());
+    if (length > MAX_FRAME_SIZE) {
+        return FrameResult::Invalid;
+    }
+    if (buffer.size() - qsizetype(sizeof(quint32)) < qsizetype(length)) {
+        return FrameResult::Incomplete;
+    }
+
+    payload = buffer.mid(sizeof(quint32), length);
+    buffer.remove(0, sizeof(quint32) + length);
+    return FrameResult::Ready;
+}
+
+QString IpcProtocol::defaultServerName()
+{
+    // The runtime directory is private to the user; without one, QLocalServer
+    // places the name in the temp directory and access is limited at listen time
+    const QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (!runtimeDir.isEmpty() && QDir(runtimeDir).exists()) {
+        return runtimeDir + "/clipboard-history.sock";
+    }
+    return QString("clipboard-history-%1").arg(qEnvironmentVariable("USER", "user"));
+}
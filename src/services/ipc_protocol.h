@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/**
+ * IpcProtocol - Binary request protocol between the daemon and its clients
+ *
+ * Every message is a frame: a big-endian quint32 payload length followed
+ * by the payload, a QDataStream that starts with a magic number and the
+ * protocol version. A connection carries any number of request/response
+ * pairs in order, so a client may pipeline several requests.
+ *
+ * Requests name a command and carry one string argument (an item ID or a
+ * search text) and a result limit. Responses carry a status and, depending
+ * on the command, a list of item entries or a text (the full text of
+ * one item, or the metrics report).
+ */
+class IpcProtocol
+{
+public:
+    enum class Command : quint8 {
+        List = 1,        // Newest items
+        Search,          // Items ranked against the argument
+        Get,             // Full text of the item with ID argument
+        Pin,
+        Unpin,
+        Paste,           // Put the item on the clipboard
+        Show,            // Show the history window
+        Metrics          // Runtime metrics report as text
+    };
+
+    enum class Status : quint8 {
+        Ok = 0,
+        NotFound,        // No item with the requested ID
+        BadRequest,      // Malformed or unknown request
+        Failed           // The command could not be carried out
+    };
+
+    struct Request {
+        Command command = Command::List;
+        QString argument;
+        qint32 limit = 0;            ///< Result limit for List/Search; 0 for the default
+    };
+
+    struct Entry {
+        QString id;
+        QString preview;             ///< Single-line preview
+        bool pinned = false;
+        qint64 timestamp = 0;        ///< Copy time in ms since epoch
+    };
+
+    struct Response {
+        Status status = Status::Ok;
+        QString message;             ///< Error description when not Ok
+        QList<Entry> entries;        ///< List/Search results
+        QString text;                ///< Get or Metrics result
+    };
+
+    enum class FrameResult {
+        Incomplete,      // More bytes are needed
+        Ready,           // A payload was taken from the buffer
+        Invalid          // The buffer does not start with a valid frame
+    };
+
+    // Message encoding
+    static QByteArray encodeRequest(const Request& request);
+    static bool decodeRequest(const QByteArray& payload, Request& request);
+    static QByteArray encodeResponse(const Response& response);
+    static bool decodeResponse(const QByteArray& payload, Response& response);
+
+    /**
+     * Prefix a payload with its length
+     * @param payload Encoded message
+     * @return Frame ready to be written to the socket
+     */
+    static QByteArray frame(const QByteArray& payload);
+
+    /**
+     * Take the first complete frame out of a receive buffer
+     * @param buffer Bytes received so far; the frame is removed from it
+     * @param payload Set to the frame's payload when Ready
+     * @return Whether a frame was taken, is incomplete or is invalid
+     */
+    static FrameResult takeFrame(QByteArray& buffer, QByteArray& payload);
+
+    /**
+     * Get the server name of the current user's daemon
+     * @return Socket path in the runtime directory, or a per-user name
+     */
+    static QString defaultServerName();
+
+    static constexpr quint32 MAGIC = 0x43484950;              // "CHIP"
+    static constexpr quint8 VERSION = 1;
+    static constexpr quint32 MAX_FRAME_SIZE = 16 * 1024 * 1024;
+    static constexpr int DEFAULT_LIMIT = 20;
+    static constexpr int MAX_LIMIT = 1000;
+};
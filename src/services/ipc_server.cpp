@@ -0,0 +1,211 @@
+#include "ipc_server.h"
+#include "clipboard_manager.h"
+#include "../lib/metrics.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+IpcServer::IpcServer(ClipboardManager* manager, QObject* parent)
+    : QObject(parent)
+    , m_manager(manager)
+    , m_server(new QLocalServer(this))
+{
+    // Only the user running the daemon may connect
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &IpcServer::onNewConnection);
+}
+
+IpcServer::~IpcServer()
+{
+    close();
+}
+
+bool IpcServer::listen(const QString& name)
+{
+    if (m_server->listen(name)) {
+        return true;
+    }
+
+    if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        if (isServerRunning(name)) {
+            qWarning() << "IpcServer: Another instance is already listening on" << name;
+            return false;
+        }
+
+        // Left behind by an instance that did not shut down cleanly
+        QLocalServer::removeServer(name);
+        if (m_server->listen(name)) {
+            return true;
+        }
+    }
+
+    qWarning() << "IpcServer: Failed to listen on" << name << ":" << m_server->errorString();
+    return false;
+}
+
+void IpcServer::close()
+{
+    m_server->close();
+    const QList<QLocalSocket*> sockets = m_buffers.keys();
+    m_buffers.clear();
+    for (QLocalSocket* socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+bool IpcServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QString IpcServer::serverName() const
+{
+    return m_server->fullServerName();
+}
+
+bool IpcServer::isServerRunning(const QString& name, int timeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    return socket.waitForConnected(timeoutMs);
+}
+
+IpcProtocol::Response IpcServer::handle(const IpcProtocol::Request& request)
+{
+    using Command = IpcProtocol::Command;
+    using Status = IpcProtocol::Status;
+
+    const int limit = request.limit > 0 ? qMin(int(request.limit), IpcProtocol::MAX_LIMIT)
+                                        : IpcProtocol::DEFAULT_LIMIT;
+
+    switch (request.command) {
+        case Command::List:
+            // Cold items are listed from their metadata, without reading them
+            return listResponse(m_manager->historyItems(limit));
+        case Command::Search: {
+            QElapsedTimer timer;
+            timer.start();
+            const QList<ClipboardItem> ranked = m_manager->rankHistory(request.argument, limit);
+            Metrics::record(Metrics::SearchLatency, timer.nsecsElapsed());
+            return listResponse(ranked);
+        }
+        case Command::Get: {
+            ClipboardItem item = m_manager->getItem(request.argument);
+            if (!item.isValid()) {
+                return errorResponse(Status::NotFound, "No such item");
+            }
+            IpcProtocol::Response response;
+            // Large text items only hold the start of their text
+            response.text = m_manager->fullText(item);
+            return response;
+        }
+        case Command::Pin:
+        case Command::Unpin: {
+            if (!m_manager->getItem(request.argument).isValid()) {
+                return errorResponse(Status::NotFound, "No such item");
+            }
+            // Pinning an already pinned item is not an error
+            if (request.command == Command::Pin) {
+                m_manager->pinItem(request.argument);
+            } else {
+                m_manager->unpinItem(request.argument);
+            }
+            return IpcProtocol::Response();
+        }
+        case Command::Paste: {
+            ClipboardItem item = m_manager->getItem(request.argument);
+            if (!item.isValid()) {
+                return errorResponse(Status::NotFound, "No such item");
+            }
+            if (!m_manager->copyToClipboard(item)) {
+                return errorResponse(Status::Failed, "Could not set the clipboard");
+            }
+            return IpcProtocol::Response();
+        }
+        case Command::Show:
+            emit showRequested();
+            return IpcProtocol::Response();
+        case Command::Metrics: {
+            IpcProtocol::Response response;
+            response.text = Metrics::report();
+            return response;
+        }
+    }
+    return errorResponse(Status::BadRequest, "Unknown command");
+}
+
+void IpcServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QLocalSocket::readyRead, this, &IpcServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &IpcServer::onDisconnected);
+    }
+}
+
+void IpcServer::onReadyRead()
+{
+    auto* socket = qobject_cast<QLocalSocket*>(sender());
+    auto buffer = m_buffers.find(socket);
+    if (buffer == m_buffers.end()) {
+        return;
+    }
+
+    buffer->append(socket->readAll());
+    QByteArray payload;
+    IpcProtocol::FrameResult result;
+    while ((result = IpcProtocol::takeFrame(*buffer, payload)) == IpcProtocol::FrameResult::Ready) {
+        IpcProtocol::Request request;
+        IpcProtocol::Response response = IpcProtocol::decodeRequest(payload, request)
+            ? handle(request)
+            : errorResponse(IpcProtocol::Status::BadRequest, "Malformed request");
+        QByteArray encoded = IpcProtocol::encodeResponse(response);
+        if (encoded.size() > qsizetype(IpcProtocol::MAX_FRAME_SIZE)) {
+            // The client would drop the frame and lose the connection
+            encoded = IpcProtocol::encodeResponse(
+                errorResponse(IpcProtocol::Status::Failed, "Response is too large to send"));
+        }
+        socket->write(IpcProtocol::frame(encoded));
+    }
+
+    // A stream that lost its framing cannot be resynchronized
+    if (result == IpcProtocol::FrameResult::Invalid) {
+        qWarning() << "IpcServer: Dropping client that sent an invalid frame";
+        socket->disconnectFromServer();
+    }
+}
+
+void IpcServer::onDisconnected()
+{
+    auto* socket = qobject_cast<QLocalSocket*>(sender());
+    m_buffers.remove(socket);
+    socket->deleteLater();
+}
+
+IpcProtocol::Response IpcServer::listResponse(const QList<ClipboardItem>& items)
+{
+    IpcProtocol::Response response;
+    response.entries.reserve(items.size());
+    for (const ClipboardItem& item : items) {
+        IpcProtocol::Entry entry;
+        entry.id = item.id();
+        const bool useText = item.hasText() && !item.hasPayload();
+        entry.preview = ClipboardItem::generatePreview(useText ? item.text() : item.preview(),
+                                                       MAX_PREVIEW_LENGTH);
+        entry.pinned = item.pinned();
+        entry.timestamp = item.timestamp().toMSecsSinceEpoch();
+        response.entries.append(entry);
+    }
+    return response;
+}
+
+IpcProtocol::Response IpcServer::errorResponse(IpcProtocol::Status status, const QString& message)
+{
+    IpcProtocol::Response response;
+    response.status = status;
+    response.message = message;
+    return response;
+}
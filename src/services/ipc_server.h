@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "ipc_protocol.h"
+#include "../models/clipboard_item.h"
+
+class QLocalServer;
+class QLocalSocket;
+class ClipboardManager;
+
+/**
+ * IpcServer - Serves the running instance's history over a local socket
+ *
+ * The daemon side of IpcProtocol: it answers list, search, get, pin,
+ * paste and show requests from the running instance's history, so scripts
+ * and compositor keybindings never start a second GUI instance. Requests
+ * are handled on the GUI thread as they arrive. List and search cover the
+ * whole history: list reads cold items from their metadata, search loads
+ * their text from disk while ranking.
+ *
+ * Only one server may listen on a name. A socket left behind by a crashed
+ * instance is detected and replaced; a live one makes listen() fail.
+ */
+class IpcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Create server for a clipboard manager
+     * @param manager History to serve, must outlive the server
+     * @param parent QObject parent
+     */
+    explicit IpcServer(ClipboardManager* manager, QObject* parent = nullptr);
+    ~IpcServer() override;
+
+    /**
+     * Start accepting connections
+     * @param name Server name or socket path
+     * @return false if another instance is listening or the socket cannot be created
+     */
+    bool listen(const QString& name = IpcProtocol::defaultServerName());
+
+    /**
+     * Stop accepting connections and drop the connected clients
+     */
+    void close();
+
+    bool isListening() const;
+    QString serverName() const;
+
+    /**
+     * Answer a single request
+     * @param request Decoded request
+     * @return Response to send back
+     */
+    IpcProtocol::Response handle(const IpcProtocol::Request& request);
+
+    /**
+     * Check if a server is listening on a name
+     * @param name Server name or socket path
+     * @param timeoutMs Time to wait for the connection
+     */
+    static bool isServerRunning(const QString& name, int timeoutMs = 100);
+
+signals:
+    /**
+     * Emitted when a client asks for the history window
+     */
+    void showRequested();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    /**
+     * Get entries for a list of items
+     */
+    static IpcProtocol::Response listResponse(const QList<ClipboardItem>& items);
+
+    static IpcProtocol::Response errorResponse(IpcProtocol::Status status, const QString& message);
+
+    static constexpr int MAX_PREVIEW_LENGTH = 80;
+
+    ClipboardManager* m_manager;
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, QByteArray> m_buffers;   ///< Partial frames per client
+};
@@ -0,0 +1,59 @@
+#include "payload_mime_data.h"
+#include <QImage>
+
+namespace {
+
+const QString IMAGE_PNG = QStringLiteral("image/png");
+const QString QT_IMAGE = QStringLiteral("application/x-qt-image");
+const QString TEXT_PLAIN = QStringLiteral("text/plain");
+const QString URI_LIST = QStringLiteral("text/uri-list");
+
+} // namespace
+
+PayloadMimeData::PayloadMimeData(const ClipboardItem& item, const BlobStore::Blob& blob)
+    : m_item(item)
+    , m_blob(blob)
+{
+    const QString type = m_item.payload().mimeType;
+    m_formats.append(type);
+    if (type == IMAGE_PNG) {
+        m_formats.append(QT_IMAGE);
+    } else if (type == URI_LIST) {
+        m_formats.append(TEXT_PLAIN);
+    }
+}
+
+QStringList PayloadMimeData::formats() const
+{
+    return m_formats;
+}
+
+bool PayloadMimeData::hasFormat(const QString& mimeType) const
+{
+    return m_formats.contains(mimeType);
+}
+
+QVariant PayloadMimeData::retrieveData(const QString& mimeType, QMetaType type) const
+{
+    const QString payloadType = m_item.payload().mimeType;
+    if (mimeType == payloadType) {
+        // A view of the mapping; only text requested as a string is decoded
+        if (type.id() == QMetaType::QString && payloadType.startsWith(QLatin1String("text/"))) {
+            if (m_text.isNull()) {
+                m_text = QString::fromUtf8(m_blob.bytes());
+            }
+            return m_text;
+        }
+        return m_blob.bytes();
+    }
+    if (mimeType == QT_IMAGE && payloadType == IMAGE_PNG) {
+        if (m_image.isNull()) {
+            m_image = QImage::fromData(m_blob.bytes(), "PNG");
+        }
+        return m_image;
+    }
+    if (mimeType == TEXT_PLAIN && payloadType == URI_LIST) {
+        return m_item.text();
+    }
+    return QMimeData::retrieveData(mimeType, type);
+}
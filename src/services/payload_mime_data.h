@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QImage>
+#include <QMimeData>
+#include <QStringList>
+
+#include "../models/blob_store.h"
+#include "../models/clipboard_item.h"
+
+/**
+ * PayloadMimeData - Clipboard data served straight from a mapped blob
+ *
+ * Offers a payload item's stored bytes under its MIME type, plus the
+ * formats applications expect alongside it (a QImage for PNG images, the
+ * file names as plain text for URI lists). The bytes are handed out as a
+ * view of the blob mapping, which this object keeps open for as long as
+ * the clipboard owns it; nothing is read or decoded until a format is
+ * actually requested.
+ *
+ * Receivers often ask for the same data several times, once per target
+ * format. Raw bytes are always served from the mapping; the decoded forms
+ * (text as a QString, the image as a QImage) are built on the first
+ * request that needs them and shared by all later ones.
+ */
+class PayloadMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor - Serves a payload item from its mapped blob
+     * @param item Item whose payload is offered
+     * @param blob Mapping of the item's payload
+     */
+    PayloadMimeData(const ClipboardItem& item, const BlobStore::Blob& blob);
+
+    /**
+     * Get the item this data was created for
+     * @return Item with its payload reference
+     */
+    const ClipboardItem& item() const { return m_item; }
+
+    /**
+     * Check if a decoded form of the payload has been built
+     * @return true once text or an image has been requested
+     */
+    bool isDecoded() const { return !m_text.isNull() || !m_image.isNull(); }
+
+    QStringList formats() const override;
+    bool hasFormat(const QString& mimeType) const override;
+
+protected:
+    QVariant retrieveData(const QString& mimeType, QMetaType type) const override;
+
+private:
+    ClipboardItem m_item;                    ///< Item being pasted
+    BlobStore::Blob m_blob;                  ///< Mapping of its payload
+    QStringList m_formats;                   ///< Offered formats, payload type first
+    mutable QString m_text;                  ///< Text payload, decoded on request
+    mutable QImage m_image;                  ///< Image payload, decoded on request
+};
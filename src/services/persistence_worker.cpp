@@ -0,0 +1,127 @@
+#include "persistence_worker.h"
+#include "../models/history_snapshot.h"
+#include "../lib/metrics.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMetaObject>
+
+PersistenceWorker::PersistenceWorker(const QString& snapshotPath, const QString& journalPath,
+                                     const QString& blobDirectory)
+    : m_snapshotPath(snapshotPath)
+    , m_journal(journalPath)
+    , m_blobs(blobDirectory)
+{
+}
+
+template <typename Function>
+void PersistenceWorker::post(Function function)
+{
+    QMetaObject::invokeMethod(this, std::move(function), Qt::QueuedConnection);
+}
+
+void PersistenceWorker::recordAdded(const ClipboardItem& item)
+{
+    post([this, item]() {
+        journalWritten(m_journal.recordAdded(item));
+    });
+}
+
+void PersistenceWorker::recordPinned(const QString& id)
+{
+    post([this, id]() {
+        journalWritten(m_journal.recordPinned(id));
+    });
+}
+
+void PersistenceWorker::recordUnpinned(const QString& id)
+{
+    post([this, id]() {
+        journalWritten(m_journal.recordUnpinned(id));
+    });
+}
+
+void PersistenceWorker::recordRemoved(const QString& id)
+{
+    post([this, id]() {
+        journalWritten(m_journal.recordRemoved(id));
+    });
+}
+
+void PersistenceWorker::recordRemoved(const QStringList& ids)
+{
+    post([this, ids]() {
+        journalWritten(m_journal.recordRemoved(ids));
+    });
+}
+
+void PersistenceWorker::requestSnapshot(int maxItems, const QList<ClipboardItem>& items)
+{
+    post([this, maxItems, items]() {
+        writeSnapshot(maxItems, items);
+    });
+}
+
+bool PersistenceWorker::writeSnapshot(int maxItems, const QList<ClipboardItem>& items)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Set the folded records aside first; anything queued later is kept
+    if (!m_journal.beginCompaction()) {
+        Metrics::add(Metrics::SaveFailures);
+        emit snapshotWritten(false, "Failed to rotate history journal");
+        return false;
+    }
+    m_pendingRecords.storeRelaxed(0);
+
+    bool success = HistorySnapshot::write(m_snapshotPath, maxItems, items);
+    m_journal.finishCompaction(success);
+
+    if (success) {
+        Metrics::add(Metrics::Saves);
+        Metrics::add(Metrics::SavedBytes, quint64(QFileInfo(m_snapshotPath).size()));
+        Metrics::record(Metrics::SaveLatency, timer.nsecsElapsed());
+    } else {
+        Metrics::add(Metrics::SaveFailures);
+    }
+
+    emit snapshotWritten(success, success ? QString()
+                                          : QString("Failed to write %1").arg(m_snapshotPath));
+    return success;
+}
+
+void PersistenceWorker::storePayload(quint64 ticket, const QByteArray& data)
+{
+    post([this, ticket, data]() {
+        const QString key = m_blobs.put(data);
+        if (!key.isEmpty()) {
+            m_unclaimedBlobs.insert(ticket, key);
+        }
+        emit payloadStored(ticket, key);
+    });
+}
+
+void PersistenceWorker::requestBlobCollection(quint64 claimedTicket, const QSet<QString>& liveKeys)
+{
+    post([this, claimedTicket, liveKeys]() {
+        // Claimed payloads are covered by liveKeys if they are still in use
+        while (!m_unclaimedBlobs.isEmpty() && m_unclaimedBlobs.firstKey() <= claimedTicket) {
+            m_unclaimedBlobs.erase(m_unclaimedBlobs.begin());
+        }
+        QSet<QString> keep = liveKeys;
+        for (const QString& key : std::as_const(m_unclaimedBlobs)) {
+            keep.insert(key);
+        }
+        m_blobs.collectGarbage(keep);
+    });
+}
+
+void PersistenceWorker::journalWritten(bool success)
+{
+    if (success) {
+        m_pendingRecords.storeRelaxed(m_journal.recordCount());
+    } else {
+        emit journalError(QString("Failed to append to %1").arg(m_journal.filePath()));
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "../models/blob_store.h"
+#include "../models/clipboard_item.h"
+#include "../models/history_journal.h"
+
+/**
+ * PersistenceWorker - Writes history changes to disk off the GUI thread
+ *
+ * The worker lives on its own thread and owns the history journal. All
+ * requests are queued to that thread in call order, so a snapshot always
+ * contains exactly the journal records queued before it, and records
+ * queued after it land in the fresh journal.
+ *
+ * Snapshots are written through QSaveFile, whose commit() syncs the data
+ * to disk before atomically replacing the previous snapshot.
+ *
+ * Captured payloads are hashed and written to the blob store here too,
+ * and the store is swept on this thread. Each payload carries a ticket;
+ * a sweep spares blobs whose ticket the caller has not claimed yet, so a
+ * blob is never deleted before the item referring to it reaches history.
+ */
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Create worker for the given files
+     * @param snapshotPath Path of the binary history snapshot
+     * @param journalPath Path of the change journal
+     * @param blobDirectory Directory of the payload blob store
+     */
+    PersistenceWorker(const QString& snapshotPath, const QString& journalPath,
+                      const QString& blobDirectory);
+
+    // Requests (thread-safe, queued to the worker thread)
+    void recordAdded(const ClipboardItem& item);
+    void recordPinned(const QString& id);
+    void recordUnpinned(const QString& id);
+    void recordRemoved(const QString& id);
+    void recordRemoved(const QStringList& ids);
+
+    /**
+     * Queue a snapshot write
+     * @param maxItems History size limit to store
+     * @param items Immutable copy of the items to write, in display order
+     */
+    void requestSnapshot(int maxItems, const QList<ClipboardItem>& items);
+
+    /**
+     * Write a snapshot and fold the journal into it
+     * Must run on the worker thread, or while the worker thread is stopped
+     * @return true if the snapshot was committed
+     */
+    bool writeSnapshot(int maxItems, const QList<ClipboardItem>& items);
+    
+    /**
+     * Queue a payload for the blob store
+     * @param ticket Increasing number identifying the payload to the caller
+     * @param data Payload bytes
+     * Reported through payloadStored()
+     */
+    void storePayload(quint64 ticket, const QByteArray& data);
+    
+    /**
+     * Queue a sweep of the blob store
+     * @param claimedTicket Highest ticket whose payloadStored() the caller
+     *                      has handled; later payloads are kept
+     * @param liveKeys Snapshot of the keys the history still refers to
+     */
+    void requestBlobCollection(quint64 claimedTicket, const QSet<QString>& liveKeys);
+
+    /**
+     * Get number of journal records written since the last snapshot
+     * @return Record count (updated on the worker thread)
+     */
+    int pendingRecords() const { return m_pendingRecords.loadRelaxed(); }
+
+signals:
+    /**
+     * Emitted after a snapshot write finishes
+     * @param success true if the snapshot was committed
+     * @param message Error description when the write failed
+     */
+    void snapshotWritten(bool success, const QString& message);
+    
+    /**
+     * Emitted after a payload queued with storePayload() is written
+     * @param ticket Ticket passed to storePayload()
+     * @param key Blob key, empty if the payload could not be written
+     */
+    void payloadStored(quint64 ticket, const QString& key);
+
+    /**
+     * Emitted when a journal record cannot be written
+     * @param message Error description
+     */
+    void journalError(const QString& message);
+
+private:
+    /**
+     * Run function on the worker thread after all earlier requests
+     */
+    template <typename Function>
+    void post(Function function);
+
+    /**
+     * Report a journal write result
+     */
+    void journalWritten(bool success);
+
+    QString m_snapshotPath;          ///< Binary snapshot file
+    HistoryJournal m_journal;        ///< Change journal, only touched on the worker thread
+    BlobStore m_blobs;               ///< Payload store, only written on the worker thread
+    QMap<quint64, QString> m_unclaimedBlobs; ///< Stored keys by ticket, until claimed
+    QAtomicInt m_pendingRecords;     ///< Mirror of the journal record count
+};
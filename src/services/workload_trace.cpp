@@ -0,0 +1,237 @@
+#include "workload_trace.h"
+#include "../models/clipboard_item.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStringList>
+
+namespace {
+
+const QString TRACE_FORMAT = QStringLiteral("clipboard-trace");
+
+// Vocabulary of synthesized texts, so previews, search and compression see
+// word-like content rather than a repeated character
+const QStringList WORDS = {
+    "the", "request", "value", "return", "https://example.com/", "error", "config",
+    "int", "const", "QString", "user", "2024-05-01", "SELECT", "from", "where",
+    "id", "=", "{", "}", "note", "meeting", "path/to/file", "status", "200", "ok"
+};
+
+constexpr int WORDS_PER_LINE = 12;
+
+} // namespace
+
+void WorkloadTrace::start()
+{
+    m_events.clear();
+    m_tokens.clear();
+    m_clock.start();
+}
+
+void WorkloadTrace::record(QStringView content)
+{
+    if (!m_clock.isValid()) {
+        m_clock.start();
+    }
+
+    const quint64 key = ClipboardItem::generateContentKey(content);
+    const auto it = m_tokens.constFind(key);
+    if (it != m_tokens.constEnd()) {
+        append(m_clock.elapsed(), content.size(), *it);
+        return;
+    }
+    m_tokens.insert(key, m_events.count());
+    append(m_clock.elapsed(), content.size());
+}
+
+void WorkloadTrace::append(qint64 offsetMs, qint64 length, int token)
+{
+    Event event;
+    event.offsetMs = qMax(offsetMs, durationMs());
+    if (token >= 0 && token < m_events.count()) {
+        event.token = m_events.at(token).token;
+        event.length = m_events.at(event.token).length;
+    } else {
+        event.token = m_events.count();
+        event.length = qMax<qint64>(0, length);
+    }
+    m_events.append(event);
+}
+
+int WorkloadTrace::duplicateCount() const
+{
+    int duplicates = 0;
+    for (int i = 0; i < m_events.count(); ++i) {
+        if (m_events.at(i).token != i) {
+            ++duplicates;
+        }
+    }
+    return duplicates;
+}
+
+QString WorkloadTrace::contentAt(int index) const
+{
+    const int token = m_events.at(index).token;
+    const qsizetype length = qsizetype(m_events.at(token).length);
+
+    // Seeded by token: equal tokens give equal text, others differ from the prefix on
+    QRandomGenerator random(quint32(token) + 1);
+    QString text = QString("#%1 ").arg(token);
+    text.reserve(length + 32);
+    int words = 0;
+    while (text.size() < length) {
+        text.append(WORDS.at(random.bounded(int(WORDS.size()))));
+        text.append(++words % WORDS_PER_LINE == 0 ? '\n' : ' ');
+    }
+    text.truncate(length);
+    return text;
+}
+
+bool WorkloadTrace::save(const QString& filePath) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "WorkloadTrace: Cannot write" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    QJsonObject header;
+    header["format"] = TRACE_FORMAT;
+    header["version"] = FORMAT_VERSION;
+    header["events"] = m_events.count();
+    QByteArray data = QJsonDocument(header).toJson(QJsonDocument::Compact);
+    data.append('\n');
+
+    for (const Event& event : m_events) {
+        QJsonObject record;
+        record["t"] = event.offsetMs;
+        record["length"] = event.length;
+        record["token"] = event.token;
+        data.append(QJsonDocument(record).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    }
+
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool WorkloadTrace::load(const QString& filePath)
+{
+    m_events.clear();
+    m_tokens.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "WorkloadTrace: Cannot read" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    const QJsonObject header = QJsonDocument::fromJson(file.readLine()).object();
+    if (header.value("format").toString() != TRACE_FORMAT ||
+        header.value("version").toInt() != FORMAT_VERSION) {
+        qWarning() << "WorkloadTrace:" << filePath << "is not a clipboard trace";
+        return false;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        const QJsonObject record = QJsonDocument::fromJson(line).object();
+        const qint64 offsetMs = record.value("t").toInteger(-1);
+        const qint64 length = record.value("length").toInteger(-1);
+        const int token = record.value("token").toInt(-1);
+        const int index = m_events.count();
+        const bool repeat = token >= 0 && token < index && m_events.at(token).token == token;
+        if (offsetMs < durationMs() || length < 0 || length > MAX_EVENT_LENGTH ||
+            (token != index && !repeat)) {
+            qWarning() << "WorkloadTrace: Invalid event" << index << "in" << filePath;
+            m_events.clear();
+            return false;
+        }
+        append(offsetMs, length, repeat ? token : -1);
+    }
+    return true;
+}
+
+WorkloadTrace WorkloadTrace::generate(Pattern pattern, int eventCount, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    WorkloadTrace trace;
+    qint64 offsetMs = 0;
+
+    switch (pattern) {
+        case Burst: {
+            // Runs of 5-20 copies 20-80 ms apart, then a pause of 2-10 s
+            int runLeft = 0;
+            for (int i = 0; i < eventCount; ++i) {
+                if (runLeft == 0) {
+                    runLeft = 5 + random.bounded(16);
+                    offsetMs += i == 0 ? 0 : 2000 + random.bounded(8000);
+                } else {
+                    offsetMs += 20 + random.bounded(61);
+                }
+                --runLeft;
+
+                // Now and then a run returns to something copied shortly before
+                const int token = i > 0 && random.bounded(10) == 0 ? qMax(0, i - 1 - random.bounded(20)) : -1;
+                trace.append(offsetMs, 20 + random.bounded(2000), token);
+            }
+            break;
+        }
+        case GiantPastes:
+            // 10k-2M characters every 1-5 s, a third of them pasted again
+            for (int i = 0; i < eventCount; ++i) {
+                offsetMs += i == 0 ? 0 : 1000 + random.bounded(4000);
+                const int token = i > 0 && random.bounded(3) == 0 ? random.bounded(i) : -1;
+                trace.append(offsetMs, 10 * 1000 + random.bounded(2 * 1000 * 1000), token);
+            }
+            break;
+        case HeavyDuplicates: {
+            // A handful of texts, nine in ten copies repeating one of them
+            const int distinct = qMax(4, eventCount / 50);
+            QList<int> tokens;
+            for (int i = 0; i < eventCount; ++i) {
+                offsetMs += i == 0 ? 0 : 300 + random.bounded(1200);
+                const bool repeat = !tokens.isEmpty() &&
+                                    (tokens.count() >= distinct || random.bounded(10) != 0);
+                if (repeat) {
+                    trace.append(offsetMs, 0, tokens.at(random.bounded(int(tokens.count()))));
+                } else {
+                    tokens.append(i);
+                    trace.append(offsetMs, 20 + random.bounded(500));
+                }
+            }
+            break;
+        }
+    }
+    return trace;
+}
+
+WorkloadTrace::Pattern WorkloadTrace::patternFromName(const QString& name, bool* ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    if (name == "burst") {
+        return Burst;
+    }
+    if (name == "giant") {
+        return GiantPastes;
+    }
+    if (name == "duplicates") {
+        return HeavyDuplicates;
+    }
+    if (ok) {
+        *ok = false;
+    }
+    return Burst;
+}
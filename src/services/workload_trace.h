@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+/**
+ * WorkloadTrace - Anonymized record of clipboard captures
+ *
+ * A trace keeps, for every captured text, only when it arrived, how long
+ * it was and which earlier capture it repeated. No content is stored: a
+ * repeat is recognized by content key while recording, and the key is
+ * forgotten once the trace is saved. Replays synthesize text of the
+ * recorded length, equal for equal tokens, so deduplication, coalescing
+ * and retention see the same load as in the recorded session.
+ *
+ * Traces are saved as JSON lines: a header object followed by one
+ * {"t", "length", "token"} object per event. They can also be generated
+ * for the patterns that are hard to capture on demand.
+ */
+class WorkloadTrace
+{
+public:
+    /**
+     * One captured text
+     */
+    struct Event {
+        qint64 offsetMs = 0;   ///< Time since the first event
+        qint64 length = 0;     ///< Text length in UTF-16 code units
+        int token = 0;         ///< Index of the first event with the same content
+    };
+
+    /**
+     * Patterns for generated traces
+     */
+    enum Pattern {
+        Burst,              ///< Rapid runs of distinct copies separated by pauses
+        GiantPastes,        ///< Texts above the inline limit, often repeated
+        HeavyDuplicates     ///< Few distinct texts copied over and over
+    };
+
+    /**
+     * Start recording: the next event is at offset 0
+     */
+    void start();
+
+    /**
+     * Record a captured text
+     * @param content Captured text; only its length and content key are used
+     */
+    void record(QStringView content);
+
+    /**
+     * Append an event
+     * @param offsetMs Time since the first event (clamped to be non-decreasing)
+     * @param length Text length; a repeat takes the length of the event it repeats
+     * @param token Index of the first event with the same content, or -1 for new content
+     */
+    void append(qint64 offsetMs, qint64 length, int token = -1);
+
+    // Getters
+    const QList<Event>& events() const { return m_events; }
+    int count() const { return m_events.count(); }
+    bool isEmpty() const { return m_events.isEmpty(); }
+    qint64 durationMs() const { return m_events.isEmpty() ? 0 : m_events.last().offsetMs; }
+
+    /**
+     * Count the events that repeat an earlier one
+     */
+    int duplicateCount() const;
+
+    /**
+     * Synthesize the text of an event
+     * @param index Event index
+     * @return Text of the recorded length, equal for events with equal tokens
+     */
+    QString contentAt(int index) const;
+
+    /**
+     * Write the trace as JSON lines
+     * @param filePath Destination, replaced atomically
+     * @return true if the file was written
+     */
+    bool save(const QString& filePath) const;
+
+    /**
+     * Read a trace written by save()
+     * @param filePath Trace file
+     * @return true if the file is a valid trace; the trace is left empty otherwise
+     */
+    bool load(const QString& filePath);
+
+    /**
+     * Generate a trace
+     * @param pattern Load pattern
+     * @param eventCount Number of events
+     * @param seed Random seed; equal seeds give equal traces
+     * @return Generated trace
+     */
+    static WorkloadTrace generate(Pattern pattern, int eventCount, quint32 seed = 1);
+
+    /**
+     * Parse a pattern name ("burst", "giant", "duplicates")
+     * @param name Pattern name
+     * @param ok Set to whether the name is known
+     */
+    static Pattern patternFromName(const QString& name, bool* ok = nullptr);
+
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr qint64 MAX_EVENT_LENGTH = 64 * 1024 * 1024; ///< Longer events are rejected on load
+
+private:
+    QList<Event> m_events;                    ///< Events, oldest first
+    QHash<quint64, int> m_tokens;             ///< Content key to token while recording
+    QElapsedTimer m_clock;                    ///< Started by start()
+};
@@ -1,8 +1,11 @@
 #include "about_dialog.h"
+#include "../lib/metrics.h"
 #include <QApplication>
 #include <QScreen>
 #include <QPixmap>
 #include <QFont>
+#include <QFontDatabase>
+#include <QScrollBar>
 #include <QDateTime>
 #include <QGraphicsDropShadowEffect>
 
@@ -11,6 +14,8 @@ AboutDialog::AboutDialog(int clipboardCount, QWidget* parent)
     , m_clipboardCount(clipboardCount)
     , m_closeButton(nullptr)
     , m_mainLayout(nullptr)
+    , m_metricsView(nullptr)
+    , m_metricsTimer(new QTimer(this))
 {
     setupUI();
     applyGlassDesign();
@@ -19,7 +24,13 @@ AboutDialog::AboutDialog(int clipboardCount, QWidget* parent)
     setWindowTitle("About Clipboard Manager");
     setWindowIcon(QIcon::fromTheme("help-about"));
     setModal(true);
-    setFixedSize(500, 600);
+    setFixedSize(500, 760);
+    
+    // Metrics keep changing while the dialog is open
+    m_metricsTimer->setObjectName("metricsTimer");
+    m_metricsTimer->setInterval(METRICS_REFRESH_MS);
+    connect(m_metricsTimer, &QTimer::timeout, this, &AboutDialog::refreshMetrics);
+    m_metricsTimer->start();
     
     // Make window frameless with translucent background for glass effect
     setWindowFlags(Qt::Dialog | Qt::FramelessWindowHint);
@@ -208,6 +219,15 @@ QWidget* AboutDialog::createStatsSection()
     
     layout->addWidget(statsGrid);
     
+    // Runtime metrics, the same report as --metrics
+    m_metricsView = new QPlainTextEdit();
+    m_metricsView->setObjectName("metricsView");
+    m_metricsView->setReadOnly(true);
+    m_metricsView->setFixedHeight(150);
+    m_metricsView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(m_metricsView);
+    refreshMetrics();
+    
     return stats;
 }
 
@@ -310,6 +330,14 @@ void AboutDialog::applyGlassDesign()
             border: 1px solid rgba(52, 152, 219, 0.3);
         }
         
+        #metricsView {
+            background: rgba(255, 255, 255, 0.6);
+            border-radius: 8px;
+            border: 1px solid rgba(52, 152, 219, 0.3);
+            color: #2c3e50;
+            font-size: 11px;
+        }
+        
         #statsLabel {
             font-size: 14px;
             color: #2c3e50;
@@ -339,4 +367,12 @@ void AboutDialog::applyGlassDesign()
 void AboutDialog::onCloseClicked()
 {
     accept();
+}
+
+void AboutDialog::refreshMetrics()
+{
+    // Keep the scroll position while the numbers update
+    const int scroll = m_metricsView->verticalScrollBar()->value();
+    m_metricsView->setPlainText(Metrics::report());
+    m_metricsView->verticalScrollBar()->setValue(scroll);
 }
\ No newline at end of file
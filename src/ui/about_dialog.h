@@ -7,6 +7,8 @@
 #include <QPushButton>
 #include <QScrollArea>
 #include <QTextEdit>
+#include <QPlainTextEdit>
+#include <QTimer>
 
 /**
  * @brief Modern About dialog for clipboard manager
@@ -15,6 +17,7 @@
  * - Modern, attractive design
  * - System color scheme adaptation
  * - Application information and statistics
+ * - Live runtime metrics of the running instance
  * - License and contact information
  */
 class AboutDialog : public QDialog
@@ -39,6 +42,11 @@ private slots:
      * Handle close button click
      */
     void onCloseClicked();
+    
+    /**
+     * Show the current runtime metrics
+     */
+    void refreshMetrics();
 
 private:
     /**
@@ -75,4 +83,8 @@ private:
     int m_clipboardCount;
     QPushButton* m_closeButton;
     QVBoxLayout* m_mainLayout;
+    QPlainTextEdit* m_metricsView;
+    QTimer* m_metricsTimer;
+    
+    static constexpr int METRICS_REFRESH_MS = 1000;
 };
\ No newline at end of file
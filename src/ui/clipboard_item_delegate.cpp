@@ -0,0 +1,87 @@
+#include "clipboard_item_delegate.h"
+#include "clipboard_list_model.h"
+#include <QPainter>
+#include <QStyle>
+
+ClipboardItemDelegate::ClipboardItemDelegate(int itemHeight, QObject* parent)
+    : QStyledItemDelegate(parent)
+    , m_itemHeight(itemHeight)
+    , m_flat(false)
+    , m_textColor(0x2c, 0x3e, 0x50)
+    , m_selectedTextColor(Qt::white)
+    , m_hintColor(0x7f, 0x8c, 0x8d)
+{
+    setFlat(false);
+}
+
+void ClipboardItemDelegate::setItemHeight(int height)
+{
+    if (height > 0 && height != m_itemHeight) {
+        m_itemHeight = height;
+        // Uniform-size views cache the row height; make them relayout
+        emit sizeHintChanged(QModelIndex());
+    }
+}
+
+void ClipboardItemDelegate::setFlat(bool flat)
+{
+    m_flat = flat;
+    if (m_flat) {
+        m_background = QColor(Qt::white);
+        m_hoverBackground = QColor(0xd6, 0xea, 0xf8);
+        m_selectedBackground = QColor(0x34, 0x98, 0xdb);
+    } else {
+        m_background = QColor(255, 255, 255, 102);
+        m_hoverBackground = QColor(52, 152, 219, 77);
+        m_selectedBackground = QColor(52, 152, 219, 204);
+    }
+}
+
+void ClipboardItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                                  const QModelIndex& index) const
+{
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    const bool selected = opt.state.testFlag(QStyle::State_Selected);
+
+    painter->save();
+    const QColor& background = selected ? m_selectedBackground
+                             : opt.state.testFlag(QStyle::State_MouseOver) ? m_hoverBackground : m_background;
+    const QRect rowRect = opt.rect.adjusted(ROW_MARGIN, ROW_MARGIN, -ROW_MARGIN, -ROW_MARGIN);
+    if (m_flat) {
+        painter->fillRect(rowRect, background);
+    } else {
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(background);
+        painter->drawRoundedRect(QRectF(rowRect), ROW_RADIUS, ROW_RADIUS);
+    }
+
+    QRect textRect = opt.rect.adjusted(TEXT_MARGIN, 0, -TEXT_MARGIN, 0);
+    if (index.row() < QUICK_SELECT_ROWS) {
+        painter->setFont(opt.font);
+        painter->setPen(selected ? m_selectedTextColor : m_hintColor);
+        painter->drawText(textRect, Qt::AlignRight | Qt::AlignVCenter | Qt::TextSingleLine,
+                          QString::number(index.row() + 1));
+        textRect.setRight(textRect.right() - HINT_WIDTH);
+    }
+
+    if (index.data(ClipboardListModel::PinnedRole).toBool()) {
+        QFont font = opt.font;
+        font.setBold(true);
+        painter->setFont(font);
+    } else {
+        painter->setFont(opt.font);
+    }
+    painter->setPen(selected ? m_selectedTextColor : m_textColor);
+
+    QString text = painter->fontMetrics().elidedText(opt.text, Qt::ElideRight, textRect.width());
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, text);
+    painter->restore();
+}
+
+QSize ClipboardItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(index)
+    return QSize(option.rect.width(), m_itemHeight);
+}
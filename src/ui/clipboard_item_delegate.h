@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QColor>
+#include <QStyledItemDelegate>
+
+/**
+ * ClipboardItemDelegate - Paints one clipboard history row
+ *
+ * Every row has the same height, so the view can lay out any number of
+ * items without measuring them and only paints the rows on screen. Text
+ * is drawn on a single line and elided to the row width; pinned items are
+ * shown in bold.
+ *
+ * The row background, hover and selection highlight are painted here
+ * with fixed colors rather than through item style sheet rules, so moving
+ * the selection repaints two rows without any style sheet matching. The
+ * first QUICK_SELECT_ROWS rows show the digit that selects them. Flat
+ * rows are opaque rectangles, drawn without blending or antialiasing.
+ */
+class ClipboardItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor - Creates delegate with the given row height
+     * @param itemHeight Height of each row in pixels
+     * @param parent QObject parent for memory management
+     */
+    explicit ClipboardItemDelegate(int itemHeight, QObject* parent = nullptr);
+
+    /**
+     * Set height of each row
+     * @param height Height in pixels
+     */
+    void setItemHeight(int height);
+
+    /**
+     * Get height of each row
+     * @return Height in pixels
+     */
+    int itemHeight() const { return m_itemHeight; }
+
+    /**
+     * Paint rows as opaque rectangles instead of translucent rounded ones
+     * @param flat true for the low-power look
+     */
+    void setFlat(bool flat);
+
+    /**
+     * Check if rows are painted flat
+     * @return true if rows are opaque rectangles
+     */
+    bool isFlat() const { return m_flat; }
+
+    // QStyledItemDelegate interface
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    static constexpr int QUICK_SELECT_ROWS = 9;  ///< Rows that show their quick-select digit
+
+private:
+    static constexpr int TEXT_MARGIN = 12;  ///< Horizontal text padding
+    static constexpr int ROW_MARGIN = 2;    ///< Gap around each row background
+    static constexpr int ROW_RADIUS = 6;    ///< Corner radius of the row background
+    static constexpr int HINT_WIDTH = 16;   ///< Space kept for the quick-select digit
+
+    int m_itemHeight;                       ///< Uniform row height
+    bool m_flat;                            ///< Opaque rectangles instead of rounded glass
+    QColor m_background;                    ///< Row background
+    QColor m_hoverBackground;               ///< Background under the mouse
+    QColor m_selectedBackground;            ///< Highlight of the current row
+    QColor m_textColor;                     ///< Text of unselected rows
+    QColor m_selectedTextColor;             ///< Text of the current row
+    QColor m_hintColor;                     ///< Quick-select digits
+};
@@ -0,0 +1,217 @@
+#include "clipboard_list_model.h"
+#include "preview_cache.h"
+#include <algorithm>
+
+ClipboardListModel::ClipboardListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ClipboardListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_filtered ? int(m_rows.size() + m_extraItems.size()) : int(m_items.size());
+}
+
+QVariant ClipboardListModel::data(const QModelIndex& index, int role) const
+{
+    const ClipboardItem* row = index.isValid() ? itemForRow(index.row()) : nullptr;
+    if (!row) {
+        return QVariant();
+    }
+
+    const ClipboardItem& item = *row;
+    switch (role) {
+        case Qt::DisplayRole:
+            return formatItemText(item);
+        case Qt::ToolTipRole:
+            return item.preview();
+        case IdRole:
+            return item.id();
+        case ItemRole:
+            return QVariant::fromValue(item);
+        case PinnedRole:
+            return item.pinned();
+        default:
+            return QVariant();
+    }
+}
+
+ClipboardItem ClipboardListModel::itemAt(int row) const
+{
+    if (const ClipboardItem* item = itemForRow(row)) {
+        return *item;
+    }
+    return ClipboardItem(); // Invalid item
+}
+
+int ClipboardListModel::rowOf(const QString& id) const
+{
+    int position = positionOf(id);
+    if (position < 0 || !m_filtered) {
+        return position;
+    }
+
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), position);
+    return it != m_rows.end() && *it == position ? int(it - m_rows.begin()) : -1;
+}
+
+int ClipboardListModel::positionOf(const QString& id) const
+{
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (m_items.at(i).id() == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ClipboardListModel::setFilter(const SearchIndex::Matches& matches,
+                                   const QList<ClipboardItem>& extraItems)
+{
+    beginResetModel();
+    m_matches = matches;
+    m_extraItems = extraItems;
+    m_filtered = true;
+    updateRows();
+    endResetModel();
+}
+
+void ClipboardListModel::clearFilter()
+{
+    if (!m_filtered) {
+        return;
+    }
+
+    beginResetModel();
+    m_matches = SearchIndex::Matches();
+    m_extraItems.clear();
+    m_rows.clear();
+    m_filtered = false;
+    endResetModel();
+}
+
+void ClipboardListModel::setItems(const QList<ClipboardItem>& items)
+{
+    beginResetModel();
+    m_items = items;
+    updateRows();
+    endResetModel();
+}
+
+void ClipboardListModel::insertItem(int row, const ClipboardItem& item)
+{
+    row = qBound(0, row, int(m_items.size()));
+    if (m_filtered) {
+        beginResetModel();
+        m_items.insert(row, item);
+        updateRows();
+        endResetModel();
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_items.insert(row, item);
+    endInsertRows();
+}
+
+bool ClipboardListModel::removeItem(int row)
+{
+    if (row < 0 || row >= m_items.size()) {
+        return false;
+    }
+
+    if (m_filtered) {
+        beginResetModel();
+        m_items.removeAt(row);
+        updateRows();
+        endResetModel();
+        return true;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_items.removeAt(row);
+    endRemoveRows();
+    return true;
+}
+
+void ClipboardListModel::moveItem(int from, int to, const ClipboardItem& item)
+{
+    if (from < 0 || from >= m_items.size()) {
+        insertItem(to, item);
+        return;
+    }
+
+    to = qBound(0, to, int(m_items.size()) - 1);
+    if (m_filtered) {
+        beginResetModel();
+        m_items.move(from, to);
+        m_items[to] = item;
+        updateRows();
+        endResetModel();
+        return;
+    }
+
+    if (from != to) {
+        // Qt expects the destination as a row of the list before the move
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        m_items.move(from, to);
+        endMoveRows();
+    }
+    replaceItem(to, item);
+}
+
+void ClipboardListModel::replaceItem(int row, const ClipboardItem& item)
+{
+    if (row < 0 || row >= m_items.size()) {
+        return;
+    }
+
+    m_items[row] = item;
+    int visibleRow = m_filtered ? rowOf(item.id()) : row;
+    if (visibleRow >= 0) {
+        QModelIndex changed = index(visibleRow);
+        emit dataChanged(changed, changed);
+    }
+}
+
+int ClipboardListModel::positionAt(int row) const
+{
+    if (m_filtered) {
+        return row >= 0 && row < m_rows.size() ? m_rows.at(row) : -1;
+    }
+    return row >= 0 && row < m_items.size() ? row : -1;
+}
+
+const ClipboardItem* ClipboardListModel::itemForRow(int row) const
+{
+    const int position = positionAt(row);
+    if (position >= 0) {
+        return &m_items.at(position);
+    }
+
+    const int extra = m_filtered ? row - int(m_rows.size()) : -1;
+    return extra >= 0 && extra < m_extraItems.size() ? &m_extraItems.at(extra) : nullptr;
+}
+
+void ClipboardListModel::updateRows()
+{
+    m_rows.clear();
+    if (!m_filtered) {
+        return;
+    }
+
+    m_rows.reserve(m_matches.count());
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (m_matches.contains(m_items.at(i).id())) {
+            m_rows.append(i);
+        }
+    }
+}
+
+QString ClipboardListModel::formatItemText(const ClipboardItem& item)
+{
+    return PreviewCache::shared().displayText(item, MAX_DISPLAY_LENGTH);
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include "../models/clipboard_item.h"
+#include "../models/search_index.h"
+
+/**
+ * ClipboardListModel - List model over the displayed clipboard history
+ *
+ * Holds the history items in display order (pinned first) and exposes them
+ * to a QListView. Display text is formatted in data(), so only rows that
+ * the view actually paints are ever formatted. Positional changes map to
+ * the matching row insert/remove/move notifications, so the view updates
+ * only the affected rows instead of resetting.
+ *
+ * A search filter hides the items that did not match. Modification methods
+ * always take positions in the full list; rows are what the view shows.
+ * While filtered, changes reset the model instead. Older items found
+ * outside the list (in the cold tier) can be shown after the matches.
+ */
+class ClipboardListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Custom data roles
+     */
+    enum Roles {
+        IdRole = Qt::UserRole,       ///< Item ID (QString)
+        ItemRole,                    ///< Full ClipboardItem
+        PinnedRole                   ///< Pin state (bool)
+    };
+
+    /**
+     * Constructor - Creates an empty model
+     * @param parent QObject parent for memory management
+     */
+    explicit ClipboardListModel(QObject* parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // Content Access Methods
+    /**
+     * Get all items in display order, including filtered out ones
+     * @return Shared list of items
+     */
+    const QList<ClipboardItem>& items() const { return m_items; }
+
+    /**
+     * Get item at row
+     * @param row Row in the model
+     * @return Item, or invalid item if row is out of range
+     */
+    ClipboardItem itemAt(int row) const;
+
+    /**
+     * Find row of an item
+     * @param id Item UUID
+     * @return Row, or -1 if not found or filtered out
+     */
+    int rowOf(const QString& id) const;
+
+    /**
+     * Find position of an item in the full list
+     * @param id Item UUID
+     * @return Position, or -1 if not found
+     */
+    int positionOf(const QString& id) const;
+
+    // Filtering Methods
+    /**
+     * Show only the items in a search result
+     * @param matches Search result over the items
+     * @param extraItems Matching items not in the list, shown after the
+     *                   matches until the filter changes
+     */
+    void setFilter(const SearchIndex::Matches& matches,
+                   const QList<ClipboardItem>& extraItems = QList<ClipboardItem>());
+
+    /**
+     * Show all items again
+     */
+    void clearFilter();
+
+    /**
+     * Check if a search filter is applied
+     * @return true if some items may be hidden
+     */
+    bool isFiltered() const { return m_filtered; }
+
+    // Content Modification Methods
+    /**
+     * Replace all items (resets attached views)
+     * @param items Items in display order
+     */
+    void setItems(const QList<ClipboardItem>& items);
+
+    /**
+     * Insert an item
+     * @param row Position to insert at (clamped to the valid range)
+     * @param item Item to insert
+     */
+    void insertItem(int row, const ClipboardItem& item);
+
+    /**
+     * Remove the item at a position
+     * @param row Position to remove
+     * @return true if the position existed
+     */
+    bool removeItem(int row);
+
+    /**
+     * Move an item and replace it with its new state
+     * @param from Position the item had
+     * @param to Position after removing it from there and reinserting it
+     * @param item Item in its new state
+     */
+    void moveItem(int from, int to, const ClipboardItem& item);
+
+    /**
+     * Replace the item at a position
+     * @param row Position to replace
+     * @param item New item state
+     */
+    void replaceItem(int row, const ClipboardItem& item);
+
+    /**
+     * Format item text for single-line display
+     * @param item Clipboard item to format
+     * @return Display text with pin indicator, from the shared PreviewCache
+     */
+    static QString formatItemText(const ClipboardItem& item);
+
+private:
+    /**
+     * Map a row to its position in the full list
+     * @return Position, or -1 for rows past the list (see itemForRow())
+     */
+    int positionAt(int row) const;
+
+    /**
+     * Get the item shown in a row, from the list or the extra items
+     * @return Item, or nullptr if row is out of range
+     */
+    const ClipboardItem* itemForRow(int row) const;
+
+    /**
+     * Recompute the visible positions from the filter
+     */
+    void updateRows();
+
+    static constexpr int MAX_DISPLAY_LENGTH = 100;
+
+    QList<ClipboardItem> m_items;    ///< Items in display order
+    QList<int> m_rows;               ///< Visible positions while filtered, ascending
+    SearchIndex::Matches m_matches;  ///< Applied search result
+    QList<ClipboardItem> m_extraItems; ///< Matches outside m_items, after m_rows
+    bool m_filtered = false;         ///< true while a search filter is applied
+};
@@ -1,4 +1,7 @@
 #include "clipboard_window.h"
+#include "../lib/display_session.h"
+#include "../lib/latency_trace.h"
+#include "../lib/metrics.h"
 #include <QScreen>
 #include <QApplication>
 #include <QHeaderView>
@@ -6,10 +9,15 @@
 #include <QStyleOption>
 #include <QStyle>
 #include <QDebug>
-#include <QGraphicsDropShadowEffect>
-#include <QGraphicsBlurEffect>
+#include <QPainter>
+#include <QWindow>
 
 ClipboardWindow::ClipboardWindow(QWidget* parent)
+    : ClipboardWindow(detectRenderMode(), parent)
+{
+}
+
+ClipboardWindow::ClipboardWindow(RenderMode mode, QWidget* parent)
     : QWidget(parent)
     , m_layout(new QVBoxLayout(this))
     , m_headerFrame(new QFrame(this))
@@ -17,24 +25,49 @@ ClipboardWindow::ClipboardWindow(QWidget* parent)
     , m_titleLabel(new QLabel("Clipboard History", this))
     , m_subtitleLabel(new QLabel("", this))
     , m_closeButton(new QPushButton("✕", this))
-    , m_scrollArea(new QScrollArea(this))
-    , m_listWidget(new QListWidget(this))
+    , m_searchEdit(new QLineEdit(this))
+    , m_listView(new QListView(this))
+    , m_model(new ClipboardListModel(this))
+    , m_delegate(nullptr)
+    , m_historyVersion(0)
     , m_maxDisplayItems(10)
     , m_itemHeight(30)
+    , m_renderMode(mode)
+    , m_screens(new ScreenTopology(this))
+    , m_prewarmed(false)
     , m_ignoreNextFocusOut(false)
+    , m_forwardingKey(false)
 {
+    m_delegate = new ClipboardItemDelegate(m_itemHeight, this);
+    m_delegate->setFlat(m_renderMode == LowPower);
+    
     setupWindow();
     setupHeader();
-    setupListWidget();
-    applyGlassDesign();
+    setupSearch();
+    setupListView();
+    setupOpaqueViewport();
+    if (m_renderMode == Glass) {
+        applyGlassDesign();
+    } else {
+        applyLowPowerDesign();
+    }
     
-    // Setup layout
-    m_layout->setContentsMargins(0, 0, 0, 0);
+    // Setup layout, leaving room for the shadow
+    const int margin = m_renderMode == Glass ? SHADOW_MARGIN : 0;
+    m_layout->setContentsMargins(margin, margin, margin, margin);
     m_layout->setSpacing(0);
     m_layout->addWidget(m_headerFrame);
-    m_layout->addWidget(m_scrollArea);
+    m_layout->addWidget(m_searchEdit);
+    m_layout->addWidget(m_listView);
     
     setLayout(m_layout);
+    
+    // A new screen may bring a device pixel ratio the window has not been rendered for
+    connect(m_screens, &ScreenTopology::changed, this, [this]() {
+        if (m_prewarmed && !isVisible()) {
+            QTimer::singleShot(0, this, &ClipboardWindow::prewarmDpiGroups);
+        }
+    });
 }
 
 ClipboardWindow::~ClipboardWindow()
@@ -42,6 +75,29 @@ ClipboardWindow::~ClipboardWindow()
     // QWidget handles cleanup of child widgets
 }
 
+ClipboardWindow::RenderMode ClipboardWindow::detectRenderMode()
+{
+    // Translucency is only cheap when a local compositor blends it
+    return DisplaySession::isCompositing() && !DisplaySession::isRemote() ? Glass : LowPower;
+}
+
+ClipboardWindow::RenderMode ClipboardWindow::renderModeFromName(const QString& name, bool* ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    if (name == "glass") {
+        return Glass;
+    }
+    if (name == "low-power") {
+        return LowPower;
+    }
+    if (ok) {
+        *ok = name == "auto";
+    }
+    return detectRenderMode();
+}
+
 void ClipboardWindow::showAtCursor()
 {
     QPoint cursorPos = QCursor::pos();
@@ -50,55 +106,51 @@ void ClipboardWindow::showAtCursor()
 
 void ClipboardWindow::showAtPosition(const QPoint& position)
 {
-    // Update window size based on content
-    QSize windowSize = calculateWindowSize();
-    resize(windowSize);
+    prepareShow();
     
     // Adjust position to stay on screen
     QPoint adjustedPos = adjustPositionForScreen(position);
+    moveToScreen(m_screens->screenAt(position));
     move(adjustedPos);
     
-    // Show window and ensure it gets focus
-    m_ignoreNextFocusOut = true;
-    show();
-    raise();
-    activateWindow();
-    setFocus();
-    
-    // Reset focus ignore flag after a short delay
-    QTimer::singleShot(100, [this]() {
-        m_ignoreNextFocusOut = false;
-    });
+    presentWindow();
 }
 
 void ClipboardWindow::showAtCenter()
 {
-    // Update window size based on content
-    QSize windowSize = calculateWindowSize();
-    resize(windowSize);
+    QSize windowSize = prepareShow();
     
     // Get primary screen center
-    QScreen* primaryScreen = QApplication::primaryScreen();
-    if (!primaryScreen) {
-        // Fallback to first available screen
-        const QList<QScreen*> screens = QApplication::screens();
-        if (!screens.isEmpty()) {
-            primaryScreen = screens.first();
-        }
-    }
-    
-    if (primaryScreen) {
-        QRect screenGeometry = primaryScreen->availableGeometry();
+    const ScreenTopology::Screen primaryScreen = m_screens->primary();
+    if (!primaryScreen.isNull()) {
+        QRect screenGeometry = primaryScreen.availableGeometry;
         QPoint centerPos = screenGeometry.center() - QPoint(windowSize.width() / 2, windowSize.height() / 2);
         
         // Ensure window stays on screen
         QPoint adjustedPos = adjustPositionForScreen(centerPos);
+        moveToScreen(primaryScreen);
         move(adjustedPos);
     } else {
         // Ultimate fallback - use fixed position
         move(100, 100);
     }
     
+    presentWindow();
+}
+
+QSize ClipboardWindow::prepareShow()
+{
+    LatencyTrace::mark(LatencyTrace::ShowRequested);
+    m_showTimer.start();
+    
+    // Update window size based on content
+    QSize windowSize = calculateWindowSize();
+    resize(windowSize);
+    return windowSize;
+}
+
+void ClipboardWindow::presentWindow()
+{
     // Show window and ensure it gets focus
     m_ignoreNextFocusOut = true;
     show();
@@ -118,47 +170,166 @@ void ClipboardWindow::hideWindow()
     emit windowClosed();
 }
 
-void ClipboardWindow::setHistory(const QList<ClipboardItem>& items)
+void ClipboardWindow::prewarm()
 {
-    m_items = items;
+    if (m_prewarmed) {
+        return;
+    }
     
-    // Update subtitle with item count
-    QString subtitle = items.isEmpty() ? "No items" : 
-                      QString("%1 item%2").arg(items.size()).arg(items.size() != 1 ? "s" : "");
-    m_subtitleLabel->setText(subtitle);
+    // Resolve the stylesheet for every child and create the native window
+    ensurePolished();
+    winId();
+    m_layout->activate();
+    prewarmDpiGroups();
     
-    updateListWidget();
+    m_prewarmed = true;
 }
 
-void ClipboardWindow::updateItem(const ClipboardItem& item)
+void ClipboardWindow::prewarmDpiGroups()
 {
-    // Find and update the item in our list
-    for (int i = 0; i < m_items.size(); ++i) {
-        if (m_items[i].id() == item.id()) {
-            m_items[i] = item;
-            updateListWidget();
-            break;
+    // Stylesheet fonts and sizes are in pixels, so polish and layout hold on
+    // every screen; only the frame and rasterized glyphs depend on the ratio.
+    // One offscreen render per ratio loads fonts, glyphs and style pixmaps.
+    const QList<qreal> ratios = m_screens->devicePixelRatios();
+    for (qreal ratio : ratios) {
+        if (hasFrameFor(ratio)) {
+            continue;
         }
+        updateFrame(ratio);
+        QPixmap scratch(size() * ratio);
+        scratch.setDevicePixelRatio(ratio);
+        scratch.fill(Qt::transparent);
+        render(&scratch, QPoint(), QRegion(), QWidget::DrawChildren);
+    }
+}
+
+qint64 ClipboardWindow::memoryUsage() const
+{
+    qint64 bytes = qint64(m_model->items().capacity()) * qint64(sizeof(ClipboardItem));
+    bytes += m_searchIndex.memoryUsage();
+    for (const QPixmap& frame : m_frames) {
+        bytes += qint64(frame.width()) * frame.height() * frame.depth() / 8;
+    }
+    return bytes;
+}
+
+bool ClipboardWindow::hasFrameFor(qreal ratio) const
+{
+    const auto frame = m_frames.constFind(ratio);
+    return frame != m_frames.constEnd() && frame->deviceIndependentSize().toSize() == size();
+}
+
+void ClipboardWindow::moveToScreen(const ScreenTopology::Screen& screen)
+{
+    // Placing the hidden window on its screen first lets it be shown there
+    // directly instead of moving across screens after it is mapped
+    QWindow* handle = windowHandle();
+    if (handle && !screen.isNull() && handle->screen() != screen.screen) {
+        handle->setScreen(screen.screen);
+    }
+}
+
+void ClipboardWindow::setHistory(const QList<ClipboardItem>& items)
+{
+    m_historyVersion = 0;
+    applyHistory(items);
+}
+
+void ClipboardWindow::setHistory(const HistoryView& view)
+{
+    if (view.version() != 0 && view.version() == m_historyVersion) {
+        return;
+    }
+    
+    m_historyVersion = view.version();
+    applyHistory(view.items());
+}
+
+void ClipboardWindow::applyHistory(const QList<ClipboardItem>& items)
+{
+    LatencyTrace::mark(LatencyTrace::HistorySet);
+    m_searchIndex.setItems(items);
+    m_model->setItems(items);
+    if (m_model->isFiltered()) {
+        applySearch(false);
+    }
+    updateSubtitle();
+    updateListView();
+}
+
+void ClipboardWindow::updateItem(const ClipboardItem& item)
+{
+    int position = m_model->positionOf(item.id());
+    if (position >= 0) {
+        m_searchIndex.addItem(item);
+        m_model->replaceItem(position, item);
+        m_historyVersion = 0;
     }
 }
 
 void ClipboardWindow::removeItem(const QString& id)
 {
-    // Remove item from our list
-    for (int i = 0; i < m_items.size(); ++i) {
-        if (m_items[i].id() == id) {
-            m_items.removeAt(i);
-            updateListWidget();
-            break;
+    removeItemAt(m_model->positionOf(id));
+}
+
+void ClipboardWindow::insertItemAt(int index, const ClipboardItem& item)
+{
+    m_searchIndex.addItem(item);
+    m_model->insertItem(index, item);
+    m_historyVersion = 0;
+    if (m_model->isFiltered()) {
+        applySearch(false);
+    }
+    updateSubtitle();
+    
+    // The window only grows until the visible row limit is reached
+    if (m_model->rowCount() <= m_maxDisplayItems) {
+        updateListView();
+    }
+}
+
+void ClipboardWindow::removeItemAt(int index)
+{
+    if (index < 0 || index >= m_model->items().size()) {
+        return;
+    }
+    
+    m_searchIndex.removeItem(m_model->items().at(index).id());
+    m_model->removeItem(index);
+    m_historyVersion = 0;
+    // A removal may compact the index, which voids the applied result
+    if (m_model->isFiltered()) {
+        applySearch(false);
+    }
+    updateSubtitle();
+    if (m_model->rowCount() < m_maxDisplayItems) {
+        updateListView();
+    }
+}
+
+void ClipboardWindow::moveItem(int from, int to, const ClipboardItem& item)
+{
+    // Re-copied content comes back under a new ID
+    if (from >= 0 && from < m_model->items().size()) {
+        const QString& previousId = m_model->items().at(from).id();
+        if (previousId != item.id()) {
+            m_searchIndex.removeItem(previousId);
         }
     }
+    m_searchIndex.addItem(item);
+    
+    m_model->moveItem(from, to, item);
+    m_historyVersion = 0;
+    if (m_model->isFiltered()) {
+        applySearch(false);
+    }
 }
 
 void ClipboardWindow::setMaxDisplayItems(int maxItems)
 {
     if (maxItems > 0) {
         m_maxDisplayItems = maxItems;
-        updateListWidget();
+        updateListView();
     }
 }
 
@@ -166,7 +337,8 @@ void ClipboardWindow::setItemHeight(int height)
 {
     if (height > 0) {
         m_itemHeight = height;
-        updateListWidget();
+        m_delegate->setItemHeight(height);
+        updateListView();
     }
 }
 
@@ -177,62 +349,100 @@ bool ClipboardWindow::isVisible() const
 
 int ClipboardWindow::selectedIndex() const
 {
-    return m_listWidget->currentRow();
+    return m_listView->currentIndex().row();
 }
 
 ClipboardItem ClipboardWindow::selectedItem() const
 {
-    int index = selectedIndex();
-    if (index >= 0 && index < m_items.size()) {
-        return m_items[index];
-    }
-    return ClipboardItem(); // Invalid item
+    return m_model->itemAt(selectedIndex());
+}
+
+void ClipboardWindow::setSearchText(const QString& text)
+{
+    m_searchEdit->setText(text);
+}
+
+QString ClipboardWindow::searchText() const
+{
+    return m_searchEdit->text();
+}
+
+int ClipboardWindow::visibleItemCount() const
+{
+    return m_model->rowCount();
 }
 
 void ClipboardWindow::keyPressEvent(QKeyEvent* event)
 {
+    // Alt+digit pastes one of the first rows, Alt+letters jump by prefix;
+    // plain typing keeps filtering through the search box
+    if (event->modifiers() == Qt::AltModifier) {
+        const int key = event->key();
+        if (key >= Qt::Key_1 && key <= Qt::Key_9 &&
+            key - Qt::Key_1 < ClipboardItemDelegate::QUICK_SELECT_ROWS) {
+            activateRow(key - Qt::Key_1);
+            return;
+        }
+        if (key >= Qt::Key_A && key <= Qt::Key_Z) {
+            jumpToPrefix(QChar(key).toLower());
+            return;
+        }
+    }
+    
     switch (event->key()) {
         case Qt::Key_Escape:
-            hideWindow();
+            // First clear the search, then close
+            if (!m_searchEdit->text().isEmpty()) {
+                m_searchEdit->clear();
+            } else {
+                hideWindow();
+            }
             break;
             
         case Qt::Key_Return:
         case Qt::Key_Enter:
-            {
-                ClipboardItem item = selectedItem();
-                if (item.isValid()) {
-                    emit itemSelected(item);
-                    hideWindow();
-                }
-            }
+            activateRow(selectedIndex());
             break;
             
         case Qt::Key_Up:
-            {
-                int currentRow = m_listWidget->currentRow();
-                if (currentRow > 0) {
-                    m_listWidget->setCurrentRow(currentRow - 1);
-                } else if (m_listWidget->count() > 0) {
-                    // Wrap to bottom
-                    m_listWidget->setCurrentRow(m_listWidget->count() - 1);
-                }
-            }
+            moveSelection(-1, true);
             break;
             
         case Qt::Key_Down:
-            {
-                int currentRow = m_listWidget->currentRow();
-                if (currentRow < m_listWidget->count() - 1) {
-                    m_listWidget->setCurrentRow(currentRow + 1);
-                } else if (m_listWidget->count() > 0) {
-                    // Wrap to top
-                    m_listWidget->setCurrentRow(0);
-                }
+            moveSelection(1, true);
+            break;
+            
+        case Qt::Key_PageUp:
+            moveSelection(-visibleRowCount(), false);
+            break;
+            
+        case Qt::Key_PageDown:
+            moveSelection(visibleRowCount(), false);
+            break;
+            
+        case Qt::Key_Home:
+            if (m_model->rowCount() > 0) {
+                setCurrentRow(0);
+            }
+            break;
+            
+        case Qt::Key_End:
+            if (m_model->rowCount() > 0) {
+                setCurrentRow(m_model->rowCount() - 1);
             }
             break;
             
         default:
-            QWidget::keyPressEvent(event);
+            // Typing anywhere in the window goes to the search box
+            if (!m_forwardingKey && !m_searchEdit->hasFocus() &&
+                (event->key() == Qt::Key_Backspace ||
+                 (!event->text().isEmpty() && event->text().at(0).isPrint()))) {
+                m_forwardingKey = true;
+                QApplication::sendEvent(m_searchEdit, event);
+                m_forwardingKey = false;
+            } else {
+                QWidget::keyPressEvent(event);
+            }
             break;
     }
 }
@@ -263,39 +473,77 @@ void ClipboardWindow::closeEvent(QCloseEvent* event)
 
 void ClipboardWindow::showEvent(QShowEvent* event)
 {
+    LatencyTrace::mark(LatencyTrace::WindowShown);
+    if (!m_showTimer.isValid()) {
+        m_showTimer.start();
+    }
     QWidget::showEvent(event);
     
+    // Every popup starts with an unfiltered list
+    m_searchEdit->clear();
+    
     // Select first item if any items exist
-    if (m_listWidget->count() > 0) {
-        m_listWidget->setCurrentRow(0);
+    if (m_model->rowCount() > 0) {
+        setCurrentRow(0);
     }
 }
 
-void ClipboardWindow::onItemActivated(QListWidgetItem* item)
+void ClipboardWindow::paintEvent(QPaintEvent* event)
 {
-    if (item) {
-        ClipboardItem clipboardItem = getClipboardItem(item);
-        if (clipboardItem.isValid()) {
-            emit itemSelected(clipboardItem);
-            hideWindow();
-        }
+    // Only the first paint after a show is recorded
+    LatencyTrace::mark(LatencyTrace::FirstPaint);
+    if (m_showTimer.isValid()) {
+        Metrics::record(Metrics::PopupShowLatency, m_showTimer.nsecsElapsed());
+        m_showTimer.invalidate();
+    }
+    
+    // The whole window background is one blit of a pixmap cached per ratio
+    const qreal ratio = devicePixelRatioF();
+    if (!hasFrameFor(ratio)) {
+        updateFrame(ratio);
     }
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_frames.value(ratio));
+    
+    QWidget::paintEvent(event);
 }
 
-void ClipboardWindow::onSelectionChanged(QListWidgetItem* current, QListWidgetItem* previous)
+void ClipboardWindow::onItemActivated(const QModelIndex& index)
+{
+    // Cold items come without their text; the receiver loads it
+    ClipboardItem clipboardItem = m_model->itemAt(index.row());
+    if (!clipboardItem.id().isEmpty()) {
+        emit itemSelected(clipboardItem);
+        hideWindow();
+    }
+}
+
+void ClipboardWindow::onSelectionChanged(const QModelIndex& current, const QModelIndex& previous)
 {
     Q_UNUSED(current)
     Q_UNUSED(previous)
     // Currently no special handling needed for selection changes
 }
 
+void ClipboardWindow::onSearchTextChanged(const QString& text)
+{
+    // Typing one more character can only narrow the previous result
+    bool refine = m_model->isFiltered() && !m_searchMatches.query().isEmpty() &&
+                  text.startsWith(m_searchMatches.query());
+    applySearch(refine);
+}
+
 void ClipboardWindow::setupWindow()
 {
     // Make window frameless and always on top
     setWindowFlags(Qt::Popup | Qt::FramelessWindowHint);
     setAttribute(Qt::WA_DeleteOnClose, false);
     setAttribute(Qt::WA_ShowWithoutActivating, false);
-    setAttribute(Qt::WA_TranslucentBackground, true);
+    
+    // Without a compositor a translucent window is blended in software on
+    // every repaint; the low-power window is opaque and paints every pixel
+    setAttribute(Qt::WA_TranslucentBackground, m_renderMode == Glass);
+    setAttribute(Qt::WA_OpaquePaintEvent, m_renderMode == LowPower);
     
     // Set window properties
     setFocusPolicy(Qt::StrongFocus);
@@ -304,34 +552,32 @@ void ClipboardWindow::setupWindow()
     // Set fixed size for consistent appearance
     setFixedSize(400, 500);
     
-    // Add drop shadow effect
-    QGraphicsDropShadowEffect* shadowEffect = new QGraphicsDropShadowEffect(this);
-    shadowEffect->setBlurRadius(20);
-    shadowEffect->setColor(QColor(0, 0, 0, 100));
-    shadowEffect->setOffset(0, 5);
-    setGraphicsEffect(shadowEffect);
+    // The drop shadow is painted from a cached pixmap (see updateFrame());
+    // a QGraphicsDropShadowEffect would render the whole window offscreen
+    // on every repaint
 }
 
-void ClipboardWindow::setupListWidget()
+void ClipboardWindow::setupListView()
 {
-    // Configure scroll area
-    m_scrollArea->setWidget(m_listWidget);
-    m_scrollArea->setWidgetResizable(true);
-    m_scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_scrollArea->setFrameStyle(QFrame::NoFrame);
-    
-    // Configure list widget
-    m_listWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_listWidget->setAlternatingRowColors(false);
-    m_listWidget->setWordWrap(true);
-    m_listWidget->setTextElideMode(Qt::ElideRight);
-    m_listWidget->setFrameStyle(QFrame::NoFrame);
+    // Uniform rows let the view lay out and paint only what is on screen
+    m_listView->setModel(m_model);
+    m_listView->setItemDelegate(m_delegate);
+    m_listView->setUniformItemSizes(true);
+    m_listView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_listView->setAlternatingRowColors(false);
+    m_listView->setTextElideMode(Qt::ElideRight);
+    m_listView->setFrameStyle(QFrame::NoFrame);
+    m_listView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    m_listView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_listView->setMouseTracking(true);
+    
+    // Keys stay with the window so typing always reaches the search box
+    m_listView->setFocusPolicy(Qt::NoFocus);
     
     // Connect signals
-    connect(m_listWidget, &QListWidget::itemActivated,
+    connect(m_listView, &QListView::activated,
             this, &ClipboardWindow::onItemActivated);
-    connect(m_listWidget, &QListWidget::currentItemChanged,
+    connect(m_listView->selectionModel(), &QItemSelectionModel::currentChanged,
             this, &ClipboardWindow::onSelectionChanged);
 }
 
@@ -368,15 +614,43 @@ void ClipboardWindow::setupHeader()
     m_headerLayout->addWidget(m_closeButton);
 }
 
+void ClipboardWindow::setupSearch()
+{
+    m_searchEdit->setObjectName("searchEdit");
+    m_searchEdit->setPlaceholderText("Type to search...");
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchEdit->setFocusPolicy(Qt::ClickFocus);
+    
+    connect(m_searchEdit, &QLineEdit::textChanged,
+            this, &ClipboardWindow::onSearchTextChanged);
+}
+
+void ClipboardWindow::applySearch(bool refine)
+{
+    const QString text = m_searchEdit->text();
+    if (text.isEmpty()) {
+        m_searchMatches = SearchIndex::Matches();
+        m_model->clearFilter();
+    } else {
+        QElapsedTimer timer;
+        timer.start();
+        m_searchMatches = refine ? m_searchIndex.refine(m_searchMatches, text)
+                                 : m_searchIndex.search(text);
+        m_model->setFilter(m_searchMatches, m_coldSearch ? m_coldSearch(text, MAX_COLD_MATCHES)
+                                                         : QList<ClipboardItem>());
+        Metrics::record(Metrics::SearchLatency, timer.nsecsElapsed());
+    }
+    
+    updateSubtitle();
+    if (m_model->rowCount() > 0) {
+        setCurrentRow(0);
+    }
+}
+
 void ClipboardWindow::applyGlassDesign()
 {
+    // The window background and border are part of the frame pixmap
     setStyleSheet(R"(
-        ClipboardWindow {
-            background: rgba(255, 255, 255, 0.85);
-            border: 1px solid rgba(255, 255, 255, 0.3);
-            border-radius: 12px;
-        }
-        
         QFrame#headerFrame {
             background: rgba(255, 255, 255, 0.9);
             border: none;
@@ -417,14 +691,17 @@ void ClipboardWindow::applyGlassDesign()
             background: rgba(231, 76, 60, 0.2);
         }
         
-        QScrollArea {
-            background: transparent;
+        QLineEdit#searchEdit {
+            background: rgba(255, 255, 255, 0.9);
             border: none;
-            border-radius: 0px 0px 12px 12px;
+            border-bottom: 1px solid rgba(0, 0, 0, 0.1);
+            padding: 6px 15px;
+            color: #2c3e50;
+            font-size: 13px;
         }
         
-        QListWidget {
-            background: rgba(255, 255, 255, 0.6);
+        QListView {
+            background: #f8f9fa;
             border: none;
             border-radius: 0px 0px 12px 12px;
             outline: none;
@@ -436,24 +713,6 @@ void ClipboardWindow::applyGlassDesign()
             padding: 5px;
         }
         
-        QListWidget::item {
-            background: rgba(255, 255, 255, 0.4);
-            border: none;
-            border-radius: 6px;
-            padding: 8px 12px;
-            margin: 2px;
-            color: #2c3e50;
-        }
-        
-        QListWidget::item:selected {
-            background: rgba(52, 152, 219, 0.8);
-            color: white;
-        }
-        
-        QListWidget::item:hover {
-            background: rgba(52, 152, 219, 0.3);
-        }
-        
         QScrollBar:vertical {
             background: rgba(255, 255, 255, 0.3);
             width: 12px;
@@ -481,45 +740,210 @@ void ClipboardWindow::applyGlassDesign()
     )");
 }
 
-void ClipboardWindow::updateListWidget()
+void ClipboardWindow::applyLowPowerDesign()
 {
-    m_listWidget->clear();
-    
-    // Limit items to maximum display count
-    int itemCount = qMin(m_items.size(), m_maxDisplayItems);
-    
-    for (int i = 0; i < itemCount; ++i) {
-        const ClipboardItem& item = m_items[i];
+    // Solid colors and square corners: nothing needs blending or antialiasing
+    setStyleSheet(R"(
+        QFrame#headerFrame {
+            background: #ffffff;
+            border: none;
+            border-bottom: 1px solid #d5d8dc;
+        }
+        
+        QLabel#titleLabel {
+            color: #2c3e50;
+            font-size: 16px;
+            font-weight: bold;
+            background: transparent;
+            border: none;
+        }
+        
+        QLabel#subtitleLabel {
+            color: #7f8c8d;
+            font-size: 12px;
+            background: transparent;
+            border: none;
+        }
         
-        QListWidgetItem* listItem = new QListWidgetItem();
-        listItem->setText(formatItemText(item));
-        listItem->setData(Qt::UserRole, item.id());
-        listItem->setSizeHint(QSize(0, m_itemHeight));
+        QPushButton#closeButton {
+            background: #ffffff;
+            border: 1px solid #d5d8dc;
+            color: #e74c3c;
+            font-size: 14px;
+            font-weight: bold;
+        }
+        
+        QPushButton#closeButton:pressed {
+            background: #fadbd8;
+        }
         
-        // Style pinned items differently
-        if (item.pinned()) {
-            QFont font = listItem->font();
-            font.setBold(true);
-            listItem->setFont(font);
-            listItem->setIcon(QIcon("📌")); // Pin emoji as icon
+        QLineEdit#searchEdit {
+            background: #ffffff;
+            border: none;
+            border-bottom: 1px solid #d5d8dc;
+            padding: 6px 15px;
+            color: #2c3e50;
+            font-size: 13px;
         }
         
-        m_listWidget->addItem(listItem);
+        QListView {
+            background: #f8f9fa;
+            border: none;
+            outline: none;
+            color: #2c3e50;
+            font-size: 13px;
+            padding: 5px;
+        }
+    )");
+}
+
+void ClipboardWindow::setupOpaqueViewport()
+{
+    // An opaque viewport is scrolled by moving its pixels and painting only
+    // the uncovered rows; a translucent one repaints the window beneath it.
+    // Both style sheets give the list a solid background, which the
+    // viewport fills itself with
+    QWidget* viewport = m_listView->viewport();
+    viewport->setBackgroundRole(QPalette::Base);
+    viewport->setAutoFillBackground(true);
+}
+
+void ClipboardWindow::updateFrame(qreal ratio)
+{
+    QPixmap& frame = m_frames[ratio];
+    frame = QPixmap(size() * ratio);
+    frame.setDevicePixelRatio(ratio);
+    
+    // A pixmap cannot be filled while a painter is active on it
+    frame.fill(m_renderMode == LowPower ? Qt::white : Qt::transparent);
+    QPainter painter(&frame);
+    if (m_renderMode == LowPower) {
+        painter.setPen(QColor(0xd5, 0xd8, 0xdc));
+        painter.drawRect(rect().adjusted(0, 0, -1, -1));
+        return;
+    }
+    
+    // Stacked translucent rounded rects fade out from the content edge,
+    // approximating a blurred shadow without an image filter
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, SHADOW_ALPHA / SHADOW_MARGIN));
+    const QRectF content = QRectF(rect()).adjusted(SHADOW_MARGIN, SHADOW_MARGIN,
+                                                   -SHADOW_MARGIN, -SHADOW_MARGIN);
+    const QRectF shadow = content.translated(0, SHADOW_OFFSET);
+    for (int spread = SHADOW_MARGIN; spread > 0; --spread) {
+        const qreal radius = CORNER_RADIUS + spread;
+        painter.drawRoundedRect(shadow.adjusted(-spread, -spread, spread, spread), radius, radius);
     }
     
-    // Update window size
+    // The translucent content must not be darkened from below
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.drawRoundedRect(content, CORNER_RADIUS, CORNER_RADIUS);
+    
+    // Glass background and its light border
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setBrush(QColor(255, 255, 255, 217));
+    painter.setPen(QPen(QColor(255, 255, 255, 77), 1));
+    painter.drawRoundedRect(content.adjusted(0.5, 0.5, -0.5, -0.5), CORNER_RADIUS, CORNER_RADIUS);
+}
+
+void ClipboardWindow::updateListView()
+{
+    // Rows are painted by the view on demand; only the window size follows the content
     QSize newSize = calculateWindowSize();
     resize(newSize);
 }
 
+void ClipboardWindow::setCurrentRow(int row)
+{
+    m_listView->setCurrentIndex(m_model->index(row));
+}
+
+void ClipboardWindow::moveSelection(int delta, bool wrap)
+{
+    const int rows = m_model->rowCount();
+    if (rows == 0) {
+        return;
+    }
+    
+    // Without a current row, moving down starts at the top and up at the bottom
+    const int current = selectedIndex();
+    int row = current < 0 ? (delta > 0 ? delta - 1 : rows + delta) : current + delta;
+    if (wrap) {
+        row = ((row % rows) + rows) % rows;
+    } else {
+        row = qBound(0, row, rows - 1);
+    }
+    setCurrentRow(row);
+}
+
+int ClipboardWindow::visibleRowCount() const
+{
+    return qMax(1, m_listView->viewport()->height() / qMax(1, m_itemHeight));
+}
+
+bool ClipboardWindow::activateRow(int row)
+{
+    if (row < 0 || row >= m_model->rowCount()) {
+        return false;
+    }
+    
+    ClipboardItem item = m_model->itemAt(row);
+    if (item.id().isEmpty()) {
+        return false;
+    }
+    emit itemSelected(item);
+    hideWindow();
+    return true;
+}
+
+void ClipboardWindow::jumpToPrefix(QChar letter)
+{
+    // A pause starts a new prefix
+    const bool extending = !m_jumpText.isEmpty() && m_jumpTimer.isValid() &&
+                           m_jumpTimer.elapsed() < QApplication::keyboardInputInterval();
+    m_jumpTimer.start();
+    m_jumpText = extending ? m_jumpText + letter : QString(letter);
+    m_jumpMatches = extending ? m_searchIndex.refine(m_jumpMatches, m_jumpText)
+                              : m_searchIndex.search(m_jumpText, SearchIndex::Prefix);
+    
+    const int rows = m_model->rowCount();
+    if (m_jumpMatches.isEmpty() || rows == 0) {
+        return;
+    }
+    
+    // A longer prefix may still match the current row; a new one moves on
+    const int current = qMax(0, selectedIndex());
+    const int start = extending ? current : current + 1;
+    for (int offset = 0; offset < rows; ++offset) {
+        const int row = (start + offset) % rows;
+        if (m_jumpMatches.contains(m_model->itemAt(row).id())) {
+            setCurrentRow(row);
+            return;
+        }
+    }
+}
+
+void ClipboardWindow::updateSubtitle()
+{
+    // Update subtitle with item count
+    int count = m_model->items().size();
+    QString subtitle = count == 0 ? "No items" : 
+                      QString("%1 item%2").arg(count).arg(count != 1 ? "s" : "");
+    if (m_model->isFiltered()) {
+        subtitle = QString("%1 of %2").arg(m_model->rowCount()).arg(subtitle);
+    }
+    m_subtitleLabel->setText(subtitle);
+}
+
 QPoint ClipboardWindow::adjustPositionForScreen(const QPoint& preferredPosition)
 {
-    QScreen* screen = QApplication::screenAt(preferredPosition);
-    if (!screen) {
-        screen = QApplication::primaryScreen();
+    const ScreenTopology::Screen screen = m_screens->screenAt(preferredPosition);
+    if (screen.isNull()) {
+        return preferredPosition;
     }
     
-    QRect screenGeometry = screen->availableGeometry();
+    QRect screenGeometry = screen.availableGeometry;
     QSize windowSize = size();
     
     QPoint adjustedPos = preferredPosition;
@@ -545,7 +969,7 @@ QPoint ClipboardWindow::adjustPositionForScreen(const QPoint& preferredPosition)
 
 QSize ClipboardWindow::calculateWindowSize() const
 {
-    int itemCount = qMin(m_items.size(), m_maxDisplayItems);
+    int itemCount = qMin(m_model->rowCount(), m_maxDisplayItems);
     if (itemCount == 0) {
         return QSize(300, 50); // Minimum size for empty list
     }
@@ -567,49 +991,5 @@ QSize ClipboardWindow::calculateWindowSize() const
 
 QString ClipboardWindow::formatItemText(const ClipboardItem& item) const
 {
-    QString text = item.text();
-    
-    // Limit length and clean up whitespace
-    const int maxLength = 100;
-    if (text.length() > maxLength) {
-        text = text.left(maxLength - 3) + "...";
-    }
-    
-    // Replace newlines with spaces and compress whitespace
-    text = text.replace('\n', ' ').replace('\r', ' ');
-    text = text.simplified();
-    
-    // Add pin indicator prefix if pinned
-    if (item.pinned()) {
-        text = "📌 " + text;
-    }
-    
-    return text;
-}
-
-QListWidgetItem* ClipboardWindow::findListWidgetItem(const QString& id) const
-{
-    for (int i = 0; i < m_listWidget->count(); ++i) {
-        QListWidgetItem* item = m_listWidget->item(i);
-        if (item && item->data(Qt::UserRole).toString() == id) {
-            return item;
-        }
-    }
-    return nullptr;
-}
-
-ClipboardItem ClipboardWindow::getClipboardItem(QListWidgetItem* listItem) const
-{
-    if (!listItem) {
-        return ClipboardItem(); // Invalid item
-    }
-    
-    QString id = listItem->data(Qt::UserRole).toString();
-    for (const ClipboardItem& item : m_items) {
-        if (item.id() == id) {
-            return item;
-        }
-    }
-    
-    return ClipboardItem(); // Invalid item
+    return ClipboardListModel::formatItemText(item);
 }
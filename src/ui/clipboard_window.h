@@ -1,13 +1,12 @@
 #pragma once
 
 #include <QWidget>
-#include <QListWidget>
-#include <QListWidgetItem>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
 #include <QPushButton>
-#include <QScrollArea>
 #include <QFrame>
 #include <QTimer>
 #include <QKeyEvent>
@@ -18,9 +17,17 @@
 #include <QCursor>
 #include <QApplication>
 #include <QList>
-#include <QGraphicsDropShadowEffect>
+#include <QPixmap>
+#include <QElapsedTimer>
+#include <QHash>
+#include <functional>
 
 #include "../models/clipboard_item.h"
+#include "../models/history_view.h"
+#include "../models/search_index.h"
+#include "clipboard_item_delegate.h"
+#include "clipboard_list_model.h"
+#include "screen_topology.h"
 
 /**
  * ClipboardWindow - Frameless popup window for clipboard history display
@@ -31,22 +38,61 @@
  * 
  * Design principles:
  * - Frameless window that appears at cursor or specified position
- * - Keyboard navigation with arrow keys, Enter, and Escape
+ * - Keyboard navigation with arrow keys, Page Up/Down, Home/End, Enter, and Escape
+ * - Alt+1..9 pastes one of the first nine rows, Alt+letters jump to the next
+ *   row starting with the typed text
+ * - Typing filters the list through an incremental search index; items
+ *   beyond the displayed history are found through setColdSearch()
  * - Mouse interaction with single/double click selection
  * - Auto-hide on focus loss or explicit close
  * - Performance target: <200ms display time
+ *
+ * The window is meant to be created once and reused: prewarm() polishes,
+ * lays out and renders it ahead of the first show, the list follows the
+ * history through deltas while hidden, and the drop shadow is a pixmap
+ * rendered once per size rather than a graphics effect, so showing and
+ * hiding only change position and visibility.
+ *
+ * Placement reads a cached ScreenTopology instead of querying the screens
+ * on every show. The frame pixmap is kept per device pixel ratio and
+ * prewarm() renders the window once for every DPI group, so a popup that
+ * opens on another monitor finds everything already rendered for it.
+ *
+ * Rendering modes:
+ * - Glass: translucent rounded window for compositing desktops. Shadow,
+ *   background and border are one cached pixmap drawn by paintEvent(),
+ *   and the list viewport is opaque so scrolling blits the rows
+ * - LowPower: opaque rectangular window without shadow or translucency,
+ *   for sessions without a compositor and forwarded or remote displays
  */
 class ClipboardWindow : public QWidget
 {
     Q_OBJECT
 
 public:
+    /**
+     * How the window is drawn
+     */
+    enum RenderMode {
+        Glass,                       ///< Translucent, rounded, with a drop shadow
+        LowPower                     ///< Opaque and flat
+    };
+
     /**
      * Constructor - Creates frameless popup window
      * @param parent QWidget parent for memory management
+     *
+     * The render mode is chosen by detectRenderMode().
      */
     explicit ClipboardWindow(QWidget* parent = nullptr);
     
+    /**
+     * Constructor - Creates frameless popup window with a render mode
+     * @param mode How the window is drawn; fixed for the window's lifetime
+     * @param parent QWidget parent for memory management
+     */
+    explicit ClipboardWindow(RenderMode mode, QWidget* parent = nullptr);
+    
     /**
      * Destructor - Ensures proper cleanup
      */
@@ -75,14 +121,80 @@ public:
      * Can be called explicitly or triggered by events
      */
     void hideWindow();
+    
+    /**
+     * Prepare the window for a fast first show
+     * Polishes the stylesheet, creates the native window, lays out the
+     * widgets and renders everything offscreen once per DPI group without
+     * showing it
+     */
+    void prewarm();
+    
+    /**
+     * Check if the window has been prepared by prewarm()
+     * @return true once prewarmed
+     */
+    bool isPrewarmed() const { return m_prewarmed; }
+    
+    /**
+     * Get how the window is drawn
+     * @return Render mode given at construction
+     */
+    RenderMode renderMode() const { return m_renderMode; }
+    
+    /**
+     * Get the cached screens the window is placed on
+     */
+    ScreenTopology* screenTopology() const { return m_screens; }
+    
+    /**
+     * Estimate the memory held by the window
+     * @return Bytes of the displayed item list, the search index and the
+     *         frame pixmaps; items are shared with the history
+     */
+    qint64 memoryUsage() const;
+    
+    /**
+     * Pick the render mode the display can afford
+     * @return Glass on a local compositing display, LowPower otherwise
+     */
+    static RenderMode detectRenderMode();
+    
+    /**
+     * Parse a render mode name
+     * @param name "auto", "glass" or "low-power"
+     * @param ok Set to whether the name is known
+     * @return Named mode; "auto" gives detectRenderMode()
+     */
+    static RenderMode renderModeFromName(const QString& name, bool* ok = nullptr);
 
     // Content Management Methods
+    /**
+     * Finds history items the window does not hold, e.g. the cold tier
+     * Called with the search text and a result limit; returns matching
+     * items newest first.
+     */
+    using ColdSearch = std::function<QList<ClipboardItem>(const QString& query, int limit)>;
+    
+    /**
+     * Also search the items beyond the displayed history
+     * @param search Called for every non-empty search; its results are
+     *               listed after the matching displayed items
+     */
+    void setColdSearch(const ColdSearch& search) { m_coldSearch = search; }
+    
     /**
      * Set clipboard history items to display
      * @param items List of clipboard items (pinned items will appear first)
      */
     void setHistory(const QList<ClipboardItem>& items);
     
+    /**
+     * Set clipboard history from a history view
+     * @param view Snapshot of the history; ignored if already displayed
+     */
+    void setHistory(const HistoryView& view);
+    
     /**
      * Update a specific item in the display
      * @param item Updated clipboard item
@@ -94,11 +206,34 @@ public:
      * @param id UUID of item to remove
      */
     void removeItem(const QString& id);
+    
+    /**
+     * Insert an item at a display position
+     * @param index Position in the history (pinned items first)
+     * @param item Item to insert
+     *
+     * Only the affected row is updated; the list is not rebuilt.
+     */
+    void insertItemAt(int index, const ClipboardItem& item);
+    
+    /**
+     * Remove the item at a display position
+     * @param index Position in the history
+     */
+    void removeItemAt(int index);
+    
+    /**
+     * Move an item between display positions
+     * @param from Position the item had
+     * @param to Position after reinserting it
+     * @param item The item in its new state
+     */
+    void moveItem(int from, int to, const ClipboardItem& item);
 
     // Configuration Methods
     /**
-     * Set maximum number of items to display
-     * @param maxItems Maximum items to show (default 10)
+     * Set number of rows shown without scrolling
+     * @param maxItems Visible rows (default 10); further items scroll
      */
     void setMaxDisplayItems(int maxItems);
     
@@ -139,6 +274,25 @@ public:
      */
     ClipboardItem selectedItem() const;
 
+    // Search Methods
+    /**
+     * Filter the list to items containing text (case-insensitive)
+     * @param text Search text; empty shows all items
+     */
+    void setSearchText(const QString& text);
+    
+    /**
+     * Get current search text
+     * @return Text in the search box
+     */
+    QString searchText() const;
+    
+    /**
+     * Get number of items shown by the current search
+     * @return Visible row count
+     */
+    int visibleItemCount() const;
+
 signals:
     /**
      * Emitted when user selects an item (Enter key, click, etc.)
@@ -182,20 +336,32 @@ protected:
      * @param event Show event
      */
     void showEvent(QShowEvent* event) override;
+    
+    /**
+     * Handle paint events to trace the first paint after showing
+     * @param event Paint event
+     */
+    void paintEvent(QPaintEvent* event) override;
 
 private slots:
     /**
-     * Handle item activation from list widget
-     * @param item Activated list widget item
+     * Handle item activation from the list view
+     * @param index Activated row
      */
-    void onItemActivated(QListWidgetItem* item);
+    void onItemActivated(const QModelIndex& index);
     
     /**
      * Handle item selection change
-     * @param current Currently selected item
-     * @param previous Previously selected item
+     * @param current Currently selected row
+     * @param previous Previously selected row
      */
-    void onSelectionChanged(QListWidgetItem* current, QListWidgetItem* previous);
+    void onSelectionChanged(const QModelIndex& current, const QModelIndex& previous);
+    
+    /**
+     * Filter the list as the search text changes
+     * @param text New search text
+     */
+    void onSearchTextChanged(const QString& text);
 
 private:
     // UI Components
@@ -205,18 +371,34 @@ private:
     QLabel* m_titleLabel;            ///< Window title label
     QLabel* m_subtitleLabel;         ///< Window subtitle label  
     QPushButton* m_closeButton;      ///< Close button
-    QScrollArea* m_scrollArea;       ///< Scroll area for list
-    QListWidget* m_listWidget;       ///< List widget for displaying items
+    QLineEdit* m_searchEdit;         ///< Search box filtering the list
+    QListView* m_listView;           ///< Virtualized list of history rows
     
     // Data
-    QList<ClipboardItem> m_items;    ///< Current clipboard items
+    ClipboardListModel* m_model;     ///< Displayed clipboard items
+    ClipboardItemDelegate* m_delegate; ///< Paints the visible rows
+    SearchIndex m_searchIndex;       ///< Index over the displayed items
+    SearchIndex::Matches m_searchMatches; ///< Result of the current search
+    ColdSearch m_coldSearch;         ///< Finds matching items outside the model
+    quint64 m_historyVersion;        ///< Version of the displayed view (0 if edited since)
     
     // Configuration
-    int m_maxDisplayItems;           ///< Maximum items to display
+    int m_maxDisplayItems;           ///< Rows visible without scrolling
     int m_itemHeight;                ///< Height of each item row
     
+    // Rendering
+    RenderMode m_renderMode;         ///< How the window is drawn
+    QHash<qreal, QPixmap> m_frames;  ///< Shadow, background and border per device pixel ratio
+    ScreenTopology* m_screens;       ///< Cached screens used for placement
+    
     // State
+    bool m_prewarmed;                ///< Polished and rendered ahead of the first show
     bool m_ignoreNextFocusOut;       ///< Flag to ignore focus out during positioning
+    bool m_forwardingKey;            ///< Key event is being passed to the search box
+    QElapsedTimer m_showTimer;       ///< Started by a show request, stopped by its first paint
+    QString m_jumpText;              ///< Letters typed with Alt for type-to-jump
+    QElapsedTimer m_jumpTimer;       ///< Time since the last type-to-jump letter
+    SearchIndex::Matches m_jumpMatches; ///< Items starting with m_jumpText
     
     // Helper Methods
     /**
@@ -225,24 +407,118 @@ private:
     void setupWindow();
     
     /**
-     * Setup the list widget properties and connections
+     * Replace the displayed items and refresh the list
      */
-    void setupListWidget();
+    void applyHistory(const QList<ClipboardItem>& items);
+    
+    /**
+     * Setup the list view, model and delegate
+     */
+    void setupListView();
     
     /**
      * Setup the header section with title and close button
      */
     void setupHeader();
     
+    /**
+     * Setup the search box below the header
+     */
+    void setupSearch();
+    
+    /**
+     * Apply the search text to the list
+     * @param refine true if the text extends the previous search
+     */
+    void applySearch(bool refine);
+    
     /**
      * Apply modern glass design styling to the window
      */
     void applyGlassDesign();
     
     /**
-     * Update the list widget with current items
+     * Apply opaque styling without translucency or rounded corners
+     */
+    void applyLowPowerDesign();
+    
+    /**
+     * Make the list viewport opaque so scrolling moves pixels instead of
+     * repainting the translucent window beneath it
+     */
+    void setupOpaqueViewport();
+    
+    /**
+     * Render the drop shadow, background and border for the current window size
+     * @param ratio Device pixel ratio to render for
+     */
+    void updateFrame(qreal ratio);
+    
+    /**
+     * Check if the frame for a device pixel ratio matches the current size
+     */
+    bool hasFrameFor(qreal ratio) const;
+    
+    /**
+     * Render the window offscreen for each device pixel ratio without a frame yet
+     */
+    void prewarmDpiGroups();
+    
+    /**
+     * Assign the native window to a screen before it is shown there
+     * @param screen Target screen; ignored if null
+     */
+    void moveToScreen(const ScreenTopology::Screen& screen);
+    
+    static constexpr int MAX_COLD_MATCHES = 200; ///< Older items listed per search
+    static constexpr int SHADOW_MARGIN = 10;  ///< Space around the content for the shadow
+    static constexpr int SHADOW_OFFSET = 4;   ///< Downward offset of the shadow
+    static constexpr int SHADOW_ALPHA = 100;  ///< Shadow opacity next to the content
+    static constexpr int CORNER_RADIUS = 12;  ///< Corner radius of the glass window
+    
+    /**
+     * Resize the window to fit the visible rows
+     */
+    void updateListView();
+    
+    /**
+     * Make a row current and selected
+     */
+    void setCurrentRow(int row);
+    
+    /**
+     * Move the current row
+     * @param delta Rows to move, negative to move up
+     * @param wrap Whether moving past either end continues at the other one
+     */
+    void moveSelection(int delta, bool wrap);
+    
+    /**
+     * Rows that fit in the visible part of the list
+     */
+    int visibleRowCount() const;
+    
+    /**
+     * Paste a row and close, as Enter does for the current row
+     * @param row Model row
+     * @return true if the row exists
      */
-    void updateListWidget();
+    bool activateRow(int row);
+    
+    /**
+     * Extend the type-to-jump text and move to the next row starting with it
+     * @param letter Letter typed with Alt
+     *
+     * Letters typed within the keyboard input interval add up to a prefix;
+     * a pause starts a new one. Each letter narrows the previous prefix
+     * matches, so a keystroke never rescans the whole history text.
+     */
+    void jumpToPrefix(QChar letter);
+    
+    /**
+     * Show the current item count in the subtitle
+     */
+    void updateSubtitle();
     
     /**
      * Position window to stay within screen bounds
@@ -258,23 +534,21 @@ private:
     QSize calculateWindowSize() const;
     
     /**
-     * Format item text for display
-     * @param item Clipboard item to format
-     * @return Formatted display text
+     * Start showing the window: trace the request and size it to its content
+     * Shared by every showAt*() method
+     * @return Size the window was given
      */
-    QString formatItemText(const ClipboardItem& item) const;
+    QSize prepareShow();
     
     /**
-     * Find list widget item by clipboard item ID
-     * @param id Clipboard item UUID
-     * @return List widget item or nullptr if not found
+     * Show, raise and focus the window once it has been placed
      */
-    QListWidgetItem* findListWidgetItem(const QString& id) const;
+    void presentWindow();
     
     /**
-     * Get clipboard item from list widget item
-     * @param listItem List widget item
-     * @return Associated clipboard item
+     * Format item text for display
+     * @param item Clipboard item to format
+     * @return Formatted display text
      */
-    ClipboardItem getClipboardItem(QListWidgetItem* listItem) const;
+    QString formatItemText(const ClipboardItem& item) const;
 };
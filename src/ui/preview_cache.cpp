@@ -0,0 +1,53 @@
+#include "preview_cache.h"
+
+PreviewCache::PreviewCache(int capacity)
+    : m_texts(qMax(1, capacity))
+{
+}
+
+PreviewCache& PreviewCache::shared()
+{
+    static PreviewCache cache;
+    return cache;
+}
+
+QString PreviewCache::displayText(const ClipboardItem& item, int maxLength)
+{
+    const QPair<QString, int> key(item.id(), maxLength);
+    QString line;
+    if (const QString* cached = m_texts.object(key)) {
+        line = *cached;
+    } else {
+        line = formatLine(item, maxLength);
+        m_texts.insert(key, new QString(line));
+    }
+
+    if (item.pinned()) {
+        return QStringLiteral("📌 ") + line;
+    }
+    return line;
+}
+
+qint64 PreviewCache::memoryUsage() const
+{
+    // Key, text and the cache's own node per entry
+    constexpr qint64 ENTRY_BYTES = sizeof(QPair<QString, int>) + sizeof(QString) + 4 * sizeof(void*);
+    qint64 bytes = qint64(m_texts.count()) * ENTRY_BYTES;
+    const QList<QPair<QString, int>> keys = m_texts.keys();
+    for (const QPair<QString, int>& key : keys) {
+        if (const QString* text = m_texts.object(key)) {
+            bytes += qint64(text->capacity()) * qint64(sizeof(QChar));
+        }
+    }
+    return bytes;
+}
+
+QString PreviewCache::formatLine(const ClipboardItem& item, int maxLength)
+{
+    // Payload and cold items only have a stand-in or no text; their stored
+    // preview describes them better
+    if (item.hasPayload() || !item.hasText()) {
+        return ClipboardItem::generatePreview(item.preview(), maxLength);
+    }
+    return ClipboardItem::generatePreview(item.text(), maxLength);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QCache>
+#include <QPair>
+#include <QString>
+#include "../models/clipboard_item.h"
+
+/**
+ * PreviewCache - Least-recently-used cache of single-line item texts
+ *
+ * Lists and menus repaint the same few items over and over; each display
+ * text is formatted once per item and length and then served from the
+ * cache. Item IDs change whenever the content does, so entries never go
+ * stale and are only dropped when the cache is full. The pin indicator
+ * is added outside the cache, so pinning does not invalidate anything.
+ *
+ * One cache is shared by the history window and the tray menu; it is not
+ * thread-safe and must only be used from the GUI thread.
+ */
+class PreviewCache
+{
+public:
+    /**
+     * Constructor - Creates an empty cache
+     * @param capacity Maximum number of cached texts
+     */
+    explicit PreviewCache(int capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Get the cache shared by all views
+     * @return Application-wide cache
+     */
+    static PreviewCache& shared();
+
+    /**
+     * Get an item's display text
+     * @param item Item to display
+     * @param maxLength Maximum length of the text, ellipsis included
+     * @return Single-line text with a pin indicator for pinned items
+     */
+    QString displayText(const ClipboardItem& item, int maxLength);
+
+    /**
+     * Check if an item's display text is cached
+     * @param id Item ID
+     * @param maxLength Length the text was formatted for
+     */
+    bool contains(const QString& id, int maxLength) const { return m_texts.contains({id, maxLength}); }
+
+    // Cache state
+    int count() const { return int(m_texts.count()); }
+    int capacity() const { return int(m_texts.maxCost()); }
+    void setCapacity(int capacity) { m_texts.setMaxCost(qMax(1, capacity)); }
+    void clear() { m_texts.clear(); }
+
+    /**
+     * Estimate the memory held by the cache
+     * @return Bytes of the formatted texts and their entries; item IDs are
+     *         shared with the items and not counted
+     */
+    qint64 memoryUsage() const;
+
+private:
+    /**
+     * Format an item's text for single-line display, without pin indicator
+     */
+    static QString formatLine(const ClipboardItem& item, int maxLength);
+
+    static constexpr int DEFAULT_CAPACITY = 512;
+
+    QCache<QPair<QString, int>, QString> m_texts; ///< (item ID, length) -> formatted line
+};
@@ -0,0 +1,87 @@
+#include "screen_topology.h"
+#include <QGuiApplication>
+#include <QScreen>
+
+ScreenTopology::ScreenTopology(QObject* parent)
+    : QObject(parent)
+    , m_valid(false)
+    , m_generation(0)
+{
+    if (qGuiApp) {
+        connect(qGuiApp, &QGuiApplication::screenAdded, this, &ScreenTopology::invalidate);
+        connect(qGuiApp, &QGuiApplication::screenRemoved, this, &ScreenTopology::invalidate);
+        connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &ScreenTopology::invalidate);
+    }
+}
+
+const QList<ScreenTopology::Screen>& ScreenTopology::screens()
+{
+    if (!m_valid) {
+        rebuild();
+    }
+    return m_screens;
+}
+
+ScreenTopology::Screen ScreenTopology::screenAt(const QPoint& point)
+{
+    const QList<Screen>& all = screens();
+    for (const Screen& screen : all) {
+        if (screen.geometry.contains(point)) {
+            return screen;
+        }
+    }
+    return all.isEmpty() ? Screen() : all.first();
+}
+
+ScreenTopology::Screen ScreenTopology::primary()
+{
+    const QList<Screen>& all = screens();
+    return all.isEmpty() ? Screen() : all.first();
+}
+
+QList<qreal> ScreenTopology::devicePixelRatios()
+{
+    QList<qreal> ratios;
+    for (const Screen& screen : screens()) {
+        if (!ratios.contains(screen.devicePixelRatio)) {
+            ratios.append(screen.devicePixelRatio);
+        }
+    }
+    return ratios;
+}
+
+void ScreenTopology::invalidate()
+{
+    if (!m_valid) {
+        return;
+    }
+    m_valid = false;
+    m_screens.clear();
+    emit changed();
+}
+
+void ScreenTopology::rebuild()
+{
+    m_screens.clear();
+    QScreen* primary = QGuiApplication::primaryScreen();
+    const QList<QScreen*> platformScreens = QGuiApplication::screens();
+    for (QScreen* screen : platformScreens) {
+        // Rebuilds see the same screens again; keep one connection each
+        connect(screen, &QScreen::geometryChanged, this, &ScreenTopology::invalidate, Qt::UniqueConnection);
+        connect(screen, &QScreen::availableGeometryChanged, this, &ScreenTopology::invalidate, Qt::UniqueConnection);
+        connect(screen, &QScreen::logicalDotsPerInchChanged, this, &ScreenTopology::invalidate, Qt::UniqueConnection);
+
+        Screen entry;
+        entry.screen = screen;
+        entry.geometry = screen->geometry();
+        entry.availableGeometry = screen->availableGeometry();
+        entry.devicePixelRatio = screen->devicePixelRatio();
+        if (screen == primary) {
+            m_screens.prepend(entry);
+        } else {
+            m_screens.append(entry);
+        }
+    }
+    m_valid = true;
+    ++m_generation;
+}
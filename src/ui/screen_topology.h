@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+class QScreen;
+
+/**
+ * ScreenTopology - Cached layout of the connected screens
+ *
+ * Placing a popup needs the screen under a point, its available area and,
+ * to render for it, its device pixel ratio. Asking QGuiApplication for
+ * those walks the platform screens and their properties on every show;
+ * this class copies them once and serves every later query from the copy.
+ *
+ * The copy is dropped when a screen is added or removed, the primary
+ * screen changes, or any screen changes its geometry, available area or
+ * DPI, and rebuilt on the next query. changed() tells users that keep
+ * per-screen state of their own, e.g. pixmaps rendered for one ratio.
+ *
+ * Screens sharing a device pixel ratio form a DPI group: a window
+ * rendered for one screen of a group is already rendered for all of them.
+ *
+ * The topology must only be used from the GUI thread.
+ */
+class ScreenTopology : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Snapshot of one screen
+     */
+    struct Screen {
+        QScreen* screen = nullptr;
+        QRect geometry;
+        QRect availableGeometry;
+        qreal devicePixelRatio = 1.0;
+
+        bool isNull() const { return screen == nullptr; }
+    };
+
+    /**
+     * Constructor - Starts following the application's screens
+     * @param parent QObject parent for memory management
+     */
+    explicit ScreenTopology(QObject* parent = nullptr);
+
+    /**
+     * Get all screens, primary first
+     */
+    const QList<Screen>& screens();
+
+    /**
+     * Get the screen containing a point
+     * @param point Global position in device-independent pixels
+     * @return That screen, the primary screen if none contains the point,
+     *         or a null screen if there are no screens
+     */
+    Screen screenAt(const QPoint& point);
+
+    /**
+     * Get the primary screen
+     * @return Primary screen, or a null screen if there are no screens
+     */
+    Screen primary();
+
+    /**
+     * Get the distinct device pixel ratios, one per DPI group
+     * @return Ratios in the order of screens(), the primary's first
+     */
+    QList<qreal> devicePixelRatios();
+
+    /**
+     * Get how often the topology has been rebuilt
+     * Queries between two changes do not increase it
+     */
+    quint64 generation() const { return m_generation; }
+
+public slots:
+    /**
+     * Drop the cached topology; the next query rebuilds it
+     */
+    void invalidate();
+
+signals:
+    /**
+     * Emitted when the cached topology is dropped
+     */
+    void changed();
+
+private:
+    /**
+     * Copy the current screens and follow their changes
+     */
+    void rebuild();
+
+    QList<Screen> m_screens;         ///< Primary first, empty until built
+    bool m_valid;                    ///< m_screens matches the platform
+    quint64 m_generation;            ///< Number of rebuilds
+};
@@ -101,7 +101,7 @@ QGroupBox* SettingsDialog::createGeneralSection()
     
     // History limit
     m_historyLimitSpinBox = new QSpinBox();
-    m_historyLimitSpinBox->setRange(10, 1000);
+    m_historyLimitSpinBox->setRange(Configuration::minHistoryLimit(), Configuration::maxHistoryLimit());
     m_historyLimitSpinBox->setSuffix(" items");
     m_historyLimitSpinBox->setToolTip("Maximum number of clipboard items to remember");
     layout->addRow("History Limit:", m_historyLimitSpinBox);
@@ -206,13 +206,16 @@ void SettingsDialog::saveConfiguration()
 {
     if (!m_config) return;
     
+    // One signal per changed setting, and no write if nothing changed
+    m_config->beginUpdate();
     m_config->setMaxHistoryItems(m_historyLimitSpinBox->value());
     m_config->setHotkey(m_hotkeyLineEdit->text().trimmed());
     m_config->setAutostart(m_startMinimizedCheckBox->isChecked());
     m_config->setShowNotifications(m_showTrayIconCheckBox->isChecked());
+    m_config->commitUpdate();
     
-    // Save to file
-    m_config->save();
+    // Written on the thread pool; quick successive applies share one write
+    m_config->scheduleSave();
 }
 
 void SettingsDialog::applyModernStyling()
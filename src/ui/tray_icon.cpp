@@ -7,7 +7,8 @@
 #include <QIcon>
 #include <QFont>
 #include <QFontMetrics>
-#include <QRegularExpression>
+
+#include "preview_cache.h"
 
 TrayIcon::TrayIcon(QObject* parent)
     : QSystemTrayIcon(parent)
@@ -18,17 +19,21 @@ TrayIcon::TrayIcon(QObject* parent)
     , m_aboutAction(nullptr)
     , m_exitAction(nullptr)
     , m_recentItemsMenu(nullptr)
+    , m_noRecentItemsAction(nullptr)
     , m_currentTheme("system")
     , m_hasCustomIcon(false)
     , m_hasHistory(false)
     , m_monitoringEnabled(true)
+    , m_loading(false)
     , m_historyCount(0)
+    , m_recentItemsVersion(0)
+    , m_recentItemsMenuDirty(true)
 {
     // Initialize context menu
     initializeMenu();
     
     // Set initial icon
-    updateIconState(false);
+    applyStateIcon();
     
     // Connect activation signal
     connect(this, &QSystemTrayIcon::activated,
@@ -50,7 +55,7 @@ void TrayIcon::setIconTheme(const QString& theme)
     m_customIcon = QIcon();
     
     // Update icon with current state
-    updateIconState(m_hasHistory);
+    applyStateIcon();
 }
 
 void TrayIcon::setCustomIcon(const QIcon& icon)
@@ -64,24 +69,56 @@ void TrayIcon::setCustomIcon(const QIcon& icon)
 
 void TrayIcon::updateIconState(bool hasHistory)
 {
-    m_hasHistory = hasHistory;
-    
-    if (m_hasCustomIcon) {
-        // Don't change custom icon
+    if (hasHistory == m_hasHistory) {
         return;
     }
     
-    QIcon icon = getStateIcon(hasHistory);
-    setIcon(icon);
+    m_hasHistory = hasHistory;
+    applyStateIcon();
 }
 
 void TrayIcon::setHistoryCount(int count)
 {
     m_historyCount = count;
+    updateIconState(count > 0);
     
     // Update tooltip to show count
-    QString tooltip = QString("Clipboard History Manager (%1 items)").arg(count);
-    setToolTip(tooltip);
+    QString tooltip = m_loading ? QString("Clipboard History Manager (loading history...)")
+                                : QString("Clipboard History Manager (%1 items)").arg(count);
+    if (tooltip != toolTip()) {
+        setToolTip(tooltip);
+    }
+}
+
+void TrayIcon::setLoading(bool loading)
+{
+    if (loading == m_loading) {
+        return;
+    }
+    
+    m_loading = loading;
+    m_noRecentItemsAction->setText(loading ? "Loading history..." : "No recent items");
+    setHistoryCount(m_historyCount);
+}
+
+bool TrayIcon::isLoading() const
+{
+    return m_loading;
+}
+
+qint64 TrayIcon::memoryUsage() const
+{
+    qint64 bytes = qint64(m_recentItems.capacity()) * qint64(sizeof(ClipboardItem));
+    for (const QMenu* menu : {m_contextMenu, m_recentItemsMenu}) {
+        if (!menu) {
+            continue;
+        }
+        const QList<QAction*> actions = menu->actions();
+        for (const QAction* action : actions) {
+            bytes += ACTION_BYTES + qint64(action->text().capacity()) * qint64(sizeof(QChar));
+        }
+    }
+    return bytes;
 }
 
 void TrayIcon::setMonitoringState(bool enabled)
@@ -101,8 +138,27 @@ void TrayIcon::setMonitoringState(bool enabled)
 
 void TrayIcon::updateRecentItems(const QList<ClipboardItem>& items)
 {
-    m_recentItems = items;
-    updateRecentItemsMenu();
+    setRecentItems(items.mid(0, MAX_RECENT_ITEMS), 0);
+}
+
+void TrayIcon::updateRecentItems(const HistoryView& view)
+{
+    if (view.version() != 0 && view.version() == m_recentItemsVersion) {
+        return;
+    }
+    
+    // Only the items shown in the menu are kept
+    setRecentItems(view.items(MAX_RECENT_ITEMS), view.version());
+}
+
+void TrayIcon::applyHistoryChange(int index, const HistoryView& view, int historyCount)
+{
+    setHistoryCount(historyCount);
+    if (index >= MAX_RECENT_ITEMS) {
+        m_recentItemsVersion = view.version();
+        return;
+    }
+    updateRecentItems(view);
 }
 
 void TrayIcon::showHistoryWindow()
@@ -184,10 +240,27 @@ void TrayIcon::initializeMenu()
     
     m_contextMenu->addSeparator();
     
-    // Recent Items submenu
+    // Recent Items submenu; its actions are filled in when it opens
     m_recentItemsMenu = new QMenu("Recent Items");
     m_recentItemsMenu->setIcon(QIcon::fromTheme("document-open-recent"));
     m_contextMenu->addMenu(m_recentItemsMenu);
+    connect(m_recentItemsMenu, &QMenu::aboutToShow,
+            this, &TrayIcon::updateRecentItemsMenu);
+    
+    m_pinnedItemIcon = QIcon::fromTheme("bookmark-new");
+    m_itemIcon = QIcon::fromTheme("edit-copy");
+    
+    m_noRecentItemsAction = new QAction("No recent items", this);
+    m_noRecentItemsAction->setEnabled(false);
+    m_recentItemsMenu->addAction(m_noRecentItemsAction);
+    for (int i = 0; i < MAX_RECENT_ITEMS; ++i) {
+        QAction* itemAction = new QAction(this);
+        itemAction->setVisible(false);
+        connect(itemAction, &QAction::triggered,
+                this, &TrayIcon::handleRecentItemTriggered);
+        m_recentItemsMenu->addAction(itemAction);
+        m_recentItemActions.append(itemAction);
+    }
     
     m_contextMenu->addSeparator();
     
@@ -227,73 +300,61 @@ void TrayIcon::initializeMenu()
     
     // Set context menu
     setContextMenu(m_contextMenu);
+}
+
+void TrayIcon::setRecentItems(const QList<ClipboardItem>& items, quint64 version)
+{
+    m_recentItems = items;
+    m_recentItemsVersion = version;
+    m_recentItemsMenuDirty = true;
     
-    // Initialize recent items menu
-    updateRecentItemsMenu();
+    // A closed menu waits for aboutToShow
+    if (m_recentItemsMenu->isVisible()) {
+        updateRecentItemsMenu();
+    }
 }
 
 void TrayIcon::updateRecentItemsMenu()
 {
-    // Clear existing actions
-    for (QAction* action : m_recentItemActions) {
-        m_recentItemsMenu->removeAction(action);
-        delete action;
-    }
-    m_recentItemActions.clear();
-    
-    if (m_recentItems.isEmpty()) {
-        // Show "No recent items" placeholder
-        QAction* noItemsAction = new QAction("No recent items", this);
-        noItemsAction->setEnabled(false);
-        m_recentItemsMenu->addAction(noItemsAction);
-        m_recentItemActions.append(noItemsAction);
+    if (!m_recentItemsMenuDirty) {
         return;
     }
+    m_recentItemsMenuDirty = false;
     
-    // Add actions for recent items (max 5)
-    int itemCount = qMin(m_recentItems.size(), MAX_RECENT_ITEMS);
-    for (int i = 0; i < itemCount; ++i) {
-        const ClipboardItem& item = m_recentItems.at(i);
-        
-        // Create preview text
-        QString preview = truncateText(item.text(), MAX_PREVIEW_LENGTH);
-        
-        // Add pinned indicator
-        if (item.pinned()) {
-            preview = "📌 " + preview;
+    m_noRecentItemsAction->setVisible(m_recentItems.isEmpty());
+    
+    // Update the slots in place; setters ignore unchanged values
+    int itemCount = qMin(int(m_recentItems.size()), MAX_RECENT_ITEMS);
+    for (int i = 0; i < MAX_RECENT_ITEMS; ++i) {
+        QAction* itemAction = m_recentItemActions.at(i);
+        if (i >= itemCount) {
+            itemAction->setVisible(false);
+            continue;
         }
         
-        QAction* itemAction = new QAction(preview, this);
-        itemAction->setToolTip(item.text()); // Full text in tooltip
-        
-        // Set icon based on item type
-        if (item.pinned()) {
-            itemAction->setIcon(QIcon::fromTheme("bookmark-new"));
-        } else {
-            itemAction->setIcon(QIcon::fromTheme("edit-copy"));
-        }
+        const ClipboardItem& item = m_recentItems.at(i);
         
-        connect(itemAction, &QAction::triggered,
-                this, &TrayIcon::handleRecentItemTriggered);
+        // Preview text with pinned indicator, shared with the history window
+        itemAction->setText(PreviewCache::shared().displayText(item, MAX_PREVIEW_LENGTH));
+        itemAction->setToolTip(item.hasPayload() ? item.preview() : item.text()); // Full text in tooltip
         
-        m_recentItemsMenu->addAction(itemAction);
-        m_recentItemActions.append(itemAction);
+        // Icon based on pin state, only replaced when that changes
+        if (itemAction->data() != QVariant(item.pinned())) {
+            itemAction->setIcon(item.pinned() ? m_pinnedItemIcon : m_itemIcon);
+            itemAction->setData(item.pinned());
+        }
+        itemAction->setVisible(true);
     }
 }
 
-QString TrayIcon::truncateText(const QString& text, int maxLength) const
+void TrayIcon::applyStateIcon()
 {
-    if (text.length() <= maxLength) {
-        return text;
+    if (m_hasCustomIcon) {
+        // Don't change custom icon
+        return;
     }
     
-    // Replace any newlines/tabs with spaces for menu display
-    QString cleanText = text;
-    cleanText.replace('\n', ' ');
-    cleanText.replace('\t', ' ');
-    cleanText.replace(QRegularExpression("\\s+"), " "); // Replace multiple spaces with single space
-    
-    return cleanText.left(maxLength - 3) + "...";
+    setIcon(getStateIcon(m_hasHistory));
 }
 
 QIcon TrayIcon::getStateIcon(bool hasHistory) const
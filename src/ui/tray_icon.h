@@ -9,6 +9,7 @@
 #include <QList>
 
 #include "models/clipboard_item.h"
+#include "models/history_view.h"
 
 /**
  * @brief System tray icon implementation for clipboard history manager
@@ -17,6 +18,10 @@
  * monitoring controls, and application actions. Supports automatic icon theme 
  * adaptation and efficient menu updates.
  * 
+ * The recent items submenu is lazy: history updates only record the items,
+ * and the menu is brought up to date when it is about to be shown. Its
+ * actions are created once and updated in place.
+ * 
  * Performance Requirements:
  * - Menu updates must complete in <100ms
  * - Icon updates must complete in <50ms
@@ -54,15 +59,33 @@ public slots:
     /**
      * @brief Update icon to reflect clipboard history state
      * @param hasHistory True if clipboard history contains items
+     *
+     * The icon is only replaced when the state actually changes.
      */
     void updateIconState(bool hasHistory);
     
     /**
      * @brief Update menu to show current history count
      * @param count Number of items in clipboard history
+     *
+     * Also updates the icon state when the history becomes empty or non-empty.
      */
     void setHistoryCount(int count);
     
+    /**
+     * @brief Show that the history is still being loaded
+     * @param loading True until the stored history is available
+     *
+     * While loading, the tooltip and the empty recent items menu say so
+     * instead of reporting an empty history.
+     */
+    void setLoading(bool loading);
+    
+    /**
+     * @brief Check if the loading state is shown
+     */
+    bool isLoading() const;
+    
     /**
      * @brief Update monitoring state in menu
      * @param enabled True if clipboard monitoring is active
@@ -75,6 +98,30 @@ public slots:
      */
     void updateRecentItems(const QList<ClipboardItem>& items);
     
+    /**
+     * @brief Update recent items submenu from a history view
+     * @param view Snapshot of the history; ignored if already shown
+     */
+    void updateRecentItems(const HistoryView& view);
+    
+    /**
+     * @brief Apply a single history change to the recent items submenu
+     * @param index Lowest display position touched by the change
+     * @param view Snapshot of the history after the change
+     * @param historyCount Number of items after the change, cold ones
+     *                     included (the view only holds the hot ones)
+     *
+     * Changes below the recent items leave the menu alone.
+     */
+    void applyHistoryChange(int index, const HistoryView& view, int historyCount);
+    
+    /**
+     * @brief Estimate the memory held by the tray menu
+     * @return Bytes of the menu actions, their texts and the recent item
+     *         list; the items themselves are shared with the history
+     */
+    qint64 memoryUsage() const;
+    
     /**
      * @brief Show history window (emits signal)
      */
@@ -143,6 +190,11 @@ private slots:
      * @brief Handle recent item menu action triggered
      */
     void handleRecentItemTriggered();
+    
+    /**
+     * @brief Bring the recent items submenu up to date before it opens
+     */
+    void updateRecentItemsMenu();
 
 private:
     /**
@@ -151,17 +203,14 @@ private:
     void initializeMenu();
     
     /**
-     * @brief Update recent items submenu efficiently
+     * @brief Record new recent items, updating the submenu only if it is open
      */
-    void updateRecentItemsMenu();
+    void setRecentItems(const QList<ClipboardItem>& items, quint64 version);
     
     /**
-     * @brief Truncate text to specified length with ellipsis
-     * @param text Text to truncate
-     * @param maxLength Maximum character count (default 50)
-     * @return Truncated text with "..." if needed
+     * @brief Apply the icon for the current theme and state
      */
-    QString truncateText(const QString& text, int maxLength = 50) const;
+    void applyStateIcon();
     
     /**
      * @brief Get appropriate icon for current theme and state
@@ -181,7 +230,10 @@ private:
     
     // Recent items submenu
     QMenu* m_recentItemsMenu;
-    QList<QAction*> m_recentItemActions;
+    QList<QAction*> m_recentItemActions;   // One per recent item slot, reused
+    QAction* m_noRecentItemsAction;        // Placeholder for an empty history
+    QIcon m_pinnedItemIcon;
+    QIcon m_itemIcon;
     
     // State tracking
     QString m_currentTheme;
@@ -189,14 +241,18 @@ private:
     bool m_hasCustomIcon;
     bool m_hasHistory;
     bool m_monitoringEnabled;
+    bool m_loading;
     int m_historyCount;
     
     // Recent items cache
     QList<ClipboardItem> m_recentItems;
+    quint64 m_recentItemsVersion;
+    bool m_recentItemsMenuDirty;           // Items changed since the menu was updated
     
     // Constants
     static constexpr int MAX_RECENT_ITEMS = 5;
     static constexpr int MAX_PREVIEW_LENGTH = 50;
+    static constexpr int ACTION_BYTES = 256;   // QAction and its private data, roughly
 };
 
 #endif // TRAY_ICON_H
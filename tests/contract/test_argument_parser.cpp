@@ -53,12 +53,19 @@ private slots:
     // Display Options Tests
     void testVerboseOption();
     void testNoTrayOption();
+    void testTraceLatencyOption();
+    void testProfileFootprintOption();
 
     // Test Options Tests
     void testVerifyClipboardOption();
     void testTestHotkeyOption();
     void testTestTrayOption();
     void testListHotkeysOption();
+    
+    // Client Mode Tests
+    void testClientCommands();
+    void testClientCommands_onlyOneAllowed();
+    void testClientInvocationDetection();
 
     // Combined Options Tests
     void testMultipleOptions();
@@ -238,7 +245,7 @@ void TestArgumentParser::testHistoryLimitOption_invalidValue()
     QVERIFY(!parseArguments(args1));
     
     // Too high
-    QStringList args2 = {"-l", "150"};
+    QStringList args2 = {"-l", "100001"};
     QVERIFY(!parseArguments(args2));
 }
 
@@ -251,9 +258,9 @@ void TestArgumentParser::testHistoryLimitOption_boundaryValues()
     QCOMPARE(parser->getHistoryLimit(), 10);
     
     // Upper boundary
-    QStringList args2 = {"-l", "100"};
+    QStringList args2 = {"-l", "100000"};
     QVERIFY(parseArguments(args2));
-    QCOMPARE(parser->getHistoryLimit(), 100);
+    QCOMPARE(parser->getHistoryLimit(), 100000);
 }
 
 void TestArgumentParser::testHistoryLimitOption_nonNumericValue()
@@ -302,6 +309,27 @@ void TestArgumentParser::testNoTrayOption()
     QVERIFY(parser->isNoTray());
 }
 
+void TestArgumentParser::testTraceLatencyOption()
+{
+    QVERIFY(parseArguments({}));
+    QVERIFY(!parser->isTraceLatency());
+    
+    QStringList args = {"--trace-latency"};
+    QVERIFY(parseArguments(args));
+    QVERIFY(parser->isTraceLatency());
+}
+
+void TestArgumentParser::testProfileFootprintOption()
+{
+    QVERIFY(parseArguments({}));
+    QVERIFY(parser->getProfileFootprintPath().isEmpty());
+    
+    QStringList args = {"--profile-footprint", "/tmp/footprint.txt"};
+    QVERIFY(parseArguments(args));
+    QCOMPARE(parser->getProfileFootprintPath(), QString("/tmp/footprint.txt"));
+    QVERIFY(!parser->isClientMode());
+}
+
 void TestArgumentParser::testVerifyClipboardOption()
 {
     
@@ -334,6 +362,56 @@ void TestArgumentParser::testListHotkeysOption()
     QVERIFY(parser->isTestMode());
 }
 
+void TestArgumentParser::testClientCommands()
+{
+    QVERIFY(parseArguments({"--verbose"}));
+    QVERIFY(!parser->isClientMode());
+    
+    QVERIFY(parseArguments({"--search", "invoice", "--limit", "5"}));
+    QVERIFY(parser->isClientMode());
+    QCOMPARE(parser->getClientRequest().command, IpcProtocol::Command::Search);
+    QCOMPARE(parser->getClientRequest().argument, QString("invoice"));
+    QCOMPARE(parser->getClientRequest().limit, 5);
+    
+    QVERIFY(parseArguments({"--paste", "1234"}));
+    QCOMPARE(parser->getClientRequest().command, IpcProtocol::Command::Paste);
+    QCOMPARE(parser->getClientRequest().argument, QString("1234"));
+    QCOMPARE(parser->getClientRequest().limit, 0);
+    
+    QVERIFY(parseArguments({"--list"}));
+    QCOMPARE(parser->getClientRequest().command, IpcProtocol::Command::List);
+    QVERIFY(!parseArguments({"--list", "--limit", "0"}));
+    
+    QVERIFY(parseArguments({"--metrics"}));
+    QVERIFY(parser->isClientMode());
+    QCOMPARE(parser->getClientRequest().command, IpcProtocol::Command::Metrics);
+}
+
+void TestArgumentParser::testClientCommands_onlyOneAllowed()
+{
+    QVERIFY(!parseArguments({"--list", "--show"}));
+    QVERIFY(!parser->getErrorString().isEmpty());
+}
+
+void TestArgumentParser::testClientInvocationDetection()
+{
+    char exe[] = "clipboard-manager";
+    char list[] = "--list";
+    char search[] = "--search=invoice";
+    char listHotkeys[] = "--list-hotkeys";
+    char verbose[] = "--verbose";
+    
+    char* clientArgs[] = {exe, verbose, list};
+    QVERIFY(ArgumentParser::isClientInvocation(3, clientArgs));
+    char* searchArgs[] = {exe, search};
+    QVERIFY(ArgumentParser::isClientInvocation(2, searchArgs));
+    char metrics[] = "--metrics";
+    char* metricsArgs[] = {exe, metrics};
+    QVERIFY(ArgumentParser::isClientInvocation(2, metricsArgs));
+    char* appArgs[] = {exe, verbose, listHotkeys};
+    QVERIFY(!ArgumentParser::isClientInvocation(3, appArgs));
+}
+
 void TestArgumentParser::testMultipleOptions()
 {
     
@@ -487,7 +565,7 @@ void TestArgumentParser::testParsingErrors()
     QList<QStringList> errorScenarios = {
         QStringList{"-l", "abc"}, // Non-numeric history limit
         QStringList{"-l", "5"},   // History limit too low
-        QStringList{"-l", "150"}  // History limit too high
+        QStringList{"-l", "100001"}  // History limit too high
     };
     
     for (const QStringList& args : errorScenarios) {
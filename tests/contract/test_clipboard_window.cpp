@@ -10,8 +10,11 @@
 #include <QSize>
 #include <QApplication>
 #include <QElapsedTimer>
+#include <QStandardPaths>
 
+#include "../../src/lib/latency_trace.h"
 #include "../../src/models/clipboard_item.h"
+#include "../../src/services/clipboard_manager.h"
 #include "../../src/ui/clipboard_window.h"
 
 class TestClipboardWindow : public QObject
@@ -31,6 +34,7 @@ private slots:
     // Window Management Tests
     void testShowAtCursor();
     void testShowAtPosition();
+    void testShowAtCenter_tracesShowRequest();
     void testHideWindow();
     void testDisplayTime();
 
@@ -52,6 +56,15 @@ private slots:
     void testSelectNextItem();
     void testSelectPreviousItem();
     void testKeyboardNavigation();
+    void testKeyboardNavigation_pageHomeEnd();
+    void testQuickSelect_altDigit();
+    void testTypeToJump_altLetters();
+
+    // Search Tests
+    void testSearch_filtersItems();
+    void testSearch_followsHistoryChanges();
+    void testSearch_typingFilters();
+    void testSearch_findsColdItems();
 
     // Mouse Interaction Tests
     void testSingleClick();
@@ -74,12 +87,14 @@ private slots:
 
     // Visual Requirements Tests
     void testFramelessWindow();
+    void testRenderModes();
     void testZOrder();
     void testScreenBounds();
     void testMultiMonitor();
 
     // Performance Contract Tests
     void testShowPerformance();
+    void testPrewarmedReshow();
     void testSetHistoryPerformance();
     void testScrollingPerformance();
 
@@ -169,6 +184,20 @@ void TestClipboardWindow::testShowAtPosition()
     QCOMPARE(window->pos(), testPos);
 }
 
+void TestClipboardWindow::testShowAtCenter_tracesShowRequest()
+{
+    // Contract: The tray path is traced like the hotkey path
+    LatencyTrace::reset();
+    LatencyTrace::setEnabled(true);
+    window->showAtCenter();
+    const quint64 requests = LatencyTrace::histogram(LatencyTrace::ShowRequested).count();
+    LatencyTrace::setEnabled(false);
+    LatencyTrace::reset();
+    
+    QVERIFY(window->isVisible());
+    QCOMPARE(requests, quint64(1));
+}
+
 void TestClipboardWindow::testHideWindow()
 {
     // Contract: Must hide window and emit signal
@@ -349,6 +378,193 @@ void TestClipboardWindow::testKeyboardNavigation()
     QVERIFY(window->selectedIndex() >= -1);
 }
 
+void TestClipboardWindow::testKeyboardNavigation_pageHomeEnd()
+{
+    // Contract: Page keys move by a page without wrapping, Home/End go to the ends
+    window->setHistory(createTestHistory(50));
+    window->show();
+    QCOMPARE(window->selectedIndex(), 0);
+    
+    QTest::keyClick(window, Qt::Key_PageDown);
+    const int page = window->selectedIndex();
+    QVERIFY(page > 0);
+    
+    QTest::keyClick(window, Qt::Key_End);
+    QCOMPARE(window->selectedIndex(), 49);
+    QTest::keyClick(window, Qt::Key_PageDown);
+    QCOMPARE(window->selectedIndex(), 49);
+    QTest::keyClick(window, Qt::Key_PageUp);
+    QCOMPARE(window->selectedIndex(), 49 - page);
+    
+    QTest::keyClick(window, Qt::Key_Home);
+    QCOMPARE(window->selectedIndex(), 0);
+    QTest::keyClick(window, Qt::Key_PageUp);
+    QCOMPARE(window->selectedIndex(), 0);
+    
+    // Arrows still wrap
+    QTest::keyClick(window, Qt::Key_Up);
+    QCOMPARE(window->selectedIndex(), 49);
+}
+
+void TestClipboardWindow::testQuickSelect_altDigit()
+{
+    // Contract: Alt+N pastes the Nth visible row; plain digits still search
+    QList<ClipboardItem> items = createTestHistory(5);
+    window->setHistory(items);
+    window->show();
+    QSignalSpy selectedSpy(window, &ClipboardWindow::itemSelected);
+    
+    QTest::keyClick(window, Qt::Key_9, Qt::AltModifier);
+    QCOMPARE(selectedSpy.count(), 0);
+    
+    QTest::keyClick(window, Qt::Key_3, Qt::AltModifier);
+    QCOMPARE(selectedSpy.count(), 1);
+    QCOMPARE(selectedSpy.at(0).at(0).value<ClipboardItem>().id(), items.at(2).id());
+    QVERIFY(window->isHidden());
+    
+    window->show();
+    QTest::keyClick(window, Qt::Key_4);
+    QCOMPARE(window->searchText(), QString("4"));
+    QCOMPARE(selectedSpy.count(), 1);
+}
+
+void TestClipboardWindow::testTypeToJump_altLetters()
+{
+    // Contract: Alt+letters move to the next row starting with the typed text
+    QList<ClipboardItem> items = {createTestItem("apple pie"),
+                                  createTestItem("banana bread"),
+                                  createTestItem("apricot jam"),
+                                  createTestItem("blueberry muffin")};
+    window->setHistory(items);
+    window->show();
+    QCOMPARE(window->selectedIndex(), 0);
+    
+    QTest::keyClick(window, Qt::Key_B, Qt::AltModifier);
+    QCOMPARE(window->selectedItem().id(), items.at(1).id());
+    QTest::keyClick(window, Qt::Key_L, Qt::AltModifier);
+    QCOMPARE(window->selectedItem().id(), items.at(3).id());
+    
+    // After a pause a new prefix starts, moving past the current row
+    QTest::qWait(QApplication::keyboardInputInterval() + 50);
+    QTest::keyClick(window, Qt::Key_A, Qt::AltModifier);
+    QCOMPARE(window->selectedItem().id(), items.at(0).id());
+    QTest::qWait(QApplication::keyboardInputInterval() + 50);
+    QTest::keyClick(window, Qt::Key_A, Qt::AltModifier);
+    QCOMPARE(window->selectedItem().id(), items.at(2).id());
+    
+    // No match keeps the selection, and nothing goes to the search box
+    QTest::qWait(QApplication::keyboardInputInterval() + 50);
+    QTest::keyClick(window, Qt::Key_Z, Qt::AltModifier);
+    QCOMPARE(window->selectedItem().id(), items.at(2).id());
+    QVERIFY(window->searchText().isEmpty());
+}
+
+void TestClipboardWindow::testSearch_filtersItems()
+{
+    // Contract: Search text must filter case-insensitively and keep display order
+    QList<ClipboardItem> items = {createTestItem("Pinned Clipboard note", true),
+                                  createTestItem("grocery list"),
+                                  createTestItem("clipboard manager")};
+    window->setHistory(items);
+    
+    window->setSearchText("CLIP");
+    QCOMPARE(window->visibleItemCount(), 2);
+    QCOMPARE(window->selectedIndex(), 0);
+    QCOMPARE(window->selectedItem().id(), items.at(0).id());
+    
+    window->setSearchText("clipboard m");
+    QCOMPARE(window->visibleItemCount(), 1);
+    QCOMPARE(window->selectedItem().id(), items.at(2).id());
+    
+    window->setSearchText("nothing like this");
+    QCOMPARE(window->visibleItemCount(), 0);
+    QVERIFY(!window->selectedItem().isValid());
+    
+    window->setSearchText(QString());
+    QCOMPARE(window->visibleItemCount(), 3);
+}
+
+void TestClipboardWindow::testSearch_followsHistoryChanges()
+{
+    // Contract: Items added or removed while searching must update the results
+    QList<ClipboardItem> items = createTestHistory(3);
+    window->setHistory(items);
+    window->setSearchText("item 1");
+    QCOMPARE(window->visibleItemCount(), 1);
+    
+    ClipboardItem added = createTestItem("Another item 12");
+    window->insertItemAt(2, added);
+    QCOMPARE(window->visibleItemCount(), 2);
+    
+    window->removeItem(items.at(1).id());
+    QCOMPARE(window->visibleItemCount(), 1);
+    QCOMPARE(window->selectedItem().id(), added.id());
+}
+
+void TestClipboardWindow::testSearch_typingFilters()
+{
+    // Contract: Typing in the window must go to the search box
+    window->setHistory(createTestHistory(5));
+    window->show();
+    
+    QTest::keyClicks(window, "m 3");
+    QCOMPARE(window->searchText(), QString("m 3"));
+    QCOMPARE(window->visibleItemCount(), 1);
+    
+    QTest::keyClick(window, Qt::Key_Backspace);
+    QCOMPARE(window->searchText(), QString("m "));
+    
+    // Escape clears the search before closing the window
+    QTest::keyClick(window, Qt::Key_Escape);
+    QVERIFY(window->searchText().isEmpty());
+    QCOMPARE(window->visibleItemCount(), 5);
+}
+
+void TestClipboardWindow::testSearch_findsColdItems()
+{
+    // Contract: Search must find items the history keeps on disk, not only the displayed ones
+    QStandardPaths::setTestModeEnabled(true);
+    ClipboardManager manager;
+    manager.setMaxHistoryItems(1000);
+    
+    // Items a previous run left in the cold segment never carry this run's marker
+    const QString marker = QString::number(QDateTime::currentMSecsSinceEpoch());
+    // More than the hot limit of 100, so the oldest ones are demoted to disk
+    for (int i = 0; i < 150; ++i) {
+        QVERIFY(manager.processText(QString("cold search %1 entry %2").arg(marker).arg(i)));
+    }
+    const HistoryView view = manager.historyView();
+    QVERIFY(manager.memoryUsage().coldEntries >= 50);
+    QVERIFY(view.count() < 150);
+    
+    window->setHistory(view);
+    window->setColdSearch([&manager](const QString& query, int limit) {
+        return manager.findColdItems(query, limit);
+    });
+    
+    // Entry 42 was demoted out of the displayed history
+    window->setSearchText(QString("cold search %1 entry 42").arg(marker));
+    QCOMPARE(window->visibleItemCount(), 1);
+    const ClipboardItem found = window->selectedItem();
+    QVERIFY(!found.id().isEmpty());
+    QCOMPARE(manager.getItem(found.id()).text(), QString("cold search %1 entry 42").arg(marker));
+    
+    // Picking it hands the item out like any other row
+    QSignalSpy selectedSpy(window, &ClipboardWindow::itemSelected);
+    QTest::keyClick(window, Qt::Key_Return);
+    QCOMPARE(selectedSpy.count(), 1);
+    QCOMPARE(selectedSpy.first().first().value<ClipboardItem>().id(), found.id());
+    
+    
+    // Displayed matches come first, cold ones after them
+    window->setSearchText(QString("%1 entry 14").arg(marker));
+    QCOMPARE(window->visibleItemCount(), 11);
+    QCOMPARE(window->selectedItem().preview(), QString("cold search %1 entry 149").arg(marker));
+    
+    window->setSearchText(QString());
+    QCOMPARE(window->visibleItemCount(), view.count());
+}
+
 void TestClipboardWindow::testSingleClick()
 {
     // Contract: Single click must emit itemSelected and close window
@@ -512,6 +728,33 @@ void TestClipboardWindow::testFramelessWindow()
     // Additional visual checks would require platform-specific code
 }
 
+void TestClipboardWindow::testRenderModes()
+{
+    // Contract: Glass windows are translucent, low-power windows opaque
+    ClipboardWindow glass(ClipboardWindow::Glass);
+    QCOMPARE(glass.renderMode(), ClipboardWindow::Glass);
+    QVERIFY(glass.testAttribute(Qt::WA_TranslucentBackground));
+    
+    ClipboardWindow lowPower(ClipboardWindow::LowPower);
+    QCOMPARE(lowPower.renderMode(), ClipboardWindow::LowPower);
+    QVERIFY(!lowPower.testAttribute(Qt::WA_TranslucentBackground));
+    lowPower.setHistory(createTestHistory(3));
+    lowPower.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&lowPower));
+    QCOMPARE(lowPower.visibleItemCount(), 3);
+    lowPower.hideWindow();
+    
+    bool ok = false;
+    QCOMPARE(ClipboardWindow::renderModeFromName("low-power", &ok), ClipboardWindow::LowPower);
+    QVERIFY(ok);
+    QCOMPARE(ClipboardWindow::renderModeFromName("glass", &ok), ClipboardWindow::Glass);
+    QVERIFY(ok);
+    QCOMPARE(ClipboardWindow::renderModeFromName("auto", &ok), ClipboardWindow::detectRenderMode());
+    QVERIFY(ok);
+    ClipboardWindow::renderModeFromName("fancy", &ok);
+    QVERIFY(!ok);
+}
+
 void TestClipboardWindow::testZOrder()
 {
     // Contract: Must appear above all other windows
@@ -558,6 +801,34 @@ void TestClipboardWindow::testShowPerformance()
     QVERIFY(elapsed < 200); // Must appear within 200ms
 }
 
+void TestClipboardWindow::testPrewarmedReshow()
+{
+    // Contract: A prewarmed window is ready offscreen and only moves on later shows
+    window->setHistory(createTestHistory(20));
+    window->prewarm();
+    QVERIFY(window->isPrewarmed());
+    QVERIFY(!window->isVisible());
+    QVERIFY(window->graphicsEffect() == nullptr);
+    
+    window->showAtPosition(QPoint(100, 100));
+    window->hideWindow();
+    
+    // Deltas while hidden do not rebuild the window
+    window->insertItemAt(0, ClipboardItem("Copied while hidden"));
+    
+    QElapsedTimer timer;
+    timer.start();
+    window->showAtPosition(QPoint(120, 120));
+    qint64 elapsed = timer.elapsed();
+    
+    QVERIFY(window->isVisible());
+    QCOMPARE(window->selectedItem().text(), QString("Copied while hidden"));
+    QVERIFY2(elapsed < 50, qPrintable(QString("Reshow took %1ms, should be <50ms").arg(elapsed)));
+    
+    // Shows are placed from the cached screens, which are read once
+    QCOMPARE(window->screenTopology()->generation(), quint64(1));
+}
+
 void TestClipboardWindow::testSetHistoryPerformance()
 {
     // Contract: Must handle up to 100 items without lag
@@ -72,6 +72,7 @@ private slots:
     // Performance Contracts
     void testRegistrationPerformance();
     void testTriggerLatency();
+    void testTriggerLatencyMeasured();
     void testMemoryUsage();
 
     // Resource Management
@@ -590,6 +591,24 @@ void TestGlobalHotkey::testTriggerLatency()
     QVERIFY2(elapsed < 50, qPrintable(QString("Trigger latency %1ms, should be <50ms").arg(elapsed)));
 }
 
+void TestGlobalHotkey::testTriggerLatencyMeasured()
+{
+    // Contract: The time since the last trigger is available to whoever shows the popup
+    QVERIFY(hotkey != nullptr);
+    QCOMPARE(hotkey->nsecsSinceTrigger(), qint64(-1));
+    
+    qint64 sinceTrigger = -1;
+    connect(hotkey, &GlobalHotkey::hotkeyTriggered, this, [this, &sinceTrigger]() {
+        sinceTrigger = hotkey->nsecsSinceTrigger();
+    });
+    hotkey->registerHotkey("Meta+V");
+    simulateHotkeyPress();
+    
+    QVERIFY(sinceTrigger >= 0);
+    QVERIFY(sinceTrigger < 50 * 1000 * 1000);
+    QVERIFY(hotkey->nsecsSinceTrigger() >= sinceTrigger);
+}
+
 void TestGlobalHotkey::testMemoryUsage()
 {
     // Contract: Memory usage should be minimal
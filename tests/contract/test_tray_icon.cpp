@@ -38,6 +38,7 @@ private slots:
 
     // Menu Management Tests
     void testSetHistoryCount();
+    void testSetLoading();
     void testSetMonitoringState();
     void testUpdateRecentItems_empty();
     void testUpdateRecentItems_withItems();
@@ -74,6 +75,8 @@ private slots:
 
     // Performance Tests
     void testMenuUpdatePerformance();
+    void testRecentItemsMenu_updatedOnShow();
+    void testSetHistoryCount_onlyTransitionsChangeIcon();
     void testIconUpdatePerformance();
 
     // System Integration Tests
@@ -208,6 +211,19 @@ void TestTrayIcon::testSetHistoryCount()
     QVERIFY(trayIcon->toolTip().contains("10 items"));
 }
 
+void TestTrayIcon::testSetLoading()
+{
+    // Contract: While the history loads the tray says so instead of "0 items"
+    trayIcon->setLoading(true);
+    QVERIFY(trayIcon->isLoading());
+    trayIcon->setHistoryCount(0);
+    QVERIFY(trayIcon->toolTip().contains("loading"));
+    
+    trayIcon->setLoading(false);
+    QVERIFY(!trayIcon->isLoading());
+    QVERIFY(trayIcon->toolTip().contains("0 items"));
+}
+
 void TestTrayIcon::testSetMonitoringState()
 {
     // Contract: Should update menu checkbox state
@@ -527,6 +543,59 @@ void TestTrayIcon::testMenuUpdatePerformance()
     QVERIFY(elapsed < 100); // Must update within 100ms
 }
 
+void TestTrayIcon::testRecentItemsMenu_updatedOnShow()
+{
+    // Contract: The recent items submenu is filled in when it opens, reusing its actions
+    QMenu* recentMenu = nullptr;
+    for (QAction* action : trayIcon->contextMenu()->actions()) {
+        if (action->menu() && action->text().contains("Recent")) {
+            recentMenu = action->menu();
+            break;
+        }
+    }
+    QVERIFY(recentMenu != nullptr);
+    
+    auto visibleTexts = [recentMenu]() {
+        QStringList texts;
+        for (QAction* action : recentMenu->actions()) {
+            if (action->isVisible()) {
+                texts.append(action->text());
+            }
+        }
+        return texts;
+    };
+    QCOMPARE(visibleTexts(), QStringList{"No recent items"});
+    
+    QList<ClipboardItem> items = createTestHistory(10);
+    trayIcon->updateRecentItems(items);
+    QCOMPARE(visibleTexts(), QStringList{"No recent items"});  // Not open yet
+    
+    QList<QAction*> actions = recentMenu->actions();
+    emit recentMenu->aboutToShow();
+    QCOMPARE(visibleTexts().size(), 5);
+    QVERIFY(visibleTexts().first().startsWith("📌 Test item 0"));
+    
+    trayIcon->updateRecentItems(items.mid(0, 2));
+    emit recentMenu->aboutToShow();
+    QCOMPARE(visibleTexts().size(), 2);
+    QCOMPARE(recentMenu->actions(), actions);
+}
+
+void TestTrayIcon::testSetHistoryCount_onlyTransitionsChangeIcon()
+{
+    // Contract: The icon follows the history becoming empty or populated, nothing else
+    trayIcon->setHistoryCount(3);
+    qint64 populatedKey = trayIcon->icon().cacheKey();
+    
+    trayIcon->setHistoryCount(4);
+    trayIcon->updateIconState(true);
+    QCOMPARE(trayIcon->icon().cacheKey(), populatedKey);
+    QVERIFY(trayIcon->toolTip().contains("4 items"));
+    
+    trayIcon->setHistoryCount(0);
+    QVERIFY(trayIcon->icon().cacheKey() != populatedKey);
+}
+
 void TestTrayIcon::testIconUpdatePerformance()
 {
     // Contract: Icon updates must be instant (<50ms) for state changes
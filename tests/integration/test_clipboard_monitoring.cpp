@@ -226,10 +226,12 @@ void TestClipboardMonitoring::testImageChangeDetection()
     // For now just verify that monitoring doesn't crash with image data
     QVERIFY(manager->isMonitoring());
     
-    // Basic verification - might not have full image support yet
+    // Images are kept in the blob store; the item only references them
     if (spy.count() > 0) {
         ClipboardItem item = getLastHistoryItem();
         QVERIFY(item.isValid());
+        QVERIFY(item.hasPayload());
+        QCOMPARE(item.payload().mimeType, QString("image/png"));
     }
 }
 
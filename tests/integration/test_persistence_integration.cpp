@@ -172,7 +172,7 @@ void TestPersistenceIntegration::testSaveHistory()
     QVERIFY(success);
     // Check if history file exists in the default config directory
     QString configDir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/clipboard-manager";
-    QVERIFY(QFile::exists(configDir + "/clipboard-history.json"));
+    QVERIFY(QFile::exists(configDir + "/clipboard-history.bin"));
 }
 
 void TestPersistenceIntegration::testLoadHistory()
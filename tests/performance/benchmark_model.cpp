@@ -0,0 +1,317 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_view.h"
+#include "../../src/models/search_index.h"
+#include "../../src/services/content_classifier.h"
+#include "../../src/services/history_search.h"
+
+/**
+ * @brief Microbenchmarks of the model layer
+ *
+ * Every benchmark runs at 100, 1k, 10k and 100k items over the same
+ * generated history, so results are comparable across commits. Nothing
+ * here asserts a time limit; compare the numbers instead:
+ *
+ *   clipboard-benchmarks -o results.csv,csv
+ *   clipboard-benchmarks -o results.xml,xml benchmarkAddItem
+ *
+ * Run with -median N or -minimumvalue to steady noisy machines. This is
+ * the clipboard-benchmarks target, not a ctest test.
+ */
+class BenchmarkModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    // History operations
+    void benchmarkAddItem_data();
+    void benchmarkAddItem();
+    void benchmarkAddDuplicate_data();
+    void benchmarkAddDuplicate();
+    void benchmarkPinUnpin_data();
+    void benchmarkPinUnpin();
+
+    // Serialization
+    void benchmarkToJson_data();
+    void benchmarkToJson();
+    void benchmarkFromJson_data();
+    void benchmarkFromJson();
+
+    // Item derivation
+    void benchmarkGenerateHash_data();
+    void benchmarkGenerateHash();
+    void benchmarkGeneratePreview_data();
+    void benchmarkGeneratePreview();
+    void benchmarkClassify_data();
+    void benchmarkClassify();
+
+    // Search
+    void benchmarkSearchIndex_data();
+    void benchmarkSearchIndex();
+    void benchmarkRank_data();
+    void benchmarkRank();
+
+private:
+    // Helper methods
+    void addSizeRows();
+    void fillHistory(ClipboardHistory& history, int count) const;
+
+    static constexpr int MAX_ITEM_COUNT = 100000;
+
+    QStringList m_texts;       ///< Generated texts, oldest first
+    qint64 m_startMs = 0;      ///< Timestamp of the oldest item
+};
+
+void BenchmarkModel::initTestCase()
+{
+    // Fixed seed: every run and every commit benchmarks the same history
+    const QStringList words = {"alpha", "bravo", "Charlie", "delta", "echo", "foxtrot",
+                               "golf", "Hotel", "india", "juliet", "lima", "mike",
+                               "https://example.com/path", "int main()", "SELECT *"};
+    QRandomGenerator random(29);
+
+    m_texts.reserve(MAX_ITEM_COUNT);
+    for (int i = 0; i < MAX_ITEM_COUNT; ++i) {
+        QStringList line;
+        const int wordCount = 3 + random.bounded(60);
+        for (int w = 0; w < wordCount; ++w) {
+            line.append(words.at(random.bounded(int(words.size()))));
+        }
+        line.append(QString::number(i));
+        m_texts.append(line.join(' '));
+    }
+    m_startMs = QDateTime::currentMSecsSinceEpoch() - MAX_ITEM_COUNT * 1000LL;
+}
+
+// History operations
+
+void BenchmarkModel::benchmarkAddItem_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkAddItem()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+
+    // The history is full, so each add also evicts the oldest item
+    int next = 0;
+    QBENCHMARK {
+        history.addItem(QStringLiteral("new content %1").arg(next++));
+    }
+    QCOMPARE(history.count(), itemCount);
+}
+
+void BenchmarkModel::benchmarkAddDuplicate_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkAddDuplicate()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+
+    // Re-copying moves the item to the top; walk the history oldest first
+    int next = 0;
+    QBENCHMARK {
+        history.addItem(m_texts.at(next));
+        next = (next + 1) % itemCount;
+    }
+    QCOMPARE(history.count(), itemCount);
+}
+
+void BenchmarkModel::benchmarkPinUnpin_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkPinUnpin()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+    const QString id = history.getItemAt(itemCount / 2).id();
+
+    QBENCHMARK {
+        history.pinItem(id);
+        history.unpinItem(id);
+    }
+    QCOMPARE(history.pinnedCount(), 0);
+}
+
+// Serialization
+
+void BenchmarkModel::benchmarkToJson_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkToJson()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+
+    QJsonObject json;
+    QBENCHMARK {
+        json = history.toJson();
+    }
+    QVERIFY(!json.isEmpty());
+}
+
+void BenchmarkModel::benchmarkFromJson_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkFromJson()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory source(itemCount);
+    fillHistory(source, itemCount);
+    const QJsonObject json = source.toJson();
+
+    ClipboardHistory loaded(itemCount);
+    QBENCHMARK {
+        loaded.fromJson(json);
+    }
+    QCOMPARE(loaded.count(), itemCount);
+}
+
+// Item derivation
+
+void BenchmarkModel::benchmarkGenerateHash_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkGenerateHash()
+{
+    QFETCH(int, itemCount);
+    int length = 0;
+    QBENCHMARK {
+        for (int i = 0; i < itemCount; ++i) {
+            length += int(ClipboardItem::generateHash(m_texts.at(i)).size());
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+void BenchmarkModel::benchmarkGeneratePreview_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkGeneratePreview()
+{
+    QFETCH(int, itemCount);
+    int length = 0;
+    QBENCHMARK {
+        for (int i = 0; i < itemCount; ++i) {
+            length += int(ClipboardItem::generatePreview(m_texts.at(i)).size());
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+// Search
+
+void BenchmarkModel::benchmarkClassify_data()
+{
+    // The full rule set should cost about the same as a single rule
+    QTest::addColumn<bool>("allRules");
+    QTest::newRow("one rule") << false;
+    QTest::newRow("all rules") << true;
+}
+
+void BenchmarkModel::benchmarkClassify()
+{
+    QFETCH(bool, allRules);
+    constexpr int COUNT = 10000;
+    int kept = 0;
+    QBENCHMARK {
+        for (int i = 0; i < COUNT; ++i) {
+            const ContentClassifier::Verdict verdict = allRules
+                ? ContentClassifier::classify(m_texts.at(i))
+                : ContentClassifier::classifyWith<ContentClassifier::EmptyRule>(m_texts.at(i));
+            kept += verdict == ContentClassifier::Keep ? 1 : 0;
+        }
+    }
+    QVERIFY(kept > 0);
+}
+
+void BenchmarkModel::benchmarkSearchIndex_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkSearchIndex()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+    SearchIndex index;
+    index.setItems(history.items());
+
+    SearchIndex::Matches matches;
+    QBENCHMARK {
+        matches = index.search("hotel");
+    }
+    QVERIFY(!matches.isEmpty());
+}
+
+void BenchmarkModel::benchmarkRank_data()
+{
+    addSizeRows();
+}
+
+void BenchmarkModel::benchmarkRank()
+{
+    QFETCH(int, itemCount);
+    ClipboardHistory history(itemCount);
+    fillHistory(history, itemCount);
+    const HistoryView view = history.view();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QList<HistorySearch::RankedItem> ranked;
+    QBENCHMARK {
+        ranked = HistorySearch::rank(view, "hotel", 50, now);
+    }
+    QVERIFY(!ranked.isEmpty());
+}
+
+// Helper methods
+
+void BenchmarkModel::addSizeRows()
+{
+    QTest::addColumn<int>("itemCount");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << MAX_ITEM_COUNT;
+}
+
+void BenchmarkModel::fillHistory(ClipboardHistory& history, int count) const
+{
+    history.beginUpdate();
+    for (int i = 0; i < count; ++i) {
+        history.addItem(ClipboardItem::fromFields(ClipboardItem::generateId(), m_texts.at(i), QString(),
+                                                  m_startMs + i * 1000LL, false, 0));
+    }
+    history.endUpdate();
+}
+
+QTEST_MAIN(BenchmarkModel)
+#include "benchmark_model.moc"
@@ -0,0 +1,209 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThreadPool>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_view.h"
+#include "../../src/models/text_matcher.h"
+#include "../../src/services/history_search.h"
+
+/**
+ * @brief Benchmarks for TextMatcher against QString::contains
+ *
+ * Every kernel the CPU supports scans the same generated history as the
+ * QString::contains(Qt::CaseInsensitive) baseline, and must find the same
+ * number of matches. Ranking is measured on one thread and sharded over
+ * the thread pool by HistorySearch.
+ */
+class TestTextMatcherBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    // Substring Scanning
+    void benchmarkContains_data();
+    void benchmarkContains();
+    void testVectorKernel_FasterThanQString();
+
+    // Ranking
+    void benchmarkRank();
+    void benchmarkRank_parallel();
+    void testParallelRank_ScalesWithCores();
+
+private:
+    // Helper methods
+    int countMatches(const QString& pattern, int kernel) const;
+
+    static constexpr int ITEM_COUNT = 50000;
+    static constexpr int BASELINE = -1;  ///< Kernel column value for QString::contains
+
+    QList<ClipboardItem> m_items;
+    QStringList m_texts;
+};
+
+void TestTextMatcherBenchmark::initTestCase()
+{
+    const QStringList words = {"alpha", "bravo", "Charlie", "delta", "echo", "foxtrot",
+                               "golf", "Hotel", "india", "juliet", "lima", "mike"};
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QRandomGenerator random(7);
+
+    m_items.reserve(ITEM_COUNT);
+    for (int i = 0; i < ITEM_COUNT; ++i) {
+        QStringList line;
+        int wordCount = 5 + random.bounded(40);
+        for (int w = 0; w < wordCount; ++w) {
+            line.append(words.at(random.bounded(int(words.size()))));
+        }
+        line.append(QString::number(i));
+        QString text = line.join(' ');
+        m_texts.append(text);
+        m_items.append(ClipboardItem::fromFields(QString("id-%1").arg(i), text, QString(),
+                                                 now - qint64(i) * 60000, i % 100 == 0, 0));
+    }
+}
+
+void TestTextMatcherBenchmark::cleanup()
+{
+    TextMatcher::setKernel(TextMatcher::bestKernel());
+}
+
+// Substring Scanning
+
+void TestTextMatcherBenchmark::benchmarkContains_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<int>("kernel");
+
+    const QStringList patterns = {"hotel india", "xray", "4217"};
+    for (const QString& pattern : patterns) {
+        QTest::newRow(qPrintable(pattern + " QString")) << pattern << int(BASELINE);
+        for (int kernel = TextMatcher::Scalar; kernel <= TextMatcher::bestKernel(); ++kernel) {
+            QString name = pattern + " " + TextMatcher::kernelName(TextMatcher::Kernel(kernel));
+            QTest::newRow(qPrintable(name)) << pattern << kernel;
+        }
+    }
+}
+
+void TestTextMatcherBenchmark::benchmarkContains()
+{
+    QFETCH(QString, pattern);
+    QFETCH(int, kernel);
+
+    const int expected = countMatches(pattern, BASELINE);
+    int found = 0;
+    QBENCHMARK {
+        found = countMatches(pattern, kernel);
+    }
+    QCOMPARE(found, expected);
+}
+
+void TestTextMatcherBenchmark::testVectorKernel_FasterThanQString()
+{
+    if (TextMatcher::bestKernel() == TextMatcher::Scalar) {
+        QSKIP("No vector kernel on this CPU");
+    }
+
+    const QString pattern = "hotel india";
+    QElapsedTimer timer;
+
+    timer.start();
+    int baseline = countMatches(pattern, BASELINE);
+    qint64 baselineNs = timer.nsecsElapsed();
+
+    timer.restart();
+    int vectorized = countMatches(pattern, TextMatcher::bestKernel());
+    qint64 vectorizedNs = timer.nsecsElapsed();
+
+    qDebug() << "QString::contains:" << baselineNs / 1000 << "us,"
+             << TextMatcher::kernelName(TextMatcher::bestKernel()) << vectorizedNs / 1000 << "us";
+
+    QCOMPARE(vectorized, baseline);
+    QVERIFY(vectorizedNs < baselineNs);
+}
+
+// Ranking
+
+void TestTextMatcherBenchmark::benchmarkRank()
+{
+    const TextMatcher matcher("hotel");
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QList<TextMatcher::RankedItem> ranked;
+    QBENCHMARK {
+        ranked = matcher.rank(m_items, 50, now);
+    }
+    QCOMPARE(ranked.size(), 50);
+    for (int i = 1; i < ranked.size(); ++i) {
+        QVERIFY(ranked.at(i - 1).score >= ranked.at(i).score);
+    }
+}
+
+void TestTextMatcherBenchmark::benchmarkRank_parallel()
+{
+    const HistoryView view(1, QList<ClipboardItem>(), m_items);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QList<TextMatcher::RankedItem> ranked;
+    QBENCHMARK {
+        ranked = HistorySearch::rank(view, "hotel", 50, now);
+    }
+    QCOMPARE(ranked.size(), 50);
+}
+
+void TestTextMatcherBenchmark::testParallelRank_ScalesWithCores()
+{
+    const HistoryView view(1, QList<ClipboardItem>(), m_items);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const TextMatcher matcher("hotel india");
+    QElapsedTimer timer;
+
+    timer.start();
+    QList<TextMatcher::RankedItem> single = matcher.rank(m_items, 50, now);
+    qint64 singleNs = timer.nsecsElapsed();
+
+    timer.restart();
+    QList<TextMatcher::RankedItem> sharded = HistorySearch::rank(view, "hotel india", 50, now);
+    qint64 shardedNs = timer.nsecsElapsed();
+
+    const int threads = QThreadPool::globalInstance()->maxThreadCount();
+    qDebug() << "Ranking" << ITEM_COUNT << "items - 1 thread:" << singleNs / 1000 << "us,"
+             << threads << "threads:" << shardedNs / 1000 << "us";
+
+    QCOMPARE(sharded.size(), single.size());
+    for (int i = 0; i < single.size(); ++i) {
+        QCOMPARE(sharded.at(i).index, single.at(i).index);
+    }
+    if (threads >= 4) {
+        QVERIFY(shardedNs < singleNs);
+    }
+}
+
+// Helper Methods
+
+int TestTextMatcherBenchmark::countMatches(const QString& pattern, int kernel) const
+{
+    int count = 0;
+    if (kernel == BASELINE) {
+        for (const QString& text : m_texts) {
+            count += text.contains(pattern, Qt::CaseInsensitive) ? 1 : 0;
+        }
+        return count;
+    }
+
+    TextMatcher::setKernel(TextMatcher::Kernel(kernel));
+    const TextMatcher matcher(pattern);
+    for (const QString& text : m_texts) {
+        count += matcher.contains(text) ? 1 : 0;
+    }
+    return count;
+}
+
+QTEST_MAIN(TestTextMatcherBenchmark)
+#include "test_text_matcher_benchmark.moc"
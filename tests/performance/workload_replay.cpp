@@ -0,0 +1,221 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocale>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../../src/lib/latency_trace.h"
+#include "../../src/services/clipboard_manager.h"
+#include "../../src/services/workload_trace.h"
+
+/**
+ * clipboard-workload - Generate and replay clipboard workload traces
+ *
+ *   clipboard-workload generate burst --events 5000 -o burst.trace
+ *   clipboard-workload replay burst.trace --speed 10
+ *   clipboard-manager --record-trace session.trace   # record a real session
+ *
+ * Replays feed every event straight to ClipboardManager::processText() in
+ * a throwaway configuration directory, headless, at the recorded pace
+ * scaled by --speed (0 replays as fast as possible). The report gives
+ * throughput, per-event latency percentiles, allocations during
+ * processing and the memory held by the history at the end.
+ *
+ * This is a tool target, not a ctest test.
+ */
+
+namespace {
+
+// C++ allocations made while an event is processed. Qt containers allocate
+// through malloc, so the heap figures below complete the picture.
+std::atomic<bool> g_countAllocations{false};
+std::atomic<quint64> g_allocations{0};
+std::atomic<quint64> g_allocatedBytes{0};
+
+void* countedAllocate(std::size_t size)
+{
+    if (g_countAllocations.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+qint64 heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+qint64 peakResidentKb()
+{
+    // Linux only; reported as unknown elsewhere
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    while (!status.atEnd()) {
+        const QByteArray line = status.readLine();
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').constFirst().toLongLong();
+        }
+    }
+    return -1;
+}
+
+QString formatBytes(qint64 bytes)
+{
+    return bytes < 0 ? QString("unknown") : QLocale::c().formattedDataSize(bytes, 1);
+}
+
+QString formatNsecs(qint64 nsecs)
+{
+    return nsecs >= 1000 * 1000 ? QString("%1 ms").arg(double(nsecs) / 1e6, 0, 'f', 2)
+                                : QString("%1 us").arg(double(nsecs) / 1e3, 0, 'f', 1);
+}
+
+int generate(const QCommandLineParser& parser, QTextStream& out, QTextStream& err)
+{
+    bool ok = false;
+    const WorkloadTrace::Pattern pattern = WorkloadTrace::patternFromName(parser.positionalArguments().value(1), &ok);
+    const int events = parser.value("events").toInt();
+    const QString output = parser.value("output");
+    if (!ok || events <= 0 || output.isEmpty()) {
+        err << "Usage: clipboard-workload generate <burst|giant|duplicates> --events N -o FILE\n";
+        return 2;
+    }
+
+    const WorkloadTrace trace = WorkloadTrace::generate(pattern, events, parser.value("seed").toUInt());
+    if (!trace.save(output)) {
+        return 1;
+    }
+    out << "Wrote " << trace.count() << " events (" << trace.duplicateCount() << " duplicates) over "
+        << trace.durationMs() / 1000.0 << " s to " << output << "\n";
+    return 0;
+}
+
+int replay(const QCommandLineParser& parser, QTextStream& out, QTextStream& err)
+{
+    WorkloadTrace trace;
+    if (!trace.load(parser.positionalArguments().value(1))) {
+        err << "Usage: clipboard-workload replay FILE [--speed X] [--history-limit N]\n";
+        return 2;
+    }
+    const double speed = parser.value("speed").toDouble();
+
+    ClipboardManager manager;
+    if (parser.isSet("history-limit")) {
+        manager.setMaxHistoryItems(parser.value("history-limit").toInt());
+    }
+
+    LatencyHistogram latency;
+    int added = 0;
+    const qint64 heapBefore = heapInUse();
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < trace.count(); ++i) {
+        // Synthesized up front so only processing is measured
+        const QString content = trace.contentAt(i);
+        if (speed > 0) {
+            const qint64 due = qint64(double(trace.events().at(i).offsetMs) / speed);
+            for (qint64 wait = due - clock.elapsed(); wait > 0; wait = due - clock.elapsed()) {
+                QCoreApplication::processEvents();
+                QThread::msleep(qMin<qint64>(wait, 10));
+            }
+        }
+
+        QElapsedTimer timer;
+        g_countAllocations = true;
+        timer.start();
+        added += manager.processText(content) ? 1 : 0;
+        latency.record(timer.nsecsElapsed());
+        g_countAllocations = false;
+        QCoreApplication::processEvents();
+    }
+    const qint64 elapsedMs = qMax<qint64>(1, clock.elapsed());
+    const ClipboardHistory::MemoryUsage memory = manager.memoryUsage();
+    const qint64 heapAfter = heapInUse();
+
+    out << "Replayed " << trace.count() << " events (" << trace.duplicateCount() << " duplicates) in "
+        << elapsedMs / 1000.0 << " s"
+        << (speed > 0 ? QString(" at %1x").arg(speed) : QString(" unpaced")) << "\n";
+    out << "Throughput: " << QString::number(trace.count() * 1000.0 / elapsedMs, 'f', 1)
+        << " events/s, " << added << " added\n";
+    out << "Latency: p50 " << formatNsecs(latency.percentile(50))
+        << ", p90 " << formatNsecs(latency.percentile(90))
+        << ", p99 " << formatNsecs(latency.percentile(99))
+        << ", max " << formatNsecs(latency.max()) << "\n";
+    out << "Allocations: " << g_allocations.load() << " operator new, "
+        << formatBytes(qint64(g_allocatedBytes.load())) << " requested\n";
+    out << "Heap in use: " << formatBytes(heapBefore) << " before, " << formatBytes(heapAfter) << " after\n";
+    out << "History: " << memory.hotItems << " items in memory, " << memory.coldEntries << " on disk, "
+        << formatBytes(memory.totalBytes()) << "\n";
+    const qint64 peakKb = peakResidentKb();
+    out << "Peak RSS: " << formatBytes(peakKb < 0 ? -1 : peakKb * 1024) << "\n";
+    return 0;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char* argv[])
+{
+    // Headless, and never touching the user's history
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QTemporaryDir home;
+    if (!home.isValid()) {
+        return 1;
+    }
+    qputenv("XDG_CONFIG_HOME", home.filePath("config").toLocal8Bit());
+    qputenv("XDG_DATA_HOME", home.filePath("data").toLocal8Bit());
+    qputenv("XDG_CACHE_HOME", home.filePath("cache").toLocal8Bit());
+
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate and replay clipboard workload traces");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "generate <burst|giant|duplicates> or replay <file>");
+    parser.addOption({"events", "Number of generated events", "count", "1000"});
+    parser.addOption({"seed", "Seed of generated traces", "seed", "1"});
+    parser.addOption({{"o", "output"}, "File a generated trace is written to", "file"});
+    parser.addOption({"speed", "Replay speed factor (0 = as fast as possible)", "factor", "1"});
+    parser.addOption({"history-limit", "Maximum history items during replay", "count"});
+    parser.process(app);
+
+    const QString command = parser.positionalArguments().value(0);
+    if (command == "generate") {
+        return generate(parser, out, err);
+    }
+    if (command == "replay") {
+        return replay(parser, out, err);
+    }
+    parser.showHelp(2);
+}
@@ -0,0 +1,217 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include "../../src/models/blob_store.h"
+#include "../../src/models/clipboard_item.h"
+#include "../../src/services/payload_mime_data.h"
+
+/**
+ * @brief Unit tests for the content-addressed BlobStore
+ *
+ * These tests verify that payloads are stored once per content, read back
+ * through a mapping without being copied, and swept once unreferenced;
+ * and that PayloadMimeData serves pasted items straight from that mapping.
+ */
+class TestBlobStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Storage
+    void testPut_storesOncePerContent();
+    void testPut_rejectsEmptyData();
+    void testOpen_mapsStoredBytes();
+    void testKeys_rejectMalformedKeys();
+    void testCollectGarbage_keepsLiveKeys();
+
+    // Paste Back
+    void testMimeData_servesMappedBytes();
+    void testMimeData_offersImageAndText();
+    void testMimeData_decodesOnce();
+
+private:
+    // Helper methods
+    int blobFileCount() const;
+    ClipboardItem createPayloadItem(const QString& mimeType, const QByteArray& data,
+                                    const QString& text);
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QScopedPointer<BlobStore> m_store;
+};
+
+void TestBlobStore::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+    m_store.reset(new BlobStore(m_dir->filePath("blobs")));
+}
+
+// Storage
+
+void TestBlobStore::testPut_storesOncePerContent()
+{
+    QByteArray screenshot(5 * 1024 * 1024, 'x');
+    QString key = m_store->put(screenshot);
+    QCOMPARE(key, BlobStore::keyFor(screenshot));
+    QVERIFY(BlobStore::isValidKey(key));
+    QVERIFY(m_store->contains(key));
+
+    QCOMPARE(m_store->put(screenshot), key);
+    QCOMPARE(blobFileCount(), 1);
+
+    QString other = m_store->put("other content");
+    QVERIFY(other != key);
+    QCOMPARE(blobFileCount(), 2);
+    QVERIFY(m_store->filePath(key).startsWith(m_store->directory() + "/" + key.left(2) + "/"));
+}
+
+void TestBlobStore::testPut_rejectsEmptyData()
+{
+    QVERIFY(m_store->put(QByteArray()).isEmpty());
+    QCOMPARE(blobFileCount(), 0);
+}
+
+void TestBlobStore::testOpen_mapsStoredBytes()
+{
+    QByteArray data("payload bytes");
+    QString key = m_store->put(data);
+
+    BlobStore::Blob blob = m_store->open(key);
+    QVERIFY(blob.isValid());
+    QCOMPARE(blob.size(), qint64(data.size()));
+    QCOMPARE(blob.bytes(), data);
+
+    // Copies share the mapping, so the bytes are never duplicated
+    BlobStore::Blob copy = blob;
+    QCOMPARE(copy.bytes().constData(), blob.bytes().constData());
+
+    QVERIFY(!m_store->open(BlobStore::keyFor("never stored")).isValid());
+}
+
+void TestBlobStore::testKeys_rejectMalformedKeys()
+{
+    QVERIFY(!BlobStore::isValidKey(QString()));
+    QVERIFY(!BlobStore::isValidKey("../../etc/passwd"));
+    QVERIFY(!BlobStore::isValidKey(QString(64, QLatin1Char('A'))));
+    QVERIFY(!BlobStore::isValidKey(QString(63, QLatin1Char('a'))));
+    QVERIFY(m_store->filePath("../outside").isEmpty());
+    QVERIFY(!m_store->open("../outside").isValid());
+    QVERIFY(!m_store->remove("../outside"));
+}
+
+void TestBlobStore::testCollectGarbage_keepsLiveKeys()
+{
+    QString live = m_store->put("still referenced");
+    QString dead = m_store->put("no longer referenced");
+    QFile stray(m_store->directory() + "/notes.txt");
+    QVERIFY(stray.open(QIODevice::WriteOnly));
+    stray.close();
+
+    QCOMPARE(m_store->collectGarbage({live}), 1);
+    QVERIFY(m_store->contains(live));
+    QVERIFY(!m_store->contains(dead));
+    QVERIFY(QFile::exists(stray.fileName()));
+
+    QVERIFY(m_store->remove(live));
+    QVERIFY(!m_store->remove(live));
+}
+
+// Paste Back
+
+void TestBlobStore::testMimeData_servesMappedBytes()
+{
+    QByteArray text = QByteArray("large text ").repeated(2000);
+    ClipboardItem item = createPayloadItem("text/plain", text, "large text");
+    BlobStore::Blob blob = m_store->open(item.payload().key);
+
+    PayloadMimeData mimeData(item, blob);
+    QVERIFY(mimeData.hasText());
+    QCOMPARE(mimeData.formats(), QStringList{"text/plain"});
+    QCOMPARE(mimeData.text(), QString::fromUtf8(text));
+
+    // Raw requests are answered from the mapping itself
+    QCOMPARE(mimeData.data("text/plain").constData(), blob.bytes().constData());
+}
+
+void TestBlobStore::testMimeData_offersImageAndText()
+{
+    QImage image(8, 4, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "PNG"));
+
+    ClipboardItem imageItem = createPayloadItem("image/png", png, "Image 8x4");
+    PayloadMimeData imageData(imageItem, m_store->open(imageItem.payload().key));
+    QVERIFY(imageData.hasImage());
+    QCOMPARE(imageData.data("image/png"), png);
+    QCOMPARE(qvariant_cast<QImage>(imageData.imageData()).size(), image.size());
+
+    ClipboardItem listItem = createPayloadItem("text/uri-list", "file:///tmp/a.txt\r\n", "/tmp/a.txt");
+    PayloadMimeData listData(listItem, m_store->open(listItem.payload().key));
+    QVERIFY(listData.hasUrls());
+    QCOMPARE(listData.urls(), QList<QUrl>{QUrl::fromLocalFile("/tmp/a.txt")});
+    QCOMPARE(listData.text(), QString("/tmp/a.txt"));
+}
+
+void TestBlobStore::testMimeData_decodesOnce()
+{
+    QImage image(16, 16, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "PNG"));
+    
+    ClipboardItem imageItem = createPayloadItem("image/png", png, "Image 16x16");
+    PayloadMimeData imageData(imageItem, m_store->open(imageItem.payload().key));
+    
+    // Raw requests never decode
+    QCOMPARE(imageData.data("image/png"), png);
+    QVERIFY(!imageData.isDecoded());
+    
+    // Every later image request shares the first decode
+    QImage first = qvariant_cast<QImage>(imageData.imageData());
+    QVERIFY(imageData.isDecoded());
+    QCOMPARE(qvariant_cast<QImage>(imageData.imageData()).cacheKey(), first.cacheKey());
+    
+    QByteArray text = QByteArray("decoded once ").repeated(1000);
+    ClipboardItem textItem = createPayloadItem("text/plain", text, "decoded once");
+    PayloadMimeData textData(textItem, m_store->open(textItem.payload().key));
+    QVERIFY(!textData.isDecoded());
+    QCOMPARE(textData.text().constData(), textData.text().constData());
+    QVERIFY(textData.isDecoded());
+}
+
+// Helper methods
+
+int TestBlobStore::blobFileCount() const
+{
+    int count = 0;
+    QDirIterator it(m_store->directory(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        ++count;
+    }
+    return count;
+}
+
+ClipboardItem TestBlobStore::createPayloadItem(const QString& mimeType, const QByteArray& data,
+                                               const QString& text)
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = mimeType;
+    payload.key = m_store->put(data);
+    payload.size = data.size();
+    return ClipboardItem::fromPayload(payload, text, QString());
+}
+
+QTEST_MAIN(TestBlobStore)
+#include "test_blob_store.moc"
@@ -0,0 +1,794 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/clipboard_item.h"
+
+/**
+ * @brief Unit tests for ClipboardHistory ordering and lookup invariants
+ *
+ * These tests verify that the id and content-hash indexes stay consistent
+ * with the display order across every mutating operation.
+ */
+class TestClipboardHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Index Lookups
+    void testFindItemIndex_afterAdds();
+    void testHasDuplicate();
+    void testDuplicateAdd_updatesIndex();
+    void testAddText_recopyRefreshesItem();
+    void testRemoveItem_updatesIndex();
+    void testPinUnpin_updatesIndex();
+    void testSizeLimit_updatesIndex();
+    void testFromJson_buildsIndex();
+    void testFromJson_largeHistoryKeepsOrder();
+    void testClear_keepsPinnedIndexed();
+
+    // Ordering
+    void testInsertOutOfOrder_keepsTimestampOrder();
+    void testPinnedSegment_orderedByTimestamp();
+
+    // Cold Tier
+    void testColdTier_demotesBeyondHotLimit();
+    void testColdTier_loadsTextOnDemand();
+    void testColdTier_reopenRestoresEntries();
+    void testColdTier_duplicatePromotesItem();
+    void testColdTier_pinAndRemove();
+    void testColdTier_removalsPromoteColdItems();
+    void testColdTier_findsItemsByPreview();
+    void testColdTier_sizeLimitEvictsColdFirst();
+    void testColdTier_clearReportsOneBatch();
+    void testColdTier_keepsPayloadReferences();
+
+    // Retention
+    void testRetention_evictsOldItemsInOneBatch();
+    void testRetention_keepsNewestWithinBudget();
+    void testRetention_evictsOversizeColdItems();
+
+    // Change Deltas
+    void testDeltas_mirrorItems();
+    void testDeltas_duplicateAddIsMove();
+    void testDeltas_demotionRemovesTail();
+    void testDeltas_loadEmitsReset();
+    void testUpdateBatch_emitsOrderChangedOnce();
+
+private:
+    // Helper methods
+    ClipboardItem createItem(const QString& text, int secondsAgo);
+    QStringList fillTieredHistory(ClipboardHistory& history, const QString& coldPath, int itemCount);
+    void verifyIndexConsistency(const ClipboardHistory& history);
+    void trackDeltas(ClipboardHistory& history, QStringList* ids);
+    QStringList itemIds(const ClipboardHistory& history);
+};
+
+// Index Lookups
+
+void TestClipboardHistory::testFindItemIndex_afterAdds()
+{
+    ClipboardHistory history;
+    QString oldest = history.addItem(createItem("Oldest", 30));
+    QString middle = history.addItem(createItem("Middle", 20));
+    QString newest = history.addItem(createItem("Newest", 10));
+
+    QCOMPARE(history.findItemIndex(newest), 0);
+    QCOMPARE(history.findItemIndex(middle), 1);
+    QCOMPARE(history.findItemIndex(oldest), 2);
+    QCOMPARE(history.findItemIndex("missing-id"), -1);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testHasDuplicate()
+{
+    ClipboardHistory history;
+    history.addItem(createItem("Duplicate me", 10));
+
+    QVERIFY(history.hasDuplicate("Duplicate me"));
+    QVERIFY(!history.hasDuplicate("Something else"));
+}
+
+void TestClipboardHistory::testDuplicateAdd_updatesIndex()
+{
+    ClipboardHistory history;
+    QString firstId = history.addItem(createItem("Repeated", 30));
+    history.addItem(createItem("Other", 20));
+
+    QString updatedId = history.addItem(createItem("Repeated", 10));
+
+    QCOMPARE(history.count(), 2);
+    QVERIFY(!history.hasItem(firstId));
+    QVERIFY(history.hasItem(updatedId));
+    QCOMPARE(history.findItemIndex(updatedId), 0);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testAddText_recopyRefreshesItem()
+{
+    ClipboardHistory history;
+    QString pinnedId = history.addItem("  Pinned\n text  ");
+    QString firstId = history.addItem("Repeated");
+    history.addItem("Other");
+    history.pinItem(pinnedId);
+
+    QSignalSpy addedSpy(&history, &ClipboardHistory::itemAdded);
+    QSignalSpy updatedSpy(&history, &ClipboardHistory::itemUpdated);
+
+    QString updatedId = history.addItem("Repeated");
+    QVERIFY(!updatedId.isEmpty());
+    QVERIFY(updatedId != firstId);
+    QCOMPARE(history.count(), 3);
+    QCOMPARE(history.findItemIndex(updatedId), 1);
+    QCOMPARE(history.getItem(updatedId).preview(), QString("Repeated"));
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(updatedSpy.count(), 1);
+
+    // Re-copying pinned content keeps it pinned and keeps its preview
+    QString repinnedId = history.addItem("  Pinned\n text  ");
+    QVERIFY(history.getItem(repinnedId).pinned());
+    QCOMPARE(history.getItem(repinnedId).preview(), QString("Pinned text"));
+    QCOMPARE(history.count(), 3);
+
+    // Whitespace-only text never becomes an item
+    QVERIFY(history.addItem(" \n\t ").isEmpty());
+    QCOMPARE(addedSpy.count(), 0);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testRemoveItem_updatesIndex()
+{
+    ClipboardHistory history;
+    QString oldest = history.addItem(createItem("Oldest", 30));
+    QString middle = history.addItem(createItem("Middle", 20));
+    history.addItem(createItem("Newest", 10));
+
+    QVERIFY(history.removeItem(middle));
+
+    QVERIFY(!history.hasItem(middle));
+    QVERIFY(!history.hasDuplicate("Middle"));
+    QCOMPARE(history.findItemIndex(oldest), 1);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testPinUnpin_updatesIndex()
+{
+    ClipboardHistory history;
+    QString oldest = history.addItem(createItem("Oldest", 30));
+    history.addItem(createItem("Middle", 20));
+    history.addItem(createItem("Newest", 10));
+
+    QVERIFY(history.pinItem(oldest));
+    QCOMPARE(history.findItemIndex(oldest), 0);
+    QCOMPARE(history.pinnedCount(), 1);
+    verifyIndexConsistency(history);
+
+    QVERIFY(history.unpinItem(oldest));
+    QCOMPARE(history.findItemIndex(oldest), 2);
+    QCOMPARE(history.pinnedCount(), 0);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testSizeLimit_updatesIndex()
+{
+    ClipboardHistory history(10);
+    QStringList ids;
+    for (int i = 0; i < 15; ++i) {
+        ids.append(history.addItem(createItem(QString("Item %1").arg(i), 100 - i)));
+    }
+
+    QCOMPARE(history.count(), 10);
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(!history.hasItem(ids.at(i)));
+        QVERIFY(!history.hasDuplicate(QString("Item %1").arg(i)));
+    }
+    for (int i = 5; i < 15; ++i) {
+        QCOMPARE(history.findItemIndex(ids.at(i)), 14 - i);
+    }
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testFromJson_buildsIndex()
+{
+    ClipboardHistory source;
+    source.addItem(createItem("First", 20));
+    QString pinnedId = source.addItem(createItem("Second", 10));
+    source.pinItem(pinnedId);
+
+    ClipboardHistory loaded(source.toJson());
+
+    QCOMPARE(loaded.count(), 2);
+    QCOMPARE(loaded.findItemIndex(pinnedId), 0);
+    QVERIFY(loaded.hasDuplicate("First"));
+    verifyIndexConsistency(loaded);
+}
+
+void TestClipboardHistory::testFromJson_largeHistoryKeepsOrder()
+{
+    // Enough items to be decoded in several chunks
+    ClipboardHistory source(10000);
+    for (int i = 0; i < 5000; ++i) {
+        source.addItem(createItem(QString("Entry %1").arg(i), 5000 - i));
+    }
+    source.pinItem(source.getItemAt(2500).id());
+
+    QJsonObject json = source.toJson();
+    QJsonArray items = json["items"].toArray();
+    items.insert(1200, QJsonValue("not an item"));
+    json["items"] = items;
+
+    ClipboardHistory loaded(json);
+    QCOMPARE(loaded.count(), source.count());
+    QCOMPARE(itemIds(loaded), itemIds(source));
+    verifyIndexConsistency(loaded);
+}
+
+void TestClipboardHistory::testClear_keepsPinnedIndexed()
+{
+    ClipboardHistory history;
+    QString pinnedId = history.addItem(createItem("Pinned", 30));
+    history.addItem(createItem("Loose 1", 20));
+    history.addItem(createItem("Loose 2", 10));
+    history.pinItem(pinnedId);
+
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemoved);
+    QSignalSpy batchSpy(&history, &ClipboardHistory::itemsRemoved);
+    history.clear();
+
+    // One batch instead of a signal per item
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(batchSpy.count(), 1);
+    QCOMPARE(batchSpy.first().first().toStringList().size(), 2);
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history.findItemIndex(pinnedId), 0);
+    QVERIFY(!history.hasDuplicate("Loose 1"));
+    verifyIndexConsistency(history);
+}
+
+// Ordering
+
+void TestClipboardHistory::testInsertOutOfOrder_keepsTimestampOrder()
+{
+    ClipboardHistory history;
+    history.addItem(createItem("Ten", 10));
+    history.addItem(createItem("Thirty", 30));
+    history.addItem(createItem("Twenty", 20));
+    history.addItem(createItem("Five", 5));
+
+    const QList<ClipboardItem> items = history.items();
+    QCOMPARE(items.size(), 4);
+    QCOMPARE(items.at(0).text(), QString("Five"));
+    QCOMPARE(items.at(1).text(), QString("Ten"));
+    QCOMPARE(items.at(2).text(), QString("Twenty"));
+    QCOMPARE(items.at(3).text(), QString("Thirty"));
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testPinnedSegment_orderedByTimestamp()
+{
+    ClipboardHistory history;
+    QString oldest = history.addItem(createItem("Oldest", 30));
+    QString middle = history.addItem(createItem("Middle", 20));
+    QString newest = history.addItem(createItem("Newest", 10));
+
+    // Pin out of timestamp order; pinned items still sort newest first
+    QVERIFY(history.pinItem(oldest));
+    QVERIFY(history.pinItem(newest));
+
+    const QList<ClipboardItem> items = history.items();
+    QCOMPARE(items.at(0).id(), newest);
+    QCOMPARE(items.at(1).id(), oldest);
+    QCOMPARE(items.at(2).id(), middle);
+    QCOMPARE(history.pinnedItems().size(), 2);
+    QCOMPARE(history.unpinnedItems().size(), 1);
+    verifyIndexConsistency(history);
+}
+
+// Cold Tier
+
+void TestClipboardHistory::testColdTier_demotesBeyondHotLimit()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    QCOMPARE(history.count(), 25);
+    QCOMPARE(history.hotCount(), 10);
+    QCOMPARE(history.coldCount(), 15);
+    QCOMPARE(history.items().size(), 10);
+    QCOMPARE(history.items().first().id(), ids.last());
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testColdTier_loadsTextOnDemand()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    // The oldest item only lives on disk
+    QCOMPARE(history.findItemIndex(ids.first()), 24);
+    QCOMPARE(history.getItem(ids.first()).text(), QString("Item 0"));
+    QCOMPARE(history.getItemAt(24).id(), ids.first());
+    QVERIFY(history.getItemAt(24).isValid());
+    QVERIFY(history.hasDuplicate("Item 0"));
+}
+
+void TestClipboardHistory::testColdTier_reopenRestoresEntries()
+{
+    QTemporaryDir dir;
+    QString coldPath = dir.filePath("history.cold");
+    QJsonObject hotJson;
+    QStringList ids;
+    {
+        ClipboardHistory history(1000);
+        ids = fillTieredHistory(history, coldPath, 25);
+        hotJson = history.toJson();
+    }
+
+    QCOMPARE(hotJson["items"].toArray().size(), 10);
+
+    ClipboardHistory reopened(1000);
+    reopened.setHotItemLimit(10);
+    QVERIFY(reopened.attachColdStore(coldPath));
+    QVERIFY(reopened.fromJson(hotJson));
+
+    QCOMPARE(reopened.count(), 25);
+    QCOMPARE(reopened.coldCount(), 15);
+    QCOMPARE(reopened.getItem(ids.at(3)).text(), QString("Item 3"));
+    QCOMPARE(reopened.findItemIndex(ids.first()), 24);
+}
+
+void TestClipboardHistory::testColdTier_duplicatePromotesItem()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    QString updatedId = history.addItem("Item 2");
+
+    QCOMPARE(history.count(), 25);
+    QCOMPARE(history.hotCount(), 10);
+    QVERIFY(!history.hasItem(ids.at(2)));
+    QCOMPARE(history.findItemIndex(updatedId), 0);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testColdTier_pinAndRemove()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    QVERIFY(history.pinItem(ids.at(1)));
+    QCOMPARE(history.findItemIndex(ids.at(1)), 0);
+    QCOMPARE(history.getItem(ids.at(1)).text(), QString("Item 1"));
+    QCOMPARE(history.coldCount(), 14);
+
+    QVERIFY(history.removeItem(ids.at(0)));
+    QVERIFY(!history.hasItem(ids.at(0)));
+    QVERIFY(!history.hasDuplicate("Item 0"));
+    QCOMPARE(history.count(), 24);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testColdTier_removalsPromoteColdItems()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList mirrored;
+    trackDeltas(history, &mirrored);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    // Items 15-24 are hot; the newest cold item refills a freed slot
+    QVERIFY(history.removeItem(ids.at(20)));
+    QCOMPARE(history.hotCount(), 10);
+    QCOMPARE(history.coldCount(), 14);
+    QCOMPARE(history.items().last().id(), ids.at(14));
+    QCOMPARE(history.items().last().text(), QString("Item 14"));
+    QCOMPARE(mirrored, itemIds(history));
+
+    // Pinning a hot item frees an unpinned slot as well
+    QVERIFY(history.pinItem(ids.at(24)));
+    QCOMPARE(history.hotCount(), 11);
+    QCOMPARE(history.coldCount(), 13);
+    QCOMPARE(history.items().last().id(), ids.at(13));
+    QCOMPARE(mirrored, itemIds(history));
+
+    // Retention evictions are refilled within the same batch
+    const QString largeId = history.addItem(createItem(QString(5000, 'x'), 1));
+    QCOMPARE(history.coldCount(), 14);
+    ClipboardHistory::RetentionPolicy policy;
+    policy.maxItemBytes = 1000;
+    history.setRetentionPolicy(policy);
+    QSignalSpy batchSpy(&history, &ClipboardHistory::itemsRemoved);
+    QCOMPARE(history.applyRetention(QDateTime::currentMSecsSinceEpoch()), QStringList{largeId});
+    QCOMPARE(batchSpy.count(), 1);
+    QCOMPARE(history.hotCount(), 11);
+    QCOMPARE(history.coldCount(), 13);
+    QCOMPARE(history.items().last().id(), ids.at(13));
+    QCOMPARE(mirrored, itemIds(history));
+
+    // Raising the limit promotes too, until the cold tier is empty
+    history.setHotItemLimit(100);
+    QCOMPARE(history.coldCount(), 0);
+    QCOMPARE(history.count(), 24);
+    QCOMPARE(mirrored, itemIds(history));
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testColdTier_findsItemsByPreview()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    // Items 0-14 are cold; hot items are never reported
+    const QList<ClipboardItem> found = history.findColdItems("ITEM 1", 100);
+    QStringList foundIds;
+    for (const ClipboardItem& item : found) {
+        QVERIFY(!item.hasText());
+        foundIds.append(item.id());
+    }
+    QCOMPARE(foundIds, (QStringList{ids.at(14), ids.at(13), ids.at(12), ids.at(11), ids.at(10), ids.at(1)}));
+
+    QCOMPARE(history.findColdItems("Item 1", 2).size(), 2);
+    QVERIFY(history.findColdItems("Item 20", 100).isEmpty());
+    QVERIFY(history.findColdItems(QString(), 100).isEmpty());
+}
+
+void TestClipboardHistory::testColdTier_keepsPayloadReferences()
+{
+    QTemporaryDir dir;
+    QString coldPath = dir.filePath("history.cold");
+    ClipboardItem::Payload payload;
+    payload.mimeType = "image/png";
+    payload.key = QString(64, QLatin1Char('e'));
+    payload.size = 2048;
+
+    QString imageId;
+    {
+        ClipboardHistory history(1000);
+        history.setHotItemLimit(10);
+        QVERIFY(history.attachColdStore(coldPath));
+        imageId = history.addItem(ClipboardItem::fromPayload(payload, "Image 64x64", QString()));
+        for (int i = 0; i < 20; ++i) {
+            history.addItem(QString("Item %1").arg(i));
+        }
+        QVERIFY(history.findItemIndex(imageId) >= history.hotCount());
+        QCOMPARE(history.payloadKeys(), QSet<QString>{payload.key});
+    }
+
+    // Reopening reads the reference back from the cold segment
+    ClipboardHistory reopened(1000);
+    reopened.setHotItemLimit(10);
+    QVERIFY(reopened.attachColdStore(coldPath));
+    QCOMPARE(reopened.payloadKeys(), QSet<QString>{payload.key});
+    ClipboardItem image = reopened.getItem(imageId);
+    QVERIFY(image.hasPayload());
+    QCOMPARE(image.payload().size, payload.size);
+    QCOMPARE(image.text(), QString("Image 64x64"));
+
+    // Re-copying the same payload promotes the item and keeps its reference
+    QString refreshedId = reopened.addItem(ClipboardItem::fromPayload(payload, "Image 64x64", QString()));
+    QCOMPARE(reopened.findItemIndex(refreshedId), 0);
+    QVERIFY(!reopened.hasItem(imageId));
+    QCOMPARE(reopened.getItem(refreshedId).payload().key, payload.key);
+}
+
+void TestClipboardHistory::testColdTier_sizeLimitEvictsColdFirst()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemoved);
+    history.setMaxItems(12);
+
+    QCOMPARE(removedSpy.count(), 13);
+    QCOMPARE(history.count(), 12);
+    QCOMPARE(history.coldCount(), 2);
+    QVERIFY(!history.hasItem(ids.at(12)));
+    QVERIFY(history.hasItem(ids.at(13)));
+}
+
+void TestClipboardHistory::testColdTier_clearReportsOneBatch()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+    QVERIFY(history.coldCount() > 0);
+    QVERIFY(history.pinItem(ids.at(24)));
+
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemoved);
+    QSignalSpy batchSpy(&history, &ClipboardHistory::itemsRemoved);
+    QSignalSpy clearedSpy(&history, &ClipboardHistory::historyCleared);
+    history.clear();
+
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(batchSpy.count(), 1);
+    QCOMPARE(clearedSpy.count(), 1);
+    const QStringList removed = batchSpy.first().first().toStringList();
+    QCOMPARE(removed.size(), 24);
+    QVERIFY(!removed.contains(ids.at(24)));
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(history.coldCount(), 0);
+    QVERIFY(!history.hasDuplicate("Item 3"));
+    verifyIndexConsistency(history);
+
+    history.clearAll();
+    QCOMPARE(batchSpy.count(), 2);
+    QCOMPARE(batchSpy.at(1).first().toStringList(), QStringList{ids.at(24)});
+    QCOMPARE(removedSpy.count(), 0);
+}
+
+// Change Deltas
+
+void TestClipboardHistory::testDeltas_mirrorItems()
+{
+    ClipboardHistory history(10);
+    QStringList mirrored;
+    trackDeltas(history, &mirrored);
+
+    QStringList ids;
+    for (int i = 0; i < 12; ++i) {
+        ids.append(history.addItem(createItem(QString("Item %1").arg(i), 100 - i)));
+        QCOMPARE(mirrored, itemIds(history));
+    }
+
+    history.pinItem(ids.at(5));
+    QCOMPARE(mirrored, itemIds(history));
+    history.addItem(createItem("Older than all", 500));
+    QCOMPARE(mirrored, itemIds(history));
+    history.unpinItem(ids.at(5));
+    QCOMPARE(mirrored, itemIds(history));
+    history.removeItem(ids.at(8));
+    QCOMPARE(mirrored, itemIds(history));
+}
+
+void TestClipboardHistory::testDeltas_duplicateAddIsMove()
+{
+    ClipboardHistory history;
+    history.addItem(createItem("Repeated", 30));
+    history.addItem(createItem("Other", 20));
+
+    QSignalSpy movedSpy(&history, &ClipboardHistory::itemMoved);
+    QSignalSpy insertedSpy(&history, &ClipboardHistory::itemInsertedAt);
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemovedAt);
+    QString id = history.addItem("Repeated");
+
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(movedSpy.count(), 1);
+    QCOMPARE(movedSpy.first().at(0).toInt(), 1);
+    QCOMPARE(movedSpy.first().at(1).toInt(), 0);
+    QCOMPARE(movedSpy.first().at(2).value<ClipboardItem>().id(), id);
+}
+
+void TestClipboardHistory::testDeltas_demotionRemovesTail()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    ClipboardHistory history(100);
+    QStringList mirrored;
+    trackDeltas(history, &mirrored);
+    fillTieredHistory(history, dir.filePath("history.cold"), 15);
+
+    QCOMPARE(mirrored.size(), history.hotCount());
+    QCOMPARE(mirrored, itemIds(history));
+
+    // Pinning a cold item brings it back as an insertion
+    QString coldId = history.getItemAt(history.count() - 1).id();
+    history.pinItem(coldId);
+    QCOMPARE(mirrored, itemIds(history));
+}
+
+void TestClipboardHistory::testDeltas_loadEmitsReset()
+{
+    ClipboardHistory source;
+    source.addItem(createItem("Saved", 10));
+
+    ClipboardHistory history;
+    QSignalSpy resetSpy(&history, &ClipboardHistory::itemsReset);
+    QSignalSpy insertedSpy(&history, &ClipboardHistory::itemInsertedAt);
+    history.fromJson(source.toJson());
+
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 0);
+}
+
+void TestClipboardHistory::testUpdateBatch_emitsOrderChangedOnce()
+{
+    ClipboardHistory history(10);
+    for (int i = 0; i < 10; ++i) {
+        history.addItem(createItem(QString("Item %1").arg(i), 100 - i));
+    }
+
+    QSignalSpy orderSpy(&history, &ClipboardHistory::orderChanged);
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemoved);
+
+    history.beginUpdate();
+    history.beginUpdate();
+    history.addItem(createItem("Batched 1", 5));
+    history.endUpdate();
+    history.addItem(createItem("Batched 2", 1));
+    QCOMPARE(orderSpy.count(), 0);
+    history.endUpdate();
+
+    // Evictions still report each item, but the order changes once
+    QCOMPARE(orderSpy.count(), 1);
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(history.count(), 10);
+
+    // An empty batch stays silent, and unbalanced ends are ignored
+    history.beginUpdate();
+    history.endUpdate();
+    history.endUpdate();
+    QCOMPARE(orderSpy.count(), 1);
+    history.addItem(createItem("After", 0));
+    QCOMPARE(orderSpy.count(), 2);
+}
+
+// Helper Methods
+
+ClipboardItem TestClipboardHistory::createItem(const QString& text, int secondsAgo)
+{
+    return ClipboardItem(text, QDateTime::currentDateTime().addSecs(-secondsAgo));
+}
+
+// Retention
+
+void TestClipboardHistory::testRetention_evictsOldItemsInOneBatch()
+{
+    QTemporaryDir dir;
+    ClipboardHistory history(1000);
+    QStringList ids = fillTieredHistory(history, dir.filePath("history.cold"), 25);
+    QVERIFY(history.pinItem(ids.at(0)));
+
+    // Without a policy nothing is evicted
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVERIFY(history.applyRetention(now).isEmpty());
+
+    // Item i was copied 1000 - i seconds ago; items 0-5 are older than this
+    ClipboardHistory::RetentionPolicy policy;
+    policy.maxAgeMs = (1000 - 5) * 1000 - 500;
+    history.setRetentionPolicy(policy);
+
+    QSignalSpy batchSpy(&history, &ClipboardHistory::itemsRemoved);
+    QSignalSpy removedSpy(&history, &ClipboardHistory::itemRemoved);
+    QSignalSpy orderSpy(&history, &ClipboardHistory::orderChanged);
+    QStringList evicted = history.applyRetention(now);
+
+    // Items 1-5 are too old; the pinned item 0 stays
+    QCOMPARE(evicted.size(), 5);
+    for (int i = 1; i <= 5; ++i) {
+        QVERIFY(evicted.contains(ids.at(i)));
+        QVERIFY(!history.hasItem(ids.at(i)));
+        QVERIFY(!history.hasDuplicate(QString("Item %1").arg(i)));
+    }
+    QVERIFY(history.hasItem(ids.at(0)));
+    QCOMPARE(history.count(), 20);
+    QCOMPARE(batchSpy.count(), 1);
+    QCOMPARE(batchSpy.first().first().toStringList(), evicted);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(orderSpy.count(), 1);
+
+    // A second sweep finds nothing left to do
+    QVERIFY(history.applyRetention(now).isEmpty());
+    QCOMPARE(batchSpy.count(), 1);
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testRetention_keepsNewestWithinBudget()
+{
+    ClipboardHistory history(1000);
+    QStringList ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.append(history.addItem(createItem(QString(100, QChar('a' + i)), 100 - i)));
+    }
+
+    // Room for the three newest 100-byte items
+    ClipboardHistory::RetentionPolicy policy;
+    policy.maxTotalBytes = 350;
+    history.setRetentionPolicy(policy);
+
+    QSignalSpy removedAtSpy(&history, &ClipboardHistory::itemRemovedAt);
+    QStringList evicted = history.applyRetention(QDateTime::currentMSecsSinceEpoch());
+
+    QCOMPARE(evicted.size(), 7);
+    QCOMPARE(history.count(), 3);
+    QCOMPARE(removedAtSpy.count(), 7);
+    for (int i = 7; i < 10; ++i) {
+        QVERIFY(history.hasItem(ids.at(i)));
+    }
+    verifyIndexConsistency(history);
+}
+
+void TestClipboardHistory::testRetention_evictsOversizeColdItems()
+{
+    QTemporaryDir dir;
+    QString coldPath = dir.filePath("history.cold");
+    QString largeId;
+    {
+        ClipboardHistory history(1000);
+        history.setHotItemLimit(10);
+        QVERIFY(history.attachColdStore(coldPath));
+        largeId = history.addItem(createItem(QString(5000, QChar('x')), 1000));
+        for (int i = 0; i < 20; ++i) {
+            history.addItem(createItem(QString("Item %1").arg(i), 900 - i));
+        }
+        QCOMPARE(history.coldCount(), 11);
+    }
+
+    // Sizes of cold entries are known after reopening, without reading their text
+    ClipboardHistory reopened(1000);
+    reopened.setHotItemLimit(10);
+    QVERIFY(reopened.attachColdStore(coldPath));
+    QVERIFY(reopened.hasItem(largeId));
+
+    ClipboardHistory::RetentionPolicy policy;
+    policy.maxItemBytes = 1000;
+    reopened.setRetentionPolicy(policy);
+    QCOMPARE(reopened.applyRetention(QDateTime::currentMSecsSinceEpoch()), QStringList{largeId});
+    QVERIFY(!reopened.hasItem(largeId));
+}
+
+QStringList TestClipboardHistory::fillTieredHistory(ClipboardHistory& history, const QString& coldPath, int itemCount)
+{
+    history.setHotItemLimit(10);
+    if (!history.attachColdStore(coldPath)) {
+        qFatal("Cannot open cold history segment");
+    }
+
+    QStringList ids;
+    for (int i = 0; i < itemCount; ++i) {
+        ids.append(history.addItem(createItem(QString("Item %1").arg(i), 1000 - i)));
+    }
+    return ids;
+}
+
+void TestClipboardHistory::verifyIndexConsistency(const ClipboardHistory& history)
+{
+    const QList<ClipboardItem> items = history.items();
+    for (int i = 0; i < items.size(); ++i) {
+        QCOMPARE(history.findItemIndex(items.at(i).id()), i);
+        QCOMPARE(history.getItem(items.at(i).id()).text(), items.at(i).text());
+        QVERIFY(history.hasDuplicate(items.at(i).text()));
+    }
+}
+
+void TestClipboardHistory::trackDeltas(ClipboardHistory& history, QStringList* ids)
+{
+    connect(&history, &ClipboardHistory::itemInsertedAt, this,
+            [ids](int index, const ClipboardItem& item) { ids->insert(index, item.id()); });
+    connect(&history, &ClipboardHistory::itemRemovedAt, this,
+            [ids](int index, const QString& id) {
+                QCOMPARE(ids->at(index), id);
+                ids->removeAt(index);
+            });
+    connect(&history, &ClipboardHistory::itemMoved, this,
+            [ids](int from, int to, const ClipboardItem& item) {
+                ids->removeAt(from);
+                ids->insert(to, item.id());
+            });
+    connect(&history, &ClipboardHistory::itemsReset, this,
+            [this, ids, &history]() { *ids = itemIds(history); });
+}
+
+QStringList TestClipboardHistory::itemIds(const ClipboardHistory& history)
+{
+    QStringList ids;
+    for (const auto& item : history.items()) {
+        ids.append(item.id());
+    }
+    return ids;
+}
+
+QTEST_MAIN(TestClipboardHistory)
+#include "test_clipboard_history.moc"
@@ -2,6 +2,7 @@
 #include <QObject>
 #include <QDateTime>
 #include <QJsonObject>
+#include <QSet>
 #include <QUuid>
 
 #include "../../src/models/clipboard_item.h"
@@ -57,6 +58,7 @@ private slots:
     void testGeneratePreview_multilineText();
     void testGeneratePreview_customMaxLength();
     void testGeneratePreview_exactMaxLength();
+    void testPreview_derivedOnDemand();
 
     // Hash Generation
     void testGenerateHash_validText();
@@ -65,6 +67,17 @@ private slots:
     void testGenerateHash_differentTextDifferentHash();
     void testGenerateHash_consistency();
 
+    // Content Key
+    void testGenerateContentKey_stableAndNonZero();
+    void testGenerateContentKey_distinguishesCloseTexts();
+    void testSameContent_comparesKeyAndText();
+    void testToJson_storedHashOnlyWhenNotDerived();
+
+    // Payload References
+    void testFromPayload_keyedByBlob();
+    void testPayload_roundTripsThroughJson();
+    void testPayload_roundTripsThroughStream();
+
     // Pin Management
     void testPin_functionality();
     void testUnpin_functionality();
@@ -99,6 +112,8 @@ private slots:
 
     // Data Integrity
     void testIdUniqueness();
+    void testIdFormat();
+    void testMoveConstructor();
     void testTimestampAccuracy();
     void testHashConsistency();
     void testPreviewConsistency();
@@ -438,6 +453,25 @@ void TestClipboardItem::testGeneratePreview_exactMaxLength()
     QVERIFY(!preview.endsWith("..."));
 }
 
+void TestClipboardItem::testPreview_derivedOnDemand()
+{
+    ClipboardItem item("First line\n\n   second line");
+    QVERIFY(item.storedPreview().isEmpty());
+    QCOMPARE(item.preview(), QString("First line second line"));
+    
+    // Loading without a preview keeps it derived
+    QJsonObject json = item.toJson();
+    json.remove("preview");
+    ClipboardItem loaded(json);
+    QVERIFY(loaded.storedPreview().isEmpty());
+    QCOMPARE(loaded.preview(), item.preview());
+    
+    // Metadata-only copies cannot derive it, so they keep a copy
+    ClipboardItem entry = item.metadata();
+    QVERIFY(!entry.hasText());
+    QCOMPARE(entry.storedPreview(), item.preview());
+}
+
 // Hash Generation Tests
 
 void TestClipboardItem::testGenerateHash_validText()
@@ -495,6 +529,127 @@ void TestClipboardItem::testGenerateHash_consistency()
     }
 }
 
+// Content Key Tests
+
+void TestClipboardItem::testGenerateContentKey_stableAndNonZero()
+{
+    QCOMPARE(ClipboardItem::generateContentKey(QString()), quint64(0));
+    
+    // Each tail length exercises a different final chunk
+    for (const QString& text : {QString("a"), QString("ab"), QString("abc"),
+                                QString("abcd"), QString("abcde")}) {
+        quint64 key = ClipboardItem::generateContentKey(text);
+        QVERIFY(key != 0);
+        QCOMPARE(ClipboardItem::generateContentKey(QString(text)), key);
+    }
+    
+    ClipboardItem item("Keyed content");
+    QCOMPARE(item.contentKey(), ClipboardItem::generateContentKey("Keyed content"));
+}
+
+void TestClipboardItem::testGenerateContentKey_distinguishesCloseTexts()
+{
+    QSet<quint64> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.insert(ClipboardItem::generateContentKey(QString("Item %1").arg(i)));
+    }
+    QCOMPARE(keys.size(), 1000);
+    
+    // Trailing NUL code units still change the key
+    QVERIFY(ClipboardItem::generateContentKey(QString("ab")) !=
+            ClipboardItem::generateContentKey(QString("ab") + QChar(0)));
+}
+
+void TestClipboardItem::testSameContent_comparesKeyAndText()
+{
+    ClipboardItem first("Shared content");
+    ClipboardItem second("Shared content");
+    ClipboardItem other("Other content");
+    
+    QVERIFY(first.sameContent(second));
+    QVERIFY(!first.sameContent(other));
+    QVERIFY(first.sameContent(first.metadata()));
+    QVERIFY(!ClipboardItem().sameContent(ClipboardItem()));
+}
+
+void TestClipboardItem::testToJson_storedHashOnlyWhenNotDerived()
+{
+    ClipboardItem item = createValidItem();
+    QVERIFY(item.storedHash().isEmpty());
+    
+    // A hash matching the text is not kept, it is derived again on demand
+    ClipboardItem reloaded(item.toJson());
+    QVERIFY(reloaded.storedHash().isEmpty());
+    QCOMPARE(reloaded.hash(), item.hash());
+}
+
+// Payload Reference Tests
+
+void TestClipboardItem::testFromPayload_keyedByBlob()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "image/png";
+    payload.key = QString(64, QLatin1Char('a'));
+    payload.size = 5 * 1024 * 1024;
+    
+    ClipboardItem item = ClipboardItem::fromPayload(payload, "Image 1920x1080", "Image 1920x1080 (5 MB)");
+    QVERIFY(item.isValid());
+    QVERIFY(item.hasPayload());
+    QCOMPARE(item.payload().size, payload.size);
+    QCOMPARE(item.preview(), QString("Image 1920x1080 (5 MB)"));
+    
+    // The stored bytes identify the content, not the stand-in text
+    QCOMPARE(item.hash(), payload.key);
+    QVERIFY(item.contentKey() != ClipboardItem::generateContentKey(item.text()));
+    QVERIFY(!item.sameContent(ClipboardItem("Image 1920x1080")));
+    
+    QVERIFY(!ClipboardItem::fromPayload(ClipboardItem::Payload(), "Image", QString()).isValid());
+    QVERIFY(!createValidItem().hasPayload());
+}
+
+void TestClipboardItem::testPayload_roundTripsThroughJson()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "text/uri-list";
+    payload.key = QString(64, QLatin1Char('b'));
+    payload.size = 42;
+    ClipboardItem item = ClipboardItem::fromPayload(payload, "/tmp/a.txt\n/tmp/b.txt", QString());
+    
+    ClipboardItem reloaded(item.toJson());
+    QVERIFY(reloaded.isValid());
+    QVERIFY(reloaded.hasPayload());
+    QCOMPARE(reloaded.payload().mimeType, payload.mimeType);
+    QCOMPARE(reloaded.payload().key, payload.key);
+    QCOMPARE(reloaded.payload().size, payload.size);
+    QCOMPARE(reloaded.contentKey(), item.contentKey());
+    QVERIFY(reloaded.storedHash().isEmpty());
+}
+
+void TestClipboardItem::testPayload_roundTripsThroughStream()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "image/png";
+    payload.key = QString(64, QLatin1Char('c'));
+    payload.size = 1234;
+    ClipboardItem item = ClipboardItem::fromPayload(payload, "Image 10x10", QString());
+    
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        QVERIFY(item.writeTo(out));
+        
+        // The old layout has no room for the reference
+        QVERIFY(!item.writeTo(out, ClipboardItem::StreamWithoutPayload));
+    }
+    
+    QDataStream in(data);
+    ClipboardItem entry;
+    QVERIFY(entry.readFrom(in, false));
+    QVERIFY(!entry.hasText());
+    QCOMPARE(entry.payload().key, payload.key);
+    QCOMPARE(entry.payload().size, payload.size);
+}
+
 // Pin Management Tests
 
 void TestClipboardItem::testPin_functionality()
@@ -845,6 +1000,34 @@ void TestClipboardItem::testIdUniqueness()
     QCOMPARE(ids.size(), 100);
 }
 
+void TestClipboardItem::testIdFormat()
+{
+    ClipboardItem item("Content");
+    QCOMPARE(item.id().size(), 16);
+    
+    bool ok = false;
+    QVERIFY(item.id().toULongLong(&ok, 16) != 0);
+    QVERIFY(ok);
+}
+
+void TestClipboardItem::testMoveConstructor()
+{
+    ClipboardItem original = createValidItem("Moved content");
+    original.pin();
+    QString id = original.id();
+    
+    ClipboardItem moved(std::move(original));
+    QVERIFY(moved.isValid());
+    QCOMPARE(moved.id(), id);
+    QCOMPARE(moved.text(), QString("Moved content"));
+    QVERIFY(moved.pinned());
+    
+    ClipboardItem assigned;
+    assigned = std::move(moved);
+    QCOMPARE(assigned.id(), id);
+    QCOMPARE(assigned.contentKey(), ClipboardItem::generateContentKey("Moved content"));
+}
+
 void TestClipboardItem::testTimestampAccuracy()
 {
     QDateTime before = QDateTime::currentDateTime();
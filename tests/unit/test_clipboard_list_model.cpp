@@ -0,0 +1,172 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QSignalSpy>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/ui/clipboard_list_model.h"
+
+/**
+ * @brief Unit tests for ClipboardListModel
+ *
+ * These tests verify that rows expose the expected roles and that
+ * positional changes are reported as row notifications instead of resets.
+ */
+class TestClipboardListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Content
+    void testSetItems_resetsModel();
+    void testData_roles();
+    void testFormatItemText();
+
+    // Row Changes
+    void testInsertItem_emitsRowsInserted();
+    void testRemoveItem_emitsRowsRemoved();
+    void testMoveItem_emitsRowsMoved();
+    void testMoveItem_replacesState();
+
+private:
+    // Helper methods
+    QList<ClipboardItem> createItems(int count);
+    QStringList rowIds(const ClipboardListModel& model);
+};
+
+// Content
+
+void TestClipboardListModel::testSetItems_resetsModel()
+{
+    ClipboardListModel model;
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+
+    QList<ClipboardItem> items = createItems(3);
+    model.setItems(items);
+
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.rowOf(items.at(1).id()), 1);
+    QCOMPARE(model.rowOf("missing"), -1);
+    QVERIFY(!model.itemAt(3).isValid());
+    QCOMPARE(model.rowCount(model.index(0)), 0);
+}
+
+void TestClipboardListModel::testData_roles()
+{
+    ClipboardItem item("Line one\nline two", QDateTime::currentDateTime());
+    item.pin();
+
+    ClipboardListModel model;
+    model.setItems({item});
+    QModelIndex index = model.index(0);
+
+    QCOMPARE(model.data(index, ClipboardListModel::IdRole).toString(), item.id());
+    QVERIFY(model.data(index, ClipboardListModel::PinnedRole).toBool());
+    QCOMPARE(model.data(index, ClipboardListModel::ItemRole).value<ClipboardItem>().id(), item.id());
+    QCOMPARE(model.data(index, Qt::ToolTipRole).toString(), item.preview());
+    QCOMPARE(model.data(index, Qt::DisplayRole).toString(), ClipboardListModel::formatItemText(item));
+    QVERIFY(!model.data(model.index(1), Qt::DisplayRole).isValid());
+}
+
+void TestClipboardListModel::testFormatItemText()
+{
+    ClipboardItem item("  spaced\r\ntext  ");
+    QCOMPARE(ClipboardListModel::formatItemText(item), QString("spaced text"));
+
+    ClipboardItem longItem(QString(150, 'x'));
+    QString text = ClipboardListModel::formatItemText(longItem);
+    QCOMPARE(text.length(), 100);
+    QVERIFY(text.endsWith("..."));
+}
+
+// Row Changes
+
+void TestClipboardListModel::testInsertItem_emitsRowsInserted()
+{
+    ClipboardListModel model;
+    model.setItems(createItems(2));
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+
+    ClipboardItem item("Inserted");
+    model.insertItem(1, item);
+
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(model.rowOf(item.id()), 1);
+    QCOMPARE(model.rowCount(), 3);
+}
+
+void TestClipboardListModel::testRemoveItem_emitsRowsRemoved()
+{
+    ClipboardListModel model;
+    QList<ClipboardItem> items = createItems(3);
+    model.setItems(items);
+    QSignalSpy removeSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    QVERIFY(model.removeItem(0));
+    QVERIFY(!model.removeItem(5));
+
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(removeSpy.at(0).at(1).toInt(), 0);
+    QCOMPARE(rowIds(model), QStringList({items.at(1).id(), items.at(2).id()}));
+}
+
+void TestClipboardListModel::testMoveItem_emitsRowsMoved()
+{
+    ClipboardListModel model;
+    QList<ClipboardItem> items = createItems(4);
+    model.setItems(items);
+    QSignalSpy moveSpy(&model, &QAbstractItemModel::rowsMoved);
+
+    // Down, then back up
+    model.moveItem(0, 2, items.at(0));
+    QCOMPARE(rowIds(model), QStringList({items.at(1).id(), items.at(2).id(),
+                                         items.at(0).id(), items.at(3).id()}));
+    model.moveItem(3, 0, items.at(3));
+    QCOMPARE(rowIds(model), QStringList({items.at(3).id(), items.at(1).id(),
+                                         items.at(2).id(), items.at(0).id()}));
+    QCOMPARE(moveSpy.count(), 2);
+}
+
+void TestClipboardListModel::testMoveItem_replacesState()
+{
+    ClipboardListModel model;
+    QList<ClipboardItem> items = createItems(2);
+    model.setItems(items);
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+
+    ClipboardItem pinned = items.at(1);
+    pinned.pin();
+    model.moveItem(1, 0, pinned);
+
+    QVERIFY(model.itemAt(0).pinned());
+    QCOMPARE(model.itemAt(0).id(), pinned.id());
+    QCOMPARE(changedSpy.count(), 1);
+}
+
+// Helper Methods
+
+QList<ClipboardItem> TestClipboardListModel::createItems(int count)
+{
+    QList<ClipboardItem> items;
+    QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < count; ++i) {
+        items.append(ClipboardItem(QString("Item %1").arg(i), now.addSecs(-i)));
+    }
+    return items;
+}
+
+QStringList TestClipboardListModel::rowIds(const ClipboardListModel& model)
+{
+    QStringList ids;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        ids.append(model.itemAt(row).id());
+    }
+    return ids;
+}
+
+QTEST_MAIN(TestClipboardListModel)
+#include "test_clipboard_list_model.moc"
@@ -0,0 +1,303 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "../../src/models/configuration.h"
+
+/**
+ * @brief Unit tests for Configuration change tracking and saving
+ *
+ * These tests verify that only real changes are signalled, that batched
+ * updates report each changed setting once, and that scheduled saves
+ * coalesce into a single atomic write that a flush does not race.
+ */
+class TestConfiguration : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Change signals
+    void testSetters_signalOnlyChanges();
+    void testUpdate_emitsOncePerChangedSetting();
+    void testUpdate_nests();
+    void testResetToDefaults_signalsOnlyChanges();
+
+    // Persistence
+    void testDirty_clearedBySaveAndLoad();
+    void testScheduleSave_coalescesWrites();
+    void testScheduleSave_quickCommitsWriteOnce();
+    void testScheduleSave_writesMissingFile();
+    void testFlush_writesScheduledSave();
+    void testFlush_afterRepeatedScheduleSaveKeepsLastState();
+    void testDestruction_writesScheduledSave();
+    void testRetentionSettings_persistAndClamp();
+
+private:
+    // Helper methods
+    QString configPath() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void TestConfiguration::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+}
+
+// Change signals
+
+void TestConfiguration::testSetters_signalOnlyChanges()
+{
+    Configuration config(configPath());
+    QSignalSpy positionSpy(&config, &Configuration::windowPositionChanged);
+
+    config.setWindowPosition(QPoint(10, 20));
+    config.setWindowPosition(QPoint(10, 20));
+    QCOMPARE(positionSpy.count(), 1);
+    QCOMPARE(positionSpy.at(0).at(0).toPoint(), QPoint(10, 20));
+}
+
+void TestConfiguration::testUpdate_emitsOncePerChangedSetting()
+{
+    Configuration config(configPath());
+    QSignalSpy positionSpy(&config, &Configuration::windowPositionChanged);
+    QSignalSpy sizeSpy(&config, &Configuration::windowSizeChanged);
+    QSignalSpy hotkeySpy(&config, &Configuration::hotkeyChanged);
+    const QString hotkey = config.hotkey();
+
+    // A drag: many positions, one signal with the last one
+    config.beginUpdate();
+    for (int x = 0; x < 50; ++x) {
+        config.setWindowPosition(QPoint(x, x));
+    }
+    config.setWindowSize(QSize(500, 700));
+    config.setHotkey("Ctrl+Alt+H");
+    config.setHotkey(hotkey);
+    QVERIFY(config.isUpdating());
+    QCOMPARE(positionSpy.count(), 0);
+    QVERIFY(config.commitUpdate());
+
+    QVERIFY(!config.isUpdating());
+    QCOMPARE(positionSpy.count(), 1);
+    QCOMPARE(positionSpy.at(0).at(0).toPoint(), QPoint(49, 49));
+    QCOMPARE(sizeSpy.count(), 1);
+
+    // Changed and changed back within the batch is no change
+    QCOMPARE(hotkeySpy.count(), 0);
+
+    config.beginUpdate();
+    config.setWindowPosition(QPoint(49, 49));
+    QVERIFY(!config.commitUpdate());
+    QCOMPARE(positionSpy.count(), 1);
+}
+
+void TestConfiguration::testUpdate_nests()
+{
+    Configuration config(configPath());
+    QSignalSpy limitSpy(&config, &Configuration::maxHistoryItemsChanged);
+
+    config.beginUpdate();
+    config.beginUpdate();
+    config.setMaxHistoryItems(200);
+    QVERIFY(!config.commitUpdate());
+    QCOMPARE(limitSpy.count(), 0);
+    QVERIFY(config.commitUpdate());
+    QCOMPARE(limitSpy.count(), 1);
+
+    // An unmatched commit is ignored
+    QVERIFY(!config.commitUpdate());
+    QVERIFY(!config.isUpdating());
+}
+
+void TestConfiguration::testResetToDefaults_signalsOnlyChanges()
+{
+    Configuration config(configPath());
+    config.setMaxHistoryItems(300);
+
+    QSignalSpy limitSpy(&config, &Configuration::maxHistoryItemsChanged);
+    QSignalSpy hotkeySpy(&config, &Configuration::hotkeyChanged);
+    config.resetToDefaults();
+    QCOMPARE(limitSpy.count(), 1);
+    QCOMPARE(hotkeySpy.count(), 0);
+}
+
+// Persistence
+
+void TestConfiguration::testDirty_clearedBySaveAndLoad()
+{
+    Configuration config(configPath());
+    QVERIFY(!config.isDirty());
+
+    config.setMaxHistoryItems(120);
+    QVERIFY(config.isDirty());
+    QVERIFY(config.save());
+    QVERIFY(!config.isDirty());
+
+    config.setMaxHistoryItems(130);
+    QVERIFY(config.load());
+    QVERIFY(!config.isDirty());
+    QCOMPARE(config.maxHistoryItems(), 120);
+}
+
+void TestConfiguration::testScheduleSave_coalescesWrites()
+{
+    Configuration config(configPath());
+    QSignalSpy savedSpy(&config, &Configuration::configurationSaved);
+
+    for (int x = 0; x < 20; ++x) {
+        config.setWindowPosition(QPoint(x, 0));
+        config.scheduleSave();
+    }
+    QVERIFY(config.isSavePending());
+    QVERIFY(!QFile::exists(configPath()));
+
+    QTRY_VERIFY_WITH_TIMEOUT(!config.isSavePending(), 5000);
+    QCOMPARE(savedSpy.count(), 1);
+    QVERIFY(!config.isDirty());
+
+    Configuration reloaded(configPath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.windowPosition(), QPoint(19, 0));
+
+    // Nothing changed, nothing written
+    config.scheduleSave();
+    QTRY_VERIFY_WITH_TIMEOUT(!config.isSavePending(), 5000);
+    QCOMPARE(savedSpy.count(), 1);
+}
+
+void TestConfiguration::testScheduleSave_quickCommitsWriteOnce()
+{
+    Configuration config(configPath());
+    QSignalSpy savedSpy(&config, &Configuration::configurationSaved);
+
+    // Two settings applies in quick succession, as from the settings dialog
+    config.beginUpdate();
+    config.setMaxHistoryItems(200);
+    config.setHotkey("Ctrl+Alt+V");
+    QVERIFY(config.commitUpdate());
+    config.scheduleSave();
+
+    config.beginUpdate();
+    config.setMaxHistoryItems(300);
+    QVERIFY(config.commitUpdate());
+    config.scheduleSave();
+
+    QVERIFY(!QFile::exists(configPath()));
+    QTRY_VERIFY_WITH_TIMEOUT(!config.isSavePending(), 5000);
+    QCOMPARE(savedSpy.count(), 1);
+
+    Configuration reloaded(configPath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.maxHistoryItems(), 300);
+    QCOMPARE(reloaded.hotkey(), QString("Ctrl+Alt+V"));
+}
+
+void TestConfiguration::testScheduleSave_writesMissingFile()
+{
+    Configuration config(configPath());
+    QVERIFY(!config.isDirty());
+
+    // First start: the defaults are written even though nothing changed
+    config.scheduleSave();
+    QTRY_VERIFY_WITH_TIMEOUT(!config.isSavePending(), 5000);
+    QVERIFY(QFile::exists(configPath()));
+
+    // A flush of a scheduled first save writes it too
+    QVERIFY(QFile::remove(configPath()));
+    config.scheduleSave();
+    QVERIFY(config.flush());
+    QVERIFY(QFile::exists(configPath()));
+}
+
+void TestConfiguration::testFlush_writesScheduledSave()
+{
+    Configuration config(configPath());
+    config.setHotkey("Ctrl+Shift+V");
+    config.scheduleSave();
+
+    QVERIFY(config.flush());
+    QVERIFY(!config.isSavePending());
+    QVERIFY(!config.isDirty());
+
+    Configuration reloaded(configPath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.hotkey(), QString("Ctrl+Shift+V"));
+}
+
+void TestConfiguration::testFlush_afterRepeatedScheduleSaveKeepsLastState()
+{
+    Configuration config(configPath());
+    config.setWindowPosition(QPoint(1, 0));
+    config.scheduleSave();
+    // The file appears before the background write has been reported
+    QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(configPath()), 5000);
+
+    config.setWindowPosition(QPoint(2, 0));
+    config.scheduleSave();
+    config.setWindowPosition(QPoint(3, 0));
+    config.scheduleSave();
+    QVERIFY(config.flush());
+    QVERIFY(!config.isSavePending());
+    QVERIFY(!config.isDirty());
+
+    // Nothing written in the background may land after the flush
+    QTest::qWait(50);
+    QVERIFY(!config.isSavePending());
+    Configuration reloaded(configPath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.windowPosition(), QPoint(3, 0));
+}
+
+void TestConfiguration::testDestruction_writesScheduledSave()
+{
+    {
+        Configuration config(configPath());
+        config.setWindowSize(QSize(640, 480));
+        config.scheduleSave();
+    }
+
+    Configuration reloaded(configPath());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.windowSize(), QSize(640, 480));
+}
+
+void TestConfiguration::testRetentionSettings_persistAndClamp()
+{
+    {
+        Configuration config(configPath());
+        QCOMPARE(config.retentionDays(), 0);
+        QCOMPARE(config.maxHistorySizeMb(), 0);
+        QCOMPARE(config.maxItemSizeKb(), 0);
+
+        QSignalSpy daysSpy(&config, &Configuration::retentionDaysChanged);
+        config.setRetentionDays(30);
+        config.setRetentionDays(30);
+        config.setMaxHistorySizeMb(-5);
+        config.setMaxItemSizeKb(512);
+        QCOMPARE(daysSpy.count(), 1);
+        QCOMPARE(config.maxHistorySizeMb(), 0);
+        QVERIFY(config.save());
+    }
+
+    Configuration loaded(configPath());
+    QVERIFY(loaded.load());
+    QCOMPARE(loaded.retentionDays(), 30);
+    QCOMPARE(loaded.maxHistorySizeMb(), 0);
+    QCOMPARE(loaded.maxItemSizeKb(), 512);
+}
+
+// Helper methods
+
+QString TestConfiguration::configPath() const
+{
+    return m_dir->filePath("config/config.json");
+}
+
+QTEST_MAIN(TestConfiguration)
+#include "test_configuration.moc"
@@ -0,0 +1,55 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QGuiApplication>
+
+#include "../../src/lib/display_session.h"
+
+/**
+ * @brief Unit tests for DisplaySession
+ *
+ * These tests verify that X display names are told apart by whether they
+ * reach another machine, and that platforms without a window system are
+ * neither compositing nor remote.
+ */
+class TestDisplaySession : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRemoteDisplayName_data();
+    void testRemoteDisplayName();
+    void testOffscreen_isNotCompositing();
+};
+
+void TestDisplaySession::testRemoteDisplayName_data()
+{
+    QTest::addColumn<QString>("display");
+    QTest::addColumn<bool>("remote");
+
+    QTest::newRow("empty") << QString() << false;
+    QTest::newRow("local") << ":0" << false;
+    QTest::newRow("local screen") << ":1.0" << false;
+    QTest::newRow("unix socket") << "unix:0" << false;
+    QTest::newRow("xquartz") << "/private/tmp/com.apple.launchd.abc/org.xquartz:0" << false;
+    QTest::newRow("ssh forwarding") << "localhost:10.0" << true;
+    QTest::newRow("remote host") << "workstation.example.org:0" << true;
+}
+
+void TestDisplaySession::testRemoteDisplayName()
+{
+    QFETCH(QString, display);
+    QFETCH(bool, remote);
+    QCOMPARE(DisplaySession::isRemoteDisplayName(display), remote);
+}
+
+void TestDisplaySession::testOffscreen_isNotCompositing()
+{
+    if (QGuiApplication::platformName() != "offscreen" && QGuiApplication::platformName() != "minimal") {
+        QSKIP("Only meaningful without a window system");
+    }
+    QVERIFY(!DisplaySession::isCompositing());
+    QVERIFY(!DisplaySession::isRemote());
+}
+
+QTEST_MAIN(TestDisplaySession)
+#include "test_display_session.moc"
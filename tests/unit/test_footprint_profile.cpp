@@ -0,0 +1,166 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include "../../src/lib/footprint_profile.h"
+#include "../../src/models/search_index.h"
+#include "../../src/ui/preview_cache.h"
+
+/**
+ * @brief Unit tests for FootprintProfile
+ *
+ * These tests verify that timer events are counted per named timer, that
+ * a quiet period only counts the wakeups after the last activity, that
+ * the report holds phases and heap sizes as "name value" lines, and that
+ * the subsystem estimates grow with their contents.
+ */
+class TestFootprintProfile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Wakeups
+    void testTimerEvents_countedPerTimer();
+    void testQuietPeriod_countsWakeupsSinceActivity();
+
+    // Report
+    void testReport_phasesAndHeap();
+    void testWriteReport_replacesFile();
+    void testKeyFor_data();
+    void testKeyFor();
+
+    // Subsystem estimates
+    void testMemoryUsage_growsWithContent();
+};
+
+// Wakeups
+
+void TestFootprintProfile::testTimerEvents_countedPerTimer()
+{
+    FootprintProfile profile;
+    profile.start();
+    QVERIFY(profile.isStarted());
+
+    QObject owner;
+    QTimer poller(&owner);
+    poller.setObjectName("pollTimer");
+    poller.setInterval(10);
+    int timeouts = 0;
+    connect(&poller, &QTimer::timeout, [&timeouts]() { ++timeouts; });
+    poller.start();
+    QTRY_VERIFY(timeouts >= 5);
+    poller.stop();
+
+    QCOMPARE(profile.timerEvents("QObject::pollTimer"), quint64(timeouts));
+    QVERIFY(profile.wakeups() > 0);
+    QVERIFY(profile.report().contains("\ntimer_qobject_polltimer_per_min "));
+}
+
+void TestFootprintProfile::testQuietPeriod_countsWakeupsSinceActivity()
+{
+    FootprintProfile profile;
+    profile.start();
+
+    QTest::qWait(50);
+    profile.markActivity();
+    QCOMPARE(profile.quietWakeups(), quint64(0));
+
+    QTimer::singleShot(10, []() {});
+    QTRY_VERIFY(profile.quietWakeups() > 0);
+    QVERIFY(profile.quietWakeups() <= profile.wakeups());
+    QVERIFY(profile.report().contains("\nactivities 1\n"));
+}
+
+// Report
+
+void TestFootprintProfile::testReport_phasesAndHeap()
+{
+    FootprintProfile profile;
+    profile.addPhase("tray icon", 12);
+    profile.addPhase("history loaded (empty)", 40);
+    profile.setHeapUsage("history", 1000);
+    profile.setHeapUsage("tray menu", 200);
+    profile.setHeapUsage("history", 1500);
+
+    const QStringList lines = profile.report().trimmed().split('\n');
+    QVERIFY(lines.contains("startup_tray_icon_ms 12"));
+    QVERIFY(lines.contains("startup_history_loaded_empty_ms 40"));
+    QVERIFY(lines.contains("heap_history_bytes 1500"));
+    QVERIFY(lines.contains("heap_tray_menu_bytes 200"));
+    QVERIFY(lines.contains("heap_total_bytes 1700"));
+    QVERIFY(lines.contains("wakeups 0"));
+
+    // One "name value" pair per line
+    for (const QString& line : lines) {
+        QCOMPARE(line.split(' ').size(), 2);
+    }
+
+#ifdef Q_OS_LINUX
+    QVERIFY(FootprintProfile::residentBytes() > 0);
+    QVERIFY(FootprintProfile::residentBytes(true) >= FootprintProfile::residentBytes());
+#endif
+}
+
+void TestFootprintProfile::testWriteReport_replacesFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("footprint.txt");
+
+    FootprintProfile profile;
+    profile.setHeapUsage("previews", 64);
+    QVERIFY(profile.writeReport(path));
+    profile.setHeapUsage("previews", 128);
+    QVERIFY(profile.writeReport(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString report = QString::fromUtf8(file.readAll());
+    QCOMPARE(report, profile.report());
+    QVERIFY(report.contains("heap_previews_bytes 128\n"));
+
+    QVERIFY(!profile.writeReport(dir.filePath("missing/footprint.txt")));
+}
+
+void TestFootprintProfile::testKeyFor_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("key");
+
+    QTest::newRow("plain") << "history" << "history";
+    QTest::newRow("spaces") << "tray menu" << "tray_menu";
+    QTest::newRow("punctuation") << "history loaded (empty)" << "history_loaded_empty";
+    QTest::newRow("timer") << "ClipboardManager::saveTimer" << "clipboardmanager_savetimer";
+    QTest::newRow("empty") << "" << "";
+}
+
+void TestFootprintProfile::testKeyFor()
+{
+    QFETCH(QString, name);
+    QFETCH(QString, key);
+
+    QCOMPARE(FootprintProfile::keyFor(name), key);
+}
+
+// Subsystem estimates
+
+void TestFootprintProfile::testMemoryUsage_growsWithContent()
+{
+    PreviewCache cache(100);
+    SearchIndex index(0);
+    const qint64 emptyCache = cache.memoryUsage();
+    const qint64 emptyIndex = index.memoryUsage();
+
+    for (int i = 0; i < 50; ++i) {
+        ClipboardItem item(QString("footprint item %1 with some text").arg(i));
+        cache.displayText(item, 40);
+        index.addItem(item);
+    }
+
+    QVERIFY(cache.memoryUsage() > emptyCache + 50 * 20 * qint64(sizeof(QChar)));
+    QVERIFY(index.memoryUsage() > emptyIndex);
+}
+
+QTEST_MAIN(TestFootprintProfile)
+#include "test_footprint_profile.moc"
@@ -0,0 +1,273 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_journal.h"
+
+/**
+ * @brief Unit tests for HistoryJournal recording and replay
+ *
+ * These tests verify that journaled changes rebuild the same history on
+ * top of a snapshot, and that a torn final record does not lose the rest.
+ */
+class TestHistoryJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Replay
+    void testReplay_rebuildsHistory();
+    void testReplay_overSnapshotIsIdempotent();
+    void testReplay_removesPinnedItems();
+    void testReplay_batchedRemoval();
+    void testReplay_clearAllRemovesPinnedItems();
+    void testReplay_doesNotEmitSignals();
+
+    // Robustness
+    void testReplay_ignoresTornRecord();
+    void testReset_discardsRecords();
+
+    // Compaction
+    void testCompaction_keepsLaterRecords();
+    void testCompaction_failureKeepsPendingRecords();
+
+private:
+    // Helper methods
+    ClipboardItem createItem(const QString& text, int secondsAgo);
+    QString journalPath() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void TestHistoryJournal::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+}
+
+// Replay
+
+void TestHistoryJournal::testReplay_rebuildsHistory()
+{
+    ClipboardItem first = createItem("First", 30);
+    ClipboardItem second = createItem("Second", 20);
+    {
+        HistoryJournal journal(journalPath());
+        QVERIFY(journal.recordAdded(first));
+        QVERIFY(journal.recordAdded(second));
+        QVERIFY(journal.recordPinned(first.id()));
+        QCOMPARE(journal.recordCount(), 3);
+    }
+
+    HistoryJournal journal(journalPath());
+    ClipboardHistory history;
+    QCOMPARE(journal.replay(history), 3);
+    QCOMPARE(journal.recordCount(), 3);
+
+    QCOMPARE(history.count(), 2);
+    QCOMPARE(history.getItemAt(0).id(), first.id());
+    QVERIFY(history.getItemAt(0).pinned());
+    QCOMPARE(history.getItemAt(1).id(), second.id());
+    QCOMPARE(history.getItemAt(1).timestamp().toString(Qt::ISODate),
+             second.timestamp().toString(Qt::ISODate));
+}
+
+void TestHistoryJournal::testReplay_overSnapshotIsIdempotent()
+{
+    ClipboardHistory source;
+    QString keptId = source.addItem(createItem("Kept", 30));
+    QString removedId = source.addItem(createItem("Removed", 20));
+
+    HistoryJournal journal(journalPath());
+    for (const auto& item : source.items()) {
+        journal.recordAdded(item);
+    }
+    source.removeItem(removedId);
+    journal.recordRemoved(removedId);
+
+    // Snapshot already contains every change the journal describes
+    ClipboardHistory loaded(source.toJson());
+    journal.replay(loaded);
+
+    QCOMPARE(loaded.count(), 1);
+    QVERIFY(loaded.hasItem(keptId));
+    QVERIFY(!loaded.hasItem(removedId));
+    QVERIFY(!loaded.hasDuplicate("Removed"));
+}
+
+void TestHistoryJournal::testReplay_batchedRemoval()
+{
+    QList<ClipboardItem> items;
+    {
+        HistoryJournal journal(journalPath());
+        for (int i = 0; i < 5; ++i) {
+            items.append(createItem(QString("Item %1").arg(i), 50 - i));
+            journal.recordAdded(items.last());
+        }
+        QVERIFY(journal.recordRemoved(QStringList{items.at(0).id(), items.at(1).id(), items.at(2).id()}));
+        QCOMPARE(journal.recordCount(), 6);
+    }
+
+    HistoryJournal journal(journalPath());
+    ClipboardHistory history;
+    QCOMPARE(journal.replay(history), 6);
+    QCOMPARE(history.count(), 2);
+    QVERIFY(history.hasItem(items.at(3).id()));
+    QVERIFY(history.hasItem(items.at(4).id()));
+}
+
+void TestHistoryJournal::testReplay_clearAllRemovesPinnedItems()
+{
+    {
+        // Recorded the way ClipboardManager journals history changes
+        HistoryJournal journal(journalPath());
+        ClipboardHistory source;
+        connect(&source, &ClipboardHistory::itemAdded, [&journal](const ClipboardItem& item) {
+            journal.recordAdded(item);
+        });
+        connect(&source, &ClipboardHistory::itemPinned, [&journal](const QString& id) {
+            journal.recordPinned(id);
+        });
+        connect(&source, &ClipboardHistory::itemsRemoved, [&journal](const QStringList& ids) {
+            journal.recordRemoved(ids);
+        });
+
+        source.addItem(createItem("First", 30));
+        const QString pinnedId = source.addItem(createItem("Pinned", 20));
+        source.addItem(createItem("Third", 10));
+        QVERIFY(source.pinItem(pinnedId));
+        source.clearAll();
+        QVERIFY(source.isEmpty());
+        QCOMPARE(journal.recordCount(), 5);
+    }
+
+    HistoryJournal journal(journalPath());
+    ClipboardHistory history;
+    QCOMPARE(journal.replay(history), 5);
+    QVERIFY(history.isEmpty());
+    QCOMPARE(history.pinnedCount(), 0);
+    QVERIFY(!history.hasDuplicate("Pinned"));
+}
+
+void TestHistoryJournal::testReplay_removesPinnedItems()
+{
+    ClipboardItem item = createItem("Pinned", 10);
+    HistoryJournal journal(journalPath());
+    journal.recordAdded(item);
+    journal.recordPinned(item.id());
+    journal.recordRemoved(item.id());
+
+    ClipboardHistory history;
+    journal.replay(history);
+    QVERIFY(history.isEmpty());
+}
+
+void TestHistoryJournal::testReplay_doesNotEmitSignals()
+{
+    HistoryJournal journal(journalPath());
+    journal.recordAdded(createItem("Quiet", 10));
+
+    ClipboardHistory history;
+    QSignalSpy addedSpy(&history, &ClipboardHistory::itemAdded);
+    QSignalSpy orderSpy(&history, &ClipboardHistory::orderChanged);
+    journal.replay(history);
+
+    QCOMPARE(history.count(), 1);
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(orderSpy.count(), 0);
+}
+
+// Robustness
+
+void TestHistoryJournal::testReplay_ignoresTornRecord()
+{
+    {
+        HistoryJournal journal(journalPath());
+        journal.recordAdded(createItem("Complete", 20));
+    }
+
+    // Simulate a crash in the middle of an append
+    QFile file(journalPath());
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("{\"op\":\"add\",\"item\":{\"text\":\"Tor");
+    file.close();
+
+    HistoryJournal journal(journalPath());
+    ClipboardHistory history;
+    QCOMPARE(journal.replay(history), 1);
+    QCOMPARE(history.count(), 1);
+
+    // Later records land after the last complete one
+    journal.recordAdded(createItem("After crash", 10));
+    ClipboardHistory reloaded;
+    QCOMPARE(HistoryJournal(journalPath()).replay(reloaded), 2);
+    QVERIFY(reloaded.hasDuplicate("After crash"));
+}
+
+void TestHistoryJournal::testReset_discardsRecords()
+{
+    HistoryJournal journal(journalPath());
+    journal.recordAdded(createItem("Folded", 10));
+    QVERIFY(journal.reset());
+    QVERIFY(journal.isEmpty());
+
+    ClipboardHistory history;
+    QCOMPARE(journal.replay(history), 0);
+    QVERIFY(history.isEmpty());
+}
+
+// Compaction
+
+void TestHistoryJournal::testCompaction_keepsLaterRecords()
+{
+    HistoryJournal journal(journalPath());
+    journal.recordAdded(createItem("Folded", 20));
+    QVERIFY(journal.beginCompaction());
+    journal.recordAdded(createItem("Written during snapshot", 10));
+    journal.finishCompaction(true);
+
+    ClipboardHistory history;
+    QCOMPARE(HistoryJournal(journalPath()).replay(history), 1);
+    QVERIFY(history.hasDuplicate("Written during snapshot"));
+    QVERIFY(!history.hasDuplicate("Folded"));
+}
+
+void TestHistoryJournal::testCompaction_failureKeepsPendingRecords()
+{
+    HistoryJournal journal(journalPath());
+    journal.recordAdded(createItem("First", 30));
+    QVERIFY(journal.beginCompaction());
+    journal.finishCompaction(false);
+
+    // The next compaction merges the leftover records instead of dropping them
+    journal.recordAdded(createItem("Second", 20));
+    QVERIFY(journal.beginCompaction());
+    journal.recordAdded(createItem("Third", 10));
+
+    ClipboardHistory history;
+    QCOMPARE(HistoryJournal(journalPath()).replay(history), 3);
+    QCOMPARE(history.getItemAt(0).text(), QString("Third"));
+    QCOMPARE(history.getItemAt(2).text(), QString("First"));
+}
+
+// Helper Methods
+
+ClipboardItem TestHistoryJournal::createItem(const QString& text, int secondsAgo)
+{
+    return ClipboardItem(text, QDateTime::currentDateTime().addSecs(-secondsAgo));
+}
+
+QString TestHistoryJournal::journalPath() const
+{
+    return m_dir->filePath("history.journal");
+}
+
+QTEST_MAIN(TestHistoryJournal)
+#include "test_history_journal.moc"
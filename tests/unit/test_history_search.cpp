@@ -0,0 +1,143 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QSignalSpy>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_view.h"
+#include "../../src/models/text_matcher.h"
+#include "../../src/services/history_search.h"
+
+/**
+ * @brief Unit tests for HistorySearch ranking on the thread pool
+ *
+ * These tests verify that sharded ranking returns exactly what a single
+ * TextMatcher::rank() pass returns, and that a new search supersedes the
+ * one still running.
+ */
+class TestHistorySearch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Sharded Ranking
+    void testRank_matchesSinglePass_data();
+    void testRank_matchesSinglePass();
+    void testRankAsync_deliversResult();
+
+    // Cancellation
+    void testStart_supersedesRunningSearch();
+    void testCancel_suppressesResult();
+
+private:
+    // Helper methods
+    HistoryView createView(int itemCount, qint64 nowMs);
+};
+
+// Sharded Ranking
+
+void TestHistorySearch::testRank_matchesSinglePass_data()
+{
+    QTest::addColumn<int>("itemCount");
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<int>("limit");
+
+    QTest::newRow("single shard") << 300 << "entry 1" << 20;
+    QTest::newRow("many shards") << 20000 << "entry 1" << 50;
+    QTest::newRow("fuzzy") << 20000 << "ey7" << 10;
+    QTest::newRow("limit above matches") << 20000 << "entry 1999" << 100;
+    QTest::newRow("no match") << 20000 << "absent" << 10;
+}
+
+void TestHistorySearch::testRank_matchesSinglePass()
+{
+    QFETCH(int, itemCount);
+    QFETCH(QString, pattern);
+    QFETCH(int, limit);
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    HistoryView view = createView(itemCount, now);
+    QList<TextMatcher::RankedItem> expected = TextMatcher(pattern).rank(view.items(), limit, now);
+    QList<TextMatcher::RankedItem> ranked = HistorySearch::rank(view, pattern, limit, now);
+
+    QCOMPARE(ranked.size(), expected.size());
+    for (int i = 0; i < ranked.size(); ++i) {
+        QCOMPARE(ranked.at(i).index, expected.at(i).index);
+        QCOMPARE(ranked.at(i).score, expected.at(i).score);
+    }
+}
+
+void TestHistorySearch::testRankAsync_deliversResult()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    HistoryView view = createView(20000, now);
+
+    QFuture<QList<TextMatcher::RankedItem>> future = HistorySearch::rankAsync(view, "entry 42", 5, now);
+    future.waitForFinished();
+    QVERIFY(!future.isCanceled());
+    QList<TextMatcher::RankedItem> ranked = future.result();
+    QCOMPARE(ranked.size(), 5);
+    QVERIFY(view.at(ranked.first().index).text().contains("entry 42"));
+}
+
+// Cancellation
+
+void TestHistorySearch::testStart_supersedesRunningSearch()
+{
+    HistoryView view = createView(50000, QDateTime::currentMSecsSinceEpoch());
+    HistorySearch search;
+    QSignalSpy finishedSpy(&search, &HistorySearch::finished);
+
+    // As if typed one character after another
+    search.start(view, "e", 10);
+    search.start(view, "en", 10);
+    search.start(view, "entry 4", 10);
+    QVERIFY(search.isRunning());
+
+    QVERIFY(finishedSpy.wait(5000));
+    QTest::qWait(50);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().at(0).toString(), QString("entry 4"));
+    QCOMPARE(search.pattern(), QString("entry 4"));
+    QCOMPARE(search.results().size(), 10);
+    QCOMPARE(search.view().count(), view.count());
+    QVERIFY(!search.isRunning());
+}
+
+void TestHistorySearch::testCancel_suppressesResult()
+{
+    HistoryView view = createView(50000, QDateTime::currentMSecsSinceEpoch());
+    HistorySearch search;
+    QSignalSpy finishedSpy(&search, &HistorySearch::finished);
+
+    search.start(view, "entry", 10);
+    search.cancel();
+    QVERIFY(!search.isRunning());
+
+    QTest::qWait(200);
+    QCOMPARE(finishedSpy.count(), 0);
+    QVERIFY(search.results().isEmpty());
+}
+
+// Helper Methods
+
+HistoryView TestHistorySearch::createView(int itemCount, qint64 nowMs)
+{
+    QList<ClipboardItem> pinned;
+    QList<ClipboardItem> unpinned;
+    for (int i = 0; i < itemCount; ++i) {
+        ClipboardItem item = ClipboardItem::fromFields(QString("id-%1").arg(i),
+                                                       QString("entry %1 of the history").arg(i),
+                                                       QString(), nowMs - qint64(i) * 1000,
+                                                       i % 500 == 0, 0);
+        if (item.pinned()) {
+            pinned.append(item);
+        } else {
+            unpinned.append(item);
+        }
+    }
+    return HistoryView(1, pinned, unpinned);
+}
+
+QTEST_MAIN(TestHistorySearch)
+#include "test_history_search.moc"
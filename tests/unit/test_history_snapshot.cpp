@@ -0,0 +1,184 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_snapshot.h"
+
+/**
+ * @brief Unit tests for the binary HistorySnapshot format
+ *
+ * These tests verify that snapshots round-trip every stored field and that
+ * damaged files are rejected instead of producing bogus items.
+ */
+class TestHistorySnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Round Trip
+    void testWriteAndOpen_preservesFields();
+    void testWriteAndOpen_preservesPayload();
+    void testHistory_roundTripsThroughSnapshot();
+    void testHistory_largeSnapshotKeepsOrder();
+    void testEmptySnapshot();
+
+    // Validation
+    void testOpen_rejectsJsonFile();
+    void testOpen_rejectsTruncatedFile();
+
+private:
+    // Helper methods
+    QString snapshotPath() const;
+
+    QScopedPointer<QTemporaryDir> m_dir;
+};
+
+void TestHistorySnapshot::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+}
+
+// Round Trip
+
+void TestHistorySnapshot::testWriteAndOpen_preservesFields()
+{
+    ClipboardItem plain("Plain text", QDateTime::currentDateTime().addSecs(-60));
+    ClipboardItem pinned(QString::fromUtf8("Ünïcödé ☃ text\nwith lines"));
+    pinned.pin();
+
+    QVERIFY(HistorySnapshot::write(snapshotPath(), 75, {pinned, plain}));
+    QVERIFY(HistorySnapshot::isSnapshotFile(snapshotPath()));
+
+    HistorySnapshot snapshot(snapshotPath());
+    QVERIFY(snapshot.open());
+    QCOMPARE(snapshot.count(), 2);
+    QCOMPARE(snapshot.maxItems(), 75);
+
+    ClipboardItem first = snapshot.itemAt(0);
+    QVERIFY(first.isValid());
+    QCOMPARE(first.id(), pinned.id());
+    QCOMPARE(first.text(), pinned.text());
+    QCOMPARE(first.preview(), pinned.preview());
+    QCOMPARE(first.hash(), pinned.hash());
+    QVERIFY(first.pinned());
+    QCOMPARE(first.timestamp().toMSecsSinceEpoch(), pinned.timestamp().toMSecsSinceEpoch());
+
+    ClipboardItem second = snapshot.itemAt(1);
+    QCOMPARE(second.id(), plain.id());
+    QVERIFY(!second.pinned());
+    QVERIFY(!snapshot.itemAt(2).isValid());
+}
+
+void TestHistorySnapshot::testWriteAndOpen_preservesPayload()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "image/png";
+    payload.key = QString(64, QLatin1Char('d'));
+    payload.size = 5 * 1024 * 1024;
+    ClipboardItem image = ClipboardItem::fromPayload(payload, "Image 800x600", "Image 800x600 (5 MB)");
+    ClipboardItem plain("Plain text");
+
+    QVERIFY(HistorySnapshot::write(snapshotPath(), 50, {image, plain}));
+
+    HistorySnapshot snapshot(snapshotPath());
+    QVERIFY(snapshot.open());
+    ClipboardItem first = snapshot.itemAt(0);
+    QVERIFY(first.isValid());
+    QVERIFY(first.hasPayload());
+    QCOMPARE(first.payload().mimeType, payload.mimeType);
+    QCOMPARE(first.payload().key, payload.key);
+    QCOMPARE(first.payload().size, payload.size);
+    QCOMPARE(first.contentKey(), image.contentKey());
+    QCOMPARE(first.preview(), image.preview());
+    QVERIFY(!snapshot.itemAt(1).hasPayload());
+}
+
+void TestHistorySnapshot::testHistory_roundTripsThroughSnapshot()
+{
+    ClipboardHistory source(80);
+    source.addItem(ClipboardItem("Older", QDateTime::currentDateTime().addSecs(-20)));
+    QString pinnedId = source.addItem(ClipboardItem("Newer", QDateTime::currentDateTime().addSecs(-10)));
+    source.pinItem(pinnedId);
+    QVERIFY(source.saveToSnapshot(snapshotPath()));
+
+    ClipboardHistory loaded;
+    QVERIFY(loaded.loadFromSnapshot(snapshotPath()));
+    QCOMPARE(loaded.maxItems(), 80);
+    QCOMPARE(loaded.count(), 2);
+    QCOMPARE(loaded.findItemIndex(pinnedId), 0);
+    QVERIFY(loaded.getItem(pinnedId).pinned());
+    QVERIFY(loaded.hasDuplicate("Older"));
+}
+
+void TestHistorySnapshot::testHistory_largeSnapshotKeepsOrder()
+{
+    // Enough items to be decoded in several chunks
+    ClipboardHistory source(10000);
+    QDateTime start = QDateTime::currentDateTime().addSecs(-5000);
+    for (int i = 0; i < 5000; ++i) {
+        source.addItem(ClipboardItem(QString("Entry %1").arg(i), start.addSecs(i)));
+    }
+    QVERIFY(source.saveToSnapshot(snapshotPath()));
+
+    ClipboardHistory loaded;
+    QVERIFY(loaded.loadFromSnapshot(snapshotPath()));
+    QCOMPARE(loaded.count(), source.count());
+    for (int i = 0; i < source.count(); i += 97) {
+        QCOMPARE(loaded.getItemAt(i).id(), source.getItemAt(i).id());
+        QCOMPARE(loaded.getItemAt(i).text(), source.getItemAt(i).text());
+    }
+}
+
+void TestHistorySnapshot::testEmptySnapshot()
+{
+    QVERIFY(HistorySnapshot::write(snapshotPath(), 50, {}));
+
+    HistorySnapshot snapshot(snapshotPath());
+    QVERIFY(snapshot.open());
+    QCOMPARE(snapshot.count(), 0);
+}
+
+// Validation
+
+void TestHistorySnapshot::testOpen_rejectsJsonFile()
+{
+    QFile file(snapshotPath());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("{\"maxItems\": 50, \"items\": []}");
+    file.close();
+
+    QVERIFY(!HistorySnapshot::isSnapshotFile(snapshotPath()));
+    HistorySnapshot snapshot(snapshotPath());
+    QVERIFY(!snapshot.open());
+
+    ClipboardHistory history;
+    QVERIFY(!history.loadFromSnapshot(snapshotPath()));
+}
+
+void TestHistorySnapshot::testOpen_rejectsTruncatedFile()
+{
+    QVERIFY(HistorySnapshot::write(snapshotPath(), 50, {ClipboardItem("Some clipboard text")}));
+
+    QFile file(snapshotPath());
+    QVERIFY(file.resize(file.size() - 4));
+
+    HistorySnapshot snapshot(snapshotPath());
+    QVERIFY(!snapshot.open());
+}
+
+// Helper Methods
+
+QString TestHistorySnapshot::snapshotPath() const
+{
+    return m_dir->filePath("history.bin");
+}
+
+QTEST_MAIN(TestHistorySnapshot)
+#include "test_history_snapshot.moc"
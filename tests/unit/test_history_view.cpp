@@ -0,0 +1,135 @@
+#include <QtTest/QtTest>
+#include <QObject>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/history_view.h"
+
+/**
+ * @brief Unit tests for HistoryView snapshots and history versions
+ *
+ * These tests verify that views are cheap to take, stay unchanged while
+ * the history moves on, and carry a version that changes with the items.
+ */
+class TestHistoryView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Versions
+    void testVersion_changesWithItems();
+    void testVersion_unchangedByLookups();
+    void testDefaultView_neverMatchesHistory();
+
+    // Snapshots
+    void testView_reusedWhileUnchanged();
+    void testView_isImmutable();
+    void testView_displayOrder();
+    void testItems_limit();
+};
+
+// Versions
+
+void TestHistoryView::testVersion_changesWithItems()
+{
+    ClipboardHistory history;
+    quint64 version = history.version();
+
+    QString id = history.addItem("First");
+    QVERIFY(history.version() != version);
+
+    version = history.version();
+    history.pinItem(id);
+    QVERIFY(history.version() != version);
+
+    version = history.version();
+    history.unpinItem(id);
+    QVERIFY(history.version() != version);
+
+    version = history.version();
+    history.removeItem(id);
+    QVERIFY(history.version() != version);
+}
+
+void TestHistoryView::testVersion_unchangedByLookups()
+{
+    ClipboardHistory history;
+    QString id = history.addItem("Looked up");
+    quint64 version = history.version();
+
+    history.getItem(id);
+    history.hasDuplicate("Looked up");
+    history.items();
+    history.view();
+    history.removeItem("missing");
+    QCOMPARE(history.version(), version);
+}
+
+void TestHistoryView::testDefaultView_neverMatchesHistory()
+{
+    ClipboardHistory history;
+    QVERIFY(HistoryView().version() != history.view().version());
+    QVERIFY(HistoryView().isEmpty());
+}
+
+// Snapshots
+
+void TestHistoryView::testView_reusedWhileUnchanged()
+{
+    ClipboardHistory history;
+    history.addItem("Shared");
+
+    HistoryView first = history.view();
+    HistoryView second = history.view();
+    QCOMPARE(first.version(), second.version());
+    QCOMPARE(&first.at(0), &second.at(0));
+}
+
+void TestHistoryView::testView_isImmutable()
+{
+    ClipboardHistory history;
+    QString id = history.addItem("Before");
+    HistoryView before = history.view();
+
+    history.addItem("After");
+    history.pinItem(id);
+
+    QCOMPARE(before.count(), 1);
+    QCOMPARE(before.at(0).text(), QString("Before"));
+    QVERIFY(!before.at(0).pinned());
+
+    HistoryView after = history.view();
+    QVERIFY(after.version() != before.version());
+    QCOMPARE(after.count(), 2);
+}
+
+void TestHistoryView::testView_displayOrder()
+{
+    ClipboardHistory history;
+    QString older = history.addItem(ClipboardItem("Older", QDateTime::currentDateTime().addSecs(-10)));
+    history.addItem("Newer");
+    history.pinItem(older);
+
+    HistoryView view = history.view();
+    QCOMPARE(view.pinnedCount(), 1);
+    QCOMPARE(view.at(0).id(), older);
+    QCOMPARE(view.at(1).text(), QString("Newer"));
+    QVERIFY(view.items() == history.items());
+}
+
+void TestHistoryView::testItems_limit()
+{
+    ClipboardHistory history;
+    for (int i = 0; i < 8; ++i) {
+        history.addItem(ClipboardItem(QString("Item %1").arg(i), QDateTime::currentDateTime().addSecs(i)));
+    }
+
+    HistoryView view = history.view();
+    QList<ClipboardItem> recent = view.items(5);
+    QCOMPARE(recent.size(), 5);
+    QCOMPARE(recent.first().text(), QString("Item 7"));
+    QCOMPARE(view.items(100).size(), 8);
+}
+
+QTEST_MAIN(TestHistoryView)
+#include "test_history_view.moc"
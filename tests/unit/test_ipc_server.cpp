@@ -0,0 +1,365 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QApplication>
+#include <QClipboard>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+
+#include "../../src/cli/ipc_client.h"
+#include "../../src/services/clipboard_manager.h"
+#include "../../src/services/ipc_protocol.h"
+#include "../../src/services/ipc_server.h"
+
+/**
+ * @brief Unit tests for IpcProtocol and IpcServer
+ *
+ * These tests verify that requests and responses survive encoding and
+ * framing, that malformed input is rejected, that only one server can
+ * own a name, and that the server answers commands from the history of
+ * the running instance, also when requests are pipelined, that List and
+ * Search reach items kept in the cold tier, and that Get returns large
+ * text in full rather than its stored start.
+ */
+class TestIpcServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    // Protocol
+    void testProtocol_requestRoundTrip();
+    void testProtocol_responseRoundTrip();
+    void testProtocol_rejectsMalformedPayloads();
+    void testFrames_waitForCompleteFrames();
+
+    // Server
+    void testListen_singleInstance();
+    void testHandle_commands();
+    void testHandle_coversColdItems();
+    void testSocket_pipelinedRequests();
+    void testClient_getsLargeTextInFull();
+
+private:
+    // Helper methods
+    void captureText(const QString& text, QString& id);
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QScopedPointer<ClipboardManager> m_manager;
+    QScopedPointer<IpcServer> m_server;
+};
+
+void TestIpcServer::initTestCase()
+{
+    // Keep the manager away from the real history
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestIpcServer::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+    m_manager.reset(new ClipboardManager());
+    m_server.reset(new IpcServer(m_manager.data()));
+}
+
+void TestIpcServer::cleanup()
+{
+    m_server.reset();
+    m_manager.reset();
+}
+
+// Protocol
+
+void TestIpcServer::testProtocol_requestRoundTrip()
+{
+    IpcProtocol::Request request;
+    request.command = IpcProtocol::Command::Search;
+    request.argument = "invoice ✓";
+    request.limit = 7;
+
+    IpcProtocol::Request decoded;
+    QVERIFY(IpcProtocol::decodeRequest(IpcProtocol::encodeRequest(request), decoded));
+    QCOMPARE(decoded.command, IpcProtocol::Command::Search);
+    QCOMPARE(decoded.argument, request.argument);
+    QCOMPARE(decoded.limit, 7);
+}
+
+void TestIpcServer::testProtocol_responseRoundTrip()
+{
+    IpcProtocol::Response response;
+    response.status = IpcProtocol::Status::NotFound;
+    response.message = "No such item";
+    response.text = "full\ntext";
+    for (int i = 0; i < 3; ++i) {
+        IpcProtocol::Entry entry;
+        entry.id = QString("id-%1").arg(i);
+        entry.preview = QString("Preview %1").arg(i);
+        entry.pinned = i == 0;
+        entry.timestamp = 1700000000000 + i;
+        response.entries.append(entry);
+    }
+
+    IpcProtocol::Response decoded;
+    QVERIFY(IpcProtocol::decodeResponse(IpcProtocol::encodeResponse(response), decoded));
+    QCOMPARE(decoded.status, IpcProtocol::Status::NotFound);
+    QCOMPARE(decoded.message, response.message);
+    QCOMPARE(decoded.text, response.text);
+    QCOMPARE(decoded.entries.size(), 3);
+    QCOMPARE(decoded.entries.at(2).id, QString("id-2"));
+    QVERIFY(decoded.entries.at(0).pinned);
+    QCOMPARE(decoded.entries.at(1).timestamp, qint64(1700000000001));
+}
+
+void TestIpcServer::testProtocol_rejectsMalformedPayloads()
+{
+    IpcProtocol::Request request;
+    QVERIFY(!IpcProtocol::decodeRequest(QByteArray(), request));
+    QVERIFY(!IpcProtocol::decodeRequest("not a request", request));
+
+    // Trailing garbage and truncation are both rejected
+    QByteArray payload = IpcProtocol::encodeRequest(IpcProtocol::Request());
+    QVERIFY(!IpcProtocol::decodeRequest(payload + "x", request));
+    QVERIFY(!IpcProtocol::decodeRequest(payload.left(payload.size() - 1), request));
+
+    IpcProtocol::Response response;
+    QVERIFY(!IpcProtocol::decodeResponse(payload, response));
+}
+
+void TestIpcServer::testFrames_waitForCompleteFrames()
+{
+    QByteArray first = IpcProtocol::frame("first");
+    QByteArray second = IpcProtocol::frame("second");
+    QByteArray buffer = first + second.left(3);
+
+    QByteArray payload;
+    QCOMPARE(IpcProtocol::takeFrame(buffer, payload), IpcProtocol::FrameResult::Ready);
+    QCOMPARE(payload, QByteArray("first"));
+    QCOMPARE(IpcProtocol::takeFrame(buffer, payload), IpcProtocol::FrameResult::Incomplete);
+
+    buffer.append(second.mid(3));
+    QCOMPARE(IpcProtocol::takeFrame(buffer, payload), IpcProtocol::FrameResult::Ready);
+    QCOMPARE(payload, QByteArray("second"));
+    QVERIFY(buffer.isEmpty());
+
+    // A length beyond the limit cannot be a frame
+    QByteArray oversized(4, char(0xff));
+    QCOMPARE(IpcProtocol::takeFrame(oversized, payload), IpcProtocol::FrameResult::Invalid);
+}
+
+// Server
+
+void TestIpcServer::testListen_singleInstance()
+{
+    const QString name = m_dir->filePath("ipc.sock");
+    QVERIFY(m_server->listen(name));
+    QVERIFY(m_server->isListening());
+    QVERIFY(IpcServer::isServerRunning(name));
+
+    IpcServer second(m_manager.data());
+    QVERIFY(!second.listen(name));
+
+    // Once the first instance is gone the name can be taken again
+    m_server->close();
+    QVERIFY(!IpcServer::isServerRunning(name));
+    QVERIFY(second.listen(name));
+}
+
+void TestIpcServer::testHandle_commands()
+{
+    m_manager->startMonitoring();
+    QString id;
+    captureText("IPC unique invoice 4711", id);
+    QVERIFY(!id.isEmpty());
+
+    IpcProtocol::Request request;
+    request.command = IpcProtocol::Command::Search;
+    request.argument = "invoice 4711";
+    IpcProtocol::Response response = m_server->handle(request);
+    QCOMPARE(response.status, IpcProtocol::Status::Ok);
+    QVERIFY(!response.entries.isEmpty());
+    QCOMPARE(response.entries.first().id, id);
+
+    request.command = IpcProtocol::Command::Get;
+    request.argument = id;
+    QCOMPARE(m_server->handle(request).text, QString("IPC unique invoice 4711"));
+
+    request.command = IpcProtocol::Command::Pin;
+    QCOMPARE(m_server->handle(request).status, IpcProtocol::Status::Ok);
+    QVERIFY(m_manager->getItem(id).pinned());
+
+    request.command = IpcProtocol::Command::List;
+    request.limit = 1;
+    response = m_server->handle(request);
+    QCOMPARE(response.entries.size(), 1);
+    QVERIFY(response.entries.first().pinned);
+
+    request.command = IpcProtocol::Command::Get;
+    request.argument = "no-such-id";
+    response = m_server->handle(request);
+    QCOMPARE(response.status, IpcProtocol::Status::NotFound);
+    QVERIFY(!response.message.isEmpty());
+
+    QSignalSpy showSpy(m_server.data(), &IpcServer::showRequested);
+    request.command = IpcProtocol::Command::Show;
+    QCOMPARE(m_server->handle(request).status, IpcProtocol::Status::Ok);
+    QCOMPARE(showSpy.count(), 1);
+
+    request.command = IpcProtocol::Command::Metrics;
+    response = m_server->handle(request);
+    QCOMPARE(response.status, IpcProtocol::Status::Ok);
+    QVERIFY(response.text.contains("\nsearch_latency_count "));
+    QVERIFY(!response.text.contains("search_latency_count 0\n"));
+}
+
+void TestIpcServer::testHandle_coversColdItems()
+{
+    // More items than the hot tier keeps, so the oldest ones go cold
+    m_manager->setMaxHistoryItems(1000);
+    const QString marker = QString::number(QDateTime::currentMSecsSinceEpoch());
+    for (int i = 0; i < 150; ++i) {
+        QVERIFY(m_manager->processText(QString("IPC cold %1 entry %2 end").arg(marker).arg(i)));
+    }
+    QVERIFY(m_manager->historyView().count() < m_manager->historyCount());
+
+    IpcProtocol::Request request;
+    request.command = IpcProtocol::Command::Search;
+    request.argument = QString("IPC cold %1 entry 3 end").arg(marker);
+    request.limit = 5;
+    IpcProtocol::Response response = m_server->handle(request);
+    QCOMPARE(response.status, IpcProtocol::Status::Ok);
+    QVERIFY(!response.entries.isEmpty());
+    QCOMPARE(response.entries.first().preview, QString("IPC cold %1 entry 3 end").arg(marker));
+
+    request.command = IpcProtocol::Command::Get;
+    request.argument = response.entries.first().id;
+    QCOMPARE(m_server->handle(request).text, QString("IPC cold %1 entry 3 end").arg(marker));
+
+    request.command = IpcProtocol::Command::List;
+    request.argument.clear();
+    request.limit = IpcProtocol::MAX_LIMIT;
+    response = m_server->handle(request);
+    QStringList previews;
+    for (const IpcProtocol::Entry& entry : response.entries) {
+        if (entry.preview.contains(marker)) {
+            previews.append(entry.preview);
+        }
+    }
+    QCOMPARE(previews.size(), 150);
+    QCOMPARE(previews.first(), QString("IPC cold %1 entry 149 end").arg(marker));
+    QCOMPARE(previews.last(), QString("IPC cold %1 entry 0 end").arg(marker));
+}
+
+void TestIpcServer::testSocket_pipelinedRequests()
+{
+    const QString name = m_dir->filePath("ipc.sock");
+    QVERIFY(m_server->listen(name));
+
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    QVERIFY(socket.waitForConnected(1000));
+
+    // Two requests in one write, answered in order
+    IpcProtocol::Request list;
+    list.command = IpcProtocol::Command::List;
+    IpcProtocol::Request get;
+    get.command = IpcProtocol::Command::Get;
+    get.argument = "no-such-id";
+    socket.write(IpcProtocol::frame(IpcProtocol::encodeRequest(list)) +
+                 IpcProtocol::frame(IpcProtocol::encodeRequest(get)));
+
+    QByteArray buffer;
+    QList<IpcProtocol::Response> responses;
+    auto receive = [&]() {
+        buffer.append(socket.readAll());
+        QByteArray payload;
+        while (IpcProtocol::takeFrame(buffer, payload) == IpcProtocol::FrameResult::Ready) {
+            IpcProtocol::Response response;
+            if (IpcProtocol::decodeResponse(payload, response)) {
+                responses.append(response);
+            }
+        }
+        return responses.size() == 2;
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(receive(), 2000);
+    QCOMPARE(responses.at(0).status, IpcProtocol::Status::Ok);
+    QCOMPARE(responses.at(1).status, IpcProtocol::Status::NotFound);
+
+    // A client that breaks the framing is dropped
+    socket.write(QByteArray(8, char(0xff)));
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QLocalSocket::UnconnectedState, 2000);
+}
+
+void TestIpcServer::testClient_getsLargeTextInFull()
+{
+    const QString name = m_dir->filePath("ipc.sock");
+    QVERIFY(m_server->listen(name));
+
+    // Longer than MAX_INLINE_TEXT_LENGTH, so it is stored as a payload
+    QString text;
+    for (int i = 0; i < 1000; ++i) {
+        text += QString("IPC large text line %1 ✓\n").arg(i);
+    }
+    QVERIFY(text.size() > 10000);
+    QVERIFY(m_manager->processText(text));
+
+    // The item is added once the payload is stored on the persistence thread
+    QString id;
+    auto stored = [&]() {
+        const HistoryView view = m_manager->historyView();
+        for (int i = 0; i < view.count(); ++i) {
+            if (view.at(i).hasPayload() && view.at(i).text().startsWith("IPC large text line 0 ")) {
+                id = view.at(i).id();
+            }
+        }
+        return !id.isEmpty();
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(stored(), 5000);
+    QVERIFY(m_manager->getItem(id).text().size() < text.size());
+
+    // The client blocks, so it runs off the thread that serves it
+    QFuture<IpcProtocol::Response> reply = QtConcurrent::run([name, id]() {
+        IpcProtocol::Request request;
+        request.command = IpcProtocol::Command::Get;
+        request.argument = id;
+        IpcProtocol::Response response;
+        IpcClient client;
+        if (!client.connectToServer(name) || !client.send(request, response)) {
+            response.status = IpcProtocol::Status::Failed;
+            response.message = client.errorString();
+        }
+        return response;
+    });
+    QTRY_VERIFY_WITH_TIMEOUT(reply.isFinished(), 5000);
+
+    const IpcProtocol::Response response = reply.result();
+    QVERIFY2(response.status == IpcProtocol::Status::Ok, qPrintable(response.message));
+    QCOMPARE(response.text.size(), text.size());
+    QCOMPARE(response.text, text);
+}
+
+// Helper methods
+
+void TestIpcServer::captureText(const QString& text, QString& id)
+{
+    auto captured = [&]() {
+        const HistoryView view = m_manager->historyView();
+        for (int i = 0; i < view.count(); ++i) {
+            if (view.at(i).text() == text) {
+                id = view.at(i).id();
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    QApplication::clipboard()->setText(text);
+    QTRY_VERIFY_WITH_TIMEOUT(captured(), 2000);
+}
+
+QTEST_MAIN(TestIpcServer)
+#include "test_ipc_server.moc"
@@ -0,0 +1,193 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/item_arena.h"
+
+/**
+ * @brief Unit tests for ItemArena metadata storage
+ *
+ * These tests verify that entries come back as the metadata they were
+ * stored from, stay ordered and findable through inserts and removals,
+ * and that removed entries' text is reclaimed by compaction.
+ */
+class TestItemArena : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Storage
+    void testInsert_roundTripsMetadata();
+    void testInsert_roundTripsPayload();
+    void testInsert_rejectsDuplicateId();
+
+    // Ordering
+    void testInsert_keepsNewestFirst();
+    void testTakeAt_keepsPositionsFindable();
+
+    // Memory
+    void testCompaction_reclaimsRemovedText();
+    void testClear_releasesMemory();
+
+private:
+    // Helper methods
+    ClipboardItem createItem(const QString& text, int secondsAgo);
+};
+
+// Storage
+
+void TestItemArena::testInsert_roundTripsMetadata()
+{
+    ItemArena arena;
+    ClipboardItem item = createItem("Some clipboard text", 10);
+    item.pin();
+
+    QCOMPARE(arena.insert(item, 42), 0);
+    QCOMPARE(arena.count(), 1);
+    QCOMPARE(arena.tagAt(0), qint64(42));
+    QCOMPARE(arena.idAt(0), item.id());
+
+    const ClipboardItem entry = arena.at(0);
+    QCOMPARE(entry.id(), item.id());
+    QCOMPARE(entry.preview(), item.preview());
+    QCOMPARE(entry.timestampMs(), item.timestampMs());
+    QCOMPARE(entry.contentKey(), item.contentKey());
+    QVERIFY(entry.pinned());
+    QVERIFY(!entry.hasText());
+    QVERIFY(!entry.hasPayload());
+}
+
+void TestItemArena::testInsert_roundTripsPayload()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "image/png";
+    payload.key = QString(64, QChar('a'));
+    payload.size = 123456;
+    ClipboardItem item = ClipboardItem::fromPayload(payload, "[Image 10x10]", "Image 10x10");
+    QVERIFY(item.isValid());
+
+    ItemArena arena;
+    QCOMPARE(arena.insert(item, 0), 0);
+    const ClipboardItem entry = arena.at(0);
+    QVERIFY(entry.hasPayload());
+    QCOMPARE(entry.payload().mimeType, payload.mimeType);
+    QCOMPARE(entry.payload().key, payload.key);
+    QCOMPARE(entry.payload().size, payload.size);
+    QCOMPARE(entry.preview(), QString("Image 10x10"));
+
+    QSet<QString> keys;
+    arena.collectPayloadKeys(keys);
+    QCOMPARE(keys, QSet<QString>{payload.key});
+}
+
+void TestItemArena::testInsert_rejectsDuplicateId()
+{
+    ItemArena arena;
+    ClipboardItem item = createItem("Twice", 5);
+    QCOMPARE(arena.insert(item, 1), 0);
+    QCOMPARE(arena.insert(item, 2), -1);
+    QCOMPARE(arena.count(), 1);
+    QCOMPARE(arena.tagAt(0), qint64(1));
+}
+
+// Ordering
+
+void TestItemArena::testInsert_keepsNewestFirst()
+{
+    ItemArena arena;
+    ClipboardItem oldest = createItem("Oldest", 30);
+    ClipboardItem middle = createItem("Middle", 20);
+    ClipboardItem newest = createItem("Newest", 10);
+
+    arena.insert(middle, 0);
+    arena.insert(newest, 0);
+    QCOMPARE(arena.insert(oldest, 0), 2);
+
+    QCOMPARE(arena.idAt(0), newest.id());
+    QCOMPARE(arena.idAt(1), middle.id());
+    QCOMPARE(arena.idAt(2), oldest.id());
+    QCOMPARE(arena.indexOf(oldest.id()), 2);
+    QCOMPARE(arena.indexOf("no-such-id"), -1);
+}
+
+void TestItemArena::testTakeAt_keepsPositionsFindable()
+{
+    ItemArena arena;
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 20; ++i) {
+        items.append(createItem(QString("Item %1").arg(i), 100 - i));
+        arena.insert(items.last(), i);
+    }
+
+    // Remove from the front, the back and the middle
+    QCOMPARE(arena.takeAt(0).id(), items.at(19).id());
+    QCOMPARE(arena.takeAt(arena.count() - 1).id(), items.at(0).id());
+    QCOMPARE(arena.takeAt(arena.indexOf(items.at(10).id())).id(), items.at(10).id());
+
+    QCOMPARE(arena.count(), 17);
+    QVERIFY(!arena.contains(items.at(10).id()));
+    for (int i = 1; i < 19; ++i) {
+        if (i == 10) {
+            continue;
+        }
+        const int position = arena.indexOf(items.at(i).id());
+        QVERIFY(position >= 0);
+        QCOMPARE(arena.idAt(position), items.at(i).id());
+        QCOMPARE(arena.tagAt(position), qint64(i));
+    }
+}
+
+// Memory
+
+void TestItemArena::testCompaction_reclaimsRemovedText()
+{
+    ItemArena arena;
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 2000; ++i) {
+        items.append(createItem(QString("Entry %1 ").arg(i).repeated(8), 10000 - i));
+        arena.insert(items.last(), i);
+    }
+    const qint64 fullTextBytes = arena.usage().textBytes;
+
+    // Evict the oldest entries, as the size limit does
+    while (arena.count() > 100) {
+        arena.takeAt(arena.count() - 1);
+    }
+
+    const ItemArena::Usage usage = arena.usage();
+    QCOMPARE(usage.entries, 100);
+    QVERIFY(usage.textBytes < fullTextBytes / 2);
+    QVERIFY(usage.deadTextBytes < usage.textBytes);
+
+    // The survivors are intact after their text moved
+    for (int i = 1900; i < 2000; ++i) {
+        const int position = arena.indexOf(items.at(i).id());
+        QVERIFY(position >= 0);
+        QCOMPARE(arena.at(position).preview(), items.at(i).preview());
+    }
+}
+
+void TestItemArena::testClear_releasesMemory()
+{
+    ItemArena arena;
+    for (int i = 0; i < 100; ++i) {
+        arena.insert(createItem(QString("Entry %1").arg(i), i), i);
+    }
+    QVERIFY(arena.usage().totalBytes() > 0);
+
+    arena.clear();
+    QVERIFY(arena.isEmpty());
+    QCOMPARE(arena.usage().recordBytes, qint64(0));
+    QCOMPARE(arena.usage().textBytes, qint64(0));
+}
+
+// Helper methods
+
+ClipboardItem TestItemArena::createItem(const QString& text, int secondsAgo)
+{
+    return ClipboardItem(text, QDateTime::currentDateTime().addSecs(-secondsAgo));
+}
+
+QTEST_MAIN(TestItemArena)
+#include "test_item_arena.moc"
@@ -0,0 +1,153 @@
+#include <QtTest/QtTest>
+#include <QObject>
+
+#include "../../src/lib/latency_trace.h"
+
+/**
+ * @brief Unit tests for LatencyHistogram and LatencyTrace
+ *
+ * These tests verify that percentiles are reported within the histogram's
+ * precision, and that the trace records each stage once per sequence and
+ * nothing at all while disabled.
+ */
+class TestLatencyTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Histogram
+    void testHistogram_emptyReportsZero();
+    void testHistogram_percentiles();
+    void testHistogram_exactBelowSixteenMicroseconds();
+
+    // Trace
+    void testTrace_disabledRecordsNothing();
+    void testTrace_recordsEachStageOncePerSequence();
+    void testTrace_showRequestStartsSequence();
+    void testTrace_stagesNeedOpenSequence();
+};
+
+void TestLatencyTrace::init()
+{
+    LatencyTrace::reset();
+    LatencyTrace::setEnabled(true);
+}
+
+void TestLatencyTrace::cleanup()
+{
+    LatencyTrace::setEnabled(false);
+    LatencyTrace::reset();
+}
+
+// Histogram
+
+void TestLatencyTrace::testHistogram_emptyReportsZero()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.percentile(50), qint64(0));
+    QCOMPARE(histogram.percentile(99), qint64(0));
+}
+
+void TestLatencyTrace::testHistogram_percentiles()
+{
+    // 1..1000 ms, one sample each
+    LatencyHistogram histogram;
+    for (int ms = 1; ms <= 1000; ++ms) {
+        histogram.record(qint64(ms) * 1000 * 1000);
+    }
+
+    QCOMPARE(histogram.count(), quint64(1000));
+    QCOMPARE(histogram.max(), qint64(1000) * 1000 * 1000);
+
+    // Buckets are at most 12.5% wide and report their upper bound
+    const qint64 p50 = histogram.percentile(50);
+    const qint64 p99 = histogram.percentile(99);
+    QVERIFY(p50 >= 500 * 1000 * 1000 && p50 <= 563 * 1000 * 1000);
+    QVERIFY(p99 >= 990 * 1000 * 1000 && p99 <= histogram.max());
+    QCOMPARE(histogram.percentile(100), histogram.max());
+
+    histogram.reset();
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.max(), qint64(0));
+}
+
+void TestLatencyTrace::testHistogram_exactBelowSixteenMicroseconds()
+{
+    LatencyHistogram histogram;
+    histogram.record(3 * 1000);
+    histogram.record(5 * 1000);
+    histogram.record(-1);  // Clock oddities count as zero
+
+    QCOMPARE(histogram.percentile(1), qint64(0));
+    QCOMPARE(histogram.percentile(50), qint64(3 * 1000));
+    QCOMPARE(histogram.percentile(99), qint64(5 * 1000));
+}
+
+// Trace
+
+void TestLatencyTrace::testTrace_disabledRecordsNothing()
+{
+    LatencyTrace::setEnabled(false);
+    QVERIFY(!LatencyTrace::isEnabled());
+
+    LatencyTrace::mark(LatencyTrace::HotkeyPressed);
+    LatencyTrace::mark(LatencyTrace::FirstPaint);
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::HotkeyPressed).count(), quint64(0));
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::FirstPaint).count(), quint64(0));
+    QCOMPARE(LatencyTrace::report(), QString("No latencies recorded"));
+}
+
+void TestLatencyTrace::testTrace_recordsEachStageOncePerSequence()
+{
+    for (int press = 0; press < 3; ++press) {
+        LatencyTrace::mark(LatencyTrace::HotkeyPressed);
+        LatencyTrace::mark(LatencyTrace::ShowRequested);
+        LatencyTrace::mark(LatencyTrace::HistorySet);
+        LatencyTrace::mark(LatencyTrace::HistorySet);
+        LatencyTrace::mark(LatencyTrace::WindowShown);
+        LatencyTrace::mark(LatencyTrace::FirstPaint);
+        LatencyTrace::mark(LatencyTrace::FirstPaint);  // Repaints after the first are ignored
+    }
+
+    for (int stage = 0; stage < LatencyTrace::StageCount; ++stage) {
+        QCOMPARE(LatencyTrace::histogram(LatencyTrace::Stage(stage)).count(), quint64(3));
+    }
+
+    // Stages are offsets from the press, so later stages never come first
+    const qint64 shown = LatencyTrace::histogram(LatencyTrace::WindowShown).max();
+    QVERIFY(LatencyTrace::histogram(LatencyTrace::FirstPaint).max() >= shown);
+
+    QString report = LatencyTrace::report();
+    QVERIFY(report.contains("hotkey"));
+    QVERIFY(report.contains("first-paint"));
+    QVERIFY(report.contains("p99="));
+}
+
+void TestLatencyTrace::testTrace_showRequestStartsSequence()
+{
+    // Shown from the tray: no hotkey press
+    LatencyTrace::mark(LatencyTrace::ShowRequested);
+    LatencyTrace::mark(LatencyTrace::WindowShown);
+    LatencyTrace::mark(LatencyTrace::FirstPaint);
+
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::HotkeyPressed).count(), quint64(0));
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::ShowRequested).count(), quint64(1));
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::FirstPaint).count(), quint64(1));
+}
+
+void TestLatencyTrace::testTrace_stagesNeedOpenSequence()
+{
+    // History updates and repaints while the popup is open are not traced
+    LatencyTrace::mark(LatencyTrace::HistorySet);
+    LatencyTrace::mark(LatencyTrace::FirstPaint);
+
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::HistorySet).count(), quint64(0));
+    QCOMPARE(LatencyTrace::histogram(LatencyTrace::FirstPaint).count(), quint64(0));
+}
+
+QTEST_MAIN(TestLatencyTrace)
+#include "test_latency_trace.moc"
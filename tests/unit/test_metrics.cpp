@@ -0,0 +1,127 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QThread>
+
+#include "../../src/lib/metrics.h"
+#include "../../src/models/clipboard_history.h"
+
+/**
+ * @brief Unit tests for the Metrics registry
+ *
+ * These tests verify that counters and histograms add up when recorded
+ * from several threads at once, that the report names every metric, and
+ * that the history counts duplicate hits and evictions.
+ */
+class TestMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Registry
+    void testCounters_addUp();
+    void testRecording_concurrentThreads();
+    void testReport_namesEveryMetric();
+    void testReset_clearsEverything();
+
+    // Instrumentation
+    void testHistory_countsDuplicatesAndEvictions();
+};
+
+void TestMetrics::init()
+{
+    Metrics::reset();
+}
+
+// Registry
+
+void TestMetrics::testCounters_addUp()
+{
+    Metrics::add(Metrics::EventsCaptured);
+    Metrics::add(Metrics::EventsCaptured);
+    Metrics::add(Metrics::SavedBytes, 4096);
+
+    QCOMPARE(Metrics::value(Metrics::EventsCaptured), quint64(2));
+    QCOMPARE(Metrics::value(Metrics::SavedBytes), quint64(4096));
+    QCOMPARE(Metrics::value(Metrics::Saves), quint64(0));
+}
+
+void TestMetrics::testRecording_concurrentThreads()
+{
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 10000;
+
+    QList<QThread*> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.append(QThread::create([t]() {
+            for (int i = 0; i < RECORDS; ++i) {
+                Metrics::add(Metrics::DuplicateHits);
+                Metrics::record(Metrics::SearchLatency, qint64(t + 1) * 1000 * 1000);
+            }
+        }));
+    }
+    for (QThread* thread : threads) {
+        thread->start();
+    }
+    for (QThread* thread : threads) {
+        QVERIFY(thread->wait(10000));
+        delete thread;
+    }
+
+    QCOMPARE(Metrics::value(Metrics::DuplicateHits), quint64(THREADS * RECORDS));
+    const LatencyHistogram& histogram = Metrics::histogram(Metrics::SearchLatency);
+    QCOMPARE(histogram.count(), quint64(THREADS * RECORDS));
+    QCOMPARE(histogram.max(), qint64(THREADS) * 1000 * 1000);
+    QCOMPARE(histogram.percentile(100), qint64(THREADS) * 1000 * 1000);
+}
+
+void TestMetrics::testReport_namesEveryMetric()
+{
+    Metrics::add(Metrics::Evictions, 3);
+    Metrics::record(Metrics::LoadTime, 12 * 1000);
+
+    const QString report = Metrics::report();
+    for (int counter = 0; counter < Metrics::CounterCount; ++counter) {
+        QVERIFY(report.contains(QLatin1String(Metrics::counterName(Metrics::Counter(counter)))));
+    }
+    for (int timing = 0; timing < Metrics::TimingCount; ++timing) {
+        QVERIFY(report.contains(QLatin1String(Metrics::timingName(Metrics::Timing(timing))) + "_p99_us"));
+    }
+
+    // One "name value" pair per line
+    const QStringList lines = report.trimmed().split('\n');
+    QCOMPARE(lines.size(), Metrics::CounterCount + Metrics::TimingCount * 5);
+    QVERIFY(lines.contains("evictions 3"));
+    QVERIFY(lines.contains("load_time_count 1"));
+    QVERIFY(lines.contains("load_time_max_us 12"));
+}
+
+void TestMetrics::testReset_clearsEverything()
+{
+    Metrics::add(Metrics::Saves);
+    Metrics::record(Metrics::SaveLatency, 5000);
+    Metrics::reset();
+
+    QCOMPARE(Metrics::value(Metrics::Saves), quint64(0));
+    QCOMPARE(Metrics::histogram(Metrics::SaveLatency).count(), quint64(0));
+    QCOMPARE(Metrics::histogram(Metrics::SaveLatency).max(), qint64(0));
+}
+
+// Instrumentation
+
+void TestMetrics::testHistory_countsDuplicatesAndEvictions()
+{
+    ClipboardHistory history(10);
+    for (int i = 0; i < 15; ++i) {
+        history.addItem(QString("metrics item %1").arg(i));
+    }
+    history.addItem("metrics item 14");
+    history.addItem("metrics item 12");
+
+    QCOMPARE(Metrics::value(Metrics::Evictions), quint64(5));
+    QCOMPARE(Metrics::value(Metrics::DuplicateHits), quint64(2));
+}
+
+QTEST_MAIN(TestMetrics)
+#include "test_metrics.moc"
@@ -0,0 +1,187 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "../../src/models/blob_store.h"
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/history_journal.h"
+#include "../../src/services/persistence_worker.h"
+
+/**
+ * @brief Unit tests for PersistenceWorker running on its own thread
+ *
+ * These tests verify that requests are written in order on the worker
+ * thread, that results are reported back through signals, and that a
+ * blob sweep spares payloads whose key the caller has not claimed yet.
+ */
+class TestPersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Journal
+    void testRecords_writtenOnWorkerThread();
+
+    // Snapshots
+    void testRequestSnapshot_reportsResult();
+    void testSnapshot_keepsRecordsQueuedAfterIt();
+    void testSnapshot_failureIsReported();
+
+    // Blobs
+    void testStorePayload_reportsKey();
+    void testBlobCollection_sparesUnclaimedPayloads();
+
+private:
+    // Helper methods
+    void startWorker(const QString& snapshotPath);
+    void flushWorker();
+
+    QScopedPointer<QTemporaryDir> m_dir;
+    QThread* m_thread = nullptr;
+    PersistenceWorker* m_worker = nullptr;
+};
+
+void TestPersistenceWorker::init()
+{
+    m_dir.reset(new QTemporaryDir());
+    QVERIFY(m_dir->isValid());
+}
+
+void TestPersistenceWorker::cleanup()
+{
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+// Journal
+
+void TestPersistenceWorker::testRecords_writtenOnWorkerThread()
+{
+    startWorker(m_dir->filePath("history.bin"));
+    ClipboardItem item("Journaled on the worker");
+    m_worker->recordAdded(item);
+    m_worker->recordPinned(item.id());
+    flushWorker();
+
+    QCOMPARE(m_worker->pendingRecords(), 2);
+    ClipboardHistory history;
+    QCOMPARE(HistoryJournal(m_dir->filePath("history.journal")).replay(history), 2);
+    QVERIFY(history.getItem(item.id()).pinned());
+}
+
+// Snapshots
+
+void TestPersistenceWorker::testRequestSnapshot_reportsResult()
+{
+    startWorker(m_dir->filePath("history.bin"));
+    QSignalSpy writtenSpy(m_worker, &PersistenceWorker::snapshotWritten);
+
+    m_worker->requestSnapshot(50, {ClipboardItem("Snapshot me")});
+    QVERIFY(writtenSpy.wait(5000));
+
+    QCOMPARE(writtenSpy.first().at(0).toBool(), true);
+    ClipboardHistory history;
+    QVERIFY(history.loadFromSnapshot(m_dir->filePath("history.bin")));
+    QVERIFY(history.hasDuplicate("Snapshot me"));
+}
+
+void TestPersistenceWorker::testSnapshot_keepsRecordsQueuedAfterIt()
+{
+    startWorker(m_dir->filePath("history.bin"));
+    ClipboardItem folded("Folded into snapshot");
+    ClipboardItem later("Queued after snapshot");
+
+    m_worker->recordAdded(folded);
+    m_worker->requestSnapshot(50, {folded});
+    m_worker->recordAdded(later);
+    flushWorker();
+
+    QCOMPARE(m_worker->pendingRecords(), 1);
+    ClipboardHistory history;
+    QVERIFY(history.loadFromSnapshot(m_dir->filePath("history.bin")));
+    HistoryJournal(m_dir->filePath("history.journal")).replay(history);
+    QCOMPARE(history.count(), 2);
+}
+
+void TestPersistenceWorker::testSnapshot_failureIsReported()
+{
+    // A directory in place of the snapshot file cannot be replaced
+    QDir(m_dir->path()).mkpath("history.bin/blocked");
+    startWorker(m_dir->filePath("history.bin"));
+    QSignalSpy writtenSpy(m_worker, &PersistenceWorker::snapshotWritten);
+
+    m_worker->recordAdded(ClipboardItem("Must survive"));
+    m_worker->requestSnapshot(50, {});
+    QVERIFY(writtenSpy.wait(5000));
+    QCOMPARE(writtenSpy.first().at(0).toBool(), false);
+
+    ClipboardHistory history;
+    QCOMPARE(HistoryJournal(m_dir->filePath("history.journal")).replay(history), 1);
+}
+
+// Blobs
+
+void TestPersistenceWorker::testStorePayload_reportsKey()
+{
+    startWorker(m_dir->filePath("history.bin"));
+    QSignalSpy storedSpy(m_worker, &PersistenceWorker::payloadStored);
+
+    const QByteArray data("Stored on the worker");
+    m_worker->storePayload(1, data);
+    QVERIFY(storedSpy.wait(5000));
+
+    QCOMPARE(storedSpy.first().at(0).toULongLong(), quint64(1));
+    QCOMPARE(storedSpy.first().at(1).toString(), BlobStore::keyFor(data));
+    QCOMPARE(BlobStore(m_dir->filePath("blobs")).open(BlobStore::keyFor(data)).bytes(), data);
+}
+
+void TestPersistenceWorker::testBlobCollection_sparesUnclaimedPayloads()
+{
+    startWorker(m_dir->filePath("history.bin"));
+    const QByteArray claimed("Claimed and dropped");
+    const QByteArray unclaimed("Not claimed yet");
+    m_worker->storePayload(1, claimed);
+    m_worker->storePayload(2, unclaimed);
+
+    // The caller has only seen the first result, and no item holds either
+    m_worker->requestBlobCollection(1, {});
+    flushWorker();
+
+    BlobStore blobs(m_dir->filePath("blobs"));
+    QVERIFY(!blobs.contains(BlobStore::keyFor(claimed)));
+    QVERIFY(blobs.contains(BlobStore::keyFor(unclaimed)));
+
+    m_worker->requestBlobCollection(2, {});
+    flushWorker();
+    QVERIFY(!blobs.contains(BlobStore::keyFor(unclaimed)));
+}
+
+// Helper Methods
+
+void TestPersistenceWorker::startWorker(const QString& snapshotPath)
+{
+    m_worker = new PersistenceWorker(snapshotPath, m_dir->filePath("history.journal"),
+                                     m_dir->filePath("blobs"));
+    m_thread = new QThread();
+    m_worker->moveToThread(m_thread);
+    m_thread->start();
+}
+
+void TestPersistenceWorker::flushWorker()
+{
+    QMetaObject::invokeMethod(m_worker, []() {}, Qt::BlockingQueuedConnection);
+}
+
+QTEST_MAIN(TestPersistenceWorker)
+#include "test_persistence_worker.moc"
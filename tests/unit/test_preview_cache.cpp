@@ -0,0 +1,106 @@
+#include <QtTest/QtTest>
+#include <QObject>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/ui/preview_cache.h"
+
+/**
+ * @brief Unit tests for PreviewCache
+ *
+ * These tests verify that display texts are formatted once per item and
+ * length, that the least recently used entries are evicted first, and
+ * that pin state and payload items are displayed correctly.
+ */
+class TestPreviewCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Formatting
+    void testDisplayText_singleLine();
+    void testDisplayText_pinIndicatorNotCached();
+    void testDisplayText_payloadUsesPreview();
+
+    // Caching
+    void testDisplayText_cachesPerLength();
+    void testCapacity_evictsLeastRecentlyUsed();
+};
+
+// Formatting
+
+void TestPreviewCache::testDisplayText_singleLine()
+{
+    PreviewCache cache;
+    QCOMPARE(cache.displayText(ClipboardItem("  first\r\n\tsecond  "), 100), QString("first second"));
+
+    QString text = cache.displayText(ClipboardItem(QString(150, 'x')), 50);
+    QCOMPARE(text.length(), 50);
+    QVERIFY(text.endsWith("..."));
+}
+
+void TestPreviewCache::testDisplayText_pinIndicatorNotCached()
+{
+    PreviewCache cache;
+    ClipboardItem item("Pinned later");
+    QCOMPARE(cache.displayText(item, 100), QString("Pinned later"));
+
+    item.pin();
+    QCOMPARE(cache.displayText(item, 100), QString("📌 Pinned later"));
+    QCOMPARE(cache.count(), 1);
+}
+
+void TestPreviewCache::testDisplayText_payloadUsesPreview()
+{
+    ClipboardItem::Payload payload;
+    payload.mimeType = "text/uri-list";
+    payload.key = QString(64, QLatin1Char('f'));
+    payload.size = 64;
+    ClipboardItem item = ClipboardItem::fromPayload(payload, "/tmp/a\n/tmp/b", "2 files: /tmp/a, /tmp/b");
+
+    PreviewCache cache;
+    QCOMPARE(cache.displayText(item, 100), QString("2 files: /tmp/a, /tmp/b"));
+}
+
+// Caching
+
+void TestPreviewCache::testDisplayText_cachesPerLength()
+{
+    PreviewCache cache;
+    ClipboardItem item(QString(120, 'y'));
+
+    QString wide = cache.displayText(item, 100);
+    QString narrow = cache.displayText(item, 50);
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(wide.length(), 100);
+    QCOMPARE(narrow.length(), 50);
+
+    QCOMPARE(cache.displayText(item, 100), wide);
+    QCOMPARE(cache.count(), 2);
+}
+
+void TestPreviewCache::testCapacity_evictsLeastRecentlyUsed()
+{
+    PreviewCache cache(2);
+    ClipboardItem first("First");
+    ClipboardItem second("Second");
+    ClipboardItem third("Third");
+
+    cache.displayText(first, 100);
+    cache.displayText(second, 100);
+    cache.displayText(first, 100);  // Now the most recently used
+    cache.displayText(third, 100);
+
+    QCOMPARE(cache.count(), 2);
+    QCOMPARE(cache.capacity(), 2);
+    QVERIFY(cache.contains(first.id(), 100));
+    QVERIFY(!cache.contains(second.id(), 100));
+    QVERIFY(cache.contains(third.id(), 100));
+
+    // Formatting is deterministic, so an evicted item is simply formatted again
+    QCOMPARE(cache.displayText(second, 100), QString("Second"));
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+}
+
+QTEST_MAIN(TestPreviewCache)
+#include "test_preview_cache.moc"
@@ -0,0 +1,143 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QThread>
+#include <atomic>
+
+#include "../../src/models/clipboard_history.h"
+#include "../../src/models/published_history.h"
+
+/**
+ * @brief Unit tests for PublishedHistory and ClipboardHistory snapshots
+ *
+ * These tests verify that snapshots are published once per event loop
+ * iteration, that readers on other threads always see a consistent
+ * history while the writer keeps changing it, and that other threads can
+ * hand items to the writer.
+ */
+class TestPublishedHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Publishing
+    void testPublish_replacesCurrent();
+    void testSnapshot_publishedByEventLoop();
+
+    // Threads
+    void testSnapshot_consistentUnderConcurrentReaders();
+    void testPostItem_fromWorkerThread();
+};
+
+// Publishing
+
+void TestPublishedHistory::testPublish_replacesCurrent()
+{
+    PublishedHistory published;
+    QVERIFY(published.current().isEmpty());
+    QCOMPARE(published.version(), quint64(0));
+
+    const HistoryView view(7, {}, {ClipboardItem("published item")});
+    published.publish(view);
+    QCOMPARE(published.version(), quint64(7));
+    QCOMPARE(published.current().count(), 1);
+    QCOMPARE(published.current().at(0).text(), QString("published item"));
+}
+
+void TestPublishedHistory::testSnapshot_publishedByEventLoop()
+{
+    ClipboardHistory history(100);
+    history.addItem("first");
+    history.addItem("second");
+    history.addItem("third");
+
+    // Nothing is published until the event loop runs, then all at once
+    QCOMPARE(history.snapshot().count(), 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(history.snapshot().count(), 3);
+    QCOMPARE(history.snapshotVersion(), history.version());
+    QCOMPARE(history.snapshot().at(0).text(), QString("third"));
+
+    history.removeItem(history.getItemAt(0).id());
+    history.publishSnapshot();
+    QCOMPARE(history.snapshot().count(), 2);
+    QCOMPARE(history.snapshotVersion(), history.version());
+}
+
+// Threads
+
+void TestPublishedHistory::testSnapshot_consistentUnderConcurrentReaders()
+{
+    constexpr int READERS = 4;
+    constexpr int MAX_ITEMS = 50;
+    ClipboardHistory history(MAX_ITEMS);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<quint64> reads{0};
+    QList<QThread*> readers;
+    for (int r = 0; r < READERS; ++r) {
+        readers.append(QThread::create([&]() {
+            quint64 lastVersion = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                const HistoryView view = history.snapshot();
+                bool ok = view.version() >= lastVersion && view.count() <= MAX_ITEMS;
+                for (int i = 0; ok && i < view.count(); ++i) {
+                    const ClipboardItem& item = view.at(i);
+                    ok = item.isValid() && item.pinned() == (i < view.pinnedCount());
+                }
+                inconsistent += ok ? 0 : 1;
+                lastVersion = view.version();
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        }));
+    }
+    for (QThread* reader : readers) {
+        reader->start();
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        const QString id = history.addItem(QString("concurrent item %1").arg(i));
+        if (i % 25 == 0) {
+            history.pinItem(id);
+        } else if (i % 25 == 1 && history.pinnedCount() > 3) {
+            history.unpinItem(history.pinnedItems().constLast().id());
+        }
+        if (i % 10 == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+    history.publishSnapshot();
+
+    done = true;
+    for (QThread* reader : readers) {
+        QVERIFY(reader->wait(10000));
+        delete reader;
+    }
+
+    QCOMPARE(inconsistent.load(), 0);
+    QVERIFY(reads.load() > 0);
+    QCOMPARE(history.snapshot().count(), history.hotCount());
+}
+
+void TestPublishedHistory::testPostItem_fromWorkerThread()
+{
+    ClipboardHistory history(100);
+    QSignalSpy addedSpy(&history, &ClipboardHistory::itemAdded);
+
+    QThread* producer = QThread::create([&history]() {
+        for (int i = 0; i < 20; ++i) {
+            history.postItem(QString("posted item %1").arg(i));
+        }
+    });
+    producer->start();
+    QVERIFY(producer->wait(10000));
+    delete producer;
+
+    // Added and signalled on the history's own thread
+    QTRY_COMPARE(addedSpy.count(), 20);
+    QCOMPARE(history.count(), 20);
+    QCOMPARE(history.getItemAt(0).text(), QString("posted item 19"));
+}
+
+QTEST_MAIN(TestPublishedHistory)
+#include "test_published_history.moc"
@@ -0,0 +1,98 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include "../../src/ui/screen_topology.h"
+
+/**
+ * @brief Unit tests for ScreenTopology
+ *
+ * These tests verify that the cached topology matches the application's
+ * screens, that points are mapped to the screen containing them or to the
+ * primary screen, and that queries are served from the cache until it is
+ * invalidated.
+ */
+class TestScreenTopology : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testScreens_matchApplication();
+    void testScreenAt_containingOrPrimary();
+    void testDevicePixelRatios_distinct();
+    void testQueries_servedFromCache();
+    void testInvalidate_rebuildsOnNextQuery();
+};
+
+void TestScreenTopology::testScreens_matchApplication()
+{
+    ScreenTopology topology;
+    const QList<ScreenTopology::Screen>& screens = topology.screens();
+
+    QCOMPARE(screens.size(), QGuiApplication::screens().size());
+    QVERIFY(!screens.isEmpty());
+    QCOMPARE(screens.first().screen, QGuiApplication::primaryScreen());
+    for (const ScreenTopology::Screen& screen : screens) {
+        QCOMPARE(screen.geometry, screen.screen->geometry());
+        QCOMPARE(screen.availableGeometry, screen.screen->availableGeometry());
+        QCOMPARE(screen.devicePixelRatio, screen.screen->devicePixelRatio());
+    }
+}
+
+void TestScreenTopology::testScreenAt_containingOrPrimary()
+{
+    ScreenTopology topology;
+    for (const ScreenTopology::Screen& screen : topology.screens()) {
+        QCOMPARE(topology.screenAt(screen.geometry.center()).screen, screen.screen);
+    }
+
+    // Far outside every screen
+    QCOMPARE(topology.screenAt(QPoint(-100000, -100000)).screen, QGuiApplication::primaryScreen());
+    QCOMPARE(topology.primary().screen, QGuiApplication::primaryScreen());
+}
+
+void TestScreenTopology::testDevicePixelRatios_distinct()
+{
+    ScreenTopology topology;
+    const QList<qreal> ratios = topology.devicePixelRatios();
+
+    QVERIFY(!ratios.isEmpty());
+    QVERIFY(ratios.size() <= topology.screens().size());
+    QCOMPARE(ratios.first(), topology.primary().devicePixelRatio);
+    for (int i = 0; i < ratios.size(); ++i) {
+        QCOMPARE(ratios.count(ratios.at(i)), qsizetype(1));
+    }
+}
+
+void TestScreenTopology::testQueries_servedFromCache()
+{
+    ScreenTopology topology;
+    QCOMPARE(topology.generation(), quint64(0));
+
+    for (int i = 0; i < 1000; ++i) {
+        topology.screenAt(QPoint(i, i));
+        topology.primary();
+        topology.devicePixelRatios();
+    }
+    QCOMPARE(topology.generation(), quint64(1));
+}
+
+void TestScreenTopology::testInvalidate_rebuildsOnNextQuery()
+{
+    ScreenTopology topology;
+    QSignalSpy changedSpy(&topology, &ScreenTopology::changed);
+    const QRect geometry = topology.primary().geometry;
+
+    topology.invalidate();
+    topology.invalidate();
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(topology.generation(), quint64(1));
+
+    // The rebuilt copy is the same as long as the screens are
+    QCOMPARE(topology.primary().geometry, geometry);
+    QCOMPARE(topology.generation(), quint64(2));
+}
+
+QTEST_MAIN(TestScreenTopology)
+#include "test_screen_topology.moc"
@@ -0,0 +1,277 @@
+#include <QtTest/QtTest>
+#include <QObject>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/search_index.h"
+
+/**
+ * @brief Unit tests for the SearchIndex n-gram index
+ *
+ * These tests verify that indexed lookups agree with a plain text scan
+ * for every query length and mode, and that incremental updates are
+ * reflected in later searches, while a result held across them only
+ * describes the items it matched that are still indexed. Most tests force
+ * posting lists with a zero
+ * threshold; small indexes otherwise scan.
+ */
+class TestSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Queries
+    void testSearch_shortQueries();
+    void testSearch_substring();
+    void testSearch_prefix();
+    void testSearch_caseSensitivity();
+    void testSearch_emptyQueryMatchesAll();
+    void testSearch_longText();
+    void testSearch_matchesLinearScan_data();
+    void testSearch_matchesLinearScan();
+    void testIndex_buildsPostingsAtThreshold();
+
+    // Updates
+    void testAddItem_replacesSameId();
+    void testRemoveItem_compactsTombstones();
+    void testRefine_narrowsPreviousResult();
+    void testRefine_afterChangeSearchesAgain();
+    void testMatches_heldAcrossChanges();
+};
+
+// Queries
+
+void TestSearchIndex::testSearch_shortQueries()
+{
+    ClipboardItem abc("abc");
+    ClipboardItem xyz("xyz");
+    SearchIndex index(0);
+    index.setItems({abc, xyz});
+
+    QCOMPARE(index.search("b").count(), 1);
+    QVERIFY(index.search("b").contains(abc.id()));
+    QVERIFY(index.search("yz").contains(xyz.id()));
+    QVERIFY(index.search("abc").contains(abc.id()));
+    QVERIFY(index.search("q").isEmpty());
+    QVERIFY(index.search("ac").isEmpty());
+}
+
+void TestSearchIndex::testSearch_substring()
+{
+    ClipboardItem first("The quick brown fox");
+    ClipboardItem second("brown bread");
+    SearchIndex index(0);
+    index.setItems({first, second});
+
+    SearchIndex::Matches brown = index.search("brown");
+    QCOMPARE(brown.count(), 2);
+
+    SearchIndex::Matches fox = index.search("k brown f");
+    QCOMPARE(fox.count(), 1);
+    QVERIFY(fox.contains(first.id()));
+
+    // Trigrams found in different items do not combine
+    QVERIFY(index.search("quick bread").isEmpty());
+}
+
+void TestSearchIndex::testSearch_prefix()
+{
+    ClipboardItem url("https://example.com");
+    ClipboardItem text("visit https://example.com");
+    SearchIndex index(0);
+    index.setItems({url, text});
+
+    SearchIndex::Matches matches = index.search("https", SearchIndex::Prefix);
+    QCOMPARE(matches.count(), 1);
+    QVERIFY(matches.contains(url.id()));
+    QCOMPARE(index.search("h", SearchIndex::Prefix).count(), 1);
+}
+
+void TestSearchIndex::testSearch_caseSensitivity()
+{
+    ClipboardItem upper("Hello World");
+    ClipboardItem lower("hello world");
+    SearchIndex index(0);
+    index.setItems({upper, lower});
+
+    QCOMPARE(index.search("HELLO").count(), 2);
+    QCOMPARE(index.search("Wo", SearchIndex::Substring, Qt::CaseSensitive).count(), 1);
+    QVERIFY(index.search("World", SearchIndex::Substring, Qt::CaseSensitive).contains(upper.id()));
+    QVERIFY(index.search("HELLO", SearchIndex::Substring, Qt::CaseSensitive).isEmpty());
+}
+
+void TestSearchIndex::testSearch_emptyQueryMatchesAll()
+{
+    SearchIndex index(0);
+    index.setItems({ClipboardItem("one"), ClipboardItem("two")});
+    QCOMPARE(index.search(QString()).count(), 2);
+}
+
+void TestSearchIndex::testSearch_longText()
+{
+    // Text past the indexed length is still found
+    ClipboardItem item(QString(10000, 'a') + "needle");
+    SearchIndex index(0);
+    index.addItem(item);
+
+    QVERIFY(index.search("needle").contains(item.id()));
+    QVERIFY(index.search("e").contains(item.id()));
+    QVERIFY(index.search("haystack").isEmpty());
+}
+
+void TestSearchIndex::testSearch_matchesLinearScan_data()
+{
+    QTest::addColumn<int>("minIndexedItems");
+    QTest::newRow("indexed") << 0;
+    QTest::newRow("scanned") << 1000;
+}
+
+void TestSearchIndex::testSearch_matchesLinearScan()
+{
+    QFETCH(int, minIndexedItems);
+
+    QStringList words = {"alpha", "beta", "gamma", "Delta", "epsilon", "zeta"};
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 200; ++i) {
+        items.append(ClipboardItem(QString("%1 %2 %3").arg(words.at(i % 6), words.at(i % 5)).arg(i)));
+    }
+    SearchIndex index(minIndexedItems);
+    index.setItems(items);
+    QCOMPARE(index.isIndexed(), minIndexedItems == 0);
+
+    const QStringList queries = {"a", "ta", "eta", "delta", "Delta", "ma del", "a 1", "17", "zeta beta"};
+    for (const QString& query : queries) {
+        SearchIndex::Matches matches = index.search(query);
+        SearchIndex::Matches sensitive = index.search(query, SearchIndex::Substring, Qt::CaseSensitive);
+        SearchIndex::Matches prefix = index.search(query, SearchIndex::Prefix);
+        int expected = 0;
+        for (const ClipboardItem& item : items) {
+            bool found = item.text().contains(query, Qt::CaseInsensitive);
+            expected += found ? 1 : 0;
+            QCOMPARE(matches.contains(item.id()), found);
+            QCOMPARE(sensitive.contains(item.id()), item.text().contains(query));
+            QCOMPARE(prefix.contains(item.id()), item.text().startsWith(query, Qt::CaseInsensitive));
+        }
+        QCOMPARE(matches.count(), expected);
+    }
+}
+
+void TestSearchIndex::testIndex_buildsPostingsAtThreshold()
+{
+    SearchIndex index(3);
+    ClipboardItem first("first entry");
+    index.addItem(first);
+    index.addItem(ClipboardItem("second entry"));
+    QVERIFY(!index.isIndexed());
+    QCOMPARE(index.search("entry").count(), 2);
+
+    ClipboardItem third("third entry");
+    index.addItem(third);
+    QVERIFY(index.isIndexed());
+    QCOMPARE(index.search("entry").count(), 3);
+    QVERIFY(index.search("ird").contains(third.id()));
+
+    // Removal still applies once the posting lists exist
+    index.removeItem(first.id());
+    QVERIFY(!index.search("first").contains(first.id()));
+    QCOMPARE(index.search("entry").count(), 2);
+}
+
+// Updates
+
+void TestSearchIndex::testAddItem_replacesSameId()
+{
+    ClipboardItem item = ClipboardItem::fromFields("fixed-id", "old text", QString(), 1000, false, 0);
+    SearchIndex index(0);
+    index.addItem(item);
+    index.addItem(ClipboardItem::fromFields("fixed-id", "new text", QString(), 1000, false, 0));
+
+    QCOMPARE(index.count(), 1);
+    QVERIFY(index.search("old").isEmpty());
+    QVERIFY(index.search("new").contains("fixed-id"));
+}
+
+void TestSearchIndex::testRemoveItem_compactsTombstones()
+{
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 1000; ++i) {
+        items.append(ClipboardItem(QString("entry %1").arg(i)));
+    }
+    SearchIndex index(0);
+    index.setItems(items);
+
+    // Removing most items triggers a compaction on the way
+    for (int i = 0; i < 900; ++i) {
+        index.removeItem(items.at(i).id());
+    }
+    QCOMPARE(index.count(), 100);
+    QVERIFY(!index.contains(items.at(0).id()));
+
+    SearchIndex::Matches matches = index.search("entry");
+    QCOMPARE(matches.count(), 100);
+    QVERIFY(matches.contains(items.at(950).id()));
+    QVERIFY(!matches.contains(items.at(5).id()));
+    QCOMPARE(index.search("entry 95").count(), 10);
+}
+
+void TestSearchIndex::testRefine_narrowsPreviousResult()
+{
+    ClipboardItem apple("apple pie");
+    ClipboardItem apply("apply now");
+    SearchIndex index(0);
+    index.setItems({apple, apply});
+
+    SearchIndex::Matches matches = index.search("a");
+    for (const QString& query : {"ap", "app", "appl", "apple"}) {
+        matches = index.refine(matches, query);
+        QCOMPARE(matches.query(), QString(query));
+    }
+    QCOMPARE(matches.count(), 1);
+    QVERIFY(matches.contains(apple.id()));
+
+    // A query that no longer contains the old one is searched from scratch
+    matches = index.refine(matches, "now");
+    QVERIFY(matches.contains(apply.id()));
+}
+
+void TestSearchIndex::testRefine_afterChangeSearchesAgain()
+{
+    SearchIndex index(0);
+    index.addItem(ClipboardItem("first note"));
+    SearchIndex::Matches matches = index.search("no");
+
+    ClipboardItem added("second note");
+    index.addItem(added);
+    matches = index.refine(matches, "note");
+    QCOMPARE(matches.count(), 2);
+    QVERIFY(matches.contains(added.id()));
+}
+
+void TestSearchIndex::testMatches_heldAcrossChanges()
+{
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 300; ++i) {
+        items.append(ClipboardItem(QString("held entry %1").arg(i)));
+    }
+    SearchIndex index(0);
+    index.setItems(items);
+    const SearchIndex::Matches all = index.search(QString());
+    QCOMPARE(all.count(), 300);
+
+    // Changes after the search leave the matched items alone
+    ClipboardItem added("held entry added");
+    index.addItem(added);
+    index.removeItem(items.at(0).id());
+    QVERIFY(all.contains(items.at(1).id()));
+    QVERIFY(!all.contains(added.id()));
+    QVERIFY(!all.contains(items.at(0).id()));
+
+    // Renumbering the documents leaves the result matching nothing
+    for (int i = 1; i < 290; ++i) {
+        index.removeItem(items.at(i).id());
+    }
+    QVERIFY(index.search("held").contains(items.at(295).id()));
+    QVERIFY(!all.contains(items.at(295).id()));
+}
+
+QTEST_MAIN(TestSearchIndex)
+#include "test_search_index.moc"
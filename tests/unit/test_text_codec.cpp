@@ -0,0 +1,244 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/cold_history_store.h"
+#include "../../src/models/text_codec.h"
+
+/**
+ * @brief Unit tests for TextCodec and compressed cold history records
+ *
+ * These tests verify that text survives encoding with and without a
+ * dictionary, that a dictionary trained on similar texts makes short
+ * snippets smaller, and that the cold segment reads its compressed
+ * records back after reopening.
+ */
+class TestTextCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Codec
+    void testEncode_roundTrips();
+    void testEncode_shortTextStaysPlain();
+    void testEncode_dictionaryShrinksSimilarText();
+    void testDecode_rejectsCorruptData();
+    void testDecode_rejectsCorruptSizeHeader();
+    void testTrainDictionary_keepsNewestWithinLimit();
+
+    // Cold segment
+    void testColdStore_reopenDecodesCompressedRecords();
+    void testColdStore_compressionShrinksFile();
+
+private:
+    // Helper methods
+    QString logLine(int i);
+    QList<ClipboardItem> fillStore(ColdHistoryStore& store, int count);
+};
+
+// Codec
+
+void TestTextCodec::testEncode_roundTrips()
+{
+    const QStringList texts = {
+        QString(),
+        "short",
+        logLine(1).repeated(20),
+        QString::fromUtf8("Unicode \xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80 text ").repeated(10)
+    };
+    const QByteArray dictionary = logLine(2).toUtf8();
+
+    for (const QString& text : texts) {
+        QString decoded;
+        QVERIFY(TextCodec::decode(TextCodec::encode(text), QByteArray(), decoded));
+        QCOMPARE(decoded, text);
+        QVERIFY(TextCodec::decode(TextCodec::encode(text, dictionary), dictionary, decoded));
+        QCOMPARE(decoded, text);
+        QVERIFY(TextCodec::decode(TextCodec::encode(text, dictionary, false), dictionary, decoded));
+        QCOMPARE(decoded, text);
+    }
+}
+
+void TestTextCodec::testEncode_shortTextStaysPlain()
+{
+    const QByteArray encoded = TextCodec::encode("tiny");
+    QCOMPARE(quint8(encoded.at(0)), quint8(TextCodec::Plain));
+    QCOMPARE(encoded.mid(1), QByteArray("tiny"));
+
+    const QByteArray uncompressed = TextCodec::encode(logLine(1).repeated(20), QByteArray(), false);
+    QCOMPARE(quint8(uncompressed.at(0)), quint8(TextCodec::Plain));
+}
+
+void TestTextCodec::testEncode_dictionaryShrinksSimilarText()
+{
+    if (!TextCodec::isCompressionAvailable()) {
+        QSKIP("Built without zlib");
+    }
+
+    QList<QByteArray> samples;
+    for (int i = 0; i < 200; ++i) {
+        samples.append(logLine(i).toUtf8());
+    }
+    const QByteArray dictionary = TextCodec::trainDictionary(samples);
+
+    const QString text = logLine(1000);
+    const QByteArray alone = TextCodec::encode(text);
+    const QByteArray withDictionary = TextCodec::encode(text, dictionary);
+    QCOMPARE(quint8(withDictionary.at(0)), quint8(TextCodec::Deflate));
+    QVERIFY(withDictionary.size() < alone.size());
+    QVERIFY(withDictionary.size() < text.toUtf8().size() / 2);
+
+    // Decoding needs the same dictionary
+    QString decoded;
+    QVERIFY(TextCodec::decode(withDictionary, dictionary, decoded));
+    QCOMPARE(decoded, text);
+    QVERIFY(!TextCodec::decode(withDictionary, QByteArray(), decoded) || decoded != text);
+}
+
+void TestTextCodec::testDecode_rejectsCorruptData()
+{
+    QString decoded;
+    QVERIFY(!TextCodec::decode(QByteArray(), QByteArray(), decoded));
+    QVERIFY(!TextCodec::decode(QByteArray("\x07garbage"), QByteArray(), decoded));
+
+    if (TextCodec::isCompressionAvailable()) {
+        QByteArray encoded = TextCodec::encode(logLine(1).repeated(20));
+        QCOMPARE(quint8(encoded.at(0)), quint8(TextCodec::Deflate));
+        encoded.chop(encoded.size() / 2);
+        QVERIFY(!TextCodec::decode(encoded, QByteArray(), decoded));
+    }
+}
+
+void TestTextCodec::testDecode_rejectsCorruptSizeHeader()
+{
+    if (!TextCodec::isCompressionAvailable()) {
+        QSKIP("Built without zlib");
+    }
+
+    const QString text = logLine(3).repeated(20);
+    QByteArray encoded = TextCodec::encode(text);
+    QCOMPARE(quint8(encoded.at(0)), quint8(TextCodec::Deflate));
+    QString decoded;
+    QVERIFY(TextCodec::decode(encoded, QByteArray(), decoded));
+    QCOMPARE(decoded, text);
+
+    // A size field of 4 GiB would otherwise be allocated before inflating
+    QByteArray huge = encoded;
+    qToLittleEndian<quint32>(0xffffffffu, huge.data() + 1);
+    QVERIFY(!TextCodec::decode(huge, QByteArray(), decoded));
+    QCOMPARE(TextCodec::decodedSize(huge), qint64(-1));
+
+    // Under the absolute limit, but more than the compressed bytes can hold
+    QByteArray inflated = encoded;
+    const qsizetype deflatedBytes = encoded.size() - 5;
+    qToLittleEndian<quint32>(quint32(deflatedBytes * 1032 + 1), inflated.data() + 1);
+    QVERIFY(!TextCodec::decode(inflated, QByteArray(), decoded));
+
+    // A size that does not match the stream is still caught by inflate
+    QByteArray mismatched = encoded;
+    qToLittleEndian<quint32>(quint32(text.toUtf8().size() + 1), mismatched.data() + 1);
+    QVERIFY(!TextCodec::decode(mismatched, QByteArray(), decoded));
+    QCOMPARE(TextCodec::decodedSize(mismatched), qint64(text.toUtf8().size() + 1));
+}
+
+void TestTextCodec::testTrainDictionary_keepsNewestWithinLimit()
+{
+    QList<QByteArray> samples;
+    for (int i = 0; i < 5000; ++i) {
+        samples.append(logLine(i).toUtf8());
+    }
+    samples.append(samples.last());
+
+    const QByteArray dictionary = TextCodec::trainDictionary(samples);
+    QVERIFY(dictionary.size() <= TextCodec::MAX_DICTIONARY_SIZE);
+    QVERIFY(dictionary.size() > TextCodec::MAX_DICTIONARY_SIZE / 2);
+    QVERIFY(dictionary.endsWith(logLine(4999).toUtf8()));
+    QCOMPARE(dictionary.count(logLine(4999).toUtf8()), qsizetype(1));
+    QVERIFY(!dictionary.contains(logLine(0).toUtf8()));
+}
+
+// Cold segment
+
+void TestTextCodec::testColdStore_reopenDecodesCompressedRecords()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("history.cold");
+    QList<ClipboardItem> items;
+    {
+        ColdHistoryStore store(path);
+        QVERIFY(store.open());
+        items = fillStore(store, 600);
+
+        // Removing records releases their dictionary references
+        for (int i = 0; i < 50; ++i) {
+            store.removeAt(store.count() - 1);
+        }
+    }
+
+    ColdHistoryStore reopened(path);
+    QVERIFY(reopened.open());
+    QCOMPARE(reopened.count(), 550);
+    for (int i = 50; i < items.count(); i += 37) {
+        const int position = reopened.indexOf(items.at(i).id());
+        QVERIFY(position >= 0);
+        const ClipboardItem loaded = reopened.load(position);
+        QVERIFY(loaded.isValid());
+        QCOMPARE(loaded.text(), items.at(i).text());
+        QCOMPARE(loaded.contentKey(), items.at(i).contentKey());
+        QCOMPARE(loaded.timestampMs(), items.at(i).timestampMs());
+    }
+
+    // Records written after reopening use the stored dictionary
+    ClipboardItem extra(logLine(9999), QDateTime::currentDateTime());
+    QVERIFY(reopened.add(extra));
+    QCOMPARE(reopened.load(reopened.indexOf(extra.id())).text(), extra.text());
+}
+
+void TestTextCodec::testColdStore_compressionShrinksFile()
+{
+    if (!TextCodec::isCompressionAvailable()) {
+        QSKIP("Built without zlib");
+    }
+
+    QTemporaryDir dir;
+    ColdHistoryStore plain(dir.filePath("plain.cold"));
+    plain.setCompressionEnabled(false);
+    QVERIFY(plain.open());
+    fillStore(plain, 600);
+
+    ColdHistoryStore compressed(dir.filePath("compressed.cold"));
+    QVERIFY(compressed.open());
+    fillStore(compressed, 600);
+
+    QVERIFY(compressed.fileSize() < plain.fileSize() / 2);
+}
+
+// Helper methods
+
+QString TestTextCodec::logLine(int i)
+{
+    return QString("2024-05-%1 12:%2:07 INFO request completed GET /api/v1/items/%3?page=%4 status=200")
+        .arg(i % 28 + 1, 2, 10, QChar('0'))
+        .arg(i % 60, 2, 10, QChar('0'))
+        .arg(i * 7919)
+        .arg(i % 13);
+}
+
+QList<ClipboardItem> TestTextCodec::fillStore(ColdHistoryStore& store, int count)
+{
+    QList<ClipboardItem> items;
+    const QDateTime start = QDateTime::currentDateTime().addSecs(-count);
+    for (int i = 0; i < count; ++i) {
+        items.append(ClipboardItem(logLine(i), start.addSecs(i)));
+        if (!store.add(items.last())) {
+            qWarning() << "Cannot add item" << i;
+        }
+    }
+    return items;
+}
+
+QTEST_MAIN(TestTextCodec)
+#include "test_text_codec.moc"
@@ -0,0 +1,271 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDateTime>
+#include <QRandomGenerator>
+
+#include "../../src/models/clipboard_item.h"
+#include "../../src/models/text_matcher.h"
+
+/**
+ * @brief Unit tests for TextMatcher scanning kernels and ranking
+ *
+ * These tests verify that every kernel available on the machine agrees
+ * with QString::contains(Qt::CaseInsensitive), and that fuzzy scoring and
+ * ranking order results as documented.
+ */
+class TestTextMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    // Substring Matching
+    void testIndexIn_data();
+    void testIndexIn();
+    void testKernels_agreeWithQString_data();
+    void testKernels_agreeWithQString();
+    void testPrefix();
+    void testIndexIn_vectorBoundaries_data();
+    void testIndexIn_vectorBoundaries();
+
+    // Fuzzy Matching
+    void testFuzzyScore_subsequence();
+    void testFuzzyScore_prefersConsecutive();
+    void testMatchScore_substringBeatsFuzzy();
+    void testMatchScore_ordering_data();
+    void testMatchScore_ordering();
+
+    // Ranking
+    void testRank_limitAndOrder();
+    void testRank_pinnedAndRecency();
+
+private:
+    // Helper methods
+    QList<TextMatcher::Kernel> availableKernels() const;
+    void addKernelRows() const;
+};
+
+void TestTextMatcher::cleanup()
+{
+    TextMatcher::setKernel(TextMatcher::bestKernel());
+}
+
+// Substring Matching
+
+void TestTextMatcher::testIndexIn_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("position");
+
+    QTest::newRow("plain") << "world" << "hello world" << 6;
+    QTest::newRow("case") << "WORLD" << "Hello World" << 6;
+    QTest::newRow("single") << "x" << "abcx" << 3;
+    QTest::newRow("two") << "Cd" << "abcd" << 2;
+    QTest::newRow("missing") << "xyz" << "abc xy z" << -1;
+    QTest::newRow("longer than text") << "abcdef" << "abc" << -1;
+    QTest::newRow("first of several") << "ab" << "xxabyyab" << 2;
+    QTest::newRow("empty pattern") << "" << "abc" << 0;
+    QTest::newRow("non-ascii ends") << QString::fromUtf8("émile") << QString::fromUtf8("Dear Émile") << 5;
+    QTest::newRow("kelvin sign") << "k" << QString::fromUtf8("5 K") << 2;
+    QTest::newRow("long s") << "s" << QString::fromUtf8("ſ") << 0;
+    QTest::newRow("past vector width") << "needle" << QString(40, 'a') + "NEEDLE" << 40;
+}
+
+void TestTextMatcher::testIndexIn()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, text);
+    QFETCH(int, position);
+
+    for (TextMatcher::Kernel kernel : availableKernels()) {
+        TextMatcher::setKernel(kernel);
+        TextMatcher matcher(pattern);
+        QCOMPARE(int(matcher.indexIn(text)), position);
+        QCOMPARE(matcher.contains(text), position >= 0);
+    }
+}
+
+void TestTextMatcher::testKernels_agreeWithQString_data()
+{
+    QTest::addColumn<int>("kernel");
+    for (TextMatcher::Kernel kernel : availableKernels()) {
+        QTest::newRow(TextMatcher::kernelName(kernel).toLatin1().constData()) << int(kernel);
+    }
+}
+
+void TestTextMatcher::testKernels_agreeWithQString()
+{
+    QFETCH(int, kernel);
+    TextMatcher::setKernel(TextMatcher::Kernel(kernel));
+    QCOMPARE(TextMatcher::kernel(), TextMatcher::Kernel(kernel));
+
+    const QString alphabet = QString::fromUtf8("abAB -é");
+    QRandomGenerator random(42);
+    auto randomText = [&](int length) {
+        QString text;
+        for (int i = 0; i < length; ++i) {
+            text.append(alphabet.at(random.bounded(int(alphabet.size()))));
+        }
+        return text;
+    };
+
+    for (int i = 0; i < 5000; ++i) {
+        QString text = randomText(random.bounded(60));
+        QString pattern = randomText(1 + random.bounded(5));
+        TextMatcher matcher(pattern);
+        QCOMPARE(matcher.indexIn(text), text.indexOf(pattern, 0, Qt::CaseInsensitive));
+    }
+}
+
+void TestTextMatcher::testPrefix()
+{
+    TextMatcher matcher("HTTP");
+    QVERIFY(matcher.isPrefixOf(QString("https://example.com")));
+    QVERIFY(!matcher.isPrefixOf(QString("see http://")));
+}
+
+void TestTextMatcher::testIndexIn_vectorBoundaries_data()
+{
+    addKernelRows();
+}
+
+void TestTextMatcher::testIndexIn_vectorBoundaries()
+{
+    QFETCH(int, kernel);
+    if (kernel > TextMatcher::bestKernel()) {
+        QSKIP("Kernel not supported by this CPU");
+    }
+    TextMatcher::setKernel(TextMatcher::Kernel(kernel));
+    QCOMPARE(int(TextMatcher::kernel()), kernel);
+
+    // Matches before, across and after the 8- and 16-unit vector blocks
+    for (int position = 0; position < 40; ++position) {
+        for (const QString& pattern : {QString("ab"), QString("xyz"), QString("needle")}) {
+            TextMatcher matcher(pattern);
+            QCOMPARE(int(matcher.indexIn(QString(position, '-') + pattern.toUpper() + QString(5, '-'))), position);
+            QVERIFY(!matcher.contains(QString(position, '-') + pattern.left(pattern.size() - 1)));
+        }
+    }
+}
+
+// Fuzzy Matching
+
+void TestTextMatcher::testFuzzyScore_subsequence()
+{
+    TextMatcher matcher("cbm");
+    QVERIFY(matcher.fuzzyScore(QString("clipboard manager")) > 0);
+    QCOMPARE(matcher.fuzzyScore(QString("manager clipboard")), 0);
+    QCOMPARE(matcher.fuzzyScore(QString("cb")), 0);
+}
+
+void TestTextMatcher::testFuzzyScore_prefersConsecutive()
+{
+    TextMatcher matcher("clip");
+    int consecutive = matcher.fuzzyScore(QString("my clipboard"));
+    int scattered = matcher.fuzzyScore(QString("cold lime ink pot"));
+    QVERIFY(scattered > 0);
+    QVERIFY(consecutive > scattered);
+}
+
+void TestTextMatcher::testMatchScore_substringBeatsFuzzy()
+{
+    TextMatcher matcher("note");
+    int substring = matcher.matchScore(QString("a long line that ends with note"));
+    int fuzzy = matcher.matchScore(QString("Note on the tea party"));
+    int prefix = matcher.matchScore(QString("notes for today"));
+    QVERIFY(fuzzy > 0 || matcher.fuzzyScore(QString("Note on the tea party")) == 0);
+    QVERIFY(substring > matcher.matchScore(QString("n o t e")));
+    QVERIFY(prefix > substring);
+    QCOMPARE(matcher.matchScore(QString("nothing")), 0);
+}
+
+void TestTextMatcher::testMatchScore_ordering_data()
+{
+    addKernelRows();
+}
+
+void TestTextMatcher::testMatchScore_ordering()
+{
+    QFETCH(int, kernel);
+    if (kernel > TextMatcher::bestKernel()) {
+        QSKIP("Kernel not supported by this CPU");
+    }
+    TextMatcher::setKernel(TextMatcher::Kernel(kernel));
+    QCOMPARE(int(TextMatcher::kernel()), kernel);
+
+    TextMatcher matcher("note");
+    int prefix = matcher.matchScore(QString("notes for today"));
+    int substring = matcher.matchScore(QString("a long line that ends with note"));
+    int fuzzy = matcher.matchScore(QString("n o t e"));
+    QVERIFY(fuzzy > 0);
+    QVERIFY(substring > fuzzy);
+    QVERIFY(prefix > substring);
+    QCOMPARE(matcher.matchScore(QString("nothing")), 0);
+}
+
+// Ranking
+
+void TestTextMatcher::testRank_limitAndOrder()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QList<ClipboardItem> items;
+    for (int i = 0; i < 20; ++i) {
+        items.append(ClipboardItem::fromFields(QString("id-%1").arg(i), QString("entry %1").arg(i),
+                                               QString(), now, false, 0));
+    }
+    items.append(ClipboardItem::fromFields("other", "unrelated", QString(), now, false, 0));
+
+    TextMatcher matcher("entry");
+    QList<TextMatcher::RankedItem> ranked = matcher.rank(items, 5, now);
+    QCOMPARE(ranked.size(), 5);
+
+    // Equal scores keep display order
+    for (int i = 0; i < ranked.size(); ++i) {
+        QCOMPARE(ranked.at(i).index, i);
+    }
+    QVERIFY(matcher.rank(items, 0, now).isEmpty());
+    QCOMPARE(matcher.rank(items, 100, now).size(), 20);
+}
+
+void TestTextMatcher::testRank_pinnedAndRecency()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 dayAgo = now - 24 * 3600 * 1000;
+    QList<ClipboardItem> items = {
+        ClipboardItem::fromFields("old", "report draft", QString(), dayAgo, false, 0),
+        ClipboardItem::fromFields("new", "report draft", QString(), now, false, 0),
+        ClipboardItem::fromFields("pinned", "the report", QString(), dayAgo, true, 0),
+    };
+
+    QList<TextMatcher::RankedItem> ranked = TextMatcher("report").rank(items, 3, now);
+    QCOMPARE(ranked.size(), 3);
+    QCOMPARE(items.at(ranked.at(0).index).id(), QString("pinned"));
+    QCOMPARE(items.at(ranked.at(1).index).id(), QString("new"));
+    QCOMPARE(items.at(ranked.at(2).index).id(), QString("old"));
+    QVERIFY(ranked.at(1).score > ranked.at(2).score);
+}
+
+// Helper Methods
+
+QList<TextMatcher::Kernel> TestTextMatcher::availableKernels() const
+{
+    QList<TextMatcher::Kernel> kernels;
+    for (int kernel = TextMatcher::Scalar; kernel <= TextMatcher::bestKernel(); ++kernel) {
+        kernels.append(TextMatcher::Kernel(kernel));
+    }
+    return kernels;
+}
+
+void TestTextMatcher::addKernelRows() const
+{
+    // One row per kernel, so each is reported on its own; unsupported ones skip
+    QTest::addColumn<int>("kernel");
+    for (int kernel = TextMatcher::Scalar; kernel <= TextMatcher::Avx2; ++kernel) {
+        QTest::newRow(TextMatcher::kernelName(TextMatcher::Kernel(kernel)).toLatin1().constData()) << kernel;
+    }
+}
+
+QTEST_MAIN(TestTextMatcher)
+#include "test_text_matcher.moc"
@@ -0,0 +1,215 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "../../src/services/workload_trace.h"
+
+/**
+ * @brief Unit tests for WorkloadTrace
+ *
+ * These tests verify that recorded traces keep only lengths and repeat
+ * patterns, that traces survive a save/load round trip, that malformed
+ * files are rejected, and that generated traces have the shape of their
+ * pattern.
+ */
+class TestWorkloadTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Recording
+    void testRecord_tokensFollowRepeats();
+    void testSave_storesNoContent();
+
+    // Persistence
+    void testLoad_roundTrips();
+    void testLoad_rejectsInvalidFiles();
+
+    // Synthesized content
+    void testContentAt_matchesLengthAndRepeats();
+
+    // Generated traces
+    void testGenerate_burstHasRunsAndPauses();
+    void testGenerate_giantPastesExceedInlineLimit();
+    void testGenerate_heavyDuplicatesRepeatFewTexts();
+    void testGenerate_isDeterministic();
+
+private:
+    // Helper methods
+    static bool writeFile(const QString& path, const QByteArray& data);
+};
+
+// Recording
+
+void TestWorkloadTrace::testRecord_tokensFollowRepeats()
+{
+    WorkloadTrace trace;
+    trace.start();
+    trace.record(u"first");
+    trace.record(u"second text");
+    trace.record(u"first");
+    trace.record(u"third");
+    trace.record(u"second text");
+
+    QCOMPARE(trace.count(), 5);
+    const QList<int> tokens = {0, 1, 0, 3, 1};
+    for (int i = 0; i < trace.count(); ++i) {
+        QCOMPARE(trace.events().at(i).token, tokens.at(i));
+    }
+    QCOMPARE(trace.events().at(1).length, qint64(11));
+    QCOMPARE(trace.duplicateCount(), 2);
+    for (int i = 1; i < trace.count(); ++i) {
+        QVERIFY(trace.events().at(i).offsetMs >= trace.events().at(i - 1).offsetMs);
+    }
+}
+
+void TestWorkloadTrace::testSave_storesNoContent()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("session.trace");
+    WorkloadTrace trace;
+    trace.start();
+    trace.record(u"my secret password");
+    trace.record(u"my secret password");
+    QVERIFY(trace.save(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    QVERIFY(!data.contains("secret"));
+    QVERIFY(data.startsWith("{"));
+    QCOMPARE(data.count('\n'), qsizetype(3));
+}
+
+// Persistence
+
+void TestWorkloadTrace::testLoad_roundTrips()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("burst.trace");
+    const WorkloadTrace trace = WorkloadTrace::generate(WorkloadTrace::Burst, 200, 7);
+    QVERIFY(trace.save(path));
+
+    WorkloadTrace loaded;
+    QVERIFY(loaded.load(path));
+    QCOMPARE(loaded.count(), trace.count());
+    for (int i = 0; i < trace.count(); ++i) {
+        QCOMPARE(loaded.events().at(i).offsetMs, trace.events().at(i).offsetMs);
+        QCOMPARE(loaded.events().at(i).length, trace.events().at(i).length);
+        QCOMPARE(loaded.events().at(i).token, trace.events().at(i).token);
+    }
+    QCOMPARE(loaded.contentAt(150), trace.contentAt(150));
+}
+
+void TestWorkloadTrace::testLoad_rejectsInvalidFiles()
+{
+    QTemporaryDir dir;
+    const QByteArray header = "{\"format\":\"clipboard-trace\",\"version\":1}\n";
+    const QList<QByteArray> invalid = {
+        QByteArray(),
+        "{\"format\":\"something-else\",\"version\":1}\n",
+        "{\"format\":\"clipboard-trace\",\"version\":99}\n",
+        header + "{\"t\":0,\"length\":5,\"token\":1}\n",                                    // Forward token
+        header + "{\"t\":10,\"length\":5,\"token\":0}\n{\"t\":5,\"length\":5,\"token\":1}\n", // Time goes back
+        header + "{\"t\":0,\"length\":-3,\"token\":0}\n",
+        header + "not json\n"
+    };
+
+    for (int i = 0; i < invalid.count(); ++i) {
+        const QString path = dir.filePath(QString("invalid%1.trace").arg(i));
+        QVERIFY(writeFile(path, invalid.at(i)));
+        WorkloadTrace trace;
+        QVERIFY2(!trace.load(path), qPrintable(path));
+        QVERIFY(trace.isEmpty());
+    }
+
+    WorkloadTrace missing;
+    QVERIFY(!missing.load(dir.filePath("missing.trace")));
+}
+
+// Synthesized content
+
+void TestWorkloadTrace::testContentAt_matchesLengthAndRepeats()
+{
+    WorkloadTrace trace;
+    trace.append(0, 500);
+    trace.append(10, 500);
+    trace.append(20, 999, 0);   // A repeat keeps the length of the first copy
+    trace.append(30, 50000);
+
+    QCOMPARE(trace.events().at(2).length, qint64(500));
+    QCOMPARE(trace.contentAt(0).size(), qsizetype(500));
+    QCOMPARE(trace.contentAt(3).size(), qsizetype(50000));
+    QCOMPARE(trace.contentAt(2), trace.contentAt(0));
+    QVERIFY(trace.contentAt(1) != trace.contentAt(0));
+    QVERIFY(!trace.contentAt(0).trimmed().isEmpty());
+}
+
+// Generated traces
+
+void TestWorkloadTrace::testGenerate_burstHasRunsAndPauses()
+{
+    const WorkloadTrace trace = WorkloadTrace::generate(WorkloadTrace::Burst, 500);
+    QCOMPARE(trace.count(), 500);
+
+    int quick = 0;
+    int pauses = 0;
+    for (int i = 1; i < trace.count(); ++i) {
+        const qint64 gap = trace.events().at(i).offsetMs - trace.events().at(i - 1).offsetMs;
+        quick += gap <= 80 ? 1 : 0;
+        pauses += gap >= 2000 ? 1 : 0;
+    }
+    QVERIFY(quick > trace.count() / 2);
+    QVERIFY(pauses > 0);
+}
+
+void TestWorkloadTrace::testGenerate_giantPastesExceedInlineLimit()
+{
+    const WorkloadTrace trace = WorkloadTrace::generate(WorkloadTrace::GiantPastes, 50);
+    QCOMPARE(trace.count(), 50);
+    for (const WorkloadTrace::Event& event : trace.events()) {
+        QVERIFY(event.length > 10000);
+    }
+    QVERIFY(trace.duplicateCount() > 0);
+}
+
+void TestWorkloadTrace::testGenerate_heavyDuplicatesRepeatFewTexts()
+{
+    const WorkloadTrace trace = WorkloadTrace::generate(WorkloadTrace::HeavyDuplicates, 1000);
+    QCOMPARE(trace.count(), 1000);
+    QVERIFY(trace.duplicateCount() > 800);
+    QVERIFY(trace.count() - trace.duplicateCount() <= 20);
+}
+
+void TestWorkloadTrace::testGenerate_isDeterministic()
+{
+    const WorkloadTrace first = WorkloadTrace::generate(WorkloadTrace::Burst, 100, 3);
+    const WorkloadTrace second = WorkloadTrace::generate(WorkloadTrace::Burst, 100, 3);
+    const WorkloadTrace other = WorkloadTrace::generate(WorkloadTrace::Burst, 100, 4);
+
+    bool differs = false;
+    for (int i = 0; i < first.count(); ++i) {
+        QCOMPARE(second.events().at(i).offsetMs, first.events().at(i).offsetMs);
+        QCOMPARE(second.events().at(i).length, first.events().at(i).length);
+        differs = differs || other.events().at(i).length != first.events().at(i).length;
+    }
+    QVERIFY(differs);
+
+    bool ok = false;
+    QCOMPARE(WorkloadTrace::patternFromName("giant", &ok), WorkloadTrace::GiantPastes);
+    QVERIFY(ok);
+    WorkloadTrace::patternFromName("unknown", &ok);
+    QVERIFY(!ok);
+}
+
+// Helper methods
+
+bool TestWorkloadTrace::writeFile(const QString& path, const QByteArray& data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QTEST_MAIN(TestWorkloadTrace)
+#include "test_workload_trace.moc"